@@ -36,6 +36,7 @@ SET(EMBREE_IGNORE_INVALID_RAYS @EMBREE_IGNORE_INVALID_RAYS@)
 SET(EMBREE_TASKING_SYSTEM @EMBREE_TASKING_SYSTEM@)
 SET(EMBREE_TBB_COMPONENT @EMBREE_TBB_COMPONENT@)
 SET(EMBREE_COMPACT_POLYS @EMBREE_COMPACT_POLYS@)
+SET(EMBREE_TRAVERSAL_PREFETCH @EMBREE_TRAVERSAL_PREFETCH@)
 
 SET(EMBREE_GEOMETRY_TRIANGLE @EMBREE_GEOMETRY_TRIANGLE@)
 SET(EMBREE_GEOMETRY_QUAD @EMBREE_GEOMETRY_QUAD@)
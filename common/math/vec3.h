@@ -255,6 +255,7 @@ namespace embree
   typedef Vec3<bool > Vec3b;
   typedef Vec3<int  > Vec3i;
   typedef Vec3<float> Vec3f;
+  typedef Vec3<double> Vec3d;
 }
 
 #include "vec3ba.h"
@@ -33,15 +33,19 @@ namespace embree
   }
 
   static bool huge_pages_enabled = false;
+  static bool huge_pages_1g_enabled = false;
   static MutexSys os_init_mutex;
 
-  __forceinline bool isHugePageCandidate(const size_t bytes) 
+  __forceinline bool isHugePageCandidate(const size_t bytes, const size_t pageSize = PAGE_SIZE_2M) 
   {
     if (!huge_pages_enabled)
       return false;
 
+    if (pageSize == PAGE_SIZE_1G && !huge_pages_1g_enabled)
+      return false;
+
     /* use huge pages only when memory overhead is low */
-    const size_t hbytes = (bytes+PAGE_SIZE_2M-1) & ~size_t(PAGE_SIZE_2M-1);
+    const size_t hbytes = (bytes+pageSize-1) & ~size_t(pageSize-1);
     return 66*(hbytes-bytes) < bytes; // at most 1.5% overhead
   }
 }
@@ -89,10 +93,15 @@ namespace embree
     return true;
   }
 
-  bool os_init(bool hugepages, bool verbose) 
+  bool os_init(bool hugepages, bool hugepages_1g, bool verbose) 
   {
     Lock<MutexSys> lock(os_init_mutex);
 
+    /* 1GB pages are not supported under Windows */
+    huge_pages_1g_enabled = false;
+    if (hugepages_1g && verbose)
+      std::cout << "WARNING: 1GB huge pages are not supported under Windows!" << std::endl;
+
     if (!hugepages) {
       huge_pages_enabled = false;
       return true;
@@ -162,6 +171,10 @@ namespace embree
   void os_advise(void *ptr, size_t bytes)
   {
   }
+
+  size_t os_advised_bytes(void* ptr, size_t bytes) {
+    return 0;
+  }
 }
 
 #endif
@@ -184,10 +197,15 @@ namespace embree
 
 namespace embree
 {
-  bool os_init(bool hugepages, bool verbose) 
+  /* start addresses of mappings that use 1GB pages */
+  static std::set<void*> huge_pages_1g_ptrs;
+  static MutexSys huge_pages_1g_mutex;
+
+  bool os_init(bool hugepages, bool hugepages_1g, bool verbose) 
   {
     Lock<MutexSys> lock(os_init_mutex);
 
+    huge_pages_1g_enabled = false;
     if (!hugepages) {
       huge_pages_enabled = false;
       return true;
@@ -227,6 +245,20 @@ namespace embree
       huge_pages_enabled = false;
       return false;
     }
+
+    /* 1GB pages can only be used if the administrator reserved some */
+    if (hugepages_1g)
+    {
+      std::ifstream file1g("/sys/kernel/mm/hugepages/hugepages-1048576kB/nr_hugepages",std::ios::in);
+      size_t nr_hugepages = 0;
+      if (file1g.is_open()) file1g >> nr_hugepages;
+      huge_pages_1g_enabled = nr_hugepages > 0;
+      if (!huge_pages_1g_enabled && verbose)
+        std::cout << "WARNING: No 1GB huge pages reserved. 1GB huge page support cannot get enabled!" << std::endl;
+    }
+#else
+    if (hugepages_1g && verbose)
+      std::cout << "WARNING: 1GB huge pages are only supported under Linux!" << std::endl;
 #endif
 
     huge_pages_enabled = true;
@@ -240,6 +272,20 @@ namespace embree
       return nullptr;
     }
 
+    /* try 1GB pages for very large allocations */
+#if defined(MAP_HUGETLB) && defined(MAP_HUGE_SHIFT)
+    if (bytes >= PAGE_SIZE_1G && isHugePageCandidate(bytes,PAGE_SIZE_1G))
+    {
+      void* ptr = mmap(0, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANON | MAP_HUGETLB | (30 << MAP_HUGE_SHIFT), -1, 0);
+      if (ptr != MAP_FAILED) {
+        Lock<MutexSys> lock(huge_pages_1g_mutex);
+        huge_pages_1g_ptrs.insert(ptr);
+        hugepages = true;
+        return ptr;
+      }
+    }
+#endif
+
     /* try direct huge page allocation first */
     if (isHugePageCandidate(bytes)) 
     {
@@ -268,9 +314,17 @@ namespace embree
     return ptr;
   }
 
+  /* returns the page size of a mapping returned by os_malloc */
+  static size_t os_page_size(void* ptr, bool hugepages)
+  {
+    if (!hugepages) return PAGE_SIZE_4K;
+    Lock<MutexSys> lock(huge_pages_1g_mutex);
+    return huge_pages_1g_ptrs.count(ptr) ? PAGE_SIZE_1G : PAGE_SIZE_2M;
+  }
+
   size_t os_shrink(void* ptr, size_t bytesNew, size_t bytesOld, bool hugepages) 
   {
-    const size_t pageSize = hugepages ? PAGE_SIZE_2M : PAGE_SIZE_4K;
+    const size_t pageSize = os_page_size(ptr,hugepages);
     bytesNew = (bytesNew+pageSize-1) & ~(pageSize-1);
     bytesOld = (bytesOld+pageSize-1) & ~(pageSize-1);
     if (bytesNew >= bytesOld)
@@ -288,17 +342,38 @@ namespace embree
       return;
 
     /* for hugepages we need to also align the size */
-    const size_t pageSize = hugepages ? PAGE_SIZE_2M : PAGE_SIZE_4K;
+    const size_t pageSize = os_page_size(ptr,hugepages);
     bytes = (bytes+pageSize-1) & ~(pageSize-1);
     if (munmap(ptr,bytes) == -1)
       throw std::bad_alloc();
+
+    if (pageSize == PAGE_SIZE_1G) {
+      Lock<MutexSys> lock(huge_pages_1g_mutex);
+      huge_pages_1g_ptrs.erase(ptr);
+    }
   }
 
-  /* hint for transparent huge pages (THP) */
+  /* hint for transparent huge pages (THP), only the 2MB aligned
+   * pages fully inside the range can get converted */
   void os_advise(void* pptr, size_t bytes)
   {
 #if defined(MADV_HUGEPAGE)
-    madvise(pptr,bytes,MADV_HUGEPAGE); 
+    const size_t begin = ((size_t)pptr + PAGE_SIZE_2M-1) & ~size_t(PAGE_SIZE_2M-1);
+    const size_t end   = ((size_t)pptr + bytes) & ~size_t(PAGE_SIZE_2M-1);
+    if (begin >= end) return;
+    madvise((void*)begin,end-begin,MADV_HUGEPAGE); 
+#endif
+  }
+
+  /* returns the number of bytes of the range os_advise marks for THP */
+  size_t os_advised_bytes(void* pptr, size_t bytes)
+  {
+#if defined(MADV_HUGEPAGE)
+    const size_t begin = ((size_t)pptr + PAGE_SIZE_2M-1) & ~size_t(PAGE_SIZE_2M-1);
+    const size_t end   = ((size_t)pptr + bytes) & ~size_t(PAGE_SIZE_2M-1);
+    return begin < end ? end-begin : 0;
+#else
+    return 0;
 #endif
   }
 }
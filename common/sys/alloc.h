@@ -55,11 +55,12 @@ namespace embree
 
   /*! allocates pages directly from OS */
   bool win_enable_selockmemoryprivilege(bool verbose);
-  bool os_init(bool hugepages, bool verbose);
+  bool os_init(bool hugepages, bool hugepages_1g, bool verbose);
   void* os_malloc (size_t bytes, bool& hugepages);
   size_t os_shrink (void* ptr, size_t bytesNew, size_t bytesOld, bool hugepages);
   void  os_free   (void* ptr, size_t bytes, bool hugepages);
   void  os_advise (void* ptr, size_t bytes);
+  size_t os_advised_bytes (void* ptr, size_t bytes);
 
   /*! allocator that performs OS allocations */
   template<typename T>
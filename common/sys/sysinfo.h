@@ -11,6 +11,7 @@
 
 #define PAGE_SIZE_2M (2*1024*1024)
 #define PAGE_SIZE_4K (4*1024)
+#define PAGE_SIZE_1G (1024*1024*1024)
 
 #include "platform.h"
 
@@ -127,6 +127,11 @@ namespace embree
     CloseHandle(HANDLE(tid));
   }
 
+  /*! releases the handle of a thread, the thread keeps running until it terminates */
+  void detachThread(thread_t tid) {
+    CloseHandle(HANDLE(tid));
+  }
+
   /*! destroy a hardware thread by its handle */
   void destroyThread(thread_t tid) {
     TerminateThread(HANDLE(tid),0);
@@ -434,6 +439,13 @@ namespace embree
     delete (pthread_t*)tid;
   }
 
+  /*! releases the handle of a thread, the thread keeps running until it terminates */
+  void detachThread(thread_t tid) {
+    if (pthread_detach(*(pthread_t*)tid) != 0)
+      FATAL("pthread_detach failed");
+    delete (pthread_t*)tid;
+  }
+
   /*! destroy a hardware thread by its handle */
   void destroyThread(thread_t tid) {
 #if defined(__ANDROID__)
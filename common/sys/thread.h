@@ -29,6 +29,9 @@ namespace embree
   /*! waits until the given thread has terminated */
   void join(thread_t tid);
 
+  /*! releases the handle of a thread, the thread keeps running until it terminates */
+  void detachThread(thread_t tid);
+
   /*! destroy handle of a thread */
   void destroyThread(thread_t tid);
 
@@ -100,6 +100,12 @@ enum RTCFormat
   RTC_FORMAT_LLONG3,
   RTC_FORMAT_LLONG4,
 
+  /* 16-bit float */
+  RTC_FORMAT_HALF = 0xB001,
+  RTC_FORMAT_HALF2,
+  RTC_FORMAT_HALF3,
+  RTC_FORMAT_HALF4,
+
   /* 32-bit float */
   RTC_FORMAT_FLOAT = 0x9001,
   RTC_FORMAT_FLOAT2,
@@ -172,7 +178,10 @@ enum RTCIntersectContextFlags
 {
   RTC_INTERSECT_CONTEXT_FLAG_NONE       = 0,
   RTC_INTERSECT_CONTEXT_FLAG_INCOHERENT = (0 << 0), // optimize for incoherent rays
-  RTC_INTERSECT_CONTEXT_FLAG_COHERENT   = (1 << 0)  // optimize for coherent rays
+  RTC_INTERSECT_CONTEXT_FLAG_COHERENT   = (1 << 0), // optimize for coherent rays
+  RTC_INTERSECT_CONTEXT_FLAG_NO_FILTER  = (1 << 1), // rays do not invoke filter functions
+  RTC_INTERSECT_CONTEXT_FLAG_DEFER_USER_GEOMETRY = (1 << 2), // ray streams invoke user geometry callbacks in batches after traversal
+  RTC_INTERSECT_CONTEXT_FLAG_ADAPTIVE_COHERENCE  = (1 << 3)  // ray streams measure their coherence and select the traversal mode themselves
 };
 
 /* Arguments for RTCFilterFunctionN */
@@ -48,7 +48,9 @@ enum RTCDeviceProperty
 
   RTC_DEVICE_PROPERTY_TASKING_SYSTEM        = 128,
   RTC_DEVICE_PROPERTY_JOIN_COMMIT_SUPPORTED = 129,
-  RTC_DEVICE_PROPERTY_PARALLEL_COMMIT_SUPPORTED = 130
+  RTC_DEVICE_PROPERTY_PARALLEL_COMMIT_SUPPORTED = 130,
+
+  RTC_DEVICE_PROPERTY_BUILD_PRIMREF_BYTES = 160
 };
 
 /* Gets a device property. */
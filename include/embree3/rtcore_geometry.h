@@ -80,6 +80,21 @@ struct RTCBoundsFunctionArguments
 /* Bounding callback function */
 typedef void (*RTCBoundsFunction)(const struct RTCBoundsFunctionArguments* args);
 
+/* Arguments for RTCSplitFunction */
+struct RTCSplitFunctionArguments
+{
+  void* geometryUserPtr;
+  unsigned int primID;
+  unsigned int dimension;
+  float position;
+  const struct RTCBounds* bounds;
+  struct RTCBounds* leftBounds_o;
+  struct RTCBounds* rightBounds_o;
+};
+
+/* Spatial split callback function */
+typedef void (*RTCSplitFunction)(const struct RTCSplitFunctionArguments* args);
+
 /* Arguments for RTCIntersectFunctionN */
 struct RTCIntersectFunctionNArguments
 {
@@ -169,6 +184,9 @@ RTC_API void rtcSetGeometryBuildQuality(RTCGeometry geometry, enum RTCBuildQuali
 /* Sets the maximal curve or point radius scale allowed by min-width feature. */
 RTC_API void rtcSetGeometryMaxRadiusScale(RTCGeometry geometry, float maxRadiusScale);
 
+/* Sets the transformation that dequantizes half and 16-bit normalized vertex positions. */
+RTC_API void rtcSetGeometryVertexDequantization(RTCGeometry geometry, const float* scale, const float* offset);
+
 
 /* Sets a geometry buffer. */
 RTC_API void rtcSetGeometryBuffer(RTCGeometry geometry, enum RTCBufferType type, unsigned int slot, enum RTCFormat format, RTCBuffer buffer, size_t byteOffset, size_t byteStride, size_t itemCount);
@@ -207,6 +225,9 @@ RTC_API void rtcSetGeometryUserPrimitiveCount(RTCGeometry geometry, unsigned int
 /* Sets the bounding callback function to calculate bounding boxes for user primitives. */
 RTC_API void rtcSetGeometryBoundsFunction(RTCGeometry geometry, RTCBoundsFunction bounds, void* userPtr);
 
+/* Sets the spatial split callback function to clip user primitives for high quality BVH builds. */
+RTC_API void rtcSetGeometrySplitFunction(RTCGeometry geometry, RTCSplitFunction split);
+
 /* Set the intersect callback function of a user geometry. */
 RTC_API void rtcSetGeometryIntersectFunction(RTCGeometry geometry, RTCIntersectFunctionN intersect);
 
@@ -223,6 +244,9 @@ RTC_API void rtcFilterOcclusion(const struct RTCOccludedFunctionNArguments* args
 /* Sets the instanced scene of an instance geometry. */
 RTC_API void rtcSetGeometryInstancedScene(RTCGeometry geometry, RTCScene scene);
 
+/* Sets the double precision origin of an instance geometry. */
+RTC_API void rtcSetGeometryInstanceOrigin(RTCGeometry geometry, const double* origin);
+
 /* Sets the transformation of an instance for the specified time step. */
 RTC_API void rtcSetGeometryTransform(RTCGeometry geometry, unsigned int timeStep, enum RTCFormat format, const void* xfm);
 
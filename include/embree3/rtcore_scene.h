@@ -21,7 +21,17 @@ enum RTCSceneFlags
   RTC_SCENE_FLAG_DYNAMIC                 = (1 << 0),
   RTC_SCENE_FLAG_COMPACT                 = (1 << 1),
   RTC_SCENE_FLAG_ROBUST                  = (1 << 2),
-  RTC_SCENE_FLAG_CONTEXT_FILTER_FUNCTION = (1 << 3)
+  RTC_SCENE_FLAG_CONTEXT_FILTER_FUNCTION = (1 << 3),
+  RTC_SCENE_FLAG_TREELET_LAYOUT          = (1 << 4)
+};
+
+/* Traversal modes selected by ray streams with adaptive coherence */
+struct RTCSceneTraversalStatistics
+{
+  float coherence;              // coherence of the last traced stream in [0,1]
+  size_t coherentStreamCount;   // number of streams traced with coherent stream traversal
+  size_t packetStreamCount;     // number of streams traced with packet traversal
+  size_t singleRayStreamCount;  // number of streams traced ray by ray
 };
 
 /* Creates a new scene. */
@@ -60,6 +70,15 @@ RTC_API void rtcCommitScene(RTCScene scene);
 /* Commits the scene from multiple threads. */
 RTC_API void rtcJoinCommitScene(RTCScene scene);
 
+/* Builds the geometries committed so far while the scene is still getting constructed. */
+RTC_API void rtcCommitSceneProgressive(RTCScene scene);
+
+/* Commit completed callback function */
+typedef void (*RTCCommitSceneCompletedFunction)(void* ptr, RTCScene scene, enum RTCError error);
+
+/* Commits the scene in the background while rays keep traversing the previously committed scene. */
+RTC_API void rtcCommitSceneAsync(RTCScene scene, RTCCommitSceneCompletedFunction completed, void* ptr);
+
 
 /* Progress monitor callback function */
 typedef bool (*RTCProgressMonitorFunction)(void* ptr, double n);
@@ -70,6 +89,9 @@ RTC_API void rtcSetSceneProgressMonitorFunction(RTCScene scene, RTCProgressMonit
 /* Sets the build quality of the scene. */
 RTC_API void rtcSetSceneBuildQuality(RTCScene scene, enum RTCBuildQuality quality);
 
+/* Sets the double precision origin of the local coordinate frame of the scene. */
+RTC_API void rtcSetSceneOrigin(RTCScene scene, const double* origin);
+
 /* Sets the scene flags. */
 RTC_API void rtcSetSceneFlags(RTCScene scene, enum RTCSceneFlags flags);
 
@@ -82,6 +104,9 @@ RTC_API void rtcGetSceneBounds(RTCScene scene, struct RTCBounds* bounds_o);
 /* Returns the linear axis-aligned bounds of the scene. */
 RTC_API void rtcGetSceneLinearBounds(RTCScene scene, struct RTCLinearBounds* bounds_o);
 
+/* Returns the traversal modes selected by ray streams with adaptive coherence. */
+RTC_API void rtcGetSceneTraversalStatistics(RTCScene scene, struct RTCSceneTraversalStatistics* statistics_o);
+
 
 /* Perform a closest point query of the scene. */
 RTC_API bool rtcPointQuery(RTCScene scene, struct RTCPointQuery* query, struct RTCPointQueryContext* context, RTCPointQueryFunction queryFunc, void* userPtr);
@@ -134,6 +159,9 @@ RTC_API void rtcOccluded16(const int* valid, RTCScene scene, struct RTCIntersect
 /* Tests a stream of M rays for occlusion with the scene. */
 RTC_API void rtcOccluded1M(RTCScene scene, struct RTCIntersectContext* context, struct RTCRay* ray, unsigned int M, size_t byteStride);
 
+/* Tests a stream of M shadow rays for occlusion with the scene, rays sharing their origin or end point get traced together. */
+RTC_API void rtcOccludedShadow1M(RTCScene scene, struct RTCIntersectContext* context, struct RTCRay* ray, unsigned int M, size_t byteStride);
+
 /* Tests a stream of pointers to M rays for occlusion with the scene. */
 RTC_API void rtcOccluded1Mp(RTCScene scene, struct RTCIntersectContext* context, struct RTCRay** ray, unsigned int M);
 
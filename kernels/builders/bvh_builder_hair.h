@@ -23,7 +23,7 @@ namespace embree
       {
         /*! default settings */
         Settings ()
-        : branchingFactor(2), maxDepth(32), logBlockSize(0), minLeafSize(1), maxLeafSize(7), finished_range_threshold(inf) {}
+        : branchingFactor(2), maxDepth(32), logBlockSize(0), minLeafSize(1), maxLeafSize(7), maxCompressedLeafSize(0), finished_range_threshold(inf) {}
 
       public:
         size_t branchingFactor;  //!< branching factor of BVH to build
@@ -31,6 +31,7 @@ namespace embree
         size_t logBlockSize;     //!< log2 of blocksize for SAH heuristic
         size_t minLeafSize;      //!< minimum size of a leaf
         size_t maxLeafSize;      //!< maximum size of a leaf
+        size_t maxCompressedLeafSize; //!< maximum size of a compressed leaf
         size_t finished_range_threshold;  //!< finished range threshold
       };
 
@@ -41,6 +42,9 @@ namespace embree
         typename CreateOBBNodeFunc,
         typename SetOBBNodeFunc,
         typename CreateLeafFunc,
+        typename CreateCompressedLeafFunc,
+        typename CreateLODFunc,
+        typename SetLODFunc,
         typename ProgressMonitor,
         typename ReportFinishedRangeFunc>
 
@@ -70,6 +74,9 @@ namespace embree
                     const CreateOBBNodeFunc& createOBBNode,
                     const SetOBBNodeFunc& setOBBNode,
                     const CreateLeafFunc& createLeaf,
+                    const CreateCompressedLeafFunc& createCompressedLeaf,
+                    const CreateLODFunc& createLOD,
+                    const SetLODFunc& setLOD,
                     const ProgressMonitor& progressMonitor,
                     const ReportFinishedRangeFunc& reportFinishedRange,
                     const Settings settings)
@@ -82,6 +89,9 @@ namespace embree
             createOBBNode(createOBBNode),
             setOBBNode(setOBBNode),
             createLeaf(createLeaf),
+            createCompressedLeaf(createCompressedLeaf),
+            createLOD(createLOD),
+            setLOD(setLOD),
             progressMonitor(progressMonitor),
             reportFinishedRange(reportFinishedRange),
             alignedHeuristic(prims), unalignedHeuristic(scene,prims), strandHeuristic(scene,prims) {}
@@ -241,12 +251,22 @@ namespace embree
 
             PrimInfoRange children[MAX_BRANCHING_FACTOR];
 
+            /* create compressed leaf if supported for all primitives of the range */
+            if (pinfo.size() <= cfg.maxCompressedLeafSize) {
+              const NodeRef leaf = createCompressedLeaf(prims,pinfo,alloc);
+              if (leaf != NodeRef::emptyNode) return leaf;
+            }
+
             /* create leaf node */
             if (depth+MIN_LARGE_LEAF_LEVELS >= cfg.maxDepth || pinfo.size() <= cfg.minLeafSize) {
               alignedHeuristic.deterministic_order(pinfo);
               return createLargeLeaf(depth,pinfo,alloc);
             }
 
+            /* create level of detail of this subtree, this has to happen before
+             * finished child ranges get reused for allocations */
+            const NodeRef lod = createLOD(prims,pinfo,depth,alloc);
+
             /* fill all children by always splitting the one with the largest surface area */
             size_t numChildren = 1;
             children[0] = pinfo;
@@ -342,6 +362,12 @@ namespace embree
               }
             }
 
+            /* level of detail continues with the full resolution subtree */
+            if (lod != NodeRef::emptyNode) {
+              setLOD(lod,node);
+              node = lod;
+            }
+
             /* reports a finished range of primrefs */
             if (unlikely(alloc_barrier))
               reportFinishedRange(pinfo);
@@ -358,6 +384,9 @@ namespace embree
           const CreateOBBNodeFunc& createOBBNode;
           const SetOBBNodeFunc& setOBBNode;
           const CreateLeafFunc& createLeaf;
+          const CreateCompressedLeafFunc& createCompressedLeaf;
+          const CreateLODFunc& createLOD;
+          const SetLODFunc& setLOD;
           const ProgressMonitor& progressMonitor;
           const ReportFinishedRangeFunc& reportFinishedRange;
 
@@ -374,6 +403,9 @@ namespace embree
         typename CreateOBBNodeFunc,
         typename SetOBBNodeFunc,
         typename CreateLeafFunc,
+        typename CreateCompressedLeafFunc,
+        typename CreateLODFunc,
+        typename SetLODFunc,
         typename ProgressMonitor,
         typename ReportFinishedRangeFunc>
 
@@ -383,6 +415,9 @@ namespace embree
                               const CreateOBBNodeFunc& createOBBNode,
                               const SetOBBNodeFunc& setOBBNode,
                               const CreateLeafFunc& createLeaf,
+                              const CreateCompressedLeafFunc& createCompressedLeaf,
+                              const CreateLODFunc& createLOD,
+                              const SetLODFunc& setLOD,
                               const ProgressMonitor& progressMonitor,
                               const ReportFinishedRangeFunc& reportFinishedRange,
                               Scene* scene,
@@ -394,13 +429,14 @@ namespace embree
             CreateAllocFunc,
             CreateAABBNodeFunc,SetAABBNodeFunc,
             CreateOBBNodeFunc,SetOBBNodeFunc,
-            CreateLeafFunc,ProgressMonitor,
-            ReportFinishedRangeFunc> Builder;
+            CreateLeafFunc,CreateCompressedLeafFunc,CreateLODFunc,SetLODFunc,
+            ProgressMonitor,ReportFinishedRangeFunc> Builder;
 
           Builder builder(scene,prims,createAlloc,
                           createAABBNode,setAABBNode,
                           createOBBNode,setOBBNode,
-                          createLeaf,progressMonitor,reportFinishedRange,settings);
+                          createLeaf,createCompressedLeaf,createLOD,setLOD,
+                          progressMonitor,reportFinishedRange,settings);
 
           NodeRef root = builder.recurse(1,pinfo,nullptr,true,false);
           _mm_mfence(); // to allow non-temporal stores during build
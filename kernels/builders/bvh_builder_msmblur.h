@@ -183,12 +183,12 @@ namespace embree
         Settings ()
         : branchingFactor(2), maxDepth(32), logBlockSize(0), minLeafSize(1), maxLeafSize(8),
           travCost(1.0f), intCost(1.0f), singleLeafTimeSegment(false),
-          singleThreadThreshold(1024) {}
+          singleThreadThreshold(1024), timeSplitThreshold(0.0f) {}
 
 
         Settings (size_t sahBlockSize, size_t minLeafSize, size_t maxLeafSize, float travCost, float intCost, size_t singleThreadThreshold)
         : branchingFactor(2), maxDepth(32), logBlockSize(bsr(sahBlockSize)), minLeafSize(minLeafSize), maxLeafSize(maxLeafSize),
-          travCost(travCost), intCost(intCost), singleThreadThreshold(singleThreadThreshold)
+          travCost(travCost), intCost(intCost), singleLeafTimeSegment(false), singleThreadThreshold(singleThreadThreshold), timeSplitThreshold(0.0f)
         {
           minLeafSize = min(minLeafSize,maxLeafSize);
         }
@@ -203,6 +203,7 @@ namespace embree
         float intCost;           //!< estimated cost of one primitive intersection
         bool singleLeafTimeSegment; //!< split time to single time range
         size_t singleThreadThreshold; //!< threshold when we switch to single threaded build
+        float timeSplitThreshold; //!< minimal reduction of swept bounds to perform a time split (0 = fixed heuristic)
       };
 
       struct BuildRecord
@@ -291,9 +292,13 @@ namespace embree
             /* first try standard object split */
             const Split object_split = heuristicObjectSplit.find(set,cfg.logBlockSize);
             const float object_split_sah = object_split.splitSAH();
+            const float leaf_sah = set.leafSAH(cfg.logBlockSize);
+
+            /* adaptive mode decides on temporal splits by the motion of this subtree */
+            if (cfg.timeSplitThreshold > 0.0f)
+              return findAdaptive(set,object_split);
 
             /* test temporal splits only when object split was bad */
-            const float leaf_sah = set.leafSAH(cfg.logBlockSize);
             if (object_split_sah < 0.50f*leaf_sah)
               return object_split;
 
@@ -311,6 +316,72 @@ namespace embree
             return object_split;
           }
 
+          /*! finds the best split, performing temporal splits only where the swept bounds grow too much */
+          const Split findAdaptive(const SetMB& set, const Split& object_split)
+          {
+            if (set.time_range.size() <= 1.01f/float(set.max_num_time_segments))
+              return object_split;
+
+            const Split temporal_split = heuristicTemporalSplit.find(set,cfg.logBlockSize);
+            if (!(temporal_split.sah < float(inf)))
+              return object_split;
+
+            /* the swept bounds grow by the ratio of the area of the union
+             * of the bounds over the entire time range to the time weighted
+             * area of the union of the bounds of both time halves, which is
+             * 1 for static geometry independent of its number of time
+             * segments */
+            const BBox1f dt0(set.time_range.lower,temporal_split.fpos);
+            const BBox1f dt1(temporal_split.fpos,set.time_range.upper);
+            const SweptBounds bounds = sweptBounds(set,dt0,dt1);
+            const float area = halfArea(bounds.bounds.bounds());
+            const float area_halves = (halfArea(bounds.bounds0.bounds())*dt0.size() + halfArea(bounds.bounds1.bounds())*dt1.size())/set.time_range.size();
+            const float swept_growth = area/area_halves;
+
+            /* small tolerance as bounds of static geometry are not exactly equal due to rounding */
+            if (swept_growth > 1.0001f*cfg.timeSplitThreshold && temporal_split.splitSAH()/MBLUR_TIME_SPLIT_THRESHOLD < object_split.splitSAH())
+              return temporal_split;
+
+            return object_split;
+          }
+
+          /*! bounds of a set over its time range and over both halves of a temporal split */
+          struct SweptBounds
+          {
+            __forceinline SweptBounds (EmptyTy)
+              : bounds(empty), bounds0(empty), bounds1(empty) {}
+
+            static __forceinline const SweptBounds merge (const SweptBounds& a, const SweptBounds& b)
+            {
+              SweptBounds r = a;
+              r.bounds.extend(b.bounds);
+              r.bounds0.extend(b.bounds0);
+              r.bounds1.extend(b.bounds1);
+              return r;
+            }
+
+            LBBox3fa bounds, bounds0, bounds1;
+          };
+
+          /*! calculates the swept bounds of a set over its time range and the time ranges dt0 and dt1 */
+          const SweptBounds sweptBounds(const SetMB& set, const BBox1f& dt0, const BBox1f& dt1)
+          {
+            auto reduce = [&] (const range<size_t>& r) -> SweptBounds
+            {
+              SweptBounds b(empty);
+              for (size_t i=r.begin(); i<r.end(); i++)
+              {
+                const PrimRefMB& prim = (*set.prims)[i];
+                b.bounds.extend(recalculatePrimRef.linearBounds(prim,set.time_range));
+                if (prim.time_range_overlap(dt0)) b.bounds0.extend(recalculatePrimRef.linearBounds(prim,dt0));
+                if (prim.time_range_overlap(dt1)) b.bounds1.extend(recalculatePrimRef.linearBounds(prim,dt1));
+              }
+              return b;
+            };
+            return parallel_reduce(set.object_range.begin(), set.object_range.end(), SetMB::PARALLEL_FIND_BLOCK_SIZE, SetMB::PARALLEL_THRESHOLD, SweptBounds(empty),
+                                   reduce, SweptBounds::merge);
+          }
+
           /*! array partitioning */
           __forceinline std::unique_ptr<mvector<PrimRefMB>> split(const Split& split, const SetMB& set, SetMB& lset, SetMB& rset)
           {
@@ -44,6 +44,27 @@ namespace embree
         static const size_t PARALLEL_FIND_BLOCK_SIZE = 1024;
         static const size_t PARALLEL_PARTITION_BLOCK_SIZE = 128;
 
+        /* ranges below this size are cache resident and get binned
+         * and partitioned in two passes, larger ranges bin the child
+         * ranges while partitioning */
+        static const size_t FUSED_BINNING_THRESHOLD = 64 * 1024;
+
+        /*! binning of the primitives of some range, gathered during partitioning of its parent */
+        struct __aligned(64) FusedBinning
+        {
+          ALIGNED_STRUCT_(64);
+
+          __forceinline FusedBinning () {}
+
+          __forceinline FusedBinning (EmptyTy)
+            : binner(empty), info(empty) {}
+
+          Binner binner;
+          CentGeomBBox3fa info;
+          BinMapping<BINS> mapping;
+          range<size_t> set;
+        };
+
         __forceinline HeuristicArrayBinningSAH ()
           : prims(nullptr) {}
 
@@ -51,6 +72,12 @@ namespace embree
         __forceinline HeuristicArrayBinningSAH (PrimRef* prims)
           : prims(prims) {}
 
+        ~HeuristicArrayBinningSAH ()
+        {
+          for (auto f : fused)
+            delete f;
+        }
+
         /*! finds the best split */
         __noinline const Split find(const PrimInfoRange& pinfo, const size_t logBlockSize)
         {
@@ -63,6 +90,18 @@ namespace embree
         template<bool parallel>
         __forceinline const Split find_template(const PrimInfoRange& pinfo, const size_t logBlockSize)
         {
+          /* reuse binning gathered while partitioning the parent range */
+          if (parallel)
+          {
+            if (FusedBinning* f = takeFusedBinning(pinfo))
+            {
+              const Split split = f->binner.best(f->mapping,logBlockSize);
+              delete f;
+              return split;
+            }
+            g_build_primref_bytes += pinfo.size()*sizeof(PrimRef);
+          }
+
           Binner binner(empty);
           const BinMapping<BINS> mapping(pinfo);
           bin_serial_or_parallel<parallel>(binner,prims,pinfo.begin(),pinfo.end(),PARALLEL_FIND_BLOCK_SIZE,mapping);
@@ -98,16 +137,22 @@ namespace embree
           const typename Binner::vbool vSplitMask(splitDimMask);
           auto isLeft = [&] (const PrimRef &ref) { return split.mapping.bin_unsafe(ref,vSplitPos,vSplitMask); };
 
+          if (parallel && set.size() >= FUSED_BINNING_THRESHOLD)
+            return split_fused(split,set,lset,rset);
+
           size_t center = 0;
           if (!parallel)
             center = serial_partitioning(prims,begin,end,local_left,local_right,isLeft,
                                          [] (CentGeomBBox3fa& pinfo,const PrimRef& ref) { pinfo.extend_center2(ref); });
           else
+          {
             center = parallel_partitioning(
               prims,begin,end,EmptyTy(),local_left,local_right,isLeft,
               [] (CentGeomBBox3fa& pinfo,const PrimRef& ref) { pinfo.extend_center2(ref); },
               [] (CentGeomBBox3fa& pinfo0,const CentGeomBBox3fa& pinfo1) { pinfo0.merge(pinfo1); },
               PARALLEL_PARTITION_BLOCK_SIZE);
+            g_build_primref_bytes += 2*set.size()*sizeof(PrimRef);
+          }
           
           new (&lset) PrimInfoRange(begin,center,local_left);
           new (&rset) PrimInfoRange(center,end,local_right);
@@ -115,6 +160,80 @@ namespace embree
           assert(area(rset.geomBounds) >= 0.0f);
         }
 
+        /*! partitions the range and bins both child ranges in the same pass */
+        __noinline void split_fused(const Split& split, const PrimInfoRange& set, PrimInfoRange& lset, PrimInfoRange& rset)
+        {
+          const size_t begin = set.begin();
+          const size_t end   = set.end();
+          const unsigned int splitPos = split.pos;
+          const unsigned int splitDim = split.dim;
+          const unsigned int splitDimMask = (unsigned int)1 << splitDim;
+
+          /* conservative child centroid bounds, the split plane is
+           * moved by a fraction of a bin to account for rounding */
+          const float splitCoord = split.mapping.pos(splitPos,splitDim);
+          const float splitEps = 0.01f / split.mapping.scale[splitDim];
+          BBox3fa lcent = set.centBounds; lcent.upper[splitDim] = min(lcent.upper[splitDim],splitCoord+splitEps);
+          BBox3fa rcent = set.centBounds; rcent.lower[splitDim] = max(rcent.lower[splitDim],splitCoord-splitEps);
+          const BinMapping<BINS> lmapping(lcent);
+          const BinMapping<BINS> rmapping(rcent);
+
+          const typename Binner::vint vSplitPos(splitPos);
+          const typename Binner::vbool vSplitMask(splitDimMask);
+          auto isLeft = [&] (const PrimRef &ref) { return split.mapping.bin_unsafe(ref,vSplitPos,vSplitMask); };
+
+          FusedBinning* left  = new FusedBinning(empty);
+          FusedBinning* right = new FusedBinning(empty);
+          const size_t center = parallel_partitioning(
+            prims,begin,end,EmptyTy(),*left,*right,isLeft,
+            [&] (FusedBinning& fb, const PrimRef& ref) {
+              fb.info.extend_center2(ref);
+              fb.binner.bin(&ref,1,isLeft(ref) ? lmapping : rmapping);
+            },
+            [] (FusedBinning& fb0, const FusedBinning& fb1) {
+              fb0.info.merge(fb1.info);
+              fb0.binner.merge(fb1.binner,BINS);
+            },
+            PARALLEL_PARTITION_BLOCK_SIZE);
+          g_build_primref_bytes += 2*set.size()*sizeof(PrimRef);
+
+          new (&lset) PrimInfoRange(begin,center,left->info);
+          new (&rset) PrimInfoRange(center,end,right->info);
+          assert(area(lset.geomBounds) >= 0.0f);
+          assert(area(rset.geomBounds) >= 0.0f);
+
+          left ->mapping = lmapping; left ->set = lset;
+          right->mapping = rmapping; right->set = rset;
+          storeFusedBinning(left);
+          storeFusedBinning(right);
+        }
+
+        /*! remembers fused binning for a child range that will get binned in parallel */
+        void storeFusedBinning(FusedBinning* f)
+        {
+          if (f->set.size() < PARALLEL_THRESHOLD) {
+            delete f;
+            return;
+          }
+          Lock<SpinLock> lock(fusedMutex);
+          fused.push_back(f);
+        }
+
+        /*! returns and removes fused binning of the specified range */
+        FusedBinning* takeFusedBinning(const range<size_t>& set)
+        {
+          Lock<SpinLock> lock(fusedMutex);
+          for (size_t i=0; i<fused.size(); i++)
+          {
+            FusedBinning* f = fused[i];
+            if (f->set.begin() != set.begin() || f->set.end() != set.end()) continue;
+            fused[i] = fused.back();
+            fused.pop_back();
+            return f;
+          }
+          return nullptr;
+        }
+
         void deterministic_order(const PrimInfoRange& pinfo)
         {
           /* required as parallel partition destroys original primitive order */
@@ -154,6 +273,8 @@ namespace embree
 
       private:
         PrimRef* const prims;
+        SpinLock fusedMutex;
+        std::vector<FusedBinning*> fused; //!< fused binning of child ranges not yet processed
       };
 
     /*! Performs standard object binning */
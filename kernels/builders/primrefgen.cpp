@@ -11,14 +11,36 @@ namespace embree
 {
   namespace isa
   {
-    PrimInfo createPrimRefArray(Geometry* geometry, unsigned int geomID, const size_t numPrimRefs, mvector<PrimRef>& prims, BuildProgressMonitor& progressMonitor)
+    /* instances get placed relative to the origin of the scene they are built into */
+    static __forceinline PrimInfo createPrimRefs(Geometry* geometry, const Vec3d& sceneOrigin, mvector<PrimRef>& prims, const range<size_t>& r, size_t k, unsigned int geomID)
+    {
+      if (geometry->getTypeMask() & Geometry::MTY_INSTANCE)
+        return ((InstanceISA*)geometry)->createPrimRefArray(prims,r,k,geomID,sceneOrigin);
+      return geometry->createPrimRefArray(prims,r,k,geomID);
+    }
+
+    static __forceinline PrimInfo createPrimRefsMB(Geometry* geometry, const Vec3d& sceneOrigin, mvector<PrimRef>& prims, size_t itime, const range<size_t>& r, size_t k, unsigned int geomID)
+    {
+      if (geometry->getTypeMask() & Geometry::MTY_INSTANCE)
+        return ((InstanceISA*)geometry)->createPrimRefArrayMB(prims,itime,r,k,geomID,sceneOrigin);
+      return geometry->createPrimRefArrayMB(prims,itime,r,k,geomID);
+    }
+
+    static __forceinline PrimInfoMB createPrimRefsMSMB(Geometry* geometry, const Vec3d& sceneOrigin, mvector<PrimRefMB>& prims, const BBox1f& t0t1, const range<size_t>& r, size_t k, unsigned int geomID)
+    {
+      if (geometry->getTypeMask() & Geometry::MTY_INSTANCE)
+        return ((InstanceISA*)geometry)->createPrimRefMBArray(prims,t0t1,r,k,geomID,sceneOrigin);
+      return geometry->createPrimRefMBArray(prims,t0t1,r,k,geomID);
+    }
+
+    PrimInfo createPrimRefArray(Geometry* geometry, unsigned int geomID, const size_t numPrimRefs, mvector<PrimRef>& prims, BuildProgressMonitor& progressMonitor, const Vec3d& sceneOrigin)
     {
       ParallelPrefixSumState<PrimInfo> pstate;
       
       /* first try */
       progressMonitor(0);
       PrimInfo pinfo = parallel_prefix_sum( pstate, size_t(0), geometry->size(), size_t(1024), PrimInfo(empty), [&](const range<size_t>& r, const PrimInfo& base) -> PrimInfo {
-          return geometry->createPrimRefArray(prims,r,r.begin(),geomID);
+          return createPrimRefs(geometry,sceneOrigin,prims,r,r.begin(),geomID);
         }, [](const PrimInfo& a, const PrimInfo& b) -> PrimInfo { return PrimInfo::merge(a,b); });
 
       /* if we need to filter out geometry, run again */
@@ -26,7 +48,7 @@ namespace embree
       {
         progressMonitor(0);
         pinfo = parallel_prefix_sum( pstate, size_t(0), geometry->size(), size_t(1024), PrimInfo(empty), [&](const range<size_t>& r, const PrimInfo& base) -> PrimInfo {
-          return geometry->createPrimRefArray(prims,r,base.size(),geomID);
+          return createPrimRefs(geometry,sceneOrigin,prims,r,base.size(),geomID);
         }, [](const PrimInfo& a, const PrimInfo& b) -> PrimInfo { return PrimInfo::merge(a,b); });
       }
       return pinfo;
@@ -41,7 +63,7 @@ namespace embree
       progressMonitor(0);
       pstate.init(iter,size_t(1024));
       PrimInfo pinfo = parallel_for_for_prefix_sum0( pstate, iter, PrimInfo(empty), [&](Geometry* mesh, const range<size_t>& r, size_t k, size_t geomID) -> PrimInfo {
-          return mesh->createPrimRefArray(prims,r,k,(unsigned)geomID);
+          return createPrimRefs(mesh,scene->origin,prims,r,k,(unsigned)geomID);
         }, [](const PrimInfo& a, const PrimInfo& b) -> PrimInfo { return PrimInfo::merge(a,b); });
       
       /* if we need to filter out geometry, run again */
@@ -49,7 +71,7 @@ namespace embree
       {
         progressMonitor(0);
         pinfo = parallel_for_for_prefix_sum1( pstate, iter, PrimInfo(empty), [&](Geometry* mesh, const range<size_t>& r, size_t k, size_t geomID, const PrimInfo& base) -> PrimInfo {
-            return mesh->createPrimRefArray(prims,r,base.size(),(unsigned)geomID);
+            return createPrimRefs(mesh,scene->origin,prims,r,base.size(),(unsigned)geomID);
           }, [](const PrimInfo& a, const PrimInfo& b) -> PrimInfo { return PrimInfo::merge(a,b); });
       }
       return pinfo;
@@ -64,7 +86,7 @@ namespace embree
       progressMonitor(0);
       pstate.init(iter,size_t(1024));
       PrimInfo pinfo = parallel_for_for_prefix_sum0( pstate, iter, PrimInfo(empty), [&](Geometry* mesh, const range<size_t>& r, size_t k, size_t geomID) -> PrimInfo {
-          return mesh->createPrimRefArrayMB(prims,itime,r,k,(unsigned)geomID);
+          return createPrimRefsMB(mesh,scene->origin,prims,itime,r,k,(unsigned)geomID);
         }, [](const PrimInfo& a, const PrimInfo& b) -> PrimInfo { return PrimInfo::merge(a,b); });
       
       /* if we need to filter out geometry, run again */
@@ -72,7 +94,7 @@ namespace embree
       {
         progressMonitor(0);
         pinfo = parallel_for_for_prefix_sum1( pstate, iter, PrimInfo(empty), [&](Geometry* mesh, const range<size_t>& r, size_t k, size_t geomID, const PrimInfo& base) -> PrimInfo {
-            return mesh->createPrimRefArrayMB(prims,itime,r,base.size(),(unsigned)geomID);
+            return createPrimRefsMB(mesh,scene->origin,prims,itime,r,base.size(),(unsigned)geomID);
           }, [](const PrimInfo& a, const PrimInfo& b) -> PrimInfo { return PrimInfo::merge(a,b); });
       }
       return pinfo;
@@ -87,7 +109,7 @@ namespace embree
       progressMonitor(0);
       pstate.init(iter,size_t(1024));
       PrimInfoMB pinfo = parallel_for_for_prefix_sum0( pstate, iter, PrimInfoMB(empty), [&](Geometry* mesh, const range<size_t>& r, size_t k, size_t geomID) -> PrimInfoMB {
-          return mesh->createPrimRefMBArray(prims,t0t1,r,k,(unsigned)geomID);
+          return createPrimRefsMSMB(mesh,scene->origin,prims,t0t1,r,k,(unsigned)geomID);
       }, [](const PrimInfoMB& a, const PrimInfoMB& b) -> PrimInfoMB { return PrimInfoMB::merge2(a,b); });
       
       /* if we need to filter out geometry, run again */
@@ -95,7 +117,7 @@ namespace embree
       {
         progressMonitor(0);
         pinfo = parallel_for_for_prefix_sum1( pstate, iter, PrimInfoMB(empty), [&](Geometry* mesh, const range<size_t>& r, size_t k, size_t geomID, const PrimInfoMB& base) -> PrimInfoMB {
-            return mesh->createPrimRefMBArray(prims,t0t1,r,base.size(),(unsigned)geomID);
+            return createPrimRefsMSMB(mesh,scene->origin,prims,t0t1,r,base.size(),(unsigned)geomID);
         }, [](const PrimInfoMB& a, const PrimInfoMB& b) -> PrimInfoMB { return PrimInfoMB::merge2(a,b); });
       }
 
@@ -229,7 +251,7 @@ namespace embree
               for (unsigned int x=0; x<g.resX-1u; x+=2)
               {
                 BBox3fa bounds = empty;
-                if (!mesh->buildBounds(g,x,y,bounds)) continue; // get bounds of subgrid
+                if (!mesh->buildBounds(j,x,y,bounds)) continue; // get bounds of subgrid
                 const PrimRef prim(bounds,(unsigned)geomID,(unsigned)p_index);
                 pinfo.add_center2(prim);
                 sgrids[p_index] = SubGridBuildData(x | g.get3x3FlagsX(x), y | g.get3x3FlagsY(y), unsigned(j));
@@ -282,7 +304,7 @@ namespace embree
                                          for (unsigned int x=0; x<g.resX-1u; x+=2)
                                          {
                                            BBox3fa bounds = empty;
-                                           if (!mesh->buildBounds(g,x,y,bounds)) continue; // get bounds of subgrid
+                                           if (!mesh->buildBounds(j,x,y,bounds)) continue; // get bounds of subgrid
                                            const PrimRef prim(bounds,geomID_,unsigned(p_index));
                                            pinfo.add_center2(prim);
                                            sgrids[p_index] = SubGridBuildData(x | g.get3x3FlagsX(x), y | g.get3x3FlagsY(y), unsigned(j));
@@ -166,6 +166,194 @@ namespace embree
     };
 
 
+    struct GridSplitter
+    {
+      __forceinline GridSplitter(const Scene* scene, const SubGridBuildData* sgrids, const PrimRef& prim)
+      {
+        const unsigned int mask = 0xFFFFFFFF >> RESERVED_NUM_SPATIAL_SPLITS_GEOMID_BITS;
+        const GridMesh* mesh = (const GridMesh*) scene->get(prim.geomID() & mask );
+        const SubGridBuildData& sgrid_bd = sgrids[prim.primID()];
+        const GridMesh::Grid& g = mesh->grid(sgrid_bd.primID);
+        const size_t sx = sgrid_bd.x();
+        const size_t sy = sgrid_bd.y();
+
+        /* clip every quad of the up to 3x3 vertex subgrid individually */
+        numQuads = 0;
+        for (size_t y=sy; y<min(sy+2,(size_t)g.resY-1); y++)
+        {
+          for (size_t x=sx; x<min(sx+2,(size_t)g.resX-1); x++)
+          {
+            Vec3fa (&q)[5] = v[numQuads];
+            q[0] = mesh->grid_vertex(g,x+0,y+0);
+            q[1] = mesh->grid_vertex(g,x+1,y+0);
+            q[2] = mesh->grid_vertex(g,x+1,y+1);
+            q[3] = mesh->grid_vertex(g,x+0,y+1);
+            q[4] = q[0];
+            for (size_t i=0; i<4; i++)
+              inv_length[numQuads][i] = Vec3fa(1.0f) / (q[i+1]-q[i]);
+            numQuads++;
+          }
+        }
+      }
+
+      __forceinline void operator() (const PrimRef& prim, const size_t dim, const float pos, PrimRef& left_o, PrimRef& right_o) const
+      {
+        BBox3fa left, right;
+        (*this)(prim.bounds(),dim,pos,left,right);
+        new (&left_o ) PrimRef(left ,prim.geomID(), prim.primID());
+        new (&right_o) PrimRef(right,prim.geomID(), prim.primID());
+      }
+
+      __forceinline void operator() (const BBox3fa& prim, const size_t dim, const float pos, BBox3fa& left_o, BBox3fa& right_o) const
+      {
+        left_o = empty; right_o = empty;
+        for (size_t i=0; i<numQuads; i++)
+        {
+          BBox3fa left, right;
+          splitPolygon<4>(prim,dim,pos,v[i],inv_length[i],left,right);
+          left_o.extend(left);
+          right_o.extend(right);
+        }
+      }
+
+    private:
+      Vec3fa v[4][5];
+      Vec3fa inv_length[4][4];
+      size_t numQuads;
+    };
+
+    struct GridSplitterFactory
+    {
+      __forceinline GridSplitterFactory(const Scene* scene, const SubGridBuildData* sgrids)
+        : scene(scene), sgrids(sgrids) {}
+
+      __forceinline GridSplitter operator() (const PrimRef& prim) const {
+        return GridSplitter(scene,sgrids,prim);
+      }
+
+    private:
+      const Scene* scene;
+      const SubGridBuildData* sgrids;
+    };
+
+    struct InstanceSplitter
+    {
+      __forceinline InstanceSplitter(const Scene* scene, const PrimRef& prim)
+      {
+        const unsigned int mask = 0xFFFFFFFF >> RESERVED_NUM_SPATIAL_SPLITS_GEOMID_BITS;
+        const Instance* instance = (const Instance*) scene->get(prim.geomID() & mask );
+        const AffineSpace3fa local2world = instance->getLocal2World();
+        const Vec3fa offset = instance->getOriginOffset(scene->origin);
+        const BBox3fa b = instance->getObjectBounds(0);
+
+        /* corners of the transformed bounding box of the instanced scene */
+        for (size_t i=0; i<8; i++) {
+          const Vec3fa p((i&1) ? b.upper.x : b.lower.x, (i&2) ? b.upper.y : b.lower.y, (i&4) ? b.upper.z : b.lower.z);
+          v[i] = xfmPoint(local2world,p)+offset;
+        }
+      }
+
+      __forceinline void operator() (const PrimRef& prim, const size_t dim, const float pos, PrimRef& left_o, PrimRef& right_o) const
+      {
+        BBox3fa left, right;
+        (*this)(prim.bounds(),dim,pos,left,right);
+        new (&left_o ) PrimRef(left ,prim.geomID(), prim.primID());
+        new (&right_o) PrimRef(right,prim.geomID(), prim.primID());
+      }
+
+      /* clips the transformed box (a parallelepiped) at the split plane by processing all 12 edges */
+      __forceinline void operator() (const BBox3fa& prim, const size_t dim, const float pos, BBox3fa& left_o, BBox3fa& right_o) const
+      {
+        BBox3fa left = empty, right = empty;
+        for (size_t i=0; i<8; i++)
+        {
+          const Vec3fa& v0 = v[i];
+          const float v0d = v0[dim];
+          if (v0d <= pos) left. extend(v0);
+          if (v0d >= pos) right.extend(v0);
+
+          for (size_t k=1; k<8; k<<=1)
+          {
+            if (i & k) continue;
+            const Vec3fa& v1 = v[i|k];
+            const float v1d = v1[dim];
+            if ((v0d < pos && pos < v1d) || (v1d < pos && pos < v0d))
+            {
+              const Vec3fa c = madd(Vec3fa((pos-v0d)/(v1d-v0d)),v1-v0,v0);
+              left.extend(c);
+              right.extend(c);
+            }
+          }
+        }
+        left_o  = intersect(left,prim);
+        right_o = intersect(right,prim);
+      }
+
+    private:
+      Vec3fa v[8];
+    };
+
+    struct InstanceSplitterFactory
+    {
+      __forceinline InstanceSplitterFactory(const Scene* scene)
+        : scene(scene) {}
+
+      __forceinline InstanceSplitter operator() (const PrimRef& prim) const {
+        return InstanceSplitter(scene,prim);
+      }
+
+    private:
+      const Scene* scene;
+    };
+
+    struct UserGeometrySplitter
+    {
+      __forceinline UserGeometrySplitter(const Scene* scene, const PrimRef& prim)
+      {
+        const unsigned int mask = 0xFFFFFFFF >> RESERVED_NUM_SPATIAL_SPLITS_GEOMID_BITS;
+        geometry = (const UserGeometry*) scene->get(prim.geomID() & mask );
+        primID = prim.primID();
+      }
+
+      __forceinline void operator() (const PrimRef& prim, const size_t dim, const float pos, PrimRef& left_o, PrimRef& right_o) const
+      {
+        BBox3fa left, right;
+        (*this)(prim.bounds(),dim,pos,left,right);
+        new (&left_o ) PrimRef(left ,prim.geomID(), prim.primID());
+        new (&right_o) PrimRef(right,prim.geomID(), prim.primID());
+      }
+
+      /* uses the split function of the geometry if set, otherwise clips the bounding box */
+      __forceinline void operator() (const BBox3fa& prim, const size_t dim, const float pos, BBox3fa& left_o, BBox3fa& right_o) const
+      {
+        BBox3fa left = prim, right = prim;
+        if (!geometry->split(primID,prim,dim,pos,left,right)) {
+          left.upper[dim] = pos;
+          right.lower[dim] = pos;
+        }
+        left_o  = intersect(left,prim);
+        right_o = intersect(right,prim);
+      }
+
+    private:
+      const UserGeometry* geometry;
+      unsigned int primID;
+    };
+
+    struct UserGeometrySplitterFactory
+    {
+      __forceinline UserGeometrySplitterFactory(const Scene* scene)
+        : scene(scene) {}
+
+      __forceinline UserGeometrySplitter operator() (const PrimRef& prim) const {
+        return UserGeometrySplitter(scene,prim);
+      }
+
+    private:
+      const Scene* scene;
+    };
+
+
     struct DummySplitter
     {
       __forceinline DummySplitter(const Scene* scene, const PrimRef& prim)
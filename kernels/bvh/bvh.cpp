@@ -3,6 +3,7 @@
 
 #include "bvh.h"
 #include "bvh_statistics.h"
+#include "../../common/algorithms/parallel_sort.h"
 
 namespace embree
 {
@@ -28,6 +29,24 @@ namespace embree
     alloc.clear();
   }
 
+  template<int N>
+  double BVHN<N>::sah()
+  {
+    if (root == BVHN::emptyNode || numPrimitives == 0 || !(getLinearBounds().expectedHalfArea() > 0.0f))
+      return 0.0;
+    return BVHNStatistics<N>(this).sah();
+  }
+
+  template<int N>
+  void BVHN<N>::addMemoryStatistics(MemoryStatistics& stat)
+  {
+    stat.bytesAllocated += alloc.getStatistics(FastAllocator::ANY_TYPE).bytesAllocatedTotal();
+    stat.bytesHugePages += alloc.getStatistics(FastAllocator::EMBREE_OS_MALLOC,true).bytesAllocatedTotal();
+    stat.bytesAdvised   += alloc.getAdvisedBytes();
+    for (size_t i=0; i<objects.size(); i++)
+      if (objects[i]) objects[i]->addMemoryStatistics(stat);
+  }
+
   template<int N>
   void BVHN<N>::set (NodeRef root, const LBBox3fa& bounds, size_t numPrimitives)
   {
@@ -109,6 +128,160 @@ namespace embree
     else return node;
   }
 
+  template<int N>
+  void BVHN<N>::layoutTreelets()
+  {
+    /* number of nodes that fit into a 4KB page */
+    const size_t treeletSize = max(size_t(1),size_t(4096)/sizeof(AABBNode));
+
+    /* node in layout order, together with the index of its parent and the child slot referencing it */
+    struct LayoutNode
+    {
+      __forceinline LayoutNode() {}
+
+      __forceinline LayoutNode(NodeRef ref, size_t parent, size_t slot)
+        : ref(ref), parent(parent), slot(slot) {}
+
+      NodeRef ref;
+      size_t parent;
+      size_t slot;
+    };
+
+    struct NodeArea
+    {
+      __forceinline NodeArea() {}
+
+      __forceinline NodeArea(const LayoutNode& node, float A)
+        : node(node), A(A) {}
+
+      __forceinline bool operator< (const NodeArea& other) const {
+        return this->A < other.A;
+      }
+
+      LayoutNode node;
+      float A;
+    };
+
+    auto isNode = [] (NodeRef ref) -> bool {
+      return ref.isAABBNode() || ref.isAABBNodeMB() || ref.isAABBNodeMB4D();
+    };
+
+    auto childArea = [] (NodeRef ref, size_t c) -> float {
+      if (ref.isAABBNode()) return area(ref.getAABBNode()->bounds(c));
+      else                  return area(ref.getAABBNodeMB()->bounds(c));
+    };
+
+    /* grows a treelet by always adding the node with largest surface area, as it is most likely traversed, returns the nodes that start new treelets */
+    auto growTreelet = [&] (const LayoutNode& root, size_t offset, std::vector<LayoutNode>& order, std::vector<NodeArea>& lst)
+    {
+      lst.clear();
+      lst.push_back(NodeArea(root,inf));
+      for (size_t i=0; i<treeletSize && !lst.empty(); i++)
+      {
+        std::pop_heap(lst.begin(), lst.end());
+        LayoutNode n = lst.back().node; lst.pop_back();
+        const size_t index = offset+order.size();
+        order.push_back(n);
+
+        BaseNode* node = n.ref.baseNode();
+        for (size_t c=0; c<N; c++) {
+          if (!isNode(node->child(c))) continue;
+          lst.push_back(NodeArea(LayoutNode(node->child(c),index,c),childArea(n.ref,c)));
+          std::push_heap(lst.begin(), lst.end());
+        }
+      }
+      std::sort(lst.begin(), lst.end());
+    };
+
+    /* lays out all treelets of a subtree, the remaining nodes of a treelet start new treelets, the largest ones get laid out next to it */
+    auto layoutSubtree = [&] (const LayoutNode& root, size_t offset, std::vector<LayoutNode>& order)
+    {
+      std::vector<NodeArea> roots, lst;
+      roots.push_back(NodeArea(root,inf));
+      while (!roots.empty())
+      {
+        const LayoutNode r = roots.back().node; roots.pop_back();
+        growTreelet(r,offset,order,lst);
+        roots.insert(roots.end(), lst.begin(), lst.end());
+      }
+    };
+
+    if (!isNode(root)) return;
+
+    /* the subtrees below the top treelet get laid out in parallel, parent indices are relative to the first node of the subtree */
+    std::vector<LayoutNode> top;
+    std::vector<NodeArea> frontier;
+    growTreelet(LayoutNode(root,0,0),0,top,frontier);
+
+    const size_t numSubtrees = frontier.size();
+    std::vector<std::vector<LayoutNode>> subtrees(numSubtrees);
+    parallel_for(numSubtrees, [&] (const size_t i) {
+        layoutSubtree(frontier[numSubtrees-1-i].node,0,subtrees[i]);
+      });
+
+    std::vector<size_t> offsets(numSubtrees+1);
+    offsets[0] = top.size();
+    for (size_t i=0; i<numSubtrees; i++)
+      offsets[i+1] = offsets[i]+subtrees[i].size();
+
+    const size_t numNodes = offsets[numSubtrees];
+    std::vector<LayoutNode> order(numNodes);
+    std::copy(top.begin(), top.end(), order.begin());
+    parallel_for(numSubtrees, [&] (const size_t i) {
+        for (size_t j=0; j<subtrees[i].size(); j++) {
+          order[offsets[i]+j] = subtrees[i][j];
+          if (j > 0) order[offsets[i]+j].parent += offsets[i];
+        }
+      });
+
+    /* the nodes get permuted among the memory locations of all nodes of
+     * the same type, in the order of their addresses, thus the layout
+     * does not allocate additional memory in the BVH */
+    auto nodeBytes = [] (NodeRef ref) -> size_t {
+      if (ref.isAABBNode())   return sizeof(AABBNode);
+      if (ref.isAABBNodeMB()) return sizeof(AABBNodeMB);
+      return sizeof(AABBNodeMB4D);
+    };
+
+    std::vector<uint64_t> addresses(numNodes);
+    std::vector<size_t> bytesOffsets(numNodes+1);
+    bytesOffsets[0] = 0;
+    for (size_t i=0; i<numNodes; i++)
+      bytesOffsets[i+1] = bytesOffsets[i]+nodeBytes(order[i].ref);
+
+    const int types[3] = { int(NodeRef::tyAABBNode), int(NodeRef::tyAABBNodeMB), int(NodeRef::tyAABBNodeMB4D) };
+    for (int type : types)
+    {
+      std::vector<size_t> indices;
+      for (size_t i=0; i<numNodes; i++)
+        if (order[i].ref.type() == type) indices.push_back(i);
+      if (indices.empty()) continue;
+
+      std::vector<uint64_t> slots(indices.size()), tmp(indices.size());
+      for (size_t j=0; j<indices.size(); j++)
+        slots[j] = (uint64_t) order[indices[j]].ref.baseNode();
+      radix_sort_u64(slots.data(),tmp.data(),slots.size());
+      for (size_t j=0; j<indices.size(); j++)
+        addresses[indices[j]] = slots[j];
+    }
+
+    /* copy all nodes before they get overwritten, then move them to their new locations and relink them */
+    std::vector<char> buffer(bytesOffsets[numNodes]);
+    parallel_for(numNodes, [&] (const size_t i) {
+        memcpy(&buffer[bytesOffsets[i]],order[i].ref.baseNode(),bytesOffsets[i+1]-bytesOffsets[i]);
+      });
+    parallel_for(numNodes, [&] (const size_t i) {
+        memcpy((char*)addresses[i],&buffer[bytesOffsets[i]],bytesOffsets[i+1]-bytesOffsets[i]);
+      });
+    parallel_for(size_t(1), numNodes, [&] (const range<size_t>& r) {
+        for (size_t i=r.begin(); i<r.end(); i++) {
+          BaseNode* parent = (BaseNode*) addresses[order[i].parent];
+          parent->child(order[i].slot) = NodeRef(addresses[i] | order[i].ref.type());
+        }
+      });
+    root = NodeRef(addresses[0] | root.type());
+  }
+
   template<int N>
   double BVHN<N>::preBuild(const std::string& builderName)
   {
@@ -175,7 +348,7 @@ namespace embree
     {
       if (!stat) stat.reset(new BVHNStatistics<N>(this));
       Lock<MutexSys> lock(g_printMutex);
-      std::cout << "BENCHMARK_BUILD " << dt << " " << double(numPrimitives)/dt << " " << stat->sah() << " " << stat->bytesUsed() << " BVH" << N << "<" << primTy->name() << ">" << std::endl << std::flush;
+      std::cout << "BENCHMARK_BUILD " << dt << " " << double(numPrimitives)/dt << " " << stat->sah() << " " << stat->bytesUsed() << " " << stat->numNodes() << " " << stat->numTimeSplitNodes() << " BVH" << N << "<" << primTy->name() << ">" << std::endl << std::flush;
     }
   }
 
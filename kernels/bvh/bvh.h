@@ -96,6 +96,12 @@ namespace embree
     
     /*! clears the acceleration structure */
     void clear();
+
+    /*! calculates the SAH cost of the hierarchy relative to its bounds */
+    double sah();
+
+    /*! adds the memory of the hierarchy and its object hierarchies to the statistics */
+    void addMemoryStatistics(MemoryStatistics& stat);
     
     /*! sets BVH members after build */
     void set (NodeRef root, const LBBox3fa& bounds, size_t numPrimitives);
@@ -106,6 +112,9 @@ namespace embree
     /*! lays out num large nodes of the BVH */
     void layoutLargeNodes(size_t num);
     NodeRef layoutLargeNodesRecursion(NodeRef& node, const FastAllocator::CachedAllocator& allocator);
+
+    /*! relays out all nodes of the BVH such that treelets of nodes likely traversed together are stored consecutively */
+    void layoutTreelets();
     
     /*! called by all builders before build starts */
     double preBuild(const std::string& builderName);
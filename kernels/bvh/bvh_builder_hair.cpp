@@ -8,6 +8,9 @@
 #include "../geometry/linei.h"
 #include "../geometry/curveNi.h"
 #include "../geometry/curveNv.h"
+#include "../geometry/curve_lod.h"
+#include "../geometry/point_lod.h"
+#include "../geometry/quantized_points.h"
 
 #if defined(EMBREE_GEOMETRY_CURVE) || defined(EMBREE_GEOMETRY_POINT)
 
@@ -50,8 +53,10 @@ namespace embree
         const PrimInfo pinfo = createPrimRefArray(scene,Geometry::MTY_CURVES,false,numPrimitives,prims,scene->progressInterface);
 
         /* estimate acceleration structure size */
-        const size_t node_bytes = pinfo.size()*sizeof(typename BVH::OBBNode)/(4*N);
-        const size_t leaf_bytes = CurvePrimitive::bytes(pinfo.size());
+        const bool compressPoints = scene->device->point_compression;
+        const size_t leafSize = compressPoints ? QuantizedPoints::MAX_POINTS : CurvePrimitive::max_size();
+        const size_t node_bytes = pinfo.size()*sizeof(typename BVH::OBBNode)/(leafSize*N);
+        const size_t leaf_bytes = compressPoints ? QuantizedPoints::estimatedBytes(pinfo.size()) : CurvePrimitive::bytes(pinfo.size());
         bvh->alloc.init_estimate(node_bytes+leaf_bytes);
         
         /* builder settings */
@@ -60,6 +65,7 @@ namespace embree
         settings.logBlockSize = bsf(CurvePrimitive::max_size());
         settings.minLeafSize = CurvePrimitive::max_size();
         settings.maxLeafSize = CurvePrimitive::max_size();
+        settings.maxCompressedLeafSize = compressPoints ? QuantizedPoints::MAX_POINTS : 0;
         settings.finished_range_threshold = numPrimitives/1000;
         if (settings.finished_range_threshold < 1000)
           settings.finished_range_threshold = inf;
@@ -79,6 +85,45 @@ namespace embree
             return CurvePrimitive::createLeaf(bvh,prims,set,alloc);
         };
         
+        /* creates a leaf of quantized points, returns an empty node if the range cannot get compressed */
+        auto createCompressedLeaf = [&] (const PrimRef* prims, const range<size_t>& set, const FastAllocator::CachedAllocator& alloc) -> NodeRef {
+
+          if (!QuantizedPoints::supported(prims,set,scene))
+            return BVH::emptyNode;
+
+          return QuantizedPoints::createLeaf(bvh,prims,set,alloc);
+        };
+
+        /* creates a level of detail leaf for far field rays, only supported with min-width */
+#if RTC_MIN_WIDTH
+        const float lodScale = scene->device->curve_lod_scale;
+#else
+        const float lodScale = 0.0f;
+#endif
+        auto createLOD = [&] (const PrimRef* prims, const PrimInfoRange& pinfo, size_t depth, const FastAllocator::CachedAllocator& alloc) -> NodeRef {
+
+          if (lodScale <= 0.0f || depth%2 != 0 || pinfo.size() < CurveLOD::MIN_PRIMITIVES)
+            return BVH::emptyNode;
+
+          /* subtrees of a single point geometry get approximated by a few quantized spheres */
+          const unsigned int geomID0 = prims[pinfo.begin()].geomID();
+          bool points = scene->get(geomID0)->getTypeMask() & Geometry::MTY_POINTS;
+          for (size_t i=pinfo.begin()+1; points && i<pinfo.end(); i++)
+            points = prims[i].geomID() == geomID0;
+
+          if (points) {
+            if (pinfo.size() < PointLOD::MIN_PRIMITIVES) return BVH::emptyNode;
+            return PointLOD::createLeaf(bvh,prims,pinfo,pinfo.geomBounds,lodScale,alloc);
+          }
+          return CurveLOD::createLeaf(bvh,prims,pinfo,pinfo.geomBounds,lodScale,alloc);
+        };
+
+        auto setLOD = [&] (NodeRef lod, NodeRef child) {
+          size_t items; char* leaf = lod.leaf(items);
+          if (*(unsigned char*)leaf == PointLOD::TY) ((PointLOD*)leaf)->child = child;
+          else                                       ((CurveLOD*)leaf)->child = child;
+        };
+
         auto reportFinishedRange = [&] (const range<size_t>& range) -> void
           {
             PrimRef* begin = prims.data()+range.begin();
@@ -94,7 +139,8 @@ namespace embree
            typename BVH::AABBNode::Set(),
            typename BVH::OBBNode::Create(),
            typename BVH::OBBNode::Set(),
-           createLeaf,scene->progressInterface,
+           createLeaf,createCompressedLeaf,createLOD,setLOD,
+           scene->progressInterface,
            reportFinishedRange,
            scene,prims.data(),pinfo,settings);
         
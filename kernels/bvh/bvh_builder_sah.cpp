@@ -5,6 +5,7 @@
 #include "bvh_builder.h"
 #include "../builders/primrefgen.h"
 #include "../builders/splitter.h"
+#include "../builders/bvh_builder_morton.h"
 
 #include "../geometry/linei.h"
 #include "../geometry/triangle.h"
@@ -20,6 +21,7 @@
 #include "../common/state.h"
 #include "../../common/algorithms/parallel_for_for.h"
 #include "../../common/algorithms/parallel_for_for_prefix_sum.h"
+#include "../../common/algorithms/parallel_sort.h"
 
 #define PROFILE 0
 #define PROFILE_RUNS 20
@@ -153,7 +155,7 @@ namespace embree
             prims.resize(numPrimitives); 
 
             PrimInfo pinfo = mesh ?
-              createPrimRefArray(mesh,geomID_,numPrimitives,prims,bvh->scene->progressInterface) :
+              createPrimRefArray(mesh,geomID_,numPrimitives,prims,bvh->scene->progressInterface,bvh->scene->origin) :
               createPrimRefArray(scene,gtype_,false,numPrimitives,prims,bvh->scene->progressInterface);
 
             /* pinfo might has zero size due to invalid geometry */
@@ -168,6 +170,7 @@ namespace embree
             NodeRef root = BVHNBuilderVirtual<N>::build(&bvh->alloc,CreateLeaf<N,Primitive>(bvh),bvh->scene->progressInterface,prims.data(),pinfo,settings);
             bvh->set(root,LBBox3fa(pinfo.geomBounds),pinfo.size());
             bvh->layoutLargeNodes(size_t(pinfo.size()*0.005f));
+            if (bvh->scene->isTreeletLayout()) bvh->layoutTreelets();
 
 #if PROFILE
           });
@@ -195,6 +198,286 @@ namespace embree
     /************************************************************************************/
     /************************************************************************************/
 
+    /* SAH builder for scenes whose full primref array does not fit into memory. Primitives
+       are sorted into spatially coherent buckets along a coarse morton order using compact
+       8 byte references, each bucket is built with the SAH builder into a primref array of
+       bounded size, and the bucket hierarchies are merged under a top-level SAH tree. */
+    template<int N, typename Primitive>
+    struct BVHNBuilderSAHStreaming : public Builder
+    {
+      typedef BVHN<N> BVH;
+      typedef typename BVHN<N>::NodeRef NodeRef;
+
+      static const size_t CELL_BITS = 10;
+      static const size_t NUM_CELLS = size_t(1) << CELL_BITS;
+      static const size_t BLOCK_SIZE = 1024;
+
+      BVH* bvh;
+      Scene* scene;
+      mvector<PrimRef> prims;
+      mvector<uint64_t> refs;
+      GeneralBVHBuilder::Settings settings;
+      Geometry::GTypeMask gtype_;
+
+      BVHNBuilderSAHStreaming (BVH* bvh, Scene* scene, const size_t sahBlockSize, const float intCost, const size_t minLeafSize, const size_t maxLeafSize, const Geometry::GTypeMask gtype)
+        : bvh(bvh), scene(scene), prims(scene->device,0), refs(scene->device,0),
+          settings(sahBlockSize, minLeafSize, min(maxLeafSize,Primitive::max_size()*BVH::maxLeafBlocks), travCost, intCost, DEFAULT_SINGLE_THREAD_THRESHOLD), gtype_(gtype) {}
+
+      /* generates the primrefs of the scene in small blocks and passes them to func */
+      template<typename Value, typename Func, typename Reduction>
+      Value streamPrimRefs(const Value& identity, const Func& func, const Reduction& reduction)
+      {
+        Scene::Iterator2 iter(scene,gtype_,false);
+        ParallelForForPrefixSumState<Value> pstate;
+        pstate.init(iter,BLOCK_SIZE);
+        return parallel_for_for_prefix_sum0(pstate, iter, identity, [&](Geometry* mesh, const range<size_t>& r, size_t k, size_t geomID) -> Value
+        {
+          Value v = identity;
+          mvector<PrimRef> block(scene->device,BLOCK_SIZE);
+          for (size_t i=r.begin(); i<r.end(); i+=BLOCK_SIZE) {
+            const PrimInfo pinfo = mesh->createPrimRefArray(block,range<size_t>(i,min(i+BLOCK_SIZE,r.end())),0,(unsigned)geomID);
+            v = reduction(v,func(block.data(),pinfo));
+          }
+          return v;
+        }, reduction);
+      }
+
+      /* groups consecutive cells into buckets of bounded size, cells
+         with too many primitives get split recursively along the
+         lower bits of the morton codes */
+      void createBuckets(const BVHBuilderMorton::MortonCodeMapping& mapping, const size_t* cellBegin, const size_t numCells, const size_t shift,
+                         const size_t maxBucketPrimitives, std::vector<std::pair<size_t,size_t>>& buckets)
+      {
+        for (size_t c0=0, c1=0; c0<numCells; c0=c1)
+        {
+          for (c1=c0+1; c1<numCells; c1++)
+            if (cellBegin[c1+1]-cellBegin[c0] > maxBucketPrimitives) break;
+          if (cellBegin[c1] == cellBegin[c0]) continue;
+          if (cellBegin[c1]-cellBegin[c0] > maxBucketPrimitives)
+            splitCell(mapping,cellBegin[c0],cellBegin[c1],shift,maxBucketPrimitives,buckets);
+          else
+            buckets.push_back(std::make_pair(cellBegin[c0],cellBegin[c1]));
+        }
+      }
+
+      /* sorts the references of a cell by the next morton code bits below shift and groups the resulting sub cells into buckets */
+      void splitCell(const BVHBuilderMorton::MortonCodeMapping& mapping, const size_t begin, const size_t end, const size_t shift,
+                     const size_t maxBucketPrimitives, std::vector<std::pair<size_t,size_t>>& buckets)
+      {
+        /* all primitives have the same morton code, split by count */
+        if (shift == 0) {
+          for (size_t i=begin; i<end; i+=maxBucketPrimitives)
+            buckets.push_back(std::make_pair(i,min(i+maxBucketPrimitives,end)));
+          return;
+        }
+
+        /* calculate the sub cell of each reference */
+        const size_t subBits = min(shift,CELL_BITS);
+        const size_t subShift = shift-subBits;
+        const size_t numSubCells = size_t(1) << subBits;
+        mvector<unsigned short> keys(scene->device,end-begin);
+        parallel_for(begin, end, BLOCK_SIZE, [&] (const range<size_t>& r)
+        {
+          mvector<PrimRef> block(scene->device,BLOCK_SIZE);
+          for (size_t i0=r.begin(); i0<r.end(); i0+=BLOCK_SIZE)
+          {
+            const size_t i1 = min(i0+BLOCK_SIZE,r.end());
+            for (size_t i=i0; i<i1; i++) {
+              const unsigned int geomID = unsigned(refs[i] >> 32);
+              const unsigned int primID = unsigned(refs[i]);
+              scene->get(geomID)->createPrimRefArray(block,range<size_t>(primID,primID+1),i-i0,geomID);
+              keys[i-begin] = (unsigned short) ((mapping.code(block[i-i0].bounds()) >> subShift) & (numSubCells-1));
+            }
+          }
+        });
+
+        /* in place permutation of the references into sub cell order */
+        std::vector<size_t> subCellBegin(numSubCells+1,0);
+        for (size_t i=0; i<end-begin; i++)
+          subCellBegin[keys[i]+1]++;
+        subCellBegin[0] = begin;
+        for (size_t c=0; c<numSubCells; c++)
+          subCellBegin[c+1] += subCellBegin[c];
+
+        std::vector<size_t> next(subCellBegin.begin(),subCellBegin.end()-1);
+        for (size_t c=0; c<numSubCells; c++)
+        {
+          while (next[c] < subCellBegin[c+1])
+          {
+            const size_t i = next[c];
+            const size_t k = keys[i-begin];
+            if (k == c) { next[c]++; continue; }
+            const size_t j = next[k]++;
+            std::swap(refs[i],refs[j]);
+            std::swap(keys[i-begin],keys[j-begin]);
+          }
+        }
+        keys.clear();
+
+        createBuckets(mapping,subCellBegin.data(),numSubCells,subShift,maxBucketPrimitives,buckets);
+      }
+
+      void build()
+      {
+	/* skip build for empty scene */
+        const size_t numPrimitives = scene->getNumPrimitives(gtype_,false);
+        if (numPrimitives == 0) {
+          bvh->clear();
+          clear();
+          return;
+        }
+
+        double t0 = bvh->preBuild(TOSTRING(isa) "::BVH" + toString(N) + "BuilderStreamingSAH");
+
+        /* the primref array of a bucket gets a quarter of the memory budget */
+        const size_t budget = scene->device->build_memory_budget;
+        const size_t maxBucketPrimitives = budget ? max(size_t(16*BLOCK_SIZE),budget/(4*sizeof(PrimRef))) : size_t(4*1024*1024);
+
+        /* first pass computes the centroid bounds */
+        scene->progressMonitor(0);
+        const PrimInfo pinfo = streamPrimRefs(PrimInfo(empty),
+          [&] (const PrimRef* block, const PrimInfo& binfo) { return binfo; },
+          [] (const PrimInfo& a, const PrimInfo& b) { return PrimInfo::merge(a,b); });
+
+        /* pinfo might has zero size due to invalid geometry */
+        if (unlikely(pinfo.size() == 0)) {
+          bvh->clear();
+          clear();
+          return;
+        }
+
+        /* second pass counts primitives per morton cell */
+        const BVHBuilderMorton::MortonCodeMapping mapping(pinfo.centBounds);
+        const size_t cellShift = 3*BVHBuilderMorton::MortonCodeMapping::LATTICE_BITS_PER_DIM - CELL_BITS;
+        std::atomic<size_t> cellCounts[NUM_CELLS];
+        for (size_t i=0; i<NUM_CELLS; i++) cellCounts[i] = 0;
+
+        streamPrimRefs(size_t(0), [&] (const PrimRef* block, const PrimInfo& binfo) -> size_t
+        {
+          size_t counts[NUM_CELLS] = { 0 };
+          for (size_t i=0; i<binfo.size(); i++)
+            counts[mapping.code(block[i].bounds()) >> cellShift]++;
+          for (size_t i=0; i<NUM_CELLS; i++)
+            if (counts[i]) cellCounts[i] += counts[i];
+          return 0;
+        }, std::plus<size_t>());
+
+        /* third pass scatters primitive references into cell order */
+        size_t cellBegin[NUM_CELLS+1];
+        std::atomic<size_t> cellOffsets[NUM_CELLS];
+        cellBegin[0] = 0;
+        for (size_t i=0; i<NUM_CELLS; i++) {
+          cellOffsets[i] = cellBegin[i];
+          cellBegin[i+1] = cellBegin[i] + cellCounts[i];
+        }
+        refs.resize(pinfo.size());
+
+        streamPrimRefs(size_t(0), [&] (const PrimRef* block, const PrimInfo& binfo) -> size_t
+        {
+          size_t counts[NUM_CELLS] = { 0 };
+          unsigned int cells[BLOCK_SIZE];
+          for (size_t i=0; i<binfo.size(); i++) {
+            cells[i] = mapping.code(block[i].bounds()) >> cellShift;
+            counts[cells[i]]++;
+          }
+          for (size_t i=0; i<NUM_CELLS; i++)
+            if (counts[i]) counts[i] = cellOffsets[i].fetch_add(counts[i]);
+          for (size_t i=0; i<binfo.size(); i++)
+            refs[counts[cells[i]]++] = (uint64_t(block[i].geomID()) << 32) | uint64_t(block[i].primID());
+          return 0;
+        }, std::plus<size_t>());
+
+        /* group consecutive cells into buckets of bounded size */
+        std::vector<std::pair<size_t,size_t>> buckets;
+        createBuckets(mapping,cellBegin,NUM_CELLS,cellShift,maxBucketPrimitives,buckets);
+        size_t maxBucketSize = 0;
+        for (size_t b=0; b<buckets.size(); b++)
+          maxBucketSize = max(maxBucketSize,buckets[b].second-buckets[b].first);
+
+        /* initialize allocator */
+        const size_t node_bytes = pinfo.size()*sizeof(typename BVH::AABBNodeMB)/(4*N);
+        const size_t leaf_bytes = size_t(1.2*Primitive::blocks(pinfo.size())*sizeof(Primitive));
+        bvh->alloc.init_estimate(node_bytes+leaf_bytes);
+        settings.singleThreadThreshold = bvh->alloc.fixSingleThreadThreshold(N,DEFAULT_SINGLE_THREAD_THRESHOLD,pinfo.size(),node_bytes+leaf_bytes);
+
+        /* build one hierarchy per bucket, sorting the references makes the build deterministic */
+        mvector<PrimRef> roots(scene->device,buckets.size());
+        {
+          mvector<uint64_t> tmp(scene->device,maxBucketSize);
+          prims.resize(maxBucketSize);
+
+          for (size_t b=0; b<buckets.size(); b++)
+          {
+            uint64_t* bucketRefs = refs.data()+buckets[b].first;
+            const size_t bucketSize = buckets[b].second-buckets[b].first;
+            radix_sort_u64(bucketRefs,tmp.data(),bucketSize);
+
+            const PrimInfo binfo = parallel_reduce(size_t(0), bucketSize, size_t(1024), PrimInfo(empty), [&] (const range<size_t>& r) -> PrimInfo
+            {
+              PrimInfo binfo(empty);
+              for (size_t i=r.begin(); i<r.end(); i++) {
+                const unsigned int geomID = unsigned(bucketRefs[i] >> 32);
+                const unsigned int primID = unsigned(bucketRefs[i]);
+                scene->get(geomID)->createPrimRefArray(prims,range<size_t>(primID,primID+1),i,geomID);
+                binfo.add_center2(prims[i]);
+              }
+              return binfo;
+            }, [] (const PrimInfo& a, const PrimInfo& b) { return PrimInfo::merge(a,b); });
+
+            const NodeRef root = BVHNBuilderVirtual<N>::build(&bvh->alloc,CreateLeaf<N,Primitive>(bvh),bvh->scene->progressInterface,prims.data(),binfo,settings);
+            roots[b] = PrimRef(binfo.geomBounds,(size_t)root);
+          }
+        }
+        prims.clear();
+        refs.clear();
+
+        /* merge bucket hierarchies under a top-level tree */
+        NodeRef root = (NodeRef) roots[0].ID();
+        if (roots.size() > 1)
+        {
+          PrimInfo rinfo(empty);
+          for (size_t b=0; b<roots.size(); b++)
+            rinfo.add_center2(roots[b]);
+
+          GeneralBVHBuilder::Settings topSettings;
+          topSettings.branchingFactor = N;
+          topSettings.maxDepth = BVH::maxBuildDepthLeaf;
+          topSettings.logBlockSize = bsr(N);
+          topSettings.minLeafSize = 1;
+          topSettings.maxLeafSize = 1;
+          topSettings.travCost = 1.0f;
+          topSettings.intCost = 1.0f;
+          topSettings.singleThreadThreshold = DEFAULT_SINGLE_THREAD_THRESHOLD;
+
+          root = BVHBuilderBinnedSAH::build<NodeRef>(
+            typename BVH::CreateAlloc(bvh),
+            typename BVH::AABBNode::Create2(),
+            typename BVH::AABBNode::Set2(),
+            [&] (const PrimRef* prims, const range<size_t>& range, const FastAllocator::CachedAllocator& alloc) -> NodeRef {
+              assert(range.size() == 1);
+              return (NodeRef) prims[range.begin()].ID();
+            },
+            [&] (size_t dn) { bvh->scene->progressMonitor(0); },
+            roots.data(),rinfo,topSettings);
+        }
+
+        bvh->set(root,LBBox3fa(pinfo.geomBounds),pinfo.size());
+        if (bvh->scene->isTreeletLayout()) bvh->layoutTreelets();
+	bvh->cleanup();
+        bvh->postBuild(t0);
+      }
+
+      void clear() {
+        prims.clear();
+        refs.clear();
+      }
+    };
+
+    /************************************************************************************/
+    /************************************************************************************/
+    /************************************************************************************/
+    /************************************************************************************/
+
     template<int N, typename Primitive>
     struct BVHNBuilderSAHQuantized : public Builder
     {
@@ -242,7 +525,7 @@ namespace embree
             /* create primref array */
             prims.resize(numPrimitives);
             PrimInfo pinfo = mesh ?
-              createPrimRefArray(mesh,geomID_,numPrimitives,prims,bvh->scene->progressInterface) :
+              createPrimRefArray(mesh,geomID_,numPrimitives,prims,bvh->scene->progressInterface,bvh->scene->origin) :
 	      createPrimRefArray(scene,gtype_,false,numPrimitives,prims,bvh->scene->progressInterface);
 
             /* enable os_malloc for two level build */
@@ -358,12 +641,15 @@ namespace embree
       GeneralBVHBuilder::Settings settings;
       const unsigned int geomID_ = std::numeric_limits<unsigned int>::max();
       unsigned int numPreviousPrimitives = 0;
+      const bool spatialSplits;
 
       BVHNBuilderSAHGrid (BVH* bvh, Scene* scene, const size_t sahBlockSize, const float intCost, const size_t minLeafSize, const size_t maxLeafSize, const size_t mode)
-        : bvh(bvh), scene(scene), mesh(nullptr), prims(scene->device,0), sgrids(scene->device,0), settings(sahBlockSize, minLeafSize, min(maxLeafSize,BVH::maxLeafBlocks), travCost, intCost, DEFAULT_SINGLE_THREAD_THRESHOLD) {}
+        : bvh(bvh), scene(scene), mesh(nullptr), prims(scene->device,0), sgrids(scene->device,0), settings(sahBlockSize, minLeafSize, min(maxLeafSize,BVH::maxLeafBlocks), travCost, intCost, DEFAULT_SINGLE_THREAD_THRESHOLD),
+          spatialSplits(mode & MODE_HIGH_QUALITY) {}
 
       BVHNBuilderSAHGrid (BVH* bvh, GridMesh* mesh, unsigned int geomID, const size_t sahBlockSize, const float intCost, const size_t minLeafSize, const size_t maxLeafSize, const size_t mode)
-        : bvh(bvh), scene(nullptr), mesh(mesh), prims(bvh->device,0), sgrids(scene->device,0), settings(sahBlockSize, minLeafSize, min(maxLeafSize,BVH::maxLeafBlocks), travCost, intCost, DEFAULT_SINGLE_THREAD_THRESHOLD), geomID_(geomID) {}
+        : bvh(bvh), scene(nullptr), mesh(mesh), prims(bvh->device,0), sgrids(scene->device,0), settings(sahBlockSize, minLeafSize, min(maxLeafSize,BVH::maxLeafBlocks), travCost, intCost, DEFAULT_SINGLE_THREAD_THRESHOLD), geomID_(geomID),
+          spatialSplits(false) {}
 
       void build()
       {
@@ -390,7 +676,7 @@ namespace embree
           return;
         }
 
-        double t0 = bvh->preBuild(mesh ? "" : TOSTRING(isa) "::BVH" + toString(N) + "BuilderSAH");
+        double t0 = bvh->preBuild(mesh ? "" : TOSTRING(isa) "::BVH" + toString(N) + (spatialSplits ? "BuilderFastSpatialSAH" : "BuilderSAH"));
 
         /* create primref array */
         settings.primrefarrayalloc = numPrimitives/1000;
@@ -417,10 +703,36 @@ namespace embree
           return;
         }
 
+        /* spatial splits require free geomID bits to count the splits per primitive */
+        const bool useSpatialSplits = spatialSplits && scene->getMaxGeomID<GridMesh,false>() < ((unsigned int)1 << (32-RESERVED_NUM_SPATIAL_SPLITS_GEOMID_BITS));
+
         /* call BVH builder */
-        NodeRef root = BVHNBuilderVirtual<N>::build(&bvh->alloc,CreateLeafGrid<N,SubGridQBVHN<N>>(bvh,sgrids.data()),bvh->scene->progressInterface,prims.data(),pinfo,settings);
+        NodeRef root(0);
+        if (useSpatialSplits)
+        {
+          /* spatial split SAH BVH builder that splits subgrid references */
+          const size_t numSplitPrimitives = max(numPrimitives,size_t(scene->max_spatial_split_replications*numPrimitives));
+          prims.resize(numSplitPrimitives);
+          settings.primrefarrayalloc = inf;
+          settings.branchingFactor = N;
+          settings.maxDepth = BVH::maxBuildDepthLeaf;
+
+          root = BVHBuilderBinnedFastSpatialSAH::build<NodeRef>(
+            typename BVH::CreateAlloc(bvh),
+            typename BVH::AABBNode::Create2(),
+            typename BVH::AABBNode::Set2(),
+            CreateLeafGrid<N,SubGridQBVHN<N>>(bvh,sgrids.data()),
+            GridSplitterFactory(scene,sgrids.data()),
+            bvh->scene->progressInterface,
+            prims.data(),
+            numSplitPrimitives,
+            pinfo,settings);
+        }
+        else
+          root = BVHNBuilderVirtual<N>::build(&bvh->alloc,CreateLeafGrid<N,SubGridQBVHN<N>>(bvh,sgrids.data()),bvh->scene->progressInterface,prims.data(),pinfo,settings);
         bvh->set(root,LBBox3fa(pinfo.geomBounds),pinfo.size());
         bvh->layoutLargeNodes(size_t(pinfo.size()*0.005f));
+        if (bvh->scene->isTreeletLayout()) bvh->layoutTreelets();
 
         /* clear temporary array */
         sgrids.clear();
@@ -456,6 +768,9 @@ namespace embree
     Builder* BVH4Triangle4SceneBuilderSAH  (void* bvh, Scene* scene, size_t mode) { return new BVHNBuilderSAH<4,Triangle4>((BVH4*)bvh,scene,4,1.0f,4,inf,TriangleMesh::geom_type); }
     Builder* BVH4Triangle4vSceneBuilderSAH (void* bvh, Scene* scene, size_t mode) { return new BVHNBuilderSAH<4,Triangle4v>((BVH4*)bvh,scene,4,1.0f,4,inf,TriangleMesh::geom_type); }
     Builder* BVH4Triangle4iSceneBuilderSAH (void* bvh, Scene* scene, size_t mode) { return new BVHNBuilderSAH<4,Triangle4i>((BVH4*)bvh,scene,4,1.0f,4,inf,TriangleMesh::geom_type,true); }
+    Builder* BVH4Triangle4SceneBuilderStreamingSAH  (void* bvh, Scene* scene, size_t mode) { return new BVHNBuilderSAHStreaming<4,Triangle4>((BVH4*)bvh,scene,4,1.0f,4,inf,TriangleMesh::geom_type); }
+    Builder* BVH4Triangle4vSceneBuilderStreamingSAH (void* bvh, Scene* scene, size_t mode) { return new BVHNBuilderSAHStreaming<4,Triangle4v>((BVH4*)bvh,scene,4,1.0f,4,inf,TriangleMesh::geom_type); }
+    Builder* BVH4Triangle4iSceneBuilderStreamingSAH (void* bvh, Scene* scene, size_t mode) { return new BVHNBuilderSAHStreaming<4,Triangle4i>((BVH4*)bvh,scene,4,1.0f,4,inf,TriangleMesh::geom_type); }
 
     Builder* BVH4QuantizedTriangle4iSceneBuilderSAH (void* bvh, Scene* scene, size_t mode) { return new BVHNBuilderSAHQuantized<4,Triangle4i>((BVH4*)bvh,scene,4,1.0f,4,inf,TriangleMesh::geom_type); }
 #if defined(__AVX__)
@@ -466,6 +781,9 @@ namespace embree
     Builder* BVH8Triangle4SceneBuilderSAH  (void* bvh, Scene* scene, size_t mode) { return new BVHNBuilderSAH<8,Triangle4>((BVH8*)bvh,scene,4,1.0f,4,inf,TriangleMesh::geom_type); }
     Builder* BVH8Triangle4vSceneBuilderSAH  (void* bvh, Scene* scene, size_t mode) { return new BVHNBuilderSAH<8,Triangle4v>((BVH8*)bvh,scene,4,1.0f,4,inf,TriangleMesh::geom_type); }
     Builder* BVH8Triangle4iSceneBuilderSAH     (void* bvh, Scene* scene, size_t mode) { return new BVHNBuilderSAH<8,Triangle4i>((BVH8*)bvh,scene,4,1.0f,4,inf,TriangleMesh::geom_type,true); }
+    Builder* BVH8Triangle4SceneBuilderStreamingSAH  (void* bvh, Scene* scene, size_t mode) { return new BVHNBuilderSAHStreaming<8,Triangle4>((BVH8*)bvh,scene,4,1.0f,4,inf,TriangleMesh::geom_type); }
+    Builder* BVH8Triangle4vSceneBuilderStreamingSAH (void* bvh, Scene* scene, size_t mode) { return new BVHNBuilderSAHStreaming<8,Triangle4v>((BVH8*)bvh,scene,4,1.0f,4,inf,TriangleMesh::geom_type); }
+    Builder* BVH8Triangle4iSceneBuilderStreamingSAH (void* bvh, Scene* scene, size_t mode) { return new BVHNBuilderSAHStreaming<8,Triangle4i>((BVH8*)bvh,scene,4,1.0f,4,inf,TriangleMesh::geom_type); }
     Builder* BVH8QuantizedTriangle4iSceneBuilderSAH  (void* bvh, Scene* scene, size_t mode) { return new BVHNBuilderSAHQuantized<8,Triangle4i>((BVH8*)bvh,scene,4,1.0f,4,inf,TriangleMesh::geom_type); }
     Builder* BVH8QuantizedTriangle4SceneBuilderSAH  (void* bvh, Scene* scene, size_t mode) { return new BVHNBuilderSAHQuantized<8,Triangle4>((BVH8*)bvh,scene,4,1.0f,4,inf,TriangleMesh::geom_type); }
 
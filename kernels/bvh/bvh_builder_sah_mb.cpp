@@ -62,6 +62,33 @@ namespace embree
     };
 #endif
 
+#if defined(EMBREE_GEOMETRY_INSTANCE)
+    /* instances get placed relative to the origin of the scene they are built into */
+    template<>
+      struct RecalculatePrimRef<Instance>
+      {
+        Scene* scene;
+
+        __forceinline RecalculatePrimRef (Scene* scene)
+          : scene(scene) {}
+
+        __forceinline PrimRefMB operator() (const PrimRefMB& prim, const BBox1f time_range) const
+        {
+          const unsigned geomID = prim.geomID();
+          const unsigned primID = prim.primID();
+          const Instance* instance = scene->get<Instance>(geomID);
+          const LBBox3fa lbounds = instance->linearBounds(primID, time_range, instance->getOriginOffset(scene->origin));
+          const range<int> tbounds = instance->timeSegmentRange(time_range);
+          return PrimRefMB (lbounds, tbounds.size(), instance->time_range, instance->numTimeSegments(), geomID, primID);
+        }
+
+        __forceinline LBBox3fa linearBounds(const PrimRefMB& prim, const BBox1f time_range) const {
+          const Instance* instance = scene->get<Instance>(prim.geomID());
+          return instance->linearBounds(prim.primID(), time_range, instance->getOriginOffset(scene->origin));
+        }
+      };
+#endif
+
     template<int N, typename Mesh, typename Primitive>
     struct CreateMSMBlurLeaf
     {
@@ -132,6 +159,8 @@ namespace embree
           });
 #endif
 
+        if (bvh->scene->isTreeletLayout()) bvh->layoutTreelets();
+
 	/* clear temporary data for static geometry */
 	bvh->cleanup();
         bvh->postBuild(t0);
@@ -196,6 +225,7 @@ namespace embree
         settings.intCost = intCost;
         settings.singleLeafTimeSegment = Primitive::singleTimeSegment;
         settings.singleThreadThreshold = bvh->alloc.fixSingleThreadThreshold(N,DEFAULT_SINGLE_THREAD_THRESHOLD,pinfo.size(),node_bytes+leaf_bytes);
+        settings.timeSplitThreshold = scene->device->time_split_threshold;
         
         /* build hierarchy */
         auto root =
@@ -558,6 +588,8 @@ namespace embree
         //else
         buildMultiSegment(numPrimitives);
 
+        if (bvh->scene->isTreeletLayout()) bvh->layoutTreelets();
+
 	/* clear temporary data for static geometry */
 	bvh->cleanup();
         bvh->postBuild(t0);
@@ -634,6 +666,7 @@ namespace embree
         settings.intCost = intCost;
         settings.singleLeafTimeSegment = false; 
         settings.singleThreadThreshold = bvh->alloc.fixSingleThreadThreshold(N,DEFAULT_SINGLE_THREAD_THRESHOLD,pinfo.size(),node_bytes+leaf_bytes);
+        settings.timeSplitThreshold = scene->device->time_split_threshold;
         
         /* build hierarchy */
         auto root =
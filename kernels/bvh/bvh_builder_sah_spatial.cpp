@@ -59,17 +59,15 @@ namespace embree
       Mesh* mesh;
       mvector<PrimRef> prims0;
       GeneralBVHBuilder::Settings settings;
-      const float splitFactor;
       unsigned int geomID_ = std::numeric_limits<unsigned int>::max();
       unsigned int numPreviousPrimitives = 0;
 
       BVHNBuilderFastSpatialSAH (BVH* bvh, Scene* scene, const size_t sahBlockSize, const float intCost, const size_t minLeafSize, const size_t maxLeafSize, const size_t mode)
-        : bvh(bvh), scene(scene), mesh(nullptr), prims0(scene->device,0), settings(sahBlockSize, minLeafSize, min(maxLeafSize,Primitive::max_size()*BVH::maxLeafBlocks), travCost, intCost, DEFAULT_SINGLE_THREAD_THRESHOLD),
-          splitFactor(scene->device->max_spatial_split_replications) {}
+        : bvh(bvh), scene(scene), mesh(nullptr), prims0(scene->device,0), settings(sahBlockSize, minLeafSize, min(maxLeafSize,Primitive::max_size()*BVH::maxLeafBlocks), travCost, intCost, DEFAULT_SINGLE_THREAD_THRESHOLD) {}
 
       BVHNBuilderFastSpatialSAH (BVH* bvh, Mesh* mesh, const unsigned int geomID, const size_t sahBlockSize, const float intCost, const size_t minLeafSize, const size_t maxLeafSize, const size_t mode)
         : bvh(bvh), scene(nullptr), mesh(mesh), prims0(bvh->device,0), settings(sahBlockSize, minLeafSize, min(maxLeafSize,Primitive::max_size()*BVH::maxLeafBlocks), travCost, intCost, DEFAULT_SINGLE_THREAD_THRESHOLD),
-          splitFactor(scene->device->max_spatial_split_replications), geomID_(geomID) {}
+          geomID_(geomID) {}
 
       // FIXME: shrink bvh->alloc in destructor here and in other builders too
 
@@ -93,7 +91,8 @@ namespace embree
         const bool usePreSplits = scene->device->useSpatialPreSplits || (maxGeomID >= ((unsigned int)1 << (32-RESERVED_NUM_SPATIAL_SPLITS_GEOMID_BITS)));
         double t0 = bvh->preBuild(mesh ? "" : TOSTRING(isa) "::BVH" + toString(N) + (usePreSplits ? "BuilderFastSpatialPresplitSAH" : "BuilderFastSpatialSAH"));
 
-        /* create primref array */
+        /* create primref array, the scene limits the replications to stay within its memory budget */
+        const float splitFactor = mesh ? bvh->device->max_spatial_split_replications : scene->max_spatial_split_replications;
         const size_t numSplitPrimitives = max(numOriginalPrimitives,size_t(splitFactor*numOriginalPrimitives));
         prims0.resize(numSplitPrimitives);
 
@@ -127,7 +126,7 @@ namespace embree
 	  {
             /* standard spatial split SAH BVH builder */
 	    pinfo = mesh ?
-	      createPrimRefArray(mesh,geomID_,numSplitPrimitives,prims0,bvh->scene->progressInterface) :
+	      createPrimRefArray(mesh,geomID_,numSplitPrimitives,prims0,bvh->scene->progressInterface,bvh->scene->origin) :
 	      createPrimRefArray(scene,Mesh::geom_type,false,numSplitPrimitives,prims0,bvh->scene->progressInterface);
 	
 	    Splitter splitter(scene);
@@ -157,6 +156,7 @@ namespace embree
 
         bvh->set(root,LBBox3fa(pinfo.geomBounds),pinfo.size());
         bvh->layoutLargeNodes(size_t(pinfo.size()*0.005f));
+        if (bvh->scene->isTreeletLayout()) bvh->layoutTreelets();
 
 	/* clear temporary data for static geometry */
 	if (scene && scene->isStaticAccel()) {
@@ -171,6 +171,94 @@ namespace embree
       }
     };
 
+    /* spatial split SAH builder for geometry types without presplit support (user geometries and instances) */
+    template<int N, typename Mesh, typename Primitive, typename Splitter>
+    struct BVHNBuilderFastSpatialSAHGeometry : public Builder
+    {
+      typedef BVHN<N> BVH;
+      typedef typename BVH::NodeRef NodeRef;
+      BVH* bvh;
+      Scene* scene;
+      mvector<PrimRef> prims0;
+      GeneralBVHBuilder::Settings settings;
+      Geometry::GTypeMask gtype_;
+
+      BVHNBuilderFastSpatialSAHGeometry (BVH* bvh, Scene* scene, const size_t sahBlockSize, const float intCost, const size_t minLeafSize, const size_t maxLeafSize, const Geometry::GTypeMask gtype)
+        : bvh(bvh), scene(scene), prims0(scene->device,0), settings(sahBlockSize, minLeafSize, min(maxLeafSize,Primitive::max_size()*BVH::maxLeafBlocks), travCost, intCost, DEFAULT_SINGLE_THREAD_THRESHOLD),
+          gtype_(gtype) {}
+
+      void build()
+      {
+	/* skip build for empty scene */
+        const size_t numOriginalPrimitives = scene->getNumPrimitives(gtype_,false);
+        if (numOriginalPrimitives == 0) {
+          prims0.clear();
+          bvh->clear();
+          return;
+        }
+
+        /* spatial splits require free geomID bits to count the splits per primitive */
+        const unsigned int maxGeomID = scene->getMaxGeomID<Mesh,false>();
+        const bool useSpatialSplits = maxGeomID < ((unsigned int)1 << (32-RESERVED_NUM_SPATIAL_SPLITS_GEOMID_BITS));
+        double t0 = bvh->preBuild(TOSTRING(isa) "::BVH" + toString(N) + (useSpatialSplits ? "BuilderFastSpatialSAH" : "BuilderSAH"));
+
+        /* create primref array */
+        const size_t numSplitPrimitives = useSpatialSplits ? max(numOriginalPrimitives,size_t(scene->max_spatial_split_replications*numOriginalPrimitives)) : numOriginalPrimitives;
+        prims0.resize(numSplitPrimitives);
+        const PrimInfo pinfo = createPrimRefArray(scene,gtype_,false,numSplitPrimitives,prims0,bvh->scene->progressInterface);
+
+        /* pinfo might has zero size due to invalid geometry */
+        if (unlikely(pinfo.size() == 0))
+        {
+          prims0.clear();
+          bvh->clear();
+          return;
+        }
+
+        const size_t node_bytes = pinfo.size()*sizeof(typename BVH::AABBNode)/(4*N);
+        const size_t leaf_bytes = size_t(1.2*Primitive::blocks(pinfo.size())*sizeof(Primitive));
+        bvh->alloc.init_estimate(node_bytes+leaf_bytes);
+        settings.singleThreadThreshold = bvh->alloc.fixSingleThreadThreshold(N,DEFAULT_SINGLE_THREAD_THRESHOLD,pinfo.size(),node_bytes+leaf_bytes);
+
+        settings.branchingFactor = N;
+        settings.maxDepth = BVH::maxBuildDepthLeaf;
+
+        /* call BVH builder */
+        NodeRef root(0);
+        if (likely(useSpatialSplits))
+        {
+          Splitter splitter(scene);
+          root = BVHBuilderBinnedFastSpatialSAH::build<NodeRef>(
+            typename BVH::CreateAlloc(bvh),
+            typename BVH::AABBNode::Create2(),
+            typename BVH::AABBNode::Set2(),
+            CreateLeafSpatial<N,Primitive>(bvh),
+            splitter,
+            bvh->scene->progressInterface,
+            prims0.data(),
+            numSplitPrimitives,
+            pinfo,settings);
+        }
+        else
+          root = BVHNBuilderVirtual<N>::build(&bvh->alloc,CreateLeafSpatial<N,Primitive>(bvh),bvh->scene->progressInterface,prims0.data(),pinfo,settings);
+
+        bvh->set(root,LBBox3fa(pinfo.geomBounds),pinfo.size());
+        bvh->layoutLargeNodes(size_t(pinfo.size()*0.005f));
+        if (bvh->scene->isTreeletLayout()) bvh->layoutTreelets();
+
+	/* clear temporary data for static geometry */
+	if (scene->isStaticAccel()) {
+          prims0.clear();
+        }
+	bvh->cleanup();
+        bvh->postBuild(t0);
+      }
+
+      void clear() {
+        prims0.clear();
+      }
+    };
+
     /************************************************************************************/
     /************************************************************************************/
     /************************************************************************************/
@@ -196,6 +284,30 @@ namespace embree
     Builder* BVH8Quad4vSceneBuilderFastSpatialSAH  (void* bvh, Scene* scene, size_t mode) { return new BVHNBuilderFastSpatialSAH<8,QuadMesh,Quad4v,QuadSplitterFactory>((BVH8*)bvh,scene,4,1.0f,4,inf,mode); }
 #endif
 
+#endif
+
+#if defined(EMBREE_GEOMETRY_USER)
+    Builder* BVH4VirtualSceneBuilderFastSpatialSAH (void* bvh, Scene* scene, size_t mode) {
+      int minLeafSize = scene->device->object_accel_min_leaf_size;
+      int maxLeafSize = scene->device->object_accel_max_leaf_size;
+      return new BVHNBuilderFastSpatialSAHGeometry<4,UserGeometry,Object,UserGeometrySplitterFactory>((BVH4*)bvh,scene,4,1.0f,minLeafSize,maxLeafSize,UserGeometry::geom_type);
+    }
+
+#if defined(__AVX__)
+    Builder* BVH8VirtualSceneBuilderFastSpatialSAH (void* bvh, Scene* scene, size_t mode) {
+      int minLeafSize = scene->device->object_accel_min_leaf_size;
+      int maxLeafSize = scene->device->object_accel_max_leaf_size;
+      return new BVHNBuilderFastSpatialSAHGeometry<8,UserGeometry,Object,UserGeometrySplitterFactory>((BVH8*)bvh,scene,8,1.0f,minLeafSize,maxLeafSize,UserGeometry::geom_type);
+    }
+#endif
+#endif
+
+#if defined(EMBREE_GEOMETRY_INSTANCE)
+    Builder* BVH4InstanceSceneBuilderFastSpatialSAH (void* bvh, Scene* scene, Geometry::GTypeMask gtype) { return new BVHNBuilderFastSpatialSAHGeometry<4,Instance,InstancePrimitive,InstanceSplitterFactory>((BVH4*)bvh,scene,4,1.0f,1,1,gtype); }
+
+#if defined(__AVX__)
+    Builder* BVH8InstanceSceneBuilderFastSpatialSAH (void* bvh, Scene* scene, Geometry::GTypeMask gtype) { return new BVHNBuilderFastSpatialSAHGeometry<8,Instance,InstancePrimitive,InstanceSplitterFactory>((BVH8*)bvh,scene,8,1.0f,1,1,gtype); }
+#endif
 #endif
   }
 }
@@ -168,6 +168,7 @@ namespace embree
         NodeRef root = BVHNBuilderVirtual<N>::build(&bvh->alloc,createLeaf,virtualprogress,prims.data(),pinfo,settings);
         bvh->set(root,LBBox3fa(pinfo.geomBounds),pinfo.size());
         bvh->layoutLargeNodes(size_t(pinfo.size()*0.005f));
+        if (bvh->scene->isTreeletLayout()) bvh->layoutTreelets();
         
 	/* clear temporary data for static geometry */
 	if (scene->isStaticAccel()) {
@@ -320,6 +321,7 @@ namespace embree
         settings.travCost = 1.0f;
         settings.intCost = 1.0f;
         settings.singleLeafTimeSegment = false;
+        settings.timeSplitThreshold = scene->device->time_split_threshold;
 
         /* build hierarchy */
         auto root =
@@ -75,7 +75,7 @@ namespace embree
       {
         for (size_t objectID=r.begin(); objectID<r.end(); objectID++)
         {
-          Mesh* mesh = scene->getSafe<Mesh>(objectID);
+          Mesh* mesh = getMeshOfType(objectID);
       
           /* ignore meshes we do not support */
           if (mesh == nullptr || mesh->numTimeSteps != 1)
@@ -95,7 +95,7 @@ namespace embree
         for (size_t objectID=r.begin(); objectID<r.end(); objectID++)
         {
           /* ignore if no triangle mesh or not enabled */
-          Mesh* mesh = scene->getSafe<Mesh>(objectID);
+          Mesh* mesh = getMeshOfType(objectID);
           if (mesh == nullptr || !mesh->isEnabled() || mesh->numTimeSteps != 1) 
             continue;
 
@@ -219,6 +219,29 @@ namespace embree
 
     }
     
+    template<int N, typename Mesh, typename Primitive>
+    void BVHNBuilderTwoLevel<N,Mesh,Primitive>::prebuild()
+    {
+      const size_t num = scene->size();
+      if (bvh->objects.size() < num) bvh->objects.resize(num);
+      if (builders.size() < num) builders.resize(num);
+
+      /* build acceleration structures of modified large meshes, the
+       * top level hierarchy is created by the next build */
+      parallel_for(size_t(0), num, [&] (const range<size_t>& r)
+      {
+        for (size_t objectID=r.begin(); objectID<r.end(); objectID++)
+        {
+          Mesh* mesh = getMeshOfType(objectID);
+          if (mesh == nullptr || !mesh->isEnabled() || mesh->numTimeSteps != 1 || isSmallGeometry(mesh))
+            continue;
+
+          setupLargeBuildRefBuilder (objectID, mesh);
+          builders[objectID]->prebuild (this);
+        }
+      });
+    }
+
     template<int N, typename Mesh, typename Primitive>
     void BVHNBuilderTwoLevel<N,Mesh,Primitive>::deleteGeometry(size_t geomID)
     {
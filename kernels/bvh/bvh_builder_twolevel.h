@@ -110,6 +110,7 @@ namespace embree
       
       /*! builder entry point */
       void build();
+      void prebuild();
       void deleteGeometry(size_t geomID);
       void clear();
 
@@ -122,6 +123,7 @@ namespace embree
         virtual ~RefBuilderBase () {}
         virtual void attachBuildRefs (BVHNBuilderTwoLevel* builder) = 0;
         virtual bool meshQualityChanged (RTCBuildQuality currQuality) = 0;
+        virtual void prebuild (BVHNBuilderTwoLevel* builder) {}
       };
 
       class RefBuilderSmall : public RefBuilderBase {
@@ -137,7 +139,7 @@ namespace embree
           assert(isSmallGeometry(mesh));
           
           mvector<PrimRef> prefs(topBuilder->scene->device, meshSize);
-          auto pinfo = createPrimRefArray(mesh,objectID_,meshSize,prefs,topBuilder->bvh->scene->progressInterface);
+          auto pinfo = createPrimRefArray(mesh,objectID_,meshSize,prefs,topBuilder->bvh->scene->progressInterface,topBuilder->bvh->scene->origin);
 
           size_t begin=0;
           while (begin < pinfo.size())
@@ -193,6 +195,15 @@ namespace embree
           return currQuality != quality_;
         }
 
+        void prebuild (BVHNBuilderTwoLevel* topBuilder)
+        {
+          /* build object if it got modified, the next build only has to create the top level */
+          if (topBuilder->isGeometryModified(objectID_)) {
+            builder_->build();
+            topBuilder->scene->setGeometryPrebuilt(objectID_);
+          }
+        }
+
       private:
         size_t          objectID_;
         Ref<Builder>    builder_;
@@ -208,6 +219,12 @@ namespace embree
       Mesh* getMesh (size_t objectID) {
         return this->scene->template getSafe<Mesh>(objectID);
       }
+      /* returns the mesh only if its type is handled by this builder, e.g. cheap or expensive instances */
+      Mesh* getMeshOfType (size_t objectID) {
+        Mesh* mesh = this->scene->template getSafe<Mesh>(objectID);
+        if (mesh == nullptr || !(this->scene->getTypeMask(objectID) & gtype)) return nullptr;
+        return mesh;
+      }
       bool  isGeometryModified (size_t objectID) {
         return this->scene->isGeometryModified(objectID);
       }
@@ -218,7 +235,7 @@ namespace embree
           [this](const range<size_t>& r)->size_t {
             size_t c = 0;
             for (auto i=r.begin(); i<r.end(); ++i) {
-              Mesh* mesh = scene->getSafe<Mesh>(i);
+              Mesh* mesh = getMeshOfType(i);
               if (mesh == nullptr || mesh->numTimeSteps != 1)
                 continue;
               size_t meshSize = mesh->size();
@@ -92,7 +92,17 @@ namespace embree
             goto pop;
 
           /* select next child and push other children */
+#if defined(EMBREE_TRAVERSAL_PREFETCH)
+          StackItemT<NodeRef>* const stackPtrOld = stackPtr;
           nodeTraverser.traverseClosestHit(cur, mask, tNear, stackPtr, stackEnd);
+
+          /* prefetch leaf data of the second closest child */
+          if (stackPtr != stackPtrOld && prefetchPushedLeaf<Primitive>(NodeRef(stackPtr[-1].ptr))) {
+            STAT3(normal.trav_prefetches,1,1,1);
+          }
+#else
+          nodeTraverser.traverseClosestHit(cur, mask, tNear, stackPtr, stackEnd);
+#endif
         }
 
         /* this is a leaf node */
@@ -174,7 +184,17 @@ namespace embree
             goto pop;
 
           /* select next child and push other children */
+#if defined(EMBREE_TRAVERSAL_PREFETCH)
+          NodeRef* const stackPtrOld = stackPtr;
           nodeTraverser.traverseAnyHit(cur, mask, tNear, stackPtr, stackEnd);
+
+          /* prefetch leaf data of the child that gets popped next */
+          if (stackPtr != stackPtrOld && prefetchPushedLeaf<Primitive>(stackPtr[-1])) {
+            STAT3(shadow.trav_prefetches,1,1,1);
+          }
+#else
+          nodeTraverser.traverseAnyHit(cur, mask, tNear, stackPtr, stackEnd);
+#endif
         }
 
         /* this is a leaf node */
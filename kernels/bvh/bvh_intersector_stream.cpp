@@ -279,6 +279,9 @@ namespace embree
           m_active &= ~((size_t)movemask(m_hit) << (i*K));
         }
 
+        /* terminate as soon as all rays are occluded */
+        if (unlikely(m_active == 0)) break;
+
       } // traversal + intersection
     }
 
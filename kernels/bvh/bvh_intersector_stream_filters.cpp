@@ -8,6 +8,171 @@ namespace embree
 {
   namespace isa
   {
+    __forceinline void invokeUserGeometry(AccelSet* accel, const vbool<VSIZEX>& valid, RayHitK<VSIZEX>& ray, unsigned int geomID, unsigned int primID, IntersectContext* context) {
+      accel->intersect(valid,ray,geomID,primID,context);
+    }
+
+    __forceinline void invokeUserGeometry(AccelSet* accel, const vbool<VSIZEX>& valid, RayK<VSIZEX>& ray, unsigned int geomID, unsigned int primID, IntersectContext* context) {
+      accel->occluded(valid,ray,geomID,primID,context);
+    }
+
+    template<int K, bool intersect>
+    __noinline void RayStreamFilter::invokeDeferredUserGeometry(Scene* scene, UserGeometryQueue& queue, IntersectContext* context)
+    {
+      /* sort ray/primitive pairs by primitive, a ray reaching a primitive through multiple leaves invokes the callback once */
+      UserGeometryQueue::Item* items = queue.items;
+      std::sort(items, items+queue.size(), [] (const UserGeometryQueue::Item& a, const UserGeometryQueue::Item& b) {
+          if (a.geomID != b.geomID) return a.geomID < b.geomID;
+          if (a.primID != b.primID) return a.primID < b.primID;
+          return a.rayID < b.rayID;
+        });
+
+      __aligned(64) RayTypeK<VSIZEX, intersect> batch;
+      unsigned int rayIDs[VSIZEX];
+
+      for (size_t i=0; i<queue.size(); )
+      {
+        const unsigned int geomID = items[i].geomID;
+        const unsigned int primID = items[i].primID;
+        AccelSet* accel = (AccelSet*) scene->get(geomID);
+
+        while (i<queue.size() && items[i].geomID == geomID && items[i].primID == primID)
+        {
+          /* gather up to VSIZEX rays that reached this primitive */
+          size_t num = 0;
+          for (; num<VSIZEX && i<queue.size() && items[i].geomID == geomID && items[i].primID == primID; i++)
+          {
+            const unsigned int rayID = items[i].rayID;
+            if (num > 0 && rayIDs[num-1] == rayID) continue;
+            RayTypeK<1, intersect> ray;
+            ((RayTypeK<K, intersect>*) queue.packets[rayID / K])->get(rayID % K, ray);
+            if (!intersect && ray.tfar < 0.0f) continue; // already occluded
+            batch.set(num, ray);
+            rayIDs[num++] = rayID;
+          }
+          if (num == 0) continue;
+
+          /* invoke the callback and scatter the results back into the stream */
+          const vbool<VSIZEX> valid = vint<VSIZEX>(step) < vint<VSIZEX>(int(num));
+          invokeUserGeometry(accel,valid,batch,geomID,primID,context);
+          for (size_t k=0; k<num; k++) {
+            RayTypeK<1, intersect> ray;
+            batch.get(k, ray);
+            ((RayTypeK<K, intersect>*) queue.packets[rayIDs[k] / K])->set(rayIDs[k] % K, ray);
+          }
+        }
+      }
+      queue.clear();
+    }
+
+    template<int K, bool intersect>
+    __forceinline void RayStreamFilter::traceStream(Scene* scene, RayTypeK<K, intersect>** rayPtrs, size_t numRays, IntersectContext* context)
+    {
+      if (likely(!context->defersUserGeometry())) {
+        scene->intersectors.intersectN(rayPtrs, numRays, context);
+        return;
+      }
+
+      /* record user geometry candidates during traversal and invoke the callbacks in batches afterwards */
+      UserGeometryQueue queue((void* const*)rayPtrs, (numRays+K-1) / K);
+      context->userGeometryQueue = &queue;
+      scene->intersectors.intersectN(rayPtrs, numRays, context);
+      context->userGeometryQueue = nullptr;
+      invokeDeferredUserGeometry<K, intersect>(scene, queue, context);
+    }
+
+    /* coherence of a stream above which coherent stream traversal is used, and below which rays get traced one by one */
+    static const float COHERENT_STREAM_THRESHOLD = 0.5f;
+    static const float SINGLE_RAY_THRESHOLD = 0.05f;
+
+    /* number of rays sampled to measure the coherence of a stream */
+    static const size_t COHERENCE_SAMPLES = 32;
+
+    /* shift of the thresholds towards the mode selected for the previous stream, which avoids switching on single outliers */
+    static const float COHERENCE_HYSTERESIS = 0.1f;
+
+    enum class TraversalMode { COHERENT, PACKET, SINGLE_RAY };
+
+    /* scene and traversal mode of the previous stream traced by this thread */
+    static __thread Scene* previous_scene = nullptr;
+    static __thread TraversalMode previous_mode = TraversalMode::PACKET;
+
+    /* selects the traversal mode of a stream, streams with adaptive coherence measure the spread of
+     * origins and directions of some sample rays, the mode of the previous stream of the calling
+     * thread for the same scene shifts the thresholds */
+    template<typename GetRay>
+    __forceinline TraversalMode selectTraversalMode(Scene* scene, IntersectContext* context, size_t N, bool singleRays, const GetRay& getRay)
+    {
+      if (likely(!context->hasAdaptiveCoherence()))
+        return context->isCoherent() ? TraversalMode::COHERENT : TraversalMode::PACKET;
+
+      Vec3fa dirs[COHERENCE_SAMPLES];
+      size_t numDirs = 0;
+      Vec3fa sumDir(zero);
+      BBox3fa orgBounds(empty);
+      const size_t step = max(N / COHERENCE_SAMPLES, size_t(1));
+      for (size_t i = 0; i < N && numDirs < COHERENCE_SAMPLES; i += step)
+      {
+        Vec3fa org, dir;
+        getRay(i, org, dir);
+        const float len = length(dir);
+        if (!(len > 0.0f && len < float(inf))) continue;
+        dirs[numDirs++] = dir / len;
+        sumDir += dir / len;
+        orgBounds.extend(org);
+      }
+
+      float coherence = 0.0f;
+      const float sumLen = length(sumDir);
+      if (numDirs > 0 && sumLen > 0.0f)
+      {
+        const Vec3fa meanDir = sumDir / sumLen;
+        float minCos = 1.0f;
+        for (size_t i = 0; i < numDirs; i++)
+          minCos = min(minCos, dot(dirs[i], meanDir));
+
+        /* origins spread over a large part of the scene diverge quickly even for similar directions */
+        const BBox3fa sceneBounds = scene->bounds.bounds();
+        const float sceneSize = sceneBounds.empty() ? 0.0f : length(sceneBounds.size());
+        const float orgSize = length(orgBounds.size());
+        const float orgCoherence = sceneSize > 0.0f ? clamp(1.0f - 4.0f * orgSize / sceneSize, 0.0f, 1.0f) : 1.0f;
+        coherence = max(minCos, 0.0f) * orgCoherence;
+      }
+
+      /* the history is kept per thread, thus threads tracing different workloads do not influence each other */
+      float coherentThreshold = COHERENT_STREAM_THRESHOLD;
+      float singleRayThreshold = SINGLE_RAY_THRESHOLD;
+      if (previous_scene == scene) {
+        if (previous_mode == TraversalMode::COHERENT)   coherentThreshold -= COHERENCE_HYSTERESIS;
+        if (previous_mode == TraversalMode::SINGLE_RAY) singleRayThreshold += COHERENCE_HYSTERESIS;
+      }
+
+      TraversalMode mode = TraversalMode::PACKET;
+      if (coherence >= coherentThreshold)
+        mode = TraversalMode::COHERENT;
+      else if (coherence < singleRayThreshold && singleRays)
+        mode = TraversalMode::SINGLE_RAY;
+
+      previous_scene = scene;
+      previous_mode = mode;
+
+      Scene::TraversalStatistics& stats = scene->traversal_statistics;
+      stats.coherence.store(coherence);
+
+      switch (mode) {
+      case TraversalMode::COHERENT  : stats.numCoherentStreams++; break;
+      case TraversalMode::PACKET    : stats.numPacketStreams++; break;
+      case TraversalMode::SINGLE_RAY: stats.numSingleRayStreams++; break;
+      }
+
+      /* the traversal kernels select their code paths through the coherence flag of the context */
+      if (mode == TraversalMode::COHERENT)
+        context->flags = (RTCIntersectContextFlags)(context->flags | RTC_INTERSECT_CONTEXT_FLAG_COHERENT);
+      else
+        context->flags = (RTCIntersectContextFlags)(context->flags & ~RTC_INTERSECT_CONTEXT_FLAG_COHERENT);
+      return mode;
+    }
+
     template<int K, bool intersect>
     __noinline void RayStreamFilter::filterAOS(Scene* scene, void* _rayN, size_t N, size_t stride, IntersectContext* context)
     {
@@ -40,7 +205,7 @@ namespace embree
           }
 
           /* trace stream */
-          scene->intersectors.intersectN(rayPtrs, size, context);
+          traceStream<K, intersect>(scene, rayPtrs, size, context);
 
           /* convert from SOA to AOS */
           for (size_t j = 0; j < size; j += K)
@@ -119,7 +284,7 @@ namespace embree
             ray.tfar  = select(valid, ray.tfar,  neg_inf);
           }
 
-          scene->intersectors.occludedN(rayPtrs, numOctantRays, context);
+          traceStream<K, false>(scene, rayPtrs, numOctantRays, context);
 
           for (unsigned int j = 0; j < numOctantRays; j += K)
           {
@@ -182,7 +347,7 @@ namespace embree
           }
 
           /* trace stream */
-          scene->intersectors.intersectN(rayPtrs, size, context);
+          traceStream<K, intersect>(scene, rayPtrs, size, context);
 
           /* convert from SOA to AOP */
           for (size_t j = 0; j < size; j += K)
@@ -261,7 +426,7 @@ namespace embree
             ray.tfar  = select(valid, ray.tfar,  neg_inf);
           }
 
-          scene->intersectors.occludedN(rayPtrs, numOctantRays, context);
+          traceStream<K, false>(scene, rayPtrs, numOctantRays, context);
 
           for (unsigned int j = 0; j < numOctantRays; j += K)
           {
@@ -318,7 +483,7 @@ namespace embree
             if (unlikely(packetIndex == MAX_INTERNAL_STREAM_SIZE / K))
             {
               const size_t size = packetIndex*K;
-              scene->intersectors.intersectN(rayPtrs, size, context);
+              traceStream<K, intersect>(scene, rayPtrs, size, context);
               packetIndex = 0;
             }
           }
@@ -327,7 +492,7 @@ namespace embree
           if (unlikely(packetIndex > 0))
           {
             const size_t size = packetIndex*K;
-            scene->intersectors.intersectN(rayPtrs, size, context);
+            traceStream<K, intersect>(scene, rayPtrs, size, context);
           }
         }
         else if (unlikely(!intersect))
@@ -399,7 +564,7 @@ namespace embree
               ray.tfar  = select(valid, ray.tfar,  neg_inf);
             }
 
-            scene->intersectors.occludedN(rayPtrs, numOctantRays, context);
+            traceStream<K, false>(scene, rayPtrs, numOctantRays, context);
 
             for (unsigned int j = 0; j < numOctantRays; j += K)
             {
@@ -479,7 +644,7 @@ namespace embree
           }
 
           /* trace stream */
-          scene->intersectors.intersectN(rayPtrs, size, context);
+          traceStream<K, intersect>(scene, rayPtrs, size, context);
 
           /* convert from SOA to SOP */
           for (size_t j = 0; j < size; j += K)
@@ -559,7 +724,7 @@ namespace embree
             ray.tfar  = select(valid, ray.tfar,  neg_inf);
           }
 
-          scene->intersectors.occludedN(rayPtrs, numOctantRays, context);
+          traceStream<K, false>(scene, rayPtrs, numOctantRays, context);
 
           for (unsigned int j = 0; j < numOctantRays; j += K)
           {
@@ -592,66 +757,326 @@ namespace embree
     }
 
 
-    void RayStreamFilter::intersectAOS(Scene* scene, RTCRayHit* _rayN, size_t N, size_t stride, IntersectContext* context) {
-      if (unlikely(context->isCoherent()))
+    void RayStreamFilter::intersectAOS(Scene* scene, RTCRayHit* _rayN, size_t N, size_t stride, IntersectContext* context)
+    {
+      const TraversalMode mode = selectTraversalMode(scene, context, N, true, [&] (size_t i, Vec3fa& org, Vec3fa& dir) {
+          const RTCRay& ray = ((RTCRayHit*)((char*)_rayN + i*stride))->ray;
+          org = Vec3fa(ray.org_x, ray.org_y, ray.org_z);
+          dir = Vec3fa(ray.dir_x, ray.dir_y, ray.dir_z);
+        });
+
+      if (unlikely(mode == TraversalMode::COHERENT))
         filterAOS<VSIZEL, true>(scene, _rayN, N, stride, context);
+      else if (unlikely(mode == TraversalMode::SINGLE_RAY))
+      {
+        for (size_t i = 0; i < N; i++)
+        {
+          RTCRayHit& ray = *(RTCRayHit*)((char*)_rayN + i*stride);
+          if (likely(ray.ray.tnear <= ray.ray.tfar))
+            scene->intersectors.intersect(ray, context);
+        }
+      }
       else
         filterAOS<VSIZEX, true>(scene, _rayN, N, stride, context);
     }
 
-    void RayStreamFilter::occludedAOS(Scene* scene, RTCRay* _rayN, size_t N, size_t stride, IntersectContext* context) {
-      if (unlikely(context->isCoherent()))
+    void RayStreamFilter::occludedAOS(Scene* scene, RTCRay* _rayN, size_t N, size_t stride, IntersectContext* context)
+    {
+      const TraversalMode mode = selectTraversalMode(scene, context, N, true, [&] (size_t i, Vec3fa& org, Vec3fa& dir) {
+          const RTCRay& ray = *(RTCRay*)((char*)_rayN + i*stride);
+          org = Vec3fa(ray.org_x, ray.org_y, ray.org_z);
+          dir = Vec3fa(ray.dir_x, ray.dir_y, ray.dir_z);
+        });
+
+      if (unlikely(mode == TraversalMode::COHERENT))
         filterAOS<VSIZEL, false>(scene, _rayN, N, stride, context);
+      else if (unlikely(mode == TraversalMode::SINGLE_RAY))
+      {
+        for (size_t i = 0; i < N; i++)
+        {
+          RTCRay& ray = *(RTCRay*)((char*)_rayN + i*stride);
+          if (likely(ray.tnear <= ray.tfar))
+            scene->intersectors.occluded(ray, context);
+        }
+      }
       else
         filterAOS<VSIZEX, false>(scene, _rayN, N, stride, context);
     }
 
-    void RayStreamFilter::intersectAOP(Scene* scene, RTCRayHit** _rayN, size_t N, IntersectContext* context) {
-      if (unlikely(context->isCoherent()))
+    void RayStreamFilter::intersectAOP(Scene* scene, RTCRayHit** _rayN, size_t N, IntersectContext* context)
+    {
+      const TraversalMode mode = selectTraversalMode(scene, context, N, true, [&] (size_t i, Vec3fa& org, Vec3fa& dir) {
+          const RTCRay& ray = _rayN[i]->ray;
+          org = Vec3fa(ray.org_x, ray.org_y, ray.org_z);
+          dir = Vec3fa(ray.dir_x, ray.dir_y, ray.dir_z);
+        });
+
+      if (unlikely(mode == TraversalMode::COHERENT))
         filterAOP<VSIZEL, true>(scene, (void**)_rayN, N, context);
+      else if (unlikely(mode == TraversalMode::SINGLE_RAY))
+      {
+        for (size_t i = 0; i < N; i++)
+        {
+          RTCRayHit& ray = *_rayN[i];
+          if (likely(ray.ray.tnear <= ray.ray.tfar))
+            scene->intersectors.intersect(ray, context);
+        }
+      }
       else
         filterAOP<VSIZEX, true>(scene, (void**)_rayN, N, context);
     }
 
-    void RayStreamFilter::occludedAOP(Scene* scene, RTCRay** _rayN, size_t N, IntersectContext* context) {
-      if (unlikely(context->isCoherent()))
+    void RayStreamFilter::occludedAOP(Scene* scene, RTCRay** _rayN, size_t N, IntersectContext* context)
+    {
+      const TraversalMode mode = selectTraversalMode(scene, context, N, true, [&] (size_t i, Vec3fa& org, Vec3fa& dir) {
+          const RTCRay& ray = *_rayN[i];
+          org = Vec3fa(ray.org_x, ray.org_y, ray.org_z);
+          dir = Vec3fa(ray.dir_x, ray.dir_y, ray.dir_z);
+        });
+
+      if (unlikely(mode == TraversalMode::COHERENT))
         filterAOP<VSIZEL, false>(scene, (void**)_rayN, N, context);
+      else if (unlikely(mode == TraversalMode::SINGLE_RAY))
+      {
+        for (size_t i = 0; i < N; i++)
+        {
+          RTCRay& ray = *_rayN[i];
+          if (likely(ray.tnear <= ray.tfar))
+            scene->intersectors.occluded(ray, context);
+        }
+      }
       else
         filterAOP<VSIZEX, false>(scene, (void**)_rayN, N, context);
     }
 
-    void RayStreamFilter::intersectSOA(Scene* scene, char* rayData, size_t N, size_t numPackets, size_t stride, IntersectContext* context) {
-      if (unlikely(context->isCoherent()))
+    /* rays of SOA and SOP streams are not stored as single rays, thus these streams use packets instead of single rays */
+    void RayStreamFilter::intersectSOA(Scene* scene, char* rayData, size_t N, size_t numPackets, size_t stride, IntersectContext* context)
+    {
+      const TraversalMode mode = selectTraversalMode(scene, context, N*numPackets, false, [&] (size_t i, Vec3fa& org, Vec3fa& dir) {
+          RTCRayN* ray = (RTCRayN*)(rayData + (i/N)*stride);
+          org = Vec3fa(RTCRayN_org_x(ray,N,i%N), RTCRayN_org_y(ray,N,i%N), RTCRayN_org_z(ray,N,i%N));
+          dir = Vec3fa(RTCRayN_dir_x(ray,N,i%N), RTCRayN_dir_y(ray,N,i%N), RTCRayN_dir_z(ray,N,i%N));
+        });
+
+      if (unlikely(mode == TraversalMode::COHERENT))
         filterSOA<VSIZEL, true>(scene, rayData, N, numPackets, stride, context);
       else
         filterSOA<VSIZEX, true>(scene, rayData, N, numPackets, stride, context);
     }
 
-    void RayStreamFilter::occludedSOA(Scene* scene, char* rayData, size_t N, size_t numPackets, size_t stride, IntersectContext* context) {
-      if (unlikely(context->isCoherent()))
+    void RayStreamFilter::occludedSOA(Scene* scene, char* rayData, size_t N, size_t numPackets, size_t stride, IntersectContext* context)
+    {
+      const TraversalMode mode = selectTraversalMode(scene, context, N*numPackets, false, [&] (size_t i, Vec3fa& org, Vec3fa& dir) {
+          RTCRayN* ray = (RTCRayN*)(rayData + (i/N)*stride);
+          org = Vec3fa(RTCRayN_org_x(ray,N,i%N), RTCRayN_org_y(ray,N,i%N), RTCRayN_org_z(ray,N,i%N));
+          dir = Vec3fa(RTCRayN_dir_x(ray,N,i%N), RTCRayN_dir_y(ray,N,i%N), RTCRayN_dir_z(ray,N,i%N));
+        });
+
+      if (unlikely(mode == TraversalMode::COHERENT))
         filterSOA<VSIZEL, false>(scene, rayData, N, numPackets, stride, context);
       else
         filterSOA<VSIZEX, false>(scene, rayData, N, numPackets, stride, context);
     }
 
-    void RayStreamFilter::intersectSOP(Scene* scene, const RTCRayHitNp* _rayN, size_t N, IntersectContext* context) {
-      if (unlikely(context->isCoherent()))
+    void RayStreamFilter::intersectSOP(Scene* scene, const RTCRayHitNp* _rayN, size_t N, IntersectContext* context)
+    {
+      const TraversalMode mode = selectTraversalMode(scene, context, N, false, [&] (size_t i, Vec3fa& org, Vec3fa& dir) {
+          const RTCRayNp& ray = _rayN->ray;
+          org = Vec3fa(ray.org_x[i], ray.org_y[i], ray.org_z[i]);
+          dir = Vec3fa(ray.dir_x[i], ray.dir_y[i], ray.dir_z[i]);
+        });
+
+      if (unlikely(mode == TraversalMode::COHERENT))
         filterSOP<VSIZEL, true>(scene, _rayN, N, context);
       else
         filterSOP<VSIZEX, true>(scene, _rayN, N, context);
     }
 
-    void RayStreamFilter::occludedSOP(Scene* scene, const RTCRayNp* _rayN, size_t N, IntersectContext* context) {
-      if (unlikely(context->isCoherent()))
+    void RayStreamFilter::occludedSOP(Scene* scene, const RTCRayNp* _rayN, size_t N, IntersectContext* context)
+    {
+      const TraversalMode mode = selectTraversalMode(scene, context, N, false, [&] (size_t i, Vec3fa& org, Vec3fa& dir) {
+          org = Vec3fa(_rayN->org_x[i], _rayN->org_y[i], _rayN->org_z[i]);
+          dir = Vec3fa(_rayN->dir_x[i], _rayN->dir_y[i], _rayN->dir_z[i]);
+        });
+
+      if (unlikely(mode == TraversalMode::COHERENT))
         filterSOP<VSIZEL, false>(scene, _rayN, N, context);
       else
         filterSOP<VSIZEX, false>(scene, _rayN, N, context);
     }
 
 
+    /* number of shadow rays grouped at once, and minimal number of rays sharing an end point to form a group */
+    static const size_t SHADOW_BATCH_SIZE = 1024;
+    static const size_t MIN_SHADOW_GROUP_SIZE = 4;
+
+    /* occlusion is symmetric for meshes without filter functions, thus rays ending in a shared point can get traced backwards from it */
+    __forceinline bool canReverseShadowRays(Scene* scene, IntersectContext* context)
+    {
+#if defined(EMBREE_BACKFACE_CULLING)
+      return false;
+#else
+      if (scene->hasFilterFunction() || context->user->filter) return false;
+      const Geometry::GTypeMask mask = Geometry::GTypeMask(Geometry::MTY_CURVES | Geometry::MTY_USER_GEOMETRY | Geometry::MTY_INSTANCE);
+      return scene->getNumPrimitives(mask,false) + scene->getNumPrimitives(mask,true) == 0;
+#endif
+    }
+
+    /* hashes the grid cell containing a point */
+    __forceinline uint64_t shadowGroupKey(const Vec3fa& p, float rcpCellSize)
+    {
+      const uint64_t x = (uint64_t) (int64_t) floorf(p.x * rcpCellSize);
+      const uint64_t y = (uint64_t) (int64_t) floorf(p.y * rcpCellSize);
+      const uint64_t z = (uint64_t) (int64_t) floorf(p.z * rcpCellSize);
+      return (x * 73856093) ^ (y * 19349663) ^ (z * 83492791);
+    }
+
+    template<int K>
+    __noinline void RayStreamFilter::traceShadowGroup(Scene* scene, RTCRay* _rayN, size_t stride, const unsigned int* rayIDs, size_t numRays, bool reverse, IntersectContext* context)
+    {
+      RayStreamAOS rayN(_rayN);
+
+      __aligned(64) unsigned int octants[8][MAX_INTERNAL_STREAM_SIZE];
+      __aligned(64) RayK<K> rays[MAX_INTERNAL_STREAM_SIZE / K];
+      __aligned(64) RayK<K>* rayPtrs[MAX_INTERNAL_STREAM_SIZE / K];
+
+      unsigned int raysInOctant[8];
+      for (unsigned int i = 0; i < 8; i++)
+        raysInOctant[i] = 0;
+
+      auto traceOctant = [&] (unsigned int octantID)
+      {
+        const unsigned int* const octantRayIDs = &octants[octantID][0];
+        const unsigned int numOctantRays = raysInOctant[octantID];
+
+        for (unsigned int j = 0; j < numOctantRays; j += K)
+        {
+          const vint<K> vi = vint<K>(int(j)) + vint<K>(step);
+          const vbool<K> valid = vi < vint<K>(int(numOctantRays));
+          const vint<K> offset = *(vint<K>*)&octantRayIDs[j] * int(stride);
+          RayK<K>& ray = rays[j/K];
+          rayPtrs[j/K] = &ray;
+          ray = rayN.getRayByOffset<K>(valid, offset);
+
+          /* trace the segment backwards starting at its end point */
+          if (reverse)
+          {
+            ray.org = ray.org + ray.tfar * ray.dir;
+            ray.dir = -ray.dir;
+            ray.tfar = ray.tfar - ray.tnear();
+            ray.tnear() = 0.0f;
+          }
+          ray.tnear() = select(valid, ray.tnear(), zero);
+          ray.tfar  = select(valid, ray.tfar,  neg_inf);
+        }
+
+        traceStream<K, false>(scene, rayPtrs, numOctantRays, context);
+
+        for (unsigned int j = 0; j < numOctantRays; j += K)
+        {
+          const vint<K> vi = vint<K>(int(j)) + vint<K>(step);
+          const vbool<K> valid = vi < vint<K>(int(numOctantRays));
+          const vint<K> offset = *(vint<K>*)&octantRayIDs[j] * int(stride);
+          rayN.setHitByOffset<K>(valid, offset, rays[j/K]);
+        }
+        raysInOctant[octantID] = 0;
+      };
+
+      /* sort rays into octants */
+      for (size_t i = 0; i < numRays; i++)
+      {
+        const Ray& ray = rayN.getRayByOffset(rayIDs[i] * stride);
+        const Vec3fa dir = reverse ? -Vec3fa(ray.dir) : Vec3fa(ray.dir);
+        const unsigned int octantID = movemask(vfloat4(dir) < 0.0f) & 0x7;
+        octants[octantID][raysInOctant[octantID]++] = rayIDs[i];
+        if (unlikely(raysInOctant[octantID] == MAX_INTERNAL_STREAM_SIZE))
+          traceOctant(octantID);
+      }
+
+      for (unsigned int i = 0; i < 8; i++)
+        if (raysInOctant[i]) traceOctant(i);
+    }
+
+    void RayStreamFilter::occludedShadowAOS(Scene* scene, RTCRay* _rayN, size_t N, size_t stride, IntersectContext* context)
+    {
+      RayStreamAOS rayN(_rayN);
+      const RTCIntersectContextFlags flags = context->flags;
+      const bool reverse = canReverseShadowRays(scene, context);
+
+      /* end points within the same grid cell count as shared */
+      const BBox3fa sceneBounds = scene->bounds.bounds();
+      const float sceneSize = sceneBounds.empty() ? 0.0f : length(sceneBounds.size());
+      const float rcpCellSize = sceneSize > 0.0f ? 1000.0f / sceneSize : 1.0f;
+
+      __aligned(64) std::pair<uint64_t, unsigned int> keys[SHADOW_BATCH_SIZE];
+      __aligned(64) unsigned int groupIDs[SHADOW_BATCH_SIZE];
+      __aligned(64) unsigned int restIDs[SHADOW_BATCH_SIZE];
+      __aligned(64) unsigned int infiniteIDs[SHADOW_BATCH_SIZE];
+
+      /* traces runs of rays with equal key as coherent groups, and returns the other rays */
+      auto traceGroups = [&] (size_t numKeys, bool reverseGroups) -> size_t
+      {
+        std::sort(keys, keys+numKeys);
+        size_t numRest = 0;
+        for (size_t i = 0; i < numKeys; )
+        {
+          size_t end = i+1;
+          while (end < numKeys && keys[end].first == keys[i].first) end++;
+          if (end-i >= MIN_SHADOW_GROUP_SIZE)
+          {
+            for (size_t j = i; j < end; j++) groupIDs[j-i] = keys[j].second;
+            context->flags = (RTCIntersectContextFlags)(flags | RTC_INTERSECT_CONTEXT_FLAG_COHERENT);
+            traceShadowGroup<VSIZEL>(scene, _rayN, stride, groupIDs, end-i, reverseGroups, context);
+          }
+          else {
+            for (size_t j = i; j < end; j++) restIDs[numRest++] = keys[j].second;
+          }
+          i = end;
+        }
+        return numRest;
+      };
+
+      for (size_t i = 0; i < N; i += SHADOW_BATCH_SIZE)
+      {
+        const size_t size = min(N - i, SHADOW_BATCH_SIZE);
+
+        /* group rays by shared target, e.g. rays towards the same light sample */
+        size_t numKeys = 0;
+        size_t numInfinite = 0;
+        for (size_t j = i; j < i+size; j++)
+        {
+          const Ray& ray = rayN.getRayByOffset(j * stride);
+          if (unlikely(ray.tnear() > ray.tfar || ray.tfar < 0.0f)) continue; // ignore invalid or already occluded rays
+#if defined(EMBREE_IGNORE_INVALID_RAYS)
+          if (unlikely(!ray.valid())) continue;
+#endif
+          const Vec3fa target = Vec3fa(ray.org) + ray.tfar * Vec3fa(ray.dir);
+          if (likely(isvalid(target)))
+            keys[numKeys++] = std::make_pair(shadowGroupKey(target, rcpCellSize), (unsigned int)j);
+          else
+            infiniteIDs[numInfinite++] = (unsigned int)j;
+        }
+        const size_t numTargetRest = traceGroups(numKeys, reverse);
+
+        /* group the remaining rays by shared origin, e.g. rays from the same shading point towards different lights */
+        numKeys = 0;
+        for (size_t j = 0; j < numTargetRest; j++)
+          keys[numKeys++] = std::make_pair(shadowGroupKey(Vec3fa(rayN.getRayByOffset(restIDs[j] * stride).org), rcpCellSize), restIDs[j]);
+        for (size_t j = 0; j < numInfinite; j++)
+          keys[numKeys++] = std::make_pair(shadowGroupKey(Vec3fa(rayN.getRayByOffset(infiniteIDs[j] * stride).org), rcpCellSize), infiniteIDs[j]);
+        const size_t numRest = traceGroups(numKeys, false);
+
+        /* trace all other rays as incoherent stream */
+        context->flags = (RTCIntersectContextFlags)(flags & ~RTC_INTERSECT_CONTEXT_FLAG_COHERENT);
+        traceShadowGroup<VSIZEX>(scene, _rayN, stride, restIDs, numRest, false, context);
+      }
+      context->flags = flags;
+    }
+
     RayStreamFilterFuncs rayStreamFilterFuncs() {
       return RayStreamFilterFuncs(RayStreamFilter::intersectAOS, RayStreamFilter::intersectAOP, RayStreamFilter::intersectSOA, RayStreamFilter::intersectSOP,
-                                  RayStreamFilter::occludedAOS,  RayStreamFilter::occludedAOP,  RayStreamFilter::occludedSOA,  RayStreamFilter::occludedSOP);
+                                  RayStreamFilter::occludedAOS,  RayStreamFilter::occludedAOP,  RayStreamFilter::occludedSOA,  RayStreamFilter::occludedSOP,
+                                  RayStreamFilter::occludedShadowAOS);
     }
   };
 };
@@ -24,6 +24,8 @@ namespace embree
       static void occludedSOA(Scene* scene, char* rays, size_t N, size_t numPackets, size_t stride, IntersectContext* context);
       static void occludedSOP(Scene* scene, const RTCRayNp* rays, size_t N, IntersectContext* context);
 
+      static void occludedShadowAOS(Scene* scene, RTCRay* rays, size_t N, size_t stride, IntersectContext* context);
+
     private:
       template<int K, bool intersect>
       static void filterAOS(Scene* scene, void* rays, size_t N, size_t stride, IntersectContext* context);
@@ -36,6 +38,15 @@ namespace embree
 
       template<int K, bool intersect>
       static void filterSOP(Scene* scene, const void* rays, size_t N, IntersectContext* context);
+
+      template<int K, bool intersect>
+      static void traceStream(Scene* scene, RayTypeK<K, intersect>** rayPtrs, size_t numRays, IntersectContext* context);
+
+      template<int K>
+      static void traceShadowGroup(Scene* scene, RTCRay* rays, size_t stride, const unsigned int* rayIDs, size_t numRays, bool reverse, IntersectContext* context);
+
+      template<int K, bool intersect>
+      static void invokeDeferredUserGeometry(Scene* scene, UserGeometryQueue& queue, IntersectContext* context);
     };
   }
 };
@@ -210,6 +210,16 @@ namespace embree
           statQuantizedNodes.size();
       }
 
+      size_t numNodes() const 
+      {
+        return statAABBNodes.numNodes + 
+          statOBBNodes.numNodes + 
+          statAABBNodesMB.numNodes + 
+          statAABBNodesMB4D.numNodes + 
+          statOBBNodesMB.numNodes + 
+          statQuantizedNodes.numNodes;
+      }
+
       double fillRate (BVH* bvh) const 
       {
         double nom = statLeaf.fillRateNom(bvh) +
@@ -272,6 +282,14 @@ namespace embree
       return stat.bytes(bvh);
     }
 
+    size_t numNodes() const {
+      return stat.numNodes();
+    }
+
+    size_t numTimeSplitNodes() const {
+      return stat.statAABBNodesMB4D.numNodes;
+    }
+
   private:
     Statistics statistics(NodeRef node, const double A, const BBox1f dt);
 
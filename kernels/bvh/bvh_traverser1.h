@@ -9,10 +9,36 @@
 
 #define NEW_SORTING_CODE 1
 
+/* number of cache lines of leaf data to prefetch for pushed leaves when
+ * EMBREE_TRAVERSAL_PREFETCH is enabled, wider ISAs use larger leaves */
+#if defined(__AVX512F__)
+#  define TRAVERSAL_PREFETCH_LEAF_LINES 4
+#elif defined(__AVX__)
+#  define TRAVERSAL_PREFETCH_LEAF_LINES 3
+#else
+#  define TRAVERSAL_PREFETCH_LEAF_LINES 2
+#endif
+
 namespace embree
 {
   namespace isa
   {
+    /*! Speculatively prefetches the primitive block of a leaf that was
+     *  pushed onto the traversal stack. Inner nodes are already
+     *  prefetched by the node traverser. Returns true if a prefetch got
+     *  issued. */
+    template<typename Primitive, typename NodeRef>
+    __forceinline bool prefetchPushedLeaf(const NodeRef ref)
+    {
+      if (!ref.isLeaf()) return false;
+      size_t num; const char* ptr = (const char*)ref.leaf(num);
+      if (num == 0) return false;
+      const size_t lines = min(size_t(TRAVERSAL_PREFETCH_LEAF_LINES),(num*sizeof(Primitive)+63)/64);
+      for (size_t i=0; i<lines; i++)
+        prefetchL2(ptr+i*64);
+      return true;
+    }
+
     /*! BVH regular node traversal for single rays. */
     template<int N, int types>
     class BVHNNodeTraverser1Hit;
@@ -29,6 +29,23 @@ namespace embree
     /*! clears the acceleration structure data */
     virtual void clear() = 0;
 
+    /*! returns the expected cost of tracing a ray that hits the bounds, 0 if unknown */
+    virtual double sah() { return 0.0; }
+
+    /*! memory of acceleration structures and how much of it is backed by huge pages */
+    struct MemoryStatistics
+    {
+      MemoryStatistics ()
+        : bytesAllocated(0), bytesHugePages(0), bytesAdvised(0) {}
+
+      size_t bytesAllocated;  //!< bytes allocated by the acceleration structures
+      size_t bytesHugePages;  //!< bytes backed by explicit 2MB or 1GB huge pages
+      size_t bytesAdvised;    //!< bytes of 4KB pages marked for transparent huge page use
+    };
+
+    /*! adds the memory of the acceleration structure to the statistics */
+    virtual void addMemoryStatistics(MemoryStatistics& stat) {}
+
     /*! returns normal bounds */
     __forceinline BBox3fa getBounds() const {
       return bounds.bounds();
@@ -272,6 +289,10 @@ namespace embree
 
       void select(bool filter)
       {
+        if (intersector1_filter) {
+          if (filter) intersector1 = intersector1_filter;
+          else        intersector1 = intersector1_nofilter;
+        }
         if (intersector4_filter) {
           if (filter) intersector4 = intersector4_filter;
           else        intersector4 = intersector4_nofilter;
@@ -304,24 +325,40 @@ namespace embree
       /*! Intersects a single ray with the scene. */
       __forceinline void intersect (RTCRayHit& ray, IntersectContext* context) {
         assert(intersector1.intersect);
+        if (unlikely(context->hasNoFilter()) && intersector1_nofilter) {
+          intersector1_nofilter.intersect(this,ray,context);
+          return;
+        }
         intersector1.intersect(this,ray,context);
       }
 
       /*! Intersects a packet of 4 rays with the scene. */
       __forceinline void intersect4 (const void* valid, RTCRayHit4& ray, IntersectContext* context) {
         assert(intersector4.intersect);
+        if (unlikely(context->hasNoFilter()) && intersector4_nofilter) {
+          intersector4_nofilter.intersect(valid,this,ray,context);
+          return;
+        }
         intersector4.intersect(valid,this,ray,context);
       }
       
       /*! Intersects a packet of 8 rays with the scene. */
       __forceinline void intersect8 (const void* valid, RTCRayHit8& ray, IntersectContext* context) {
         assert(intersector8.intersect);
+        if (unlikely(context->hasNoFilter()) && intersector8_nofilter) {
+          intersector8_nofilter.intersect(valid,this,ray,context);
+          return;
+        }
         intersector8.intersect(valid,this,ray,context);
       }
       
       /*! Intersects a packet of 16 rays with the scene. */
       __forceinline void intersect16 (const void* valid, RTCRayHit16& ray, IntersectContext* context) {
         assert(intersector16.intersect);
+        if (unlikely(context->hasNoFilter()) && intersector16_nofilter) {
+          intersector16_nofilter.intersect(valid,this,ray,context);
+          return;
+        }
         intersector16.intersect(valid,this,ray,context);
       }
       
@@ -329,6 +366,10 @@ namespace embree
       __forceinline void intersectN (RTCRayHitN** rayN, const size_t N, IntersectContext* context)
       {
         assert(intersectorN.intersect);
+        if (unlikely(context->hasNoFilter()) && intersectorN_nofilter) {
+          intersectorN_nofilter.intersect(this,rayN,N,context);
+          return;
+        }
         intersectorN.intersect(this,rayN,N,context);
       }
       
@@ -360,24 +401,40 @@ namespace embree
       /*! Tests if single ray is occluded by the scene. */
       __forceinline void occluded (RTCRay& ray, IntersectContext* context) {
         assert(intersector1.occluded);
+        if (unlikely(context->hasNoFilter()) && intersector1_nofilter) {
+          intersector1_nofilter.occluded(this,ray,context);
+          return;
+        }
         intersector1.occluded(this,ray,context);
       }
       
       /*! Tests if a packet of 4 rays is occluded by the scene. */
       __forceinline void occluded4 (const void* valid, RTCRay4& ray, IntersectContext* context) {
         assert(intersector4.occluded);
+        if (unlikely(context->hasNoFilter()) && intersector4_nofilter) {
+          intersector4_nofilter.occluded(valid,this,ray,context);
+          return;
+        }
         intersector4.occluded(valid,this,ray,context);
       }
       
       /*! Tests if a packet of 8 rays is occluded by the scene. */
       __forceinline void occluded8 (const void* valid, RTCRay8& ray, IntersectContext* context) {
         assert(intersector8.occluded);
+        if (unlikely(context->hasNoFilter()) && intersector8_nofilter) {
+          intersector8_nofilter.occluded(valid,this,ray,context);
+          return;
+        }
         intersector8.occluded(valid,this,ray,context);
       }
       
       /*! Tests if a packet of 16 rays is occluded by the scene. */
       __forceinline void occluded16 (const void* valid, RTCRay16& ray, IntersectContext* context) {
         assert(intersector16.occluded);
+        if (unlikely(context->hasNoFilter()) && intersector16_nofilter) {
+          intersector16_nofilter.occluded(valid,this,ray,context);
+          return;
+        }
         intersector16.occluded(valid,this,ray,context);
       }
       
@@ -385,6 +442,10 @@ namespace embree
       __forceinline void occludedN (RTCRayN** rayN, const size_t N, IntersectContext* context)
       {
         assert(intersectorN.occluded);
+        if (unlikely(context->hasNoFilter()) && intersectorN_nofilter) {
+          intersectorN_nofilter.occluded(this,rayN,N,context);
+          return;
+        }
         intersectorN.occluded(this,rayN,N,context);
       }
       
@@ -435,6 +496,8 @@ namespace embree
       void* leafIntersector;
       Collider collider;
       Intersector1 intersector1;
+      Intersector1 intersector1_filter;
+      Intersector1 intersector1_nofilter;
       Intersector4 intersector4;
       Intersector4 intersector4_filter;
       Intersector4 intersector4_nofilter;
@@ -468,6 +531,9 @@ namespace embree
     /*! build acceleration structure */
     virtual void build () = 0;
 
+    /*! builds the acceleration structures of individual geometries only */
+    virtual void prebuild () {}
+
   public:
     Intersectors intersectors;
   };
@@ -524,21 +590,26 @@ namespace embree
   typedef void (*occludedStreamAOP_func)(Scene* scene, RTCRay** _rayN, const size_t N, IntersectContext* context);
   typedef void (*occludedStreamSOA_func)(Scene* scene, char* rayN, const size_t N, const size_t streams, const size_t stream_offset, IntersectContext* context);
   typedef void (*occludedStreamSOP_func)(Scene* scene, const RTCRayNp* rayN, const size_t N, IntersectContext* context);
+  typedef void (*occludedShadowStreamAOS_func)(Scene* scene, RTCRay* _rayN, const size_t N, const size_t stride, IntersectContext* context);
 
   struct RayStreamFilterFuncs
   {
     RayStreamFilterFuncs()
     : intersectAOS(nullptr), intersectAOP(nullptr), intersectSOA(nullptr), intersectSOP(nullptr),
-      occludedAOS(nullptr),  occludedAOP(nullptr),  occludedSOA(nullptr),  occludedSOP(nullptr) {}
+      occludedAOS(nullptr),  occludedAOP(nullptr),  occludedSOA(nullptr),  occludedSOP(nullptr),
+      occludedShadowAOS(nullptr) {}
 
     RayStreamFilterFuncs(void (*ptr) ())
     : intersectAOS((intersectStreamAOS_func) ptr), intersectAOP((intersectStreamAOP_func) ptr), intersectSOA((intersectStreamSOA_func) ptr), intersectSOP((intersectStreamSOP_func) ptr),
-      occludedAOS((occludedStreamAOS_func) ptr),   occludedAOP((occludedStreamAOP_func) ptr),   occludedSOA((occludedStreamSOA_func) ptr),   occludedSOP((occludedStreamSOP_func) ptr) {}
+      occludedAOS((occludedStreamAOS_func) ptr),   occludedAOP((occludedStreamAOP_func) ptr),   occludedSOA((occludedStreamSOA_func) ptr),   occludedSOP((occludedStreamSOP_func) ptr),
+      occludedShadowAOS((occludedShadowStreamAOS_func) ptr) {}
 
     RayStreamFilterFuncs(intersectStreamAOS_func intersectAOS, intersectStreamAOP_func intersectAOP, intersectStreamSOA_func intersectSOA, intersectStreamSOP_func intersectSOP,
-                         occludedStreamAOS_func  occludedAOS,  occludedStreamAOP_func  occludedAOP,  occludedStreamSOA_func  occludedSOA,  occludedStreamSOP_func  occludedSOP)
+                         occludedStreamAOS_func  occludedAOS,  occludedStreamAOP_func  occludedAOP,  occludedStreamSOA_func  occludedSOA,  occludedStreamSOP_func  occludedSOP,
+                         occludedShadowStreamAOS_func occludedShadowAOS)
     : intersectAOS(intersectAOS), intersectAOP(intersectAOP), intersectSOA(intersectSOA), intersectSOP(intersectSOP),
-      occludedAOS(occludedAOS),   occludedAOP(occludedAOP),   occludedSOA(occludedSOA),   occludedSOP(occludedSOP) {}
+      occludedAOS(occludedAOS),   occludedAOP(occludedAOP),   occludedSOA(occludedSOA),   occludedSOP(occludedSOP),
+      occludedShadowAOS(occludedShadowAOS) {}
 
   public:
     intersectStreamAOS_func intersectAOS;
@@ -550,6 +621,8 @@ namespace embree
     occludedStreamAOP_func occludedAOP;
     occludedStreamSOA_func occludedSOA;
     occludedStreamSOP_func occludedSOP;
+
+    occludedShadowStreamAOS_func occludedShadowAOS;
   }; 
 
   typedef RayStreamFilterFuncs (*RayStreamFilterFuncsType)();
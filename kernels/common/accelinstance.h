@@ -24,6 +24,10 @@ namespace embree
       bounds = accel->bounds;
     }
 
+    void prebuild () {
+      if (builder) builder->prebuild();
+    }
+
     void deleteGeometry(size_t geomID) {
       if (accel  ) accel->deleteGeometry(geomID);
       if (builder) builder->deleteGeometry(geomID);
@@ -34,6 +38,14 @@ namespace embree
       if (builder) builder->clear();
     }
 
+    double sah() {
+      return accel ? accel->sah() : 0.0;
+    }
+
+    void addMemoryStatistics(MemoryStatistics& stat) {
+      if (accel) accel->addMemoryStatistics(stat);
+    }
+
   private:
     std::unique_ptr<AccelData> accel;
     std::unique_ptr<Builder> builder;
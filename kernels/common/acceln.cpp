@@ -9,10 +9,11 @@
 namespace embree
 {
   AccelN::AccelN()
-    : Accel(AccelData::TY_ACCELN), accels() {}
+    : Accel(AccelData::TY_ACCELN), accels(), double_buffered(false), front(nullptr), active(nullptr) {}
 
   AccelN::~AccelN() 
   {
+    delete front;
     for (size_t i=0; i<accels.size(); i++)
       delete accels[i];
   }
@@ -150,6 +151,101 @@ namespace embree
         This->accels[i]->intersectors.occludedN(ray,M,context);
   }
 
+  bool AccelN::pointQueryBuffered (Accel::Intersectors* This_in, PointQuery* query, PointQueryContext* context)
+  {
+    AccelN* This = (AccelN*)This_in->ptr;
+    return This->active.load()->pointQuery(query,context);
+  }
+
+  void AccelN::intersectBuffered (Accel::Intersectors* This_in, RTCRayHit& ray, IntersectContext* context)
+  {
+    AccelN* This = (AccelN*)This_in->ptr;
+    This->active.load()->intersect(ray,context);
+  }
+
+  /* the active buffer may not support the packet size, thus we fall back to single rays */
+  template<int K>
+  __forceinline void intersect1K (Accel::Intersectors* active, const void* valid, RayHitK<K>& ray, IntersectContext* context)
+  {
+    for (size_t i=0; i<K; i++) {
+      if (!((const int*)valid)[i]) continue;
+      RayHit ray1; ray.get(i,ray1);
+      active->intersect((RTCRayHit&)ray1,context);
+      ray.set(i,ray1);
+    }
+  }
+
+  template<int K>
+  __forceinline void occluded1K (Accel::Intersectors* active, const void* valid, RayK<K>& ray, IntersectContext* context)
+  {
+    for (size_t i=0; i<K; i++) {
+      if (!((const int*)valid)[i]) continue;
+      Ray ray1; ray.get(i,ray1);
+      active->occluded((RTCRay&)ray1,context);
+      ray.set(i,ray1);
+    }
+  }
+
+  void AccelN::intersect4Buffered (const void* valid, Accel::Intersectors* This_in, RTCRayHit4& ray, IntersectContext* context)
+  {
+    Accel::Intersectors* active = ((AccelN*)This_in->ptr)->active.load();
+    if (likely(active->intersector4)) active->intersect4(valid,ray,context);
+    else intersect1K<4>(active,valid,(RayHit4&)ray,context);
+  }
+
+  void AccelN::intersect8Buffered (const void* valid, Accel::Intersectors* This_in, RTCRayHit8& ray, IntersectContext* context)
+  {
+    Accel::Intersectors* active = ((AccelN*)This_in->ptr)->active.load();
+    if (likely(active->intersector8)) active->intersect8(valid,ray,context);
+    else intersect1K<8>(active,valid,(RayHit8&)ray,context);
+  }
+
+  void AccelN::intersect16Buffered (const void* valid, Accel::Intersectors* This_in, RTCRayHit16& ray, IntersectContext* context)
+  {
+    Accel::Intersectors* active = ((AccelN*)This_in->ptr)->active.load();
+    if (likely(active->intersector16)) active->intersect16(valid,ray,context);
+    else intersect1K<16>(active,valid,(RayHit16&)ray,context);
+  }
+
+  void AccelN::intersectNBuffered (Accel::Intersectors* This_in, RTCRayHitN** ray, const size_t N, IntersectContext* context)
+  {
+    AccelN* This = (AccelN*)This_in->ptr;
+    This->active.load()->intersectN(ray,N,context);
+  }
+
+  void AccelN::occludedBuffered (Accel::Intersectors* This_in, RTCRay& ray, IntersectContext* context)
+  {
+    AccelN* This = (AccelN*)This_in->ptr;
+    This->active.load()->occluded(ray,context);
+  }
+
+  void AccelN::occluded4Buffered (const void* valid, Accel::Intersectors* This_in, RTCRay4& ray, IntersectContext* context)
+  {
+    Accel::Intersectors* active = ((AccelN*)This_in->ptr)->active.load();
+    if (likely(active->intersector4)) active->occluded4(valid,ray,context);
+    else occluded1K<4>(active,valid,(Ray4&)ray,context);
+  }
+
+  void AccelN::occluded8Buffered (const void* valid, Accel::Intersectors* This_in, RTCRay8& ray, IntersectContext* context)
+  {
+    Accel::Intersectors* active = ((AccelN*)This_in->ptr)->active.load();
+    if (likely(active->intersector8)) active->occluded8(valid,ray,context);
+    else occluded1K<8>(active,valid,(Ray8&)ray,context);
+  }
+
+  void AccelN::occluded16Buffered (const void* valid, Accel::Intersectors* This_in, RTCRay16& ray, IntersectContext* context)
+  {
+    Accel::Intersectors* active = ((AccelN*)This_in->ptr)->active.load();
+    if (likely(active->intersector16)) active->occluded16(valid,ray,context);
+    else occluded1K<16>(active,valid,(Ray16&)ray,context);
+  }
+
+  void AccelN::occludedNBuffered (Accel::Intersectors* This_in, RTCRayN** ray, const size_t N, IntersectContext* context)
+  {
+    AccelN* This = (AccelN*)This_in->ptr;
+    This->active.load()->occludedN(ray,N,context);
+  }
+
   void AccelN::accels_print(size_t ident)
   {
     for (size_t i=0; i<accels.size(); i++)
@@ -188,28 +284,39 @@ namespace embree
       valid16 &= (bool) accels[i]->intersectors.intersector16;
     }
 
+    /* when double buffered rays still traverse the front buffer */
+    Accel::Intersectors& isects = double_buffered ? built : intersectors;
+    LBBox3fa& ibounds = double_buffered ? built_bounds : bounds;
+    
     if (accels.size() == 1) {
       type = accels[0]->type; // FIXME: should just assign entire Accel
-      bounds = accels[0]->bounds;
-      intersectors = accels[0]->intersectors;
+      ibounds = accels[0]->bounds;
+      isects = accels[0]->intersectors;
     }
     else 
     {
       type = AccelData::TY_ACCELN;
-      intersectors.ptr = this;
-      intersectors.intersector1  = Intersector1(&intersect,&occluded,&pointQuery,valid1 ? "AccelN::intersector1": nullptr);
-      intersectors.intersector4  = Intersector4(&intersect4,&occluded4,valid4 ? "AccelN::intersector4" : nullptr);
-      intersectors.intersector8  = Intersector8(&intersect8,&occluded8,valid8 ? "AccelN::intersector8" : nullptr);
-      intersectors.intersector16 = Intersector16(&intersect16,&occluded16,valid16 ? "AccelN::intersector16": nullptr);
-      intersectors.intersectorN  = IntersectorN(&intersectN,&occludedN,"AccelN::intersectorN");
+      isects.ptr = this;
+      isects.intersector1  = Intersector1(&intersect,&occluded,&pointQuery,valid1 ? "AccelN::intersector1": nullptr);
+      isects.intersector4  = Intersector4(&intersect4,&occluded4,valid4 ? "AccelN::intersector4" : nullptr);
+      isects.intersector8  = Intersector8(&intersect8,&occluded8,valid8 ? "AccelN::intersector8" : nullptr);
+      isects.intersector16 = Intersector16(&intersect16,&occluded16,valid16 ? "AccelN::intersector16": nullptr);
+      isects.intersectorN  = IntersectorN(&intersectN,&occludedN,"AccelN::intersectorN");
 
       /*! calculate bounds */
-      bounds = empty;
+      ibounds = empty;
       for (size_t i=0; i<accels.size(); i++) 
-        bounds.extend(accels[i]->bounds);
+        ibounds.extend(accels[i]->bounds);
     }
   }
 
+  void AccelN::accels_prebuild () 
+  {
+    parallel_for (accels.size(), [&] (size_t i) { 
+        accels[i]->prebuild();
+      });
+  }
+
   void AccelN::accels_select(bool filter)
   {
     for (size_t i=0; i<accels.size(); i++) 
@@ -222,11 +329,92 @@ namespace embree
       accels[i]->deleteGeometry(geomID);
   }
 
+  /*! front buffer of a double buffered AccelN, it only gets traversed */
+  class AccelNFrontBuffer : public AccelN
+  {
+  public:
+    void build () {}
+    void clear () {}
+  };
+
+  void AccelN::accels_double_buffer ()
+  {
+    Accel::Intersectors* current = double_buffered ? active.load() : &intersectors;
+
+    /* rays still traverse the front buffer if the last build failed */
+    if (front && current == &front->intersectors) {
+      accels_init();
+      return;
+    }
+
+    /* rays cannot traverse the previous front buffer anymore */
+    delete front;
+    front = new AccelNFrontBuffer;
+    front->accels.swap(accels);
+    front->type = type;
+    front->bounds = bounds;
+    front->intersectors = *current;
+    if (front->intersectors.ptr == this)
+      front->intersectors.ptr = front;
+    active.store(&front->intersectors);
+
+    if (double_buffered)
+      return;
+    
+    /* forward rays to the active buffer */
+    double_buffered = true;
+    intersectors = Accel::Intersectors();
+    intersectors.ptr = this;
+    intersectors.intersector1  = Intersector1(&intersectBuffered,&occludedBuffered,&pointQueryBuffered,"AccelN::intersector1Buffered");
+    intersectors.intersector4  = Intersector4(&intersect4Buffered,&occluded4Buffered,"AccelN::intersector4Buffered");
+    intersectors.intersector8  = Intersector8(&intersect8Buffered,&occluded8Buffered,"AccelN::intersector8Buffered");
+    intersectors.intersector16 = Intersector16(&intersect16Buffered,&occluded16Buffered,"AccelN::intersector16Buffered");
+    intersectors.intersectorN  = IntersectorN(&intersectNBuffered,&occludedNBuffered,"AccelN::intersectorNBuffered");
+  }
+
+  void AccelN::accels_swap_buffers ()
+  {
+    assert(double_buffered);
+    bounds = built_bounds;
+    active.store(&built);
+  }
+
+  void AccelN::accels_single_buffer ()
+  {
+    if (!double_buffered)
+      return;
+    
+    double_buffered = false;
+    intersectors = built;
+    bounds = built_bounds;
+    active.store(nullptr);
+    delete front; front = nullptr;
+  }
+
   void AccelN::accels_clear()
   {
     for (size_t i=0; i<accels.size(); i++) {
       accels[i]->clear();
     }
   }
+
+  double AccelN::sah()
+  {
+    /* weight each acceleration structure by the probability of hitting its bounds */
+    const float A = halfArea(getBounds());
+    double cost = 0.0;
+    for (size_t i=0; i<accels.size(); i++) {
+      if (accels[i]->isEmpty()) continue;
+      const float Ai = halfArea(accels[i]->getBounds());
+      cost += accels[i]->sah() * (A > 0.0f ? double(Ai)/double(A) : 1.0);
+    }
+    return cost;
+  }
+
+  void AccelN::addMemoryStatistics(MemoryStatistics& stat)
+  {
+    for (size_t i=0; i<accels.size(); i++)
+      accels[i]->addMemoryStatistics(stat);
+  }
 }
 
@@ -35,15 +35,52 @@ namespace embree
     static void occluded16 (const void* valid, Accel::Intersectors* This, RTCRay16& ray, IntersectContext* context);
     static void occludedN (Accel::Intersectors* This, RTCRayN** ray, const size_t N, IntersectContext* context);
 
+  public:
+    /* forward rays to the active buffer when double buffered */
+    static bool pointQueryBuffered (Accel::Intersectors* This, PointQuery* query, PointQueryContext* context);
+    static void intersectBuffered (Accel::Intersectors* This, RTCRayHit& ray, IntersectContext* context);
+    static void intersect4Buffered (const void* valid, Accel::Intersectors* This, RTCRayHit4& ray, IntersectContext* context);
+    static void intersect8Buffered (const void* valid, Accel::Intersectors* This, RTCRayHit8& ray, IntersectContext* context);
+    static void intersect16Buffered (const void* valid, Accel::Intersectors* This, RTCRayHit16& ray, IntersectContext* context);
+    static void intersectNBuffered (Accel::Intersectors* This, RTCRayHitN** ray, const size_t N, IntersectContext* context);
+    static void occludedBuffered (Accel::Intersectors* This, RTCRay& ray, IntersectContext* context);
+    static void occluded4Buffered (const void* valid, Accel::Intersectors* This, RTCRay4& ray, IntersectContext* context);
+    static void occluded8Buffered (const void* valid, Accel::Intersectors* This, RTCRay8& ray, IntersectContext* context);
+    static void occluded16Buffered (const void* valid, Accel::Intersectors* This, RTCRay16& ray, IntersectContext* context);
+    static void occludedNBuffered (Accel::Intersectors* This, RTCRayN** ray, const size_t N, IntersectContext* context);
+
   public:
     void accels_print(size_t ident);
     void accels_immutable();
     void accels_build ();
+    void accels_prebuild ();
     void accels_select(bool filter);
     void accels_deleteGeometry(size_t geomID);
     void accels_clear ();
 
+    /*! returns the expected cost of tracing a ray through all acceleration structures */
+    double sah();
+
+    /*! adds the memory of all acceleration structures to the statistics */
+    void addMemoryStatistics(MemoryStatistics& stat);
+
+  public:
+    /*! moves the current acceleration structures into the front buffer, rays traverse them while new ones get built */
+    void accels_double_buffer ();
+
+    /*! atomically switches rays over to the newly built acceleration structures */
+    void accels_swap_buffers ();
+
+    /*! releases the front buffer and traverses the acceleration structures directly again */
+    void accels_single_buffer ();
+
   public:
     std::vector<Accel*> accels;
+
+    bool double_buffered;                          //!< true if rays get forwarded to the active buffer
+    AccelN* front;                                 //!< previous acceleration structures, traversed while the accels get rebuilt
+    Accel::Intersectors built;                     //!< intersectors of the accels when double buffered
+    LBBox3fa built_bounds;                         //!< bounds of the accels when double buffered
+    std::atomic<Accel::Intersectors*> active;      //!< intersectors rays get forwarded to when double buffered
   };
 }
@@ -125,6 +125,23 @@ namespace embree
         return true;
       }
 
+      /*! Splits the bounds of an item at the specified plane, returns false if no split function is set */
+      __forceinline bool split(size_t i, const BBox3fa& bounds, size_t dim, float pos, BBox3fa& left_o, BBox3fa& right_o) const
+      {
+        if (!splitFunc) return false;
+        assert(i < size());
+        RTCSplitFunctionArguments args;
+        args.geometryUserPtr = userPtr;
+        args.primID = (unsigned int)i;
+        args.dimension = (unsigned int)dim;
+        args.position = pos;
+        args.bounds = (const RTCBounds*)&bounds;
+        args.leftBounds_o = (RTCBounds*)&left_o;
+        args.rightBounds_o = (RTCBounds*)&right_o;
+        splitFunc(&args);
+        return true;
+      }
+
       /* gets version info of topology */
       unsigned int getTopologyVersion() const {
         return numPrimitives;
@@ -221,6 +238,7 @@ namespace embree
 
     public:
       RTCBoundsFunction boundsFunc;
+      RTCSplitFunction splitFunc;
       IntersectorN intersectorN;
   };
   
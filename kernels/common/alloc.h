@@ -632,6 +632,17 @@ namespace embree
       return Statistics(this,atype,huge_pages);
     }
 
+    /*! returns the number of allocated bytes that are marked for transparent huge page use */
+    size_t getAdvisedBytes()
+    {
+      Block* usedBlocks = this->usedBlocks.load();
+      Block* freeBlocks = this->freeBlocks.load();
+      size_t bytes = 0;
+      if (usedBlocks) bytes += usedBlocks->getAdvisedBytes();
+      if (freeBlocks) bytes += freeBlocks->getAdvisedBytes();
+      return bytes;
+    }
+
     size_t getUsedBytes() {
       return bytesUsed;
     }
@@ -705,7 +716,7 @@ namespace embree
      
         std::cout << "  total : " << stat_all.str(numPrimitives) << std::endl;
         std::cout << "  4K    : " << stat_4K.str(numPrimitives) << std::endl;
-        std::cout << "  2M    : " << stat_2M.str(numPrimitives) << std::endl;
+        std::cout << "  huge  : " << stat_2M.str(numPrimitives) << std::endl;
         std::cout << "  malloc: " << stat_malloc.str(numPrimitives) << std::endl;
         std::cout << "  shared: " << stat_shared.str(numPrimitives) << std::endl;
       }
@@ -781,6 +792,11 @@ namespace embree
             const size_t alignment = maxAlignment;
             if (device) device->memoryMonitor(bytesAllocate+alignment,false);
             ptr = alignedMalloc(bytesAllocate,alignment);
+
+            /* give hint to transparently convert large blocks to 2MB pages */
+            if (bytesAllocate >= PAGE_SIZE_2M)
+              os_advise(ptr,bytesAllocate);
+
             return new (ptr) Block(ALIGNED_MALLOC,bytesAllocate-sizeof_Header,bytesAllocate-sizeof_Header,next,alignment);
           }
         }
@@ -889,6 +905,22 @@ namespace embree
       size_t getBlockReservedBytes() const {
         return reserveEnd;
       }
+
+      /* returns the number of allocated bytes marked for transparent huge page use in create */
+      size_t getBlockAdvisedBytes() const
+      {
+        const size_t sizeof_Header = offsetof(Block,data[0]);
+        const size_t bytes = sizeof_Header+getBlockAllocatedBytes();
+        if (atype == EMBREE_OS_MALLOC && !huge_pages)
+          return os_advised_bytes((void*)this,bytes);
+
+        /* blocks of the default size additionally mark the 2MB pages they partially cover */
+        if (atype == ALIGNED_MALLOC && bytes == 2*PAGE_SIZE_2M)
+          return os_advised_bytes((void*)this,bytes) ? bytes : 0;
+        if (atype == ALIGNED_MALLOC && bytes >= PAGE_SIZE_2M)
+          return os_advised_bytes((void*)this,bytes);
+        return 0;
+      }
   
       bool hasType(AllocationType atype_i, bool huge_pages_i) const
       {
@@ -933,6 +965,13 @@ namespace embree
         return bytes;
       }
 
+      size_t getAdvisedBytes() const {
+        size_t bytes = 0;
+        for (const Block* block = this; block; block = block->next)
+          bytes += block->getBlockAdvisedBytes();
+        return bytes;
+      }
+
       void print_list ()
       {
         for (const Block* block = this; block; block = block->next)
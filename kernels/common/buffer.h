@@ -8,6 +8,33 @@
 
 namespace embree
 {
+  /*! checks if vertex positions of that format have to get decoded before use */
+  __forceinline bool isCompactVertexFormat(RTCFormat format) {
+    return format == RTC_FORMAT_HALF3 || format == RTC_FORMAT_SHORT3;
+  }
+
+  /*! checks if elements of that format only need to be 2 bytes aligned */
+  __forceinline bool is16BitFormat(RTCFormat format) {
+    return (format >= RTC_FORMAT_USHORT && format <= RTC_FORMAT_SHORT4) || (format >= RTC_FORMAT_HALF && format <= RTC_FORMAT_HALF4);
+  }
+
+  /*! converts a half precision float to single precision */
+  __forceinline float half_to_float(unsigned short h)
+  {
+    const unsigned int sign = (unsigned int)(h & 0x8000) << 16;
+    const unsigned int exponent = (h >> 10) & 0x1f;
+    const unsigned int mantissa = h & 0x3ff;
+    if (exponent == 0) { // zero and denormals
+      const float f = float(mantissa)*(1.0f/16777216.0f);
+      return sign ? -f : f;
+    }
+    unsigned int bits = sign | (mantissa << 13);
+    if (exponent == 31) bits |= 0x7f800000;  // infinity and NaN
+    else                bits |= (exponent+112) << 23;
+    float f; memcpy(&f,&bits,sizeof(float));
+    return f;
+  }
+
   /*! Implements an API data buffer object. This class may or may not own the data. */
   class Buffer : public RefCount
   {
@@ -259,5 +286,21 @@ namespace embree
       assert(i<num);
       vfloat4::storeu((float*)(ptr_ofs + i*stride), (vfloat4)v);
     }
+
+    /*! decodes and dequantizes the i'th element of a half or 16-bit normalized buffer */
+    __forceinline const Vec3fa decode(size_t i, const Vec3fa& scale, const Vec3fa& offset) const
+    {
+      assert(i<num);
+      assert(isCompactVertexFormat(format));
+      Vec3fa v;
+      if (format == RTC_FORMAT_HALF3) {
+        const unsigned short* h = (const unsigned short*)(ptr_ofs + i*stride);
+        v = Vec3fa(half_to_float(h[0]),half_to_float(h[1]),half_to_float(h[2]));
+      } else {
+        const short* s = (const short*)(ptr_ofs + i*stride);
+        v = max(Vec3fa(float(s[0]),float(s[1]),float(s[2]))*Vec3fa(1.0f/32767.0f),Vec3fa(-1.0f));
+      }
+      return madd(v,scale,offset);
+    }
   };
 }
@@ -19,6 +19,9 @@ namespace embree
     /*! initiates the hierarchy builder */
     virtual void build() = 0;
 
+    /*! builds the hierarchies of individual geometries without the top level hierarchy */
+    virtual void prebuild() {};
+
     /*! notifies the builder about the deletion of some geometry */
     virtual void deleteGeometry(size_t geomID) {};
 
@@ -11,27 +11,90 @@ namespace embree
 {
   class Scene;
 
+  /*! Ray/user primitive pairs recorded while tracing a ray stream. The
+   *  user geometry callbacks get invoked after traversal, once for each
+   *  batch of rays that reached the same primitive. */
+  struct UserGeometryQueue
+  {
+    struct Item
+    {
+      unsigned int geomID;
+      unsigned int primID;
+      unsigned int rayID;  //!< index of the ray inside the traced stream
+    };
+
+    static const size_t MAX_PACKETS = 32;
+    static const size_t MAX_ITEMS = 512;
+
+    __forceinline UserGeometryQueue(void* const* packetPtrs, size_t numPackets)
+      : numPackets(numPackets), numItems(0)
+    {
+      assert(numPackets <= MAX_PACKETS);
+      for (size_t i=0; i<numPackets; i++) packets[i] = packetPtrs[i];
+    }
+
+    /*! records the active rays of a packet, fails if the packet is not part of the stream or the queue is full */
+    template<int K>
+    __forceinline bool push(const vbool<K>& valid, void* packet, unsigned int geomID, unsigned int primID)
+    {
+      size_t packetID = 0;
+      while (packetID < numPackets && packets[packetID] != packet) packetID++;
+      if (unlikely(packetID == numPackets)) return false;
+      if (unlikely(numItems + popcnt(valid) > MAX_ITEMS)) return false;
+      for (size_t m=movemask(valid), k=bsf(m); m!=0; m=btc(m,k), k=bsf(m)) {
+        Item& item = items[numItems++];
+        item.geomID = geomID;
+        item.primID = primID;
+        item.rayID = unsigned(packetID*K+k);
+      }
+      return true;
+    }
+
+    __forceinline size_t size() const { return numItems; }
+    __forceinline void clear() { numItems = 0; }
+
+  public:
+    void* packets[MAX_PACKETS];  //!< packets of the traced stream, in their original order
+    size_t numPackets;
+    size_t numItems;
+    Item items[MAX_ITEMS];
+  };
+
   struct IntersectContext
   {
   public:
     __forceinline IntersectContext(Scene* scene, RTCIntersectContext* user_context)
-      : scene(scene), user(user_context) {}
+      : scene(scene), user(user_context), flags(user_context ? user_context->flags : RTC_INTERSECT_CONTEXT_FLAG_NONE), userGeometryQueue(nullptr) {}
 
     __forceinline bool hasContextFilter() const {
       return user->filter != nullptr;
     }
 
     __forceinline bool isCoherent() const {
-      return embree::isCoherent(user->flags);
+      return embree::isCoherent(flags);
     }
 
     __forceinline bool isIncoherent() const {
-      return embree::isIncoherent(user->flags);
+      return embree::isIncoherent(flags);
+    }
+
+    __forceinline bool hasNoFilter() const {
+      return flags & RTC_INTERSECT_CONTEXT_FLAG_NO_FILTER;
+    }
+
+    __forceinline bool defersUserGeometry() const {
+      return flags & RTC_INTERSECT_CONTEXT_FLAG_DEFER_USER_GEOMETRY;
+    }
+
+    __forceinline bool hasAdaptiveCoherence() const {
+      return flags & RTC_INTERSECT_CONTEXT_FLAG_ADAPTIVE_COHERENCE;
     }
     
   public:
     Scene* scene;
     RTCIntersectContext* user;
+    RTCIntersectContextFlags flags;       //!< flags of the user context, ray streams with adaptive coherence override the coherence flag
+    UserGeometryQueue* userGeometryQueue; //!< set while tracing a stream with deferred user geometry callbacks
   };
 
   template<int M, typename Geometry>
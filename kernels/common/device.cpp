@@ -93,7 +93,7 @@ namespace embree
     if (State::enable_selockmemoryprivilege)
       State::hugepages_success &= win_enable_selockmemoryprivilege(State::verbosity(3));
 #endif
-    State::hugepages_success &= os_init(State::hugepages,State::verbosity(3));
+    State::hugepages_success &= os_init(State::hugepages,State::hugepages_1g,State::verbosity(3));
     
     /*! set tessellation cache size */
     setCacheSize( State::tessellation_cache_size );
@@ -554,6 +554,8 @@ namespace embree
     case RTC_DEVICE_PROPERTY_PARALLEL_COMMIT_SUPPORTED: return 0;
 #endif
 
+    case RTC_DEVICE_PROPERTY_BUILD_PRIMREF_BYTES: return g_build_primref_bytes;
+
     default: throw_RTCError(RTC_ERROR_INVALID_ARGUMENT, "unknown readable property"); break;
     };
   }
@@ -358,6 +358,11 @@ namespace embree
       throw_RTCError(RTC_ERROR_INVALID_OPERATION,"operation not supported for this geometry"); 
     }
 
+    /*! Sets the transformation that dequantizes compact vertex formats. */
+    virtual void setVertexDequantization(const Vec3fa& scale, const Vec3fa& offset) {
+      throw_RTCError(RTC_ERROR_INVALID_OPERATION,"operation not supported for this geometry");
+    }
+
     /*! Set user data pointer. */
     virtual void setUserData(void* ptr);
       
@@ -374,6 +379,11 @@ namespace embree
     /*! interpolates user data to the specified u/v locations */
     virtual void interpolateN(const RTCInterpolateNArguments* const args);
 
+    /*! checks if all floats of a buffer can get addressed by the 32 bit offsets of SIMD gathers */
+    static __forceinline bool isGatherable(size_t num, size_t stride) {
+      return stride % sizeof(float) == 0 && num*stride <= size_t(std::numeric_limits<int>::max())*sizeof(float);
+    }
+
     /* point query api */
     bool pointQuery(PointQuery* query, PointQueryContext* context);
 
@@ -455,6 +465,11 @@ namespace embree
       throw_RTCError(RTC_ERROR_INVALID_OPERATION,"operation not supported for this geometry");
     }
 
+    /*! Sets the double precision origin of the instance */
+    virtual void setInstanceOrigin(const Vec3d& origin) {
+      throw_RTCError(RTC_ERROR_INVALID_OPERATION,"operation not supported for this geometry");
+    }
+
     /*! Sets transformation of the instance */
     virtual void setTransform(const AffineSpace3fa& transform, unsigned int timeStep) {
       throw_RTCError(RTC_ERROR_INVALID_OPERATION,"operation not supported for this geometry"); 
@@ -478,6 +493,11 @@ namespace embree
       throw_RTCError(RTC_ERROR_INVALID_OPERATION,"operation not supported for this geometry"); 
     }
 
+    /*! Set spatial split function. */
+    virtual void setSplitFunction (RTCSplitFunction split) { 
+      throw_RTCError(RTC_ERROR_INVALID_OPERATION,"operation not supported for this geometry"); 
+    }
+
     /*! Set intersect function for ray packets of size N. */
     virtual void setIntersectFunctionN (RTCIntersectFunctionN intersect) { 
       throw_RTCError(RTC_ERROR_INVALID_OPERATION,"operation not supported for this geometry"); 
@@ -203,6 +203,17 @@ RTC_NAMESPACE_BEGIN;
     RTC_CATCH_END2(scene);
   }
 
+  RTC_API void rtcSetSceneOrigin (RTCScene hscene, const double* origin)
+  {
+    Scene* scene = (Scene*) hscene;
+    RTC_CATCH_BEGIN;
+    RTC_TRACE(rtcSetSceneOrigin);
+    RTC_VERIFY_HANDLE(hscene);
+    RTC_VERIFY_HANDLE(origin);
+    scene->setOrigin(Vec3d(origin[0],origin[1],origin[2]));
+    RTC_CATCH_END2(scene);
+  }
+
   RTC_API void rtcSetSceneFlags (RTCScene hscene, RTCSceneFlags flags) 
   {
     Scene* scene = (Scene*) hscene;
@@ -230,6 +241,7 @@ RTC_NAMESPACE_BEGIN;
     RTC_CATCH_BEGIN;
     RTC_TRACE(rtcCommitScene);
     RTC_VERIFY_HANDLE(hscene);
+    scene->waitCommitAsync();
     scene->commit(false);
     RTC_CATCH_END2(scene);
   }
@@ -240,7 +252,28 @@ RTC_NAMESPACE_BEGIN;
     RTC_CATCH_BEGIN;
     RTC_TRACE(rtcJoinCommitScene);
     RTC_VERIFY_HANDLE(hscene);
-    scene->commit(true);
+    scene->joinCommit();
+    RTC_CATCH_END2(scene);
+  }
+
+  RTC_API void rtcCommitSceneProgressive (RTCScene hscene) 
+  {
+    Scene* scene = (Scene*) hscene;
+    RTC_CATCH_BEGIN;
+    RTC_TRACE(rtcCommitSceneProgressive);
+    RTC_VERIFY_HANDLE(hscene);
+    scene->waitCommitAsync();
+    scene->commit(false,true);
+    RTC_CATCH_END2(scene);
+  }
+
+  RTC_API void rtcCommitSceneAsync (RTCScene hscene, RTCCommitSceneCompletedFunction completed, void* ptr) 
+  {
+    Scene* scene = (Scene*) hscene;
+    RTC_CATCH_BEGIN;
+    RTC_TRACE(rtcCommitSceneAsync);
+    RTC_VERIFY_HANDLE(hscene);
+    scene->commitAsync(completed,ptr);
     RTC_CATCH_END2(scene);
   }
 
@@ -250,7 +283,7 @@ RTC_NAMESPACE_BEGIN;
     RTC_CATCH_BEGIN;
     RTC_TRACE(rtcGetSceneBounds);
     RTC_VERIFY_HANDLE(hscene);
-    if (scene->isModified()) throw_RTCError(RTC_ERROR_INVALID_OPERATION,"scene not committed");
+    if (scene->isModified() && !scene->isCommitAsyncPending()) throw_RTCError(RTC_ERROR_INVALID_OPERATION,"scene not committed");
     BBox3fa bounds = scene->bounds.bounds();
     bounds_o->lower_x = bounds.lower.x;
     bounds_o->lower_y = bounds.lower.y;
@@ -271,7 +304,7 @@ RTC_NAMESPACE_BEGIN;
     RTC_VERIFY_HANDLE(hscene);
     if (bounds_o == nullptr)
       throw_RTCError(RTC_ERROR_INVALID_OPERATION,"invalid destination pointer");
-    if (scene->isModified())
+    if (scene->isModified() && !scene->isCommitAsyncPending())
       throw_RTCError(RTC_ERROR_INVALID_OPERATION,"scene not committed");
     
     bounds_o->bounds0.lower_x = scene->bounds.bounds0.lower.x;
@@ -293,6 +326,23 @@ RTC_NAMESPACE_BEGIN;
     RTC_CATCH_END2(scene);
   }
 
+  RTC_API void rtcGetSceneTraversalStatistics(RTCScene hscene, RTCSceneTraversalStatistics* statistics_o)
+  {
+    Scene* scene = (Scene*) hscene;
+    RTC_CATCH_BEGIN;
+    RTC_TRACE(rtcGetSceneTraversalStatistics);
+    RTC_VERIFY_HANDLE(hscene);
+    if (statistics_o == nullptr)
+      throw_RTCError(RTC_ERROR_INVALID_OPERATION,"invalid destination pointer");
+
+    const Scene::TraversalStatistics& stats = scene->traversal_statistics;
+    statistics_o->coherence = max(stats.coherence.load(),0.0f);
+    statistics_o->coherentStreamCount = stats.numCoherentStreams;
+    statistics_o->packetStreamCount = stats.numPacketStreams;
+    statistics_o->singleRayStreamCount = stats.numSingleRayStreams;
+    RTC_CATCH_END2(scene);
+  }
+
   RTC_API void rtcCollide (RTCScene hscene0, RTCScene hscene1, RTCCollideFunc callback, void* userPtr)
   {
     Scene* scene0 = (Scene*) hscene0;
@@ -842,6 +892,35 @@ RTC_NAMESPACE_BEGIN;
     RTC_CATCH_END2(scene);
   }
 
+  RTC_API void rtcOccludedShadow1M(RTCScene hscene, RTCIntersectContext* user_context, RTCRay* ray, unsigned int M, size_t byteStride) 
+  {
+    Scene* scene = (Scene*) hscene;
+    RTC_CATCH_BEGIN;
+    RTC_TRACE(rtcOccludedShadow1M);
+
+#if defined (EMBREE_RAY_PACKETS)
+#if defined(DEBUG)
+    RTC_VERIFY_HANDLE(hscene);
+    if (scene->isModified()) throw_RTCError(RTC_ERROR_INVALID_OPERATION,"scene not committed");
+    if (((size_t)ray) & 0x03) throw_RTCError(RTC_ERROR_INVALID_ARGUMENT, "ray not aligned to 4 bytes");   
+#endif
+    STAT3(shadow.travs,M,M,M);
+    IntersectContext context(scene,user_context);
+    /* fast codepath for streams of size 1 */
+    if (likely(M == 1)) {
+      if (likely(ray->tnear <= ray->tfar)) 
+        scene->intersectors.occluded (*ray,&context);
+    } 
+    /* codepath for shadow ray streams */
+    else {
+      scene->device->rayStreamFilters.occludedShadowAOS(scene,ray,M,byteStride,&context);
+    }
+#else
+    throw_RTCError(RTC_ERROR_INVALID_OPERATION,"rtcOccludedShadow1M not supported");
+#endif
+    RTC_CATCH_END2(scene);
+  }
+
   RTC_API void rtcOccluded1Mp(RTCScene hscene, RTCIntersectContext* user_context, RTCRay** ray, unsigned int M) 
   {
     Scene* scene = (Scene*) hscene;
@@ -973,6 +1052,17 @@ RTC_NAMESPACE_BEGIN;
     RTC_CATCH_END2(geometry);
   }
 
+  RTC_API void rtcSetGeometryInstanceOrigin(RTCGeometry hgeometry, const double* origin)
+  {
+    Geometry* geometry = (Geometry*) hgeometry;
+    RTC_CATCH_BEGIN;
+    RTC_TRACE(rtcSetGeometryInstanceOrigin);
+    RTC_VERIFY_HANDLE(hgeometry);
+    RTC_VERIFY_HANDLE(origin);
+    geometry->setInstanceOrigin(Vec3d(origin[0],origin[1],origin[2]));
+    RTC_CATCH_END2(geometry);
+  }
+
   AffineSpace3fa loadTransform(RTCFormat format, const float* xfm)
   {
     AffineSpace3fa space = one;
@@ -1370,7 +1460,19 @@ RTC_NAMESPACE_BEGIN;
 #endif
     RTC_CATCH_END2(geometry);
   }
-  
+
+  RTC_API void rtcSetGeometryVertexDequantization(RTCGeometry hgeometry, const float* scale, const float* offset)
+  {
+    Geometry* geometry = (Geometry*) hgeometry;
+    RTC_CATCH_BEGIN;
+    RTC_TRACE(rtcSetGeometryVertexDequantization);
+    RTC_VERIFY_HANDLE(hgeometry);
+    RTC_VERIFY_HANDLE(scale);
+    RTC_VERIFY_HANDLE(offset);
+    geometry->setVertexDequantization(Vec3fa(scale[0],scale[1],scale[2]),Vec3fa(offset[0],offset[1],offset[2]));
+    RTC_CATCH_END2(geometry);
+  }
+
   RTC_API void rtcSetGeometryMask (RTCGeometry hgeometry, unsigned int mask) 
   {
     Geometry* geometry = (Geometry*) hgeometry;
@@ -1539,6 +1641,16 @@ RTC_NAMESPACE_BEGIN;
     RTC_CATCH_END2(geometry);
   }
 
+  RTC_API void rtcSetGeometrySplitFunction (RTCGeometry hgeometry, RTCSplitFunction split)
+  {
+    Geometry* geometry = (Geometry*) hgeometry;
+    RTC_CATCH_BEGIN;
+    RTC_TRACE(rtcSetGeometrySplitFunction);
+    RTC_VERIFY_HANDLE(hgeometry);
+    geometry->setSplitFunction(split);
+    RTC_CATCH_END2(geometry);
+  }
+
   RTC_API void rtcSetGeometryDisplacementFunction (RTCGeometry hgeometry, RTCDisplacementFunctionN displacement)
   {
     Geometry* geometry = (Geometry*) hgeometry;
@@ -5,6 +5,7 @@
 
 #include "../bvh/bvh4_factory.h"
 #include "../bvh/bvh8_factory.h"
+#include "primref.h"
 #include "../../common/algorithms/parallel_reduce.h"
  
 namespace embree
@@ -22,6 +23,10 @@ namespace embree
       flags_modified(true), enabled_geometry_types(0),
       scene_flags(RTC_SCENE_FLAG_NONE),
       quality_flags(RTC_BUILD_QUALITY_MEDIUM),
+      max_spatial_split_replications(device->max_spatial_split_replications), memory_constrained(false),
+      origin(zero),
+      progressive_commit(false), defer_binding(false),
+      async_thread(nullptr), async_completed_function(nullptr), async_completed_ptr(nullptr),
       is_build(false), modified(true),
       progressInterface(this), progress_monitor_function(nullptr), progress_monitor_ptr(nullptr), progress_monitor_counter(0)
   {
@@ -38,6 +43,11 @@ namespace embree
 
   Scene::~Scene() noexcept
   {
+    /* the background thread of an asynchronous commit releases its reference last, thus it may destroy the scene itself */
+    if (async_thread) {
+      if (async_commit_scene == this) detachThread(async_thread);
+      else embree::join(async_thread);
+    }
     device->refDec();
   }
   
@@ -87,12 +97,151 @@ namespace embree
     }
   }
 
+  void Scene::printMemoryStatistics()
+  {
+    MemoryStatistics stat;
+    addMemoryStatistics(stat);
+
+    std::stringstream str;
+    str.setf(std::ios::fixed, std::ios::floatfield);
+    str << "scene memory: "
+        << "total = " << std::setw(7) << std::setprecision(3) << 1E-6*double(stat.bytesAllocated) << " MB, "
+        << "huge pages = " << std::setw(7) << std::setprecision(3) << 1E-6*double(stat.bytesHugePages) << " MB, "
+        << "THP advised = " << std::setw(7) << std::setprecision(3) << 1E-6*double(stat.bytesAdvised) << " MB";
+    std::cout << str.str() << std::endl;
+  }
+
+  void Scene::selectMemoryBudget()
+  {
+    const bool was_memory_constrained = memory_constrained;
+    max_spatial_split_replications = device->max_spatial_split_replications;
+    memory_constrained = false;
+
+    const size_t budget = device->build_memory_budget;
+    const size_t numPrimitives = world.size();
+    if (budget && numPrimitives)
+    {
+      /* rough per primitive estimates for the primref array and the final acceleration structure */
+      const float bytesPrimRef = float(sizeof(PrimRef));
+      const float bytesAccel = 64.0f;
+      const float bytesPerPrimitive = float(budget)/float(numPrimitives);
+      const float replications = quality_flags == RTC_BUILD_QUALITY_HIGH ? max_spatial_split_replications : 1.0f;
+
+      if (replications*bytesPrimRef + bytesAccel > bytesPerPrimitive)
+      {
+        /* first reduce spatial split replications (this also caps presplits), then switch to compact leaves */
+        const float maxReplications = (bytesPerPrimitive - bytesAccel)/bytesPrimRef;
+        max_spatial_split_replications = max(1.0f,min(max_spatial_split_replications,maxReplications));
+        memory_constrained = maxReplications < 1.0f;
+      }
+
+      if (device->verbosity(1))
+      {
+        /* the budget is specified in MiB, thus the estimate gets printed in MiB too */
+        std::cout << "memory budget: " << float(budget)/float(1024*1024) << " MiB for " << numPrimitives << " primitives, estimated "
+                  << float(numPrimitives)*(replications*bytesPrimRef + bytesAccel)/float(1024*1024) << " MiB";
+        if (memory_constrained) std::cout << ", using compact leaves";
+        else if (max_spatial_split_replications < device->max_spatial_split_replications)
+          std::cout << ", reducing spatial split replications to " << max_spatial_split_replications;
+        std::cout << std::endl;
+      }
+    }
+
+    /* acceleration structures have to get re-created when leaf types change */
+    if (memory_constrained != was_memory_constrained)
+      flags_modified = true;
+  }
+
+  Scene::InstanceMetrics Scene::getInstanceMetrics()
+  {
+    Lock<MutexSys> lock(instanceMetricsMutex);
+    if (!instance_metrics.valid)
+    {
+      instance_metrics.sah = sah();
+      instance_metrics.numPrimitives = world.size();
+      instance_metrics.numExpensivePrimitives =
+        world.numBezierCurves + world.numMBBezierCurves + world.numLineSegments + world.numMBLineSegments +
+        world.numPoints + world.numMBPoints + world.numUserGeometries + world.numMBUserGeometries +
+        world.numInstancesCheap + world.numMBInstancesCheap + world.numInstancesExpensive + world.numMBInstancesExpensive;
+      instance_metrics.valid = true;
+    }
+    return instance_metrics;
+  }
+
+  void Scene::classifyInstances()
+  {
+#if defined(EMBREE_GEOMETRY_INSTANCE)
+    /* instances of scenes with fewer primitives are never considered expensive */
+    const size_t minExpensivePrimitives = 64;
+    const float factor = device->instancing_expensive_factor;
+
+    expensive_instances.clear();
+
+    std::vector<unsigned> geomIDs;
+    for (size_t i=0; i<geometries.size(); i++) {
+      Geometry* geom = geometries[i].ptr;
+      if (geom && geom->isEnabled() && (geom->getTypeMask() & Geometry::MTY_INSTANCE) && ((Instance*)geom)->object)
+        geomIDs.push_back((unsigned)i);
+    }
+    if (geomIDs.size() == 0)
+      return;
+
+    /* gather the cost of each instance and the overlap of their world space bounds */
+    std::vector<InstanceMetrics> metrics(geomIDs.size());
+    std::vector<double> cost(geomIDs.size());
+    BBox3fa sceneBounds = empty;
+    double sumArea = 0.0;
+    for (size_t i=0; i<geomIDs.size(); i++)
+    {
+      Instance* instance = (Instance*) geometries[geomIDs[i]].ptr;
+      metrics[i] = ((Scene*)instance->object)->getInstanceMetrics();
+
+      /* curves, points, user geometries and instances are about four times as expensive to intersect as triangles */
+      const double expensiveRatio = metrics[i].numPrimitives ? double(metrics[i].numExpensivePrimitives)/double(metrics[i].numPrimitives) : 0.0;
+      cost[i] = metrics[i].sah*(1.0+3.0*expensiveRatio);
+
+      const BBox3fa b = instance->bounds(0);
+      const Vec3fa offset = instance->getOriginOffset(origin);
+      const BBox3fa bounds(b.lower+offset,b.upper+offset);
+      sceneBounds.extend(bounds);
+      sumArea += halfArea(bounds);
+    }
+    const double sceneArea = halfArea(sceneBounds);
+    const double overlap = sceneArea > 0.0 ? sumArea/sceneArea : 0.0;
+
+    std::vector<double> sorted = cost;
+    std::nth_element(sorted.begin(),sorted.begin()+sorted.size()/2,sorted.end());
+    const double median = sorted[sorted.size()/2];
+
+    /* the expensive instances get traversed after the cheap ones, which only pays off if rays typically hit several instances */
+    expensive_instances.resize(geometries.size(),false);
+    size_t numExpensive = 0;
+    for (size_t i=0; i<geomIDs.size(); i++)
+    {
+      const bool expensive = factor > 0.0f && overlap > 1.0 &&
+        metrics[i].numPrimitives >= minExpensivePrimitives && cost[i] > double(factor)*median;
+      expensive_instances[geomIDs[i]] = expensive;
+      numExpensive += expensive;
+    }
+
+    if (device->verbosity(2))
+    {
+      std::cout << "instances: " << numExpensive << " of " << geomIDs.size() << " classified as expensive, overlap = " << overlap << ", median cost = " << median << std::endl;
+      if (device->verbosity(3)) {
+        for (size_t i=0; i<geomIDs.size(); i++)
+          std::cout << "  instance " << geomIDs[i] << ": primitives = " << metrics[i].numPrimitives << ", sah = " << metrics[i].sah << ", cost = " << cost[i]
+                    << (isExpensiveInstance(geomIDs[i]) ? ", expensive" : ", cheap") << std::endl;
+      }
+    }
+#endif
+  }
+
   void Scene::createTriangleAccel()
   {
 #if defined(EMBREE_GEOMETRY_TRIANGLE)
     if (device->tri_accel == "default") 
     {
-      if (quality_flags != RTC_BUILD_QUALITY_LOW)
+      if (quality_flags != RTC_BUILD_QUALITY_LOW && !progressive_commit)
       {
         int mode =  2*(int)isCompactAccel() + 1*(int)isRobustAccel(); 
         switch (mode) {
@@ -213,7 +362,7 @@ namespace embree
 #if defined(EMBREE_GEOMETRY_QUAD)
     if (device->quad_accel == "default") 
     {
-      if (quality_flags != RTC_BUILD_QUALITY_LOW)
+      if (quality_flags != RTC_BUILD_QUALITY_LOW && !progressive_commit)
       {
         /* static */
         int mode =  2*(int)isCompactAccel() + 1*(int)isRobustAccel(); 
@@ -421,7 +570,9 @@ namespace embree
 #if defined (EMBREE_TARGET_SIMD8)
       if (device->canUseAVX() && !isCompactAccel())
       {
-        if (quality_flags != RTC_BUILD_QUALITY_LOW) {
+        if (quality_flags == RTC_BUILD_QUALITY_HIGH) {
+          accels_add(device->bvh8_factory->BVH8UserGeometry(this,BVHFactory::BuildVariant::HIGH_QUALITY));
+        } else if (quality_flags != RTC_BUILD_QUALITY_LOW) {
           accels_add(device->bvh8_factory->BVH8UserGeometry(this,BVHFactory::BuildVariant::STATIC));
         } else {
           accels_add(device->bvh8_factory->BVH8UserGeometry(this,BVHFactory::BuildVariant::DYNAMIC));
@@ -430,7 +581,9 @@ namespace embree
       else
 #endif
       {
-        if (quality_flags != RTC_BUILD_QUALITY_LOW) {
+        if (quality_flags == RTC_BUILD_QUALITY_HIGH) {
+          accels_add(device->bvh4_factory->BVH4UserGeometry(this,BVHFactory::BuildVariant::HIGH_QUALITY));
+        } else if (quality_flags != RTC_BUILD_QUALITY_LOW) {
           accels_add(device->bvh4_factory->BVH4UserGeometry(this,BVHFactory::BuildVariant::STATIC));
         } else {
           accels_add(device->bvh4_factory->BVH4UserGeometry(this,BVHFactory::BuildVariant::DYNAMIC));
@@ -471,7 +624,9 @@ namespace embree
     {
 #if defined (EMBREE_TARGET_SIMD8)
       if (device->canUseAVX() && !isCompactAccel()) {
-        if (quality_flags != RTC_BUILD_QUALITY_LOW) {
+        if (quality_flags == RTC_BUILD_QUALITY_HIGH) {
+          accels_add(device->bvh8_factory->BVH8Instance(this, false, BVHFactory::BuildVariant::HIGH_QUALITY));
+        } else if (quality_flags != RTC_BUILD_QUALITY_LOW) {
           accels_add(device->bvh8_factory->BVH8Instance(this, false, BVHFactory::BuildVariant::STATIC));
         } else {
           accels_add(device->bvh8_factory->BVH8Instance(this, false, BVHFactory::BuildVariant::DYNAMIC));
@@ -480,7 +635,9 @@ namespace embree
       else
 #endif
       {
-        if (quality_flags != RTC_BUILD_QUALITY_LOW) {
+        if (quality_flags == RTC_BUILD_QUALITY_HIGH) {
+          accels_add(device->bvh4_factory->BVH4Instance(this, false, BVHFactory::BuildVariant::HIGH_QUALITY));
+        } else if (quality_flags != RTC_BUILD_QUALITY_LOW) {
           accels_add(device->bvh4_factory->BVH4Instance(this, false, BVHFactory::BuildVariant::STATIC));
         } else {
           accels_add(device->bvh4_factory->BVH4Instance(this, false, BVHFactory::BuildVariant::DYNAMIC));
@@ -514,7 +671,9 @@ namespace embree
     {
 #if defined (EMBREE_TARGET_SIMD8)
       if (device->canUseAVX() && !isCompactAccel()) {
-        if (quality_flags != RTC_BUILD_QUALITY_LOW) {
+        if (quality_flags == RTC_BUILD_QUALITY_HIGH) {
+          accels_add(device->bvh8_factory->BVH8Instance(this, true, BVHFactory::BuildVariant::HIGH_QUALITY));
+        } else if (quality_flags != RTC_BUILD_QUALITY_LOW) {
           accels_add(device->bvh8_factory->BVH8Instance(this, true, BVHFactory::BuildVariant::STATIC));
         } else {
           accels_add(device->bvh8_factory->BVH8Instance(this, true, BVHFactory::BuildVariant::DYNAMIC));
@@ -523,7 +682,9 @@ namespace embree
       else
 #endif
       {
-        if (quality_flags != RTC_BUILD_QUALITY_LOW) {
+        if (quality_flags == RTC_BUILD_QUALITY_HIGH) {
+          accels_add(device->bvh4_factory->BVH4Instance(this, true, BVHFactory::BuildVariant::HIGH_QUALITY));
+        } else if (quality_flags != RTC_BUILD_QUALITY_LOW) {
           accels_add(device->bvh4_factory->BVH4Instance(this, true, BVHFactory::BuildVariant::STATIC));
         } else {
           accels_add(device->bvh4_factory->BVH4Instance(this, true, BVHFactory::BuildVariant::DYNAMIC));
@@ -553,23 +714,24 @@ namespace embree
   void Scene::createGridAccel()
   {
     BVHFactory::IntersectVariant ivariant = isRobustAccel() ? BVHFactory::IntersectVariant::ROBUST : BVHFactory::IntersectVariant::FAST;
+    BVHFactory::BuildVariant bvariant = quality_flags == RTC_BUILD_QUALITY_HIGH ? BVHFactory::BuildVariant::HIGH_QUALITY : BVHFactory::BuildVariant::STATIC;
 #if defined(EMBREE_GEOMETRY_GRID)
     if (device->grid_accel == "default") 
     {
 #if defined (EMBREE_TARGET_SIMD8)
       if (device->canUseAVX() && !isCompactAccel())
       {
-        accels_add(device->bvh8_factory->BVH8Grid(this,BVHFactory::BuildVariant::STATIC,ivariant));
+        accels_add(device->bvh8_factory->BVH8Grid(this,bvariant,ivariant));
       }
       else
 #endif
       {
-        accels_add(device->bvh4_factory->BVH4Grid(this,BVHFactory::BuildVariant::STATIC,ivariant));
+        accels_add(device->bvh4_factory->BVH4Grid(this,bvariant,ivariant));
       }
     }
-    else if (device->grid_accel == "bvh4.grid") accels_add(device->bvh4_factory->BVH4Grid(this,BVHFactory::BuildVariant::STATIC,ivariant));
+    else if (device->grid_accel == "bvh4.grid") accels_add(device->bvh4_factory->BVH4Grid(this,bvariant,ivariant));
 #if defined (EMBREE_TARGET_SIMD8)
-    else if (device->grid_accel == "bvh8.grid") accels_add(device->bvh8_factory->BVH8Grid(this,BVHFactory::BuildVariant::STATIC,ivariant));
+    else if (device->grid_accel == "bvh8.grid") accels_add(device->bvh8_factory->BVH8Grid(this,bvariant,ivariant));
 #endif
     else throw_RTCError(RTC_ERROR_INVALID_ARGUMENT,"unknown grid accel "+device->grid_accel);
 #endif
@@ -605,6 +767,19 @@ namespace embree
       if (!id_pool.add(geomID))
         throw_RTCError(RTC_ERROR_INVALID_OPERATION,"invalid geometry ID provided");
     }
+
+    /* a progressive commit is reading the geometry list */
+    if (defer_binding) {
+      deferred_geometries.push_back(std::make_pair(geomID,geometry));
+      return geomID;
+    }
+
+    bind_locked(geomID,geometry);
+    return geomID;
+  }
+
+  void Scene::bind_locked(unsigned geomID, Ref<Geometry> geometry)
+  {
     if (geomID >= geometries.size()) {
       geometries.resize(geomID+1);
       vertices.resize(geomID+1);
@@ -615,23 +790,54 @@ namespace embree
     if (geometry->isEnabled()) {
       setModified ();
     }
-    return geomID;
+  }
+
+  void Scene::setDeferredBinding(bool defer)
+  {
+    Lock<SpinLock> lock(geometriesMutex);
+    for (auto& g : deferred_geometries) {
+      if (g.second) bind_locked(g.first,g.second);
+      else          detach_locked(g.first);
+    }
+    deferred_geometries.clear();
+    defer_binding = defer;
   }
 
   void Scene::detachGeometry(size_t geomID)
   {
     Lock<SpinLock> lock(geometriesMutex);
+
+    /* the geometry may have been attached or detached during a progressive commit */
+    bool deferred = false;
+    Ref<Geometry> geometry = null;
+    for (auto& g : deferred_geometries) {
+      if (g.first != geomID) continue;
+      deferred = true;
+      geometry = g.second;
+    }
     
-    if (geomID >= geometries.size())
+    if (!deferred && geomID >= geometries.size())
       throw_RTCError(RTC_ERROR_INVALID_OPERATION,"invalid geometry ID");
 
-    Ref<Geometry>& geometry = geometries[geomID];
+    if (!deferred) geometry = geometries[geomID];
     if (geometry == null)
       throw_RTCError(RTC_ERROR_INVALID_OPERATION,"invalid geometry");
-    
+
+    id_pool.deallocate((unsigned)geomID);
+
+    /* a progressive commit is reading the geometry list */
+    if (defer_binding) {
+      deferred_geometries.push_back(std::make_pair((unsigned)geomID,Ref<Geometry>(null)));
+      return;
+    }
+
+    detach_locked(geomID);
+  }
+
+  void Scene::detach_locked(size_t geomID)
+  {
     setModified ();
     accels_deleteGeometry(unsigned(geomID));
-    id_pool.deallocate((unsigned)geomID);
     geometries[geomID] = null;
     vertices[geomID] = nullptr;
     geometryModCounters_[geomID] = 0;
@@ -642,11 +848,35 @@ namespace embree
     is_build = true;
   }
 
-  void Scene::commit_task ()
+  void Scene::commit_task (bool progressive, bool async)
+  {
+    /* geometries attached during a progressive commit get bound after it finished */
+    setDeferredBinding(progressive);
+    try {
+      build_task(progressive,async);
+    }
+    catch (...) {
+      setDeferredBinding(false);
+      throw;
+    }
+    setDeferredBinding(false);
+  }
+
+  bool Scene::prepare_task (bool progressive, bool async)
   {
     checkIfModifiedAndSet ();
     if (!isModified()) {
-      return;
+      return false;
+    }
+
+    /* only asynchronous commits keep the previous acceleration structures alive */
+    if (!async)
+      accels_single_buffer();
+
+    /* progressive commits require per geometry hierarchies */
+    if (progressive && !progressive_commit) {
+      progressive_commit = true;
+      flags_modified = true;
     }
     
     /* print scene statistics */
@@ -654,6 +884,9 @@ namespace embree
       printStatistics();
 
     progress_monitor_counter = 0;
+
+    /* instances have to get classified before they are counted */
+    classifyInstances();
     
     /* gather scene stats and call preCommit function of each geometry */
     this->world = parallel_reduce (size_t(0), geometries.size(), GeometryCounts (), 
@@ -665,7 +898,8 @@ namespace embree
           if (geometries[i] && geometries[i]->isEnabled()) 
           {
             geometries[i]->preCommit();
-            geometries[i]->addElementsToCount (c);
+            if (isExpensiveInstance(i)) ((Instance*)geometries[i].ptr)->addExpensiveElementsToCount (c);
+            else geometries[i]->addElementsToCount (c);
             c.numFilterFunctions += (int) geometries[i]->hasFilterFunctions();
           }
         }
@@ -674,41 +908,85 @@ namespace embree
       std::plus<GeometryCounts>()
     );
     
+    /* degrade build quality if required to stay within the memory budget */
+    selectMemoryBudget();
+    
     /* select acceleration structures to build */
     unsigned int new_enabled_geometry_types = world.enabledGeometryTypesMask();
     if (flags_modified || new_enabled_geometry_types != enabled_geometry_types)
     {
-      accels_init();
+      /* progressive commits keep the hierarchies built ahead of the top
+       * level and only add acceleration structures for geometry types
+       * that have none yet, the bits are the ones of enabledGeometryTypesMask */
+      const bool keep = progressive_commit && !flags_modified;
+      const unsigned int types = keep ? enabled_geometry_types : 0;
+      auto isNew = [&] (unsigned int type, bool mblur) {
+        return !(types & (mblur ? 1 << type : 1 << (type+8)));
+      };
+
+      if (!keep)
+      {
+        accels_init();
 
-      /* we need to make all geometries modified, otherwise two level builder will 
-        not rebuild currently not modified geometries */
-      parallel_for(geometryModCounters_.size(), [&] ( const size_t i ) {
-          geometryModCounters_[i] = 0;
-        });
+        /* we need to make all geometries modified, otherwise two level builder will
+           not rebuild currently not modified geometries */
+        parallel_for(geometryModCounters_.size(), [&] ( const size_t i ) {
+            geometryModCounters_[i] = 0;
+          });
+      }
       
-      if (getNumPrimitives(TriangleMesh::geom_type,false)) createTriangleAccel();
-      if (getNumPrimitives(TriangleMesh::geom_type,true)) createTriangleMBAccel();
-      if (getNumPrimitives(QuadMesh::geom_type,false)) createQuadAccel();
-      if (getNumPrimitives(QuadMesh::geom_type,true)) createQuadMBAccel();
-      if (getNumPrimitives(GridMesh::geom_type,false)) createGridAccel();
-      if (getNumPrimitives(GridMesh::geom_type,true)) createGridMBAccel();
-      if (getNumPrimitives(SubdivMesh::geom_type,false)) createSubdivAccel();
-      if (getNumPrimitives(SubdivMesh::geom_type,true)) createSubdivMBAccel();
-      if (getNumPrimitives(Geometry::MTY_CURVES,false)) createHairAccel();
-      if (getNumPrimitives(Geometry::MTY_CURVES,true)) createHairMBAccel();
-      if (getNumPrimitives(UserGeometry::geom_type,false)) createUserGeometryAccel();
-      if (getNumPrimitives(UserGeometry::geom_type,true)) createUserGeometryMBAccel();
-      if (getNumPrimitives(Geometry::MTY_INSTANCE_CHEAP,false)) createInstanceAccel();
-      if (getNumPrimitives(Geometry::MTY_INSTANCE_CHEAP,true)) createInstanceMBAccel();
-      if (getNumPrimitives(Geometry::MTY_INSTANCE_EXPENSIVE,false)) createInstanceExpensiveAccel();
-      if (getNumPrimitives(Geometry::MTY_INSTANCE_EXPENSIVE,true)) createInstanceExpensiveMBAccel();
+      if (getNumPrimitives(TriangleMesh::geom_type,false) && isNew(0,false)) createTriangleAccel();
+      if (getNumPrimitives(TriangleMesh::geom_type,true) && isNew(0,true)) createTriangleMBAccel();
+      if (getNumPrimitives(QuadMesh::geom_type,false) && isNew(1,false)) createQuadAccel();
+      if (getNumPrimitives(QuadMesh::geom_type,true) && isNew(1,true)) createQuadMBAccel();
+      if (getNumPrimitives(GridMesh::geom_type,false) && isNew(7,false)) createGridAccel();
+      if (getNumPrimitives(GridMesh::geom_type,true) && isNew(7,true)) createGridMBAccel();
+      if (getNumPrimitives(SubdivMesh::geom_type,false) && isNew(3,false)) createSubdivAccel();
+      if (getNumPrimitives(SubdivMesh::geom_type,true) && isNew(3,true)) createSubdivMBAccel();
+      if (getNumPrimitives(Geometry::MTY_CURVES,false) && isNew(2,false) && isNew(8,false)) createHairAccel();
+      if (getNumPrimitives(Geometry::MTY_CURVES,true) && isNew(2,true) && isNew(8,true)) createHairMBAccel();
+      if (getNumPrimitives(UserGeometry::geom_type,false) && isNew(4,false)) createUserGeometryAccel();
+      if (getNumPrimitives(UserGeometry::geom_type,true) && isNew(4,true)) createUserGeometryMBAccel();
+      if (getNumPrimitives(Geometry::MTY_INSTANCE_CHEAP,false) && isNew(5,false)) createInstanceAccel();
+      if (getNumPrimitives(Geometry::MTY_INSTANCE_CHEAP,true) && isNew(5,true)) createInstanceMBAccel();
+      if (getNumPrimitives(Geometry::MTY_INSTANCE_EXPENSIVE,false) && isNew(6,false)) createInstanceExpensiveAccel();
+      if (getNumPrimitives(Geometry::MTY_INSTANCE_EXPENSIVE,true) && isNew(6,true)) createInstanceExpensiveMBAccel();
       
       flags_modified = false;
-      enabled_geometry_types = new_enabled_geometry_types;
+      enabled_geometry_types = types | new_enabled_geometry_types;
     }
     
     /* select fast code path if no filter function is present */
     accels_select(hasFilterFunction());
+
+    /* capture the per geometry state the background build publishes together with the new acceleration structures */
+    if (async)
+    {
+      async_vertices.resize(geometries.size());
+      async_modCounters.resize(geometries.size());
+      parallel_for(geometries.size(), [&] ( const size_t i ) {
+          const bool enabled = geometries[i] && geometries[i]->isEnabled();
+          async_vertices[i] = enabled ? geometries[i]->getCompactVertexArray() : vertices[i];
+          async_modCounters[i] = enabled ? geometries[i]->getModCounter() : geometryModCounters_[i];
+        });
+    }
+    return true;
+  }
+
+  void Scene::build_task (bool progressive, bool async)
+  {
+    /* asynchronous commits got prepared before the background build started */
+    if (!async && !prepare_task(progressive,async))
+      return;
+
+    /* progressive commits only build the hierarchies of individual
+     * geometries, the scene stays modified until the next commit */
+    if (progressive)
+    {
+      intersectors = Accel::Intersectors(missing_rtcCommit);
+      accels_prebuild();
+      return;
+    }
   
     /* build all hierarchies of this scene */
     accels_build();
@@ -719,22 +997,47 @@ namespace embree
       flags_modified = true; // in non-dynamic mode we have to re-create accels
     }
 
+    /* the final commit of a progressive build finished, later commits use the regular acceleration structures again */
+    if (progressive_commit) {
+      progressive_commit = false;
+      flags_modified = true;
+    }
+
     /* call postCommit function of each geometry */
     parallel_for(geometries.size(), [&] ( const size_t i ) {
         if (geometries[i] && geometries[i]->isEnabled()) {
           geometries[i]->postCommit();
-          vertices[i] = geometries[i]->getCompactVertexArray();
-          geometryModCounters_[i] = geometries[i]->getModCounter();
+          if (!async) {
+            vertices[i] = geometries[i]->getCompactVertexArray();
+            geometryModCounters_[i] = geometries[i]->getModCounter();
+          }
         }
       });
       
     updateInterface();
 
+    /* instances of this scene have to recalculate its metrics */
+    {
+      Lock<MutexSys> lock(instanceMetricsMutex);
+      instance_metrics.valid = false;
+    }
+
+    /* rays in flight finish on the front buffer, new rays use the new acceleration structures */
+    if (async)
+    {
+      for (size_t i=0; i<async_vertices.size(); i++) {
+        vertices[i] = async_vertices[i];
+        geometryModCounters_[i] = async_modCounters[i];
+      }
+      accels_swap_buffers();
+    }
+
     if (device->verbosity(2)) {
       std::cout << "created scene intersector" << std::endl;
       accels_print(2);
       std::cout << "selected scene intersector" << std::endl;
       intersectors.print(2);
+      printMemoryStatistics();
     }
     
     setModified(false);
@@ -751,6 +1054,13 @@ namespace embree
     return quality_flags;
   }
 
+  void Scene::setOrigin(const Vec3d& origin_i)
+  {
+    if (origin.x == origin_i.x && origin.y == origin_i.y && origin.z == origin_i.z) return;
+    origin = origin_i;
+    setModified();
+  }
+
   void Scene::setSceneFlags(RTCSceneFlags scene_flags_i)
   {
     if (scene_flags == scene_flags_i) return;
@@ -764,7 +1074,7 @@ namespace embree
                    
 #if defined(TASKING_INTERNAL)
 
-  void Scene::commit (bool join) 
+  void Scene::commit (bool join, bool progressive, bool async) 
   {
     Lock<MutexSys> buildLock(buildMutex,false);
 
@@ -791,7 +1101,7 @@ namespace embree
 
     /* initiate build */
     try {
-      scheduler->spawn_root([&]() { commit_task(); Lock<MutexSys> lock(schedulerMutex); this->scheduler = nullptr; }, 1, !join);
+      scheduler->spawn_root([&]() { commit_task(progressive,async); Lock<MutexSys> lock(schedulerMutex); this->scheduler = nullptr; }, 1, !join);
     }
     catch (...) {
       accels_clear();
@@ -806,7 +1116,7 @@ namespace embree
 
 #if defined(TASKING_TBB)
 
-  void Scene::commit (bool join) 
+  void Scene::commit (bool join, bool progressive, bool async) 
   {
 #if defined(TASKING_TBB) && (TBB_INTERFACE_VERSION_MAJOR < 8)
     if (join)
@@ -861,7 +1171,7 @@ namespace embree
       {
         device->arena->execute([&]{
             group.run([&]{
-                tbb::parallel_for (size_t(0), size_t(1), size_t(1), [&] (size_t) { commit_task(); }, ctx);
+                tbb::parallel_for (size_t(0), size_t(1), size_t(1), [&] (size_t) { commit_task(progressive,async); }, ctx);
               });
             group.wait();
           });
@@ -870,7 +1180,7 @@ namespace embree
 #endif
       {
         group.run([&]{
-            tbb::parallel_for (size_t(0), size_t(1), size_t(1), [&] (size_t) { commit_task(); }, ctx);
+            tbb::parallel_for (size_t(0), size_t(1), size_t(1), [&] (size_t) { commit_task(progressive,async); }, ctx);
           });
         group.wait();
       }
@@ -892,7 +1202,7 @@ namespace embree
 
 #if defined(TASKING_PPL)
 
-  void Scene::commit (bool join) 
+  void Scene::commit (bool join, bool progressive, bool async) 
   {
 #if defined(TASKING_PPL)
     if (join)
@@ -914,7 +1224,7 @@ namespace embree
     try {
 
       group.run([&]{
-          concurrency::parallel_for(size_t(0), size_t(1), size_t(1), [&](size_t) { commit_task(); });
+          concurrency::parallel_for(size_t(0), size_t(1), size_t(1), [&](size_t) { commit_task(progressive,async); });
         });
       group.wait();
 
@@ -933,6 +1243,115 @@ namespace embree
   }
 #endif
 
+  /* runs a step of an asynchronous commit and reports its errors through the device */
+  template<typename Closure>
+  static RTCError commitAsyncStep (Scene* scene, const Closure& closure)
+  {
+    RTCError error = RTC_ERROR_NONE;
+    try {
+      closure();
+    }
+    catch (std::bad_alloc&) {
+      error = RTC_ERROR_OUT_OF_MEMORY;
+      Device::process_error(scene->device,error,"out of memory");
+    }
+    catch (rtcore_error& e) {
+      error = e.error;
+      Device::process_error(scene->device,error,e.what());
+    }
+    catch (std::exception& e) {
+      error = RTC_ERROR_UNKNOWN;
+      Device::process_error(scene->device,error,e.what());
+    }
+    catch (...) {
+      error = RTC_ERROR_UNKNOWN;
+      Device::process_error(scene->device,error,"unknown exception caught");
+    }
+    return error;
+  }
+
+  __thread Scene* Scene::async_commit_scene = nullptr;
+
+  static void commitAsyncThread (void* ptr)
+  {
+    Scene* scene = (Scene*) ptr;
+    Scene::async_commit_scene = scene;
+    const RTCError error = commitAsyncStep(scene,[&] { scene->commit(false,false,true); });
+    
+    if (scene->async_completed_function)
+      scene->async_completed_function(scene->async_completed_ptr,(RTCScene)scene,error);
+
+    /* releases the reference acquired by commitAsync, the scene may get destroyed here */
+    scene->refDec();
+    Scene::async_commit_scene = nullptr;
+  }
+
+  void Scene::commitAsync (RTCCommitSceneCompletedFunction completed, void* ptr)
+  {
+    if (async_commit_scene == this)
+      throw_RTCError(RTC_ERROR_INVALID_OPERATION,"rtcCommitSceneAsync cannot get called from the completion callback");
+
+    /* the front buffer of the previous asynchronous commit gets released below */
+    waitCommitAsync();
+
+    Lock<MutexSys> lock(asyncMutex);
+    
+    /* rays traverse the current acceleration structures while new ones get built from scratch */
+    accels_double_buffer();
+    flags_modified = true;
+    setModified();
+
+    /* the scene state gets updated here, as rays traverse the front buffer concurrently to the background build */
+    const RTCError error = commitAsyncStep(this,[&] { prepare_task(false,true); });
+    if (error != RTC_ERROR_NONE) {
+      if (completed) completed(ptr,(RTCScene)this,error);
+      return;
+    }
+    
+    async_completed_function = completed;
+    async_completed_ptr = ptr;
+    refInc();
+    async_thread = createThread(commitAsyncThread,this);
+  }
+
+  void Scene::waitCommitAsync ()
+  {
+    /* the completion callback gets invoked after the build finished */
+    if (async_commit_scene == this)
+      return;
+
+    Lock<MutexSys> lock(asyncMutex);
+    if (!async_thread) return;
+    embree::join(async_thread);
+    async_thread = nullptr;
+  }
+
+  void Scene::joinCommit ()
+  {
+    bool pending = false;
+    {
+      Lock<MutexSys> lock(asyncMutex);
+      pending = async_thread != nullptr;
+    }
+
+    /* a regular commit would restart the build if the background build already finished */
+    if (!pending) {
+      commit(true);
+      return;
+    }
+
+#if defined(TASKING_INTERNAL)
+    /* help with the background build if it is already running */
+    Ref<TaskScheduler> scheduler = nullptr;
+    {
+      Lock<MutexSys> lock(schedulerMutex);
+      scheduler = this->scheduler;
+    }
+    if (scheduler) scheduler->join();
+#endif
+    waitCommitAsync();
+  }
+
   void Scene::setProgressMonitorFunction(RTCProgressMonitorFunction func, void* ptr) 
   {
     progress_monitor_function = func;
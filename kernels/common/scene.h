@@ -43,7 +43,7 @@ namespace embree
         Geometry* geom = scene->geometries[i].ptr;
         if (geom == nullptr) return nullptr;
         if (!all && !geom->isEnabled()) return nullptr;
-        const size_t mask = geom->getTypeMask() & Ty::geom_type; 
+        const size_t mask = scene->getTypeMask(i) & Ty::geom_type;
         if (!(mask)) return nullptr;
         if ((geom->numTimeSteps != 1) != mblur) return nullptr;
         return (Ty*) geom;
@@ -112,7 +112,7 @@ namespace embree
         Geometry* geom = scene->geometries[i].ptr;
         if (geom == nullptr) return nullptr;
         if (!geom->isEnabled()) return nullptr;
-        if (!(geom->getTypeMask() & typemask)) return nullptr;
+        if (!(scene->getTypeMask(i) & typemask)) return nullptr;
         if ((geom->numTimeSteps != 1) != mblur) return nullptr;
         return geom;
       }
@@ -165,6 +165,15 @@ namespace embree
     /*! prints statistics about the scene */
     void printStatistics();
 
+    /*! prints how much memory of the acceleration structures is backed by huge pages */
+    void printMemoryStatistics();
+
+    /*! estimates the memory required to build the scene and degrades the build to fit into the memory budget */
+    void selectMemoryBudget();
+
+    /*! classifies instances as cheap or expensive based on the metrics of their instanced scenes */
+    void classifyInstances();
+
     /*! clears the scene */
     void clear();
 
@@ -176,9 +185,28 @@ namespace embree
     
     void setSceneFlags(RTCSceneFlags scene_flags);
     RTCSceneFlags getSceneFlags() const;
+
+    void setOrigin(const Vec3d& origin);
     
-    void commit (bool join);
-    void commit_task ();
+    void commit (bool join, bool progressive = false, bool async = false);
+    void commit_task (bool progressive, bool async);
+    bool prepare_task (bool progressive, bool async);
+    void build_task (bool progressive, bool async);
+
+    /* commits the scene in a background thread, rays traverse the previous acceleration structures meanwhile */
+    void commitAsync (RTCCommitSceneCompletedFunction completed, void* ptr);
+
+    /* waits until the pending asynchronous commit finished */
+    void waitCommitAsync ();
+
+    /* joins the pending build, asynchronous commits get waited for */
+    void joinCommit ();
+
+    /* checks if an asynchronous commit got started, rays traverse the previous acceleration structures until it finished */
+    bool isCommitAsyncPending () {
+      Lock<MutexSys> lock(asyncMutex);
+      return async_thread != nullptr;
+    }
     void build () {}
 
     void updateInterface();
@@ -188,6 +216,15 @@ namespace embree
     
     /* bind geometry to the scene */
     unsigned int bind (unsigned geomID, Ref<Geometry> geometry);
+
+    /* binds or detaches geometries attached or detached during a progressive commit and enables or disables deferred binding */
+    void setDeferredBinding (bool defer);
+
+  private:
+    void bind_locked (unsigned geomID, Ref<Geometry> geometry);
+    void detach_locked (size_t geomID);
+
+  public:
     
     /* determines if scene is modified */
     __forceinline bool isModified() const { return modified; }
@@ -204,6 +241,11 @@ namespace embree
       return g->getModCounter() > geometryModCounters_[geomID];
     }
 
+    /* marks a geometry as unmodified after a progressive commit built its hierarchy ahead of the top level */
+    __forceinline void setGeometryPrebuilt(size_t geomID) {
+      geometryModCounters_[geomID] = geometries[geomID]->getModCounter();
+    }
+
   protected:
     
     __forceinline void checkIfModifiedAndSet () 
@@ -246,18 +288,34 @@ namespace embree
       else return (Mesh*) geometries[i].ptr;
     }
 
+    /*! returns the type mask of a geometry, instances classified as expensive by this scene report MTY_INSTANCE_EXPENSIVE */
+    __forceinline Geometry::GTypeMask getTypeMask(size_t i) const
+    {
+      assert(i < geometries.size());
+      if (isExpensiveInstance(i)) return Geometry::MTY_INSTANCE_EXPENSIVE;
+      return geometries[i]->getTypeMask();
+    }
+
+    /*! checks if the geometry is an instance classified as expensive by this scene */
+    __forceinline bool isExpensiveInstance(size_t i) const {
+      return i < expensive_instances.size() && expensive_instances[i];
+    }
+
     __forceinline Ref<Geometry> get_locked(size_t i)  {
       Lock<SpinLock> lock(geometriesMutex);
+      for (auto g = deferred_geometries.rbegin(); g != deferred_geometries.rend(); ++g)
+        if (g->first == i) return g->second;
       assert(i < geometries.size()); 
       return geometries[i]; 
     }
 
     /* flag decoding */
     __forceinline bool isFastAccel() const { return !isCompactAccel() && !isRobustAccel(); }
-    __forceinline bool isCompactAccel() const { return scene_flags & RTC_SCENE_FLAG_COMPACT; }
+    __forceinline bool isCompactAccel() const { return (scene_flags & RTC_SCENE_FLAG_COMPACT) || memory_constrained; }
     __forceinline bool isRobustAccel()  const { return scene_flags & RTC_SCENE_FLAG_ROBUST; }
     __forceinline bool isStaticAccel()  const { return !(scene_flags & RTC_SCENE_FLAG_DYNAMIC); }
     __forceinline bool isDynamicAccel() const { return scene_flags & RTC_SCENE_FLAG_DYNAMIC; }
+    __forceinline bool isTreeletLayout() const { return scene_flags & RTC_SCENE_FLAG_TREELET_LAYOUT; }
     
     __forceinline bool hasContextFilterFunction() const {
       return scene_flags & RTC_SCENE_FLAG_CONTEXT_FILTER_FUNCTION;
@@ -289,6 +347,57 @@ namespace embree
     
     RTCSceneFlags scene_flags;
     RTCBuildQuality quality_flags;
+
+    /* build settings selected to fit into the memory budget */
+    float max_spatial_split_replications;  //!< maximally replications*N many primitives in accel for spatial splits
+    bool memory_constrained;               //!< true if compact leaves have to get used
+
+    Vec3d origin;                    //!< double precision origin of the local coordinate frame, instances get placed relative to it when building
+
+    bool progressive_commit;         //!< true if geometries are built ahead of the top level hierarchy by progressive commits
+    bool defer_binding;              //!< true while a progressive commit runs, attached geometries get bound after it finished
+    std::vector<std::pair<unsigned,Ref<Geometry>>> deferred_geometries;
+
+    MutexSys asyncMutex;
+    thread_t async_thread;           //!< background thread of the pending asynchronous commit, holds a reference to the scene
+    RTCCommitSceneCompletedFunction async_completed_function;
+    void* async_completed_ptr;
+    vector<float*> async_vertices;              //!< vertex arrays captured for the pending asynchronous commit
+    vector<unsigned int> async_modCounters;     //!< modification counters captured for the pending asynchronous commit
+    static __thread Scene* async_commit_scene;  //!< scene whose asynchronous commit the calling thread runs
+    
+    /*! traversal modes selected by ray streams with adaptive coherence */
+    struct TraversalStatistics
+    {
+      TraversalStatistics ()
+        : coherence(-1.0f), numCoherentStreams(0), numPacketStreams(0), numSingleRayStreams(0) {}
+
+      std::atomic<float> coherence;               //!< coherence measured for the last traced stream, negative if none got traced yet
+      std::atomic<size_t> numCoherentStreams;
+      std::atomic<size_t> numPacketStreams;
+      std::atomic<size_t> numSingleRayStreams;
+    };
+    TraversalStatistics traversal_statistics;
+
+    /*! metrics of this scene used to classify instances of it */
+    struct InstanceMetrics
+    {
+      InstanceMetrics ()
+        : valid(false), sah(0.0), numPrimitives(0), numExpensivePrimitives(0) {}
+
+      bool valid;                     //!< false if the metrics have to get recalculated since the last commit
+      double sah;                     //!< expected cost of tracing a ray that hits the scene bounds
+      size_t numPrimitives;           //!< number of primitives of the scene
+      size_t numExpensivePrimitives;  //!< number of curves, points, user geometries and instances
+    };
+
+    /*! returns the metrics of the last commit, calculates them on first use */
+    InstanceMetrics getInstanceMetrics();
+
+    InstanceMetrics instance_metrics;
+    std::vector<bool> expensive_instances;  //!< instances classified as expensive at the last commit, indexed by geomID
+    MutexSys instanceMetricsMutex;
+
     MutexSys buildMutex;
     SpinLock geometriesMutex;
     bool is_build;
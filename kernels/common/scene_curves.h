@@ -507,6 +507,85 @@ namespace embree
     void interpolate(const RTCInterpolateArguments* const args) {
       interpolate_impl<4>(args);
     }
+
+    template<int K>
+    void interpolateN_impl(const RTCInterpolateNArguments* const args)
+    {
+      const int* valid_i = (const int*) args->valid;
+      const unsigned* primIDs = args->primIDs;
+      const float* u = args->u;
+      unsigned int N = args->N;
+      RTCBufferType bufferType = args->bufferType;
+      unsigned int bufferSlot = args->bufferSlot;
+      float* P = args->P;
+      float* dPdu = args->dPdu;
+      float* ddPdudu = args->ddPdudu;
+      unsigned int valueCount = args->valueCount;
+
+      /* calculate base pointer and stride */
+      assert((bufferType == RTC_BUFFER_TYPE_VERTEX && bufferSlot < numTimeSteps) ||
+             (bufferType == RTC_BUFFER_TYPE_VERTEX_ATTRIBUTE && bufferSlot <= vertexAttribs.size()));
+      const char* src = nullptr; 
+      size_t stride = 0, num = 0;
+      if (bufferType == RTC_BUFFER_TYPE_VERTEX_ATTRIBUTE) {
+        src    = vertexAttribs[bufferSlot].getPtr();
+        stride = vertexAttribs[bufferSlot].getStride();
+        num    = vertexAttribs[bufferSlot].size();
+      } else {
+        src    = vertices[bufferSlot].getPtr();
+        stride = vertices[bufferSlot].getStride();
+        num    = vertices[bufferSlot].size();
+      }
+
+      /* gathers use 32 bit offsets, huge buffers use the scalar path */
+      if (unlikely(!isGatherable(num,stride))) {
+        Geometry::interpolateN(args);
+        return;
+      }
+      const float* fsrc = (const float*) src;
+      const int fstride = int(stride/sizeof(float));
+
+      for (unsigned int i=0; i<N; i+=K)
+      {
+        const vbool<K> valid0 = vint<K>((int)i)+vint<K>(step) < vint<K>(int(N));
+        vbool<K> valid = valid0;
+        if (valid_i) valid &= vint<K>::loadu(valid0,&valid_i[i]) != vint<K>(zero);
+        if (none(valid)) continue;
+
+        /* gather first vertex of all lanes */
+        const vint<K> primID = vint<K>::loadu(valid,&primIDs[i]);
+        vint<K> index(zero);
+        for (size_t m=movemask(valid), k=bsf(m); m!=0; m=btc(m,k), k=bsf(m))
+          index[k] = int(curves[primID[k]]);
+        const vfloat<K> uu = vfloat<K>::loadu(valid,&u[i]);
+        const vint<K> ofs0 = index*fstride;
+        const vint<K> ofs1 = ofs0+fstride;
+        const vint<K> ofs2 = ofs1+fstride;
+        const vint<K> ofs3 = ofs2+fstride;
+
+        /* basis weights are shared by all values */
+        typedef typename Curve<vfloat<K>>::Basis Basis;
+        const Vec4vf<K> b   = Basis::eval(uu);
+        const Vec4vf<K> db  = Basis::derivative(uu);
+        const Vec4vf<K> ddb = Basis::derivative2(uu);
+
+        for (unsigned int j=0; j<valueCount; j++)
+        {
+          const size_t ofs = j*N+i;
+          const vfloat<K> p0 = vfloat<K>::template gather<4>(valid,fsrc+j,ofs0);
+          const vfloat<K> p1 = vfloat<K>::template gather<4>(valid,fsrc+j,ofs1);
+          const vfloat<K> p2 = vfloat<K>::template gather<4>(valid,fsrc+j,ofs2);
+          const vfloat<K> p3 = vfloat<K>::template gather<4>(valid,fsrc+j,ofs3);
+          if (P      ) vfloat<K>::storeu(valid,P+ofs,      madd(b.x,  p0,madd(b.y,  p1,madd(b.z,  p2,b.w  *p3))));
+          if (dPdu   ) vfloat<K>::storeu(valid,dPdu+ofs,   madd(db.x, p0,madd(db.y, p1,madd(db.z, p2,db.w *p3))));
+          if (ddPdudu) vfloat<K>::storeu(valid,ddPdudu+ofs,madd(ddb.x,p0,madd(ddb.y,p1,madd(ddb.z,p2,ddb.w*p3))));
+        }
+      }
+    }
+
+    void interpolateN(const RTCInterpolateNArguments* const args) {
+      interpolateN_impl<4>(args);
+    }
   };
   
   template<template<typename Ty> class Curve>
@@ -689,6 +768,101 @@ namespace embree
     void interpolate(const RTCInterpolateArguments* const args) {
       interpolate_impl<4>(args);
     }
+
+    template<int K>
+    void interpolateN_impl(const RTCInterpolateNArguments* const args)
+    {
+      const int* valid_i = (const int*) args->valid;
+      const unsigned* primIDs = args->primIDs;
+      const float* u = args->u;
+      unsigned int N = args->N;
+      RTCBufferType bufferType = args->bufferType;
+      unsigned int bufferSlot = args->bufferSlot;
+      float* P = args->P;
+      float* dPdu = args->dPdu;
+      float* ddPdudu = args->ddPdudu;
+      unsigned int valueCount = args->valueCount;
+
+      /* we interpolate vertex attributes linearly for hermite basis */
+      const bool linear = bufferType == RTC_BUFFER_TYPE_VERTEX_ATTRIBUTE;
+      const char* vsrc = nullptr, *tsrc = nullptr;
+      size_t vstride = 0, tstride = 0;
+      bool gatherable = true;
+      if (linear) {
+        assert(bufferSlot <= vertexAttribs.size());
+        vsrc = vertexAttribs[bufferSlot].getPtr();
+        vstride = vertexAttribs[bufferSlot].getStride();
+        gatherable &= isGatherable(vertexAttribs[bufferSlot].size(),vstride);
+      } else {
+        assert(bufferSlot < numTimeSteps);
+        vsrc = vertices[bufferSlot].getPtr();
+        tsrc = tangents[bufferSlot].getPtr();
+        vstride = vertices[bufferSlot].getStride();
+        tstride = tangents[bufferSlot].getStride();
+        gatherable &= isGatherable(vertices[bufferSlot].size(),vstride);
+        gatherable &= isGatherable(tangents[bufferSlot].size(),tstride);
+      }
+
+      /* gathers use 32 bit offsets, huge buffers use the scalar path */
+      if (unlikely(!gatherable)) {
+        Geometry::interpolateN(args);
+        return;
+      }
+      const float* fvsrc = (const float*) vsrc;
+      const float* ftsrc = (const float*) tsrc;
+      const int fvstride = int(vstride/sizeof(float));
+      const int ftstride = int(tstride/sizeof(float));
+
+      for (unsigned int i=0; i<N; i+=K)
+      {
+        const vbool<K> valid0 = vint<K>((int)i)+vint<K>(step) < vint<K>(int(N));
+        vbool<K> valid = valid0;
+        if (valid_i) valid &= vint<K>::loadu(valid0,&valid_i[i]) != vint<K>(zero);
+        if (none(valid)) continue;
+
+        /* gather first vertex of all lanes */
+        const vint<K> primID = vint<K>::loadu(valid,&primIDs[i]);
+        vint<K> index(zero);
+        for (size_t m=movemask(valid), k=bsf(m); m!=0; m=btc(m,k), k=bsf(m))
+          index[k] = int(curves[primID[k]]);
+        const vfloat<K> uu = vfloat<K>::loadu(valid,&u[i]);
+        const vint<K> vofs0 = index*fvstride;
+        const vint<K> vofs1 = vofs0+fvstride;
+        const vint<K> tofs0 = index*ftstride;
+        const vint<K> tofs1 = tofs0+ftstride;
+
+        /* basis weights are shared by all values */
+        const Vec4vf<K> b   = BezierBasis::eval(uu);
+        const Vec4vf<K> db  = BezierBasis::derivative(uu);
+        const Vec4vf<K> ddb = BezierBasis::derivative2(uu);
+
+        for (unsigned int j=0; j<valueCount; j++)
+        {
+          const size_t ofs = j*N+i;
+          const vfloat<K> p0 = vfloat<K>::template gather<4>(valid,fvsrc+j,vofs0);
+          const vfloat<K> p1 = vfloat<K>::template gather<4>(valid,fvsrc+j,vofs1);
+          if (linear)
+          {
+            if (P      ) vfloat<K>::storeu(valid,P+ofs,      lerp(p0,p1,uu));
+            if (dPdu   ) vfloat<K>::storeu(valid,dPdu+ofs,   p1-p0);
+            if (ddPdudu) vfloat<K>::storeu(valid,ddPdudu+ofs,vfloat<K>(zero));
+            continue;
+          }
+
+          const vfloat<K> t0 = vfloat<K>::template gather<4>(valid,ftsrc+j,tofs0);
+          const vfloat<K> t1 = vfloat<K>::template gather<4>(valid,ftsrc+j,tofs1);
+          const vfloat<K> q1 = madd(1.0f/3.0f,t0,p0);
+          const vfloat<K> q2 = nmadd(1.0f/3.0f,t1,p1);
+          if (P      ) vfloat<K>::storeu(valid,P+ofs,      madd(b.x,  p0,madd(b.y,  q1,madd(b.z,  q2,b.w  *p1))));
+          if (dPdu   ) vfloat<K>::storeu(valid,dPdu+ofs,   madd(db.x, p0,madd(db.y, q1,madd(db.z, q2,db.w *p1))));
+          if (ddPdudu) vfloat<K>::storeu(valid,ddPdudu+ofs,madd(ddb.x,p0,madd(ddb.y,q1,madd(ddb.z,q2,ddb.w*p1))));
+        }
+      }
+    }
+
+    void interpolateN(const RTCInterpolateNArguments* const args) {
+      interpolateN_impl<4>(args);
+    }
   };
   }
   
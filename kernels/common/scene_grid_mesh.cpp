@@ -9,7 +9,9 @@ namespace embree
 #if defined(EMBREE_LOWEST_ISA)
 
   GridMesh::GridMesh (Device* device)
-    : Geometry(device,GTY_GRID_MESH,0,1)
+    : Geometry(device,GTY_GRID_MESH,0,1),
+      displFunc(nullptr),
+      displacementRate(1)
   {
     vertices.resize(numTimeSteps);
   }
@@ -141,8 +143,195 @@ namespace embree
       if (vertices[t].getStride() != vertices[0].getStride())
         throw_RTCError(RTC_ERROR_INVALID_OPERATION,"stride of vertex buffers have to be identical for each time step");
 
+    /* reserve one tessellation cache entry per subgrid of displaced grids, this also invalidates previously cached vertices */
+    displacementCacheOffsets.clear();
+    displacementCache.clear();
+    displacementCellBounds.clear();
+    if (displFunc)
+    {
+#if !defined(EMBREE_GEOMETRY_SUBDIVISION)
+      throw_RTCError(RTC_ERROR_INVALID_OPERATION,"displaced grids require subdivision surface support");
+#endif
+      if (numTimeSteps != 1)
+        throw_RTCError(RTC_ERROR_INVALID_OPERATION,"displaced grids do not support motion blur");
+
+      size_t numSubGrids = 0;
+      displacementCacheOffsets.resize(grids.size());
+      for (size_t i=0; i<grids.size(); i++)
+      {
+        const Grid& g = grid(i);
+        const size_t res = max(g.resX,g.resY);
+        if (res > 1 && (res-1)*displacementRate >= 0x7fff)
+          throw_RTCError(RTC_ERROR_INVALID_OPERATION,"grid resolution too large for displacement rate");
+        displacementCacheOffsets[i] = numSubGrids;
+        numSubGrids += max((unsigned int)1,((unsigned int)g.resX >> 1) * ((unsigned int)g.resY >> 1));
+      }
+      displacementCache.resize(numSubGrids);
+
+      /* cells cull nothing until the build calculated their bounds */
+      displacementCellBounds.resize(4*numSubGrids,BBox3fa(Vec3fa(neg_inf),Vec3fa(pos_inf)));
+    }
+
     Geometry::commit();
   }
+
+  void GridMesh::setTessellationRate(float N)
+  {
+    displacementRate = (unsigned int) clamp(ceilf(N),1.0f,float(MAX_DISPLACEMENT_RATE));
+    Geometry::update();
+  }
+
+  void GridMesh::setDisplacementFunction (RTCDisplacementFunctionN func)
+  {
+    displFunc = func;
+    Geometry::update();
+  }
+
+  void GridMesh::displace(size_t gridID, unsigned int sx, unsigned int sy, unsigned int cellsX, unsigned int cellsY, Vec3fa* dst) const
+  {
+    const Grid& g = grid(gridID);
+    const unsigned int R = displacementRate;
+    const unsigned int width = cellsX*R+1;
+    const unsigned int numVertices = width*(cellsY*R+1);
+    const float rcpR = rcp(float(R));
+    const float rcp_grid_width  = rcp(float((g.resX-1)*R));
+    const float rcp_grid_height = rcp(float((g.resY-1)*R));
+
+    /* the displacement function gets invoked for blocks of vertices, arrays are aligned and padded for SIMD processing */
+    static const unsigned int BLOCK_SIZE = 64;
+    __aligned(64) float u[BLOCK_SIZE], v[BLOCK_SIZE];
+    __aligned(64) float Ng_x[BLOCK_SIZE], Ng_y[BLOCK_SIZE], Ng_z[BLOCK_SIZE];
+    __aligned(64) float P_x[BLOCK_SIZE], P_y[BLOCK_SIZE], P_z[BLOCK_SIZE];
+
+    for (unsigned int i0=0; i0<numVertices; i0+=BLOCK_SIZE)
+    {
+      const unsigned int N = min(numVertices-i0,BLOCK_SIZE);
+      for (unsigned int k=0; k<N; k++)
+      {
+        /* integer coordinates of the refined vertex make vertices shared between subgrids bit identical */
+        const unsigned int ix = sx*R + (i0+k)%width;
+        const unsigned int iy = sy*R + (i0+k)/width;
+        const unsigned int cx = min(ix/R,(unsigned int)g.resX-2);
+        const unsigned int cy = min(iy/R,(unsigned int)g.resY-2);
+        const float fx = float(ix-cx*R)*rcpR;
+        const float fy = float(iy-cy*R)*rcpR;
+
+        /* bilinear interpolation of the grid cell */
+        const Vec3fa p00 = grid_vertex(g,cx+0,cy+0);
+        const Vec3fa p10 = grid_vertex(g,cx+1,cy+0);
+        const Vec3fa p01 = grid_vertex(g,cx+0,cy+1);
+        const Vec3fa p11 = grid_vertex(g,cx+1,cy+1);
+        const Vec3fa P = lerp(lerp(p00,p10,fx),lerp(p01,p11,fx),fy);
+        const Vec3fa dPdx = lerp(p10-p00,p11-p01,fy);
+        const Vec3fa dPdy = lerp(p01-p00,p11-p10,fx);
+        const Vec3fa Ng = normalize_safe(cross(dPdx,dPdy));
+
+        u[k] = float(ix)*rcp_grid_width;
+        v[k] = float(iy)*rcp_grid_height;
+        Ng_x[k] = Ng.x; Ng_y[k] = Ng.y; Ng_z[k] = Ng.z;
+        P_x[k] = P.x; P_y[k] = P.y; P_z[k] = P.z;
+      }
+
+      RTCDisplacementFunctionNArguments args;
+      args.geometryUserPtr = userPtr;
+      args.geometry = (RTCGeometry)this;
+      args.primID = unsigned(gridID);
+      args.timeStep = 0;
+      args.u = u;
+      args.v = v;
+      args.Ng_x = Ng_x;
+      args.Ng_y = Ng_y;
+      args.Ng_z = Ng_z;
+      args.P_x = P_x;
+      args.P_y = P_y;
+      args.P_z = P_z;
+      args.N = N;
+      displFunc(&args);
+
+      for (unsigned int k=0; k<N; k++)
+        dst[i0+k] = Vec3fa(P_x[k],P_y[k],P_z[k]);
+    }
+  }
+
+  bool GridMesh::buildDisplacedBounds(size_t gridID, size_t sx, size_t sy, BBox3fa& bbox) const
+  {
+    const Grid& g = grid(gridID);
+    if (!buildBounds(g,sx,sy,bbox)) return false;
+
+    /* only the bounds of the displaced vertices are kept, the vertices get evaluated again lazily during rendering */
+    const unsigned int cellsX = sx+2 < g.resX ? 2 : 1;
+    const unsigned int cellsY = sy+2 < g.resY ? 2 : 1;
+    Vec3fa vtx[(2*MAX_DISPLACEMENT_RATE+1)*(2*MAX_DISPLACEMENT_RATE+1)];
+    displace(gridID,(unsigned int)sx,(unsigned int)sy,cellsX,cellsY,vtx);
+
+    const unsigned int R = displacementRate;
+    const unsigned int width = cellsX*R+1;
+    const size_t numVertices = width*(cellsY*R+1);
+    for (size_t i=0; i<numVertices; i++)
+      if (unlikely(!isvalid(vtx[i]))) return false;
+
+    /* the bounds of the cells let rays skip the tessellation cache lookup of subgrids they only graze */
+    BBox3fa b(empty);
+    BBox3fa* cellBounds = &displacementCellBounds[4*displacementCacheIndex(gridID,(unsigned int)sx,(unsigned int)sy)];
+    for (unsigned int cy=0; cy<cellsY; cy++)
+    {
+      for (unsigned int cx=0; cx<cellsX; cx++)
+      {
+        BBox3fa cb(empty);
+        for (unsigned int y=cy*R; y<=(cy+1)*R; y++)
+          for (unsigned int x=cx*R; x<=(cx+1)*R; x++)
+            cb.extend(vtx[y*width+x]);
+        cellBounds[2*cy+cx] = cb;
+        b.extend(cb);
+      }
+    }
+    bbox = b;
+    return true;
+  }
+
+  const Vec3fa* GridMesh::lookupDisplacedSubGrid(size_t gridID, unsigned int sx, unsigned int sy, unsigned int cellsX, unsigned int cellsY, const BBox3fa*& blockBounds) const
+  {
+    const unsigned int width  = cellsX*displacementRate;
+    const unsigned int height = cellsY*displacementRate;
+    const unsigned int numVertices = (width+1)*(height+1);
+#if defined(EMBREE_GEOMETRY_SUBDIVISION)
+    SharedLazyTessellationCache::CacheEntry& entry = displacementCache[displacementCacheIndex(gridID,sx,sy)];
+    const Vec3fa* vtx = SharedLazyTessellationCache::lookup(entry,0,[&] () {
+        const unsigned int blocksX = (width+1)/2;
+        const unsigned int blocksY = (height+1)/2;
+        const size_t bytes = numVertices*sizeof(Vec3fa) + blocksX*blocksY*sizeof(BBox3fa);
+        Vec3fa* vtx = (Vec3fa*) SharedLazyTessellationCache::malloc(bytes);
+        displace(gridID,sx,sy,cellsX,cellsY,vtx);
+
+        /* bounds of the 2x2 blocks of refined cells the intersectors iterate over */
+        BBox3fa* bounds = (BBox3fa*) &vtx[numVertices];
+        for (unsigned int by=0; by<blocksY; by++)
+        {
+          for (unsigned int bx=0; bx<blocksX; bx++)
+          {
+            BBox3fa b(empty);
+            for (unsigned int y=2*by; y<=min(2*by+2,height); y++)
+              for (unsigned int x=2*bx; x<=min(2*bx+2,width); x++)
+                b.extend(vtx[y*(width+1)+x]);
+            bounds[by*blocksX+bx] = b;
+          }
+        }
+        return vtx;
+      });
+    blockBounds = (const BBox3fa*) &vtx[numVertices];
+    return vtx;
+#else
+    blockBounds = nullptr;
+    return nullptr;
+#endif
+  }
+
+  void GridMesh::releaseDisplacedSubGrid() const
+  {
+#if defined(EMBREE_GEOMETRY_SUBDIVISION)
+    SharedLazyTessellationCache::unlock();
+#endif
+  }
   
   void GridMesh::addElementsToCount (GeometryCounts & counts) const 
   {
@@ -175,6 +364,10 @@ namespace embree
   void GridMesh::interpolate(const RTCInterpolateArguments* const args) {
     interpolate_impl<4>(args);
   }
+
+  void GridMesh::interpolateN(const RTCInterpolateNArguments* const args) {
+    interpolateN_impl<4>(args);
+  }
   
 #endif
 
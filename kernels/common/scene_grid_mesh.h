@@ -5,6 +5,7 @@
 
 #include "geometry.h"
 #include "buffer.h"
+#include "../subdiv/tessellation_cache.h"
 
 namespace embree
 {
@@ -14,6 +15,9 @@ namespace embree
     /*! type of this geometry */
     static const Geometry::GTypeMask geom_type = Geometry::MTY_GRID_MESH;
 
+    /*! maximal number of refined cells per grid cell edge of displaced grids */
+    static const unsigned int MAX_DISPLACEMENT_RATE = 16;
+
     /*! grid */
     struct Grid 
     {
@@ -54,7 +58,10 @@ namespace embree
     void updateBuffer(RTCBufferType type, unsigned int slot);
     void commit();
     bool verify();
+    void setTessellationRate(float N);
+    void setDisplacementFunction (RTCDisplacementFunctionN func);
     void interpolate(const RTCInterpolateArguments* const args);
+    void interpolateN(const RTCInterpolateNArguments* const args);
 
     template<int N>
     void interpolate_impl(const RTCInterpolateArguments* const args)
@@ -133,6 +140,113 @@ namespace embree
         }
       }
     }
+
+    template<int K>
+    void interpolateN_impl(const RTCInterpolateNArguments* const args)
+    {
+      const int* valid_i = (const int*) args->valid;
+      const unsigned* primIDs = args->primIDs;
+      const float* u = args->u;
+      const float* v = args->v;
+      unsigned int N = args->N;
+      RTCBufferType bufferType = args->bufferType;
+      unsigned int bufferSlot = args->bufferSlot;
+      float* P = args->P;
+      float* dPdu = args->dPdu;
+      float* dPdv = args->dPdv;
+      float* ddPdudu = args->ddPdudu;
+      float* ddPdvdv = args->ddPdvdv;
+      float* ddPdudv = args->ddPdudv;
+      unsigned int valueCount = args->valueCount;
+
+      /* calculate base pointer and stride */
+      assert((bufferType == RTC_BUFFER_TYPE_VERTEX && bufferSlot < numTimeSteps) ||
+             (bufferType == RTC_BUFFER_TYPE_VERTEX_ATTRIBUTE && bufferSlot <= vertexAttribs.size()));
+      const char* src = nullptr; 
+      size_t stride = 0, num = 0;
+      if (bufferType == RTC_BUFFER_TYPE_VERTEX_ATTRIBUTE) {
+        src    = vertexAttribs[bufferSlot].getPtr();
+        stride = vertexAttribs[bufferSlot].getStride();
+        num    = vertexAttribs[bufferSlot].size();
+      } else {
+        src    = vertices[bufferSlot].getPtr();
+        stride = vertices[bufferSlot].getStride();
+        num    = vertices[bufferSlot].size();
+      }
+
+      /* gathers use 32 bit offsets, huge buffers use the scalar path */
+      if (unlikely(!isGatherable(num,stride))) {
+        Geometry::interpolateN(args);
+        return;
+      }
+      const float* fsrc = (const float*) src;
+      const int fstride = int(stride/sizeof(float));
+
+      for (unsigned int i=0; i<N; i+=K)
+      {
+        const vbool<K> valid0 = vint<K>((int)i)+vint<K>(step) < vint<K>(int(N));
+        vbool<K> valid = valid0;
+        if (valid_i) valid &= vint<K>::loadu(valid0,&valid_i[i]) != vint<K>(zero);
+        if (none(valid)) continue;
+
+        /* gather grid layouts of all lanes */
+        const vint<K> primID = vint<K>::loadu(valid,&primIDs[i]);
+        vint<K> startVtxID(zero), lineVtxOffset(zero);
+        vfloat<K> grid_width(1.0f), grid_height(1.0f);
+        for (size_t m=movemask(valid), k=bsf(m); m!=0; m=btc(m,k), k=bsf(m)) {
+          const Grid& g = grid(primID[k]);
+          startVtxID[k] = int(g.startVtxID);
+          lineVtxOffset[k] = int(g.lineVtxOffset);
+          grid_width[k] = float(g.resX-1);
+          grid_height[k] = float(g.resY-1);
+        }
+
+        /* clamp input u,v to [0;1] range and locate the grid cell, u=1 and v=1 map to the last cell */
+        const vfloat<K> UU = clamp(vfloat<K>::loadu(valid,&u[i]),vfloat<K>(zero),vfloat<K>(one))*grid_width;
+        const vfloat<K> VV = clamp(vfloat<K>::loadu(valid,&v[i]),vfloat<K>(zero),vfloat<K>(one))*grid_height;
+        const vfloat<K> fu = max(min(floor(UU),grid_width -1.0f),vfloat<K>(zero));
+        const vfloat<K> fv = max(min(floor(VV),grid_height-1.0f),vfloat<K>(zero));
+        const vfloat<K> uu = UU-fu;
+        const vfloat<K> vv = VV-fv;
+        const vint<K> idx0 = startVtxID + vint<K>(fv)*lineVtxOffset + vint<K>(fu);
+        const vint<K> ofs0 = idx0*fstride;
+        const vint<K> ofs3 = (idx0+lineVtxOffset)*fstride;
+        const vint<K> ofs1 = ofs0+fstride;
+        const vint<K> ofs2 = ofs3+fstride;
+        const vfloat<K> rcp_grid_width  = rcp(grid_width);
+        const vfloat<K> rcp_grid_height = rcp(grid_height);
+
+        const vbool<K> left = uu+vv <= 1.0f;
+        const vfloat<K> U = select(left,uu,vfloat<K>(1.0f)-uu);
+        const vfloat<K> V = select(left,vv,vfloat<K>(1.0f)-vv);
+        const vfloat<K> W = 1.0f-U-V;
+
+        for (unsigned int j=0; j<valueCount; j++)
+        {
+          const size_t ofs = j*N+i;
+          const vfloat<K> p0 = vfloat<K>::template gather<4>(valid,fsrc+j,ofs0);
+          const vfloat<K> p1 = vfloat<K>::template gather<4>(valid,fsrc+j,ofs1);
+          const vfloat<K> p2 = vfloat<K>::template gather<4>(valid,fsrc+j,ofs2);
+          const vfloat<K> p3 = vfloat<K>::template gather<4>(valid,fsrc+j,ofs3);
+          const vfloat<K> Q0 = select(left,p0,p2);
+          const vfloat<K> Q1 = select(left,p1,p3);
+          const vfloat<K> Q2 = select(left,p3,p1);
+
+          if (P) {
+            vfloat<K>::storeu(valid,P+ofs,madd(W,Q0,madd(U,Q1,V*Q2)));
+          }
+          if (dPdu) {
+            assert(dPdu); vfloat<K>::storeu(valid,dPdu+ofs,select(left,Q1-Q0,Q0-Q1)*rcp_grid_width);
+            assert(dPdv); vfloat<K>::storeu(valid,dPdv+ofs,select(left,Q2-Q0,Q0-Q2)*rcp_grid_height);
+          }
+          if (ddPdudu) {
+            assert(ddPdudu); vfloat<K>::storeu(valid,ddPdudu+ofs,vfloat<K>(zero));
+            assert(ddPdvdv); vfloat<K>::storeu(valid,ddPdvdv+ofs,vfloat<K>(zero));
+            assert(ddPdudv); vfloat<K>::storeu(valid,ddPdudv+ofs,vfloat<K>(zero));
+          }
+        }
+      }
+    }
     
     void addElementsToCount (GeometryCounts & counts) const;
     
@@ -217,6 +331,13 @@ namespace embree
       return true;
     }
 
+    /*! calculates the build bounds of a subgrid of the i'th grid including its displacement, if it's valid */
+    __forceinline bool buildBounds(size_t gridID, size_t sx, size_t sy, BBox3fa& bbox) const
+    {
+      if (unlikely(isDisplaced())) return buildDisplacedBounds(gridID,sx,sy,bbox);
+      return buildBounds(grid(gridID),sx,sy,bbox);
+    }
+
     /*! calculates the build bounds of the i'th primitive at the itime'th time segment, if it's valid */
     __forceinline bool buildBounds(const Grid& g, size_t sx, size_t sy, size_t itime, BBox3fa& bbox) const
     {
@@ -274,11 +395,45 @@ namespace embree
       return LBBox3fa([&] (size_t itime) { return bounds(g,sx,sy,itime); }, dt, time_range, fnumTimeSegments);
     }
 
+    /*! checks if the grids get refined and displaced by a displacement function */
+    __forceinline bool isDisplaced() const {
+      return !displacementCache.empty();
+    }
+
+    /*! evaluates the displaced vertices of cellsX x cellsY cells of the i'th grid starting at (sx,sy), each cell gets refined into displacementRate x displacementRate cells */
+    void displace(size_t gridID, unsigned int sx, unsigned int sy, unsigned int cellsX, unsigned int cellsY, Vec3fa* dst) const;
+
+    /*! calculates the build bounds of the displaced subgrid starting at (sx,sy), also records the displaced bounds of its cells */
+    bool buildDisplacedBounds(size_t gridID, size_t sx, size_t sy, BBox3fa& bbox) const;
+
+    /*! returns the index of the tessellation cache entry of the subgrid starting at (sx,sy) */
+    __forceinline size_t displacementCacheIndex(size_t gridID, unsigned int sx, unsigned int sy) const {
+      return displacementCacheOffsets[gridID] + (sy>>1)*(grid(gridID).resX>>1) + (sx>>1);
+    }
+
+    /*! returns the displaced bounds of the 2x2 cells of the subgrid starting at (sx,sy), cell (cx,cy) is stored at index 2*cy+cx */
+    __forceinline const BBox3fa* displacedCellBounds(size_t gridID, unsigned int sx, unsigned int sy) const {
+      return &displacementCellBounds[4*displacementCacheIndex(gridID,sx,sy)];
+    }
+
+    /*! returns the displaced vertices of a subgrid from the tessellation cache, followed by the bounds of
+     *  each 2x2 block of refined cells, the vertices stay valid until releaseDisplacedSubGrid gets called */
+    const Vec3fa* lookupDisplacedSubGrid(size_t gridID, unsigned int sx, unsigned int sy, unsigned int cellsX, unsigned int cellsY, const BBox3fa*& blockBounds) const;
+
+    /*! releases the vertices returned by lookupDisplacedSubGrid */
+    void releaseDisplacedSubGrid() const;
+
   public:
     BufferView<Grid> grids;      //!< array of triangles
     BufferView<Vec3fa> vertices0;        //!< fast access to first vertex buffer
     vector<BufferView<Vec3fa>> vertices; //!< vertex array for each timestep
     vector<RawBufferView> vertexAttribs; //!< vertex attributes
+
+    RTCDisplacementFunctionN displFunc;  //!< displacement function
+    unsigned int displacementRate;       //!< number of refined cells per grid cell edge of displaced grids
+    std::vector<size_t> displacementCacheOffsets; //!< index of the first cache entry of each grid
+    mutable std::vector<SharedLazyTessellationCache::CacheEntry> displacementCache; //!< one tessellation cache entry per subgrid of displaced grids
+    mutable std::vector<BBox3fa> displacementCellBounds; //!< displaced bounds of the 2x2 cells of each subgrid of displaced grids
   };
 
   namespace isa
@@ -16,6 +16,7 @@ namespace embree
     if (object) object->refInc();
     gsubtype = GTY_SUBTYPE_INSTANCE_LINEAR;
     world2local0 = one;
+    origin = Vec3d(zero);
     local2world = (AffineSpace3ff*) alignedMalloc(numTimeSteps*sizeof(AffineSpace3ff),16);
     for (size_t i = 0; i < numTimeSteps; i++)
       local2world[i] = one;
@@ -56,23 +57,17 @@ namespace embree
     Geometry::update();
   }
 
-#if 0
-  void Instance::preCommit()
+  void Instance::setInstanceOrigin(const Vec3d& origin_i)
   {
-#if 0 // disable expensive instance optimization for now
-    // decide whether we're an expensive instance or not
-    auto numExpensiveGeo =  static_cast<Scene*> (object)->getNumPrimitives(CurveGeometry::geom_type, false)
-                          + static_cast<Scene*> (object)->getNumPrimitives(CurveGeometry::geom_type, true)
-                          + static_cast<Scene*> (object)->getNumPrimitives(UserGeometry::geom_type, false)
-                          + static_cast<Scene*> (object)->getNumPrimitives(UserGeometry::geom_type, true);
-    if (numExpensiveGeo > 0) {
-      this->gtype = GTY_INSTANCE_EXPENSIVE;
-    }
-#endif
+    origin = origin_i;
+    Geometry::update();
+  }
 
-    Geometry::preCommit();
+  Vec3fa Instance::getObjectOrigin() const
+  {
+    const Vec3d& o = ((Scene*)object)->origin;
+    return Vec3fa(float(o.x),float(o.y),float(o.z));
   }
-#endif
 
   void Instance::addElementsToCount (GeometryCounts & counts) const 
   {
@@ -91,6 +86,16 @@ namespace embree
     }
   }
 
+  void Instance::addExpensiveElementsToCount (GeometryCounts & counts) const
+  {
+    /* expensive instances are put into a separate hierarchy that gets traversed last */
+    if (1 == numTimeSteps) {
+      counts.numInstancesExpensive += numPrimitives;
+    } else {
+      counts.numMBInstancesExpensive += numPrimitives;
+    }
+  }
+
   void Instance::setTransform(const AffineSpace3fa& xfm, unsigned int timeStep)
   {
     if (timeStep >= numTimeSteps)
@@ -47,12 +47,14 @@ namespace embree
   public:
     virtual void setNumTimeSteps (unsigned int numTimeSteps) override;
     virtual void setInstancedScene(const Ref<Scene>& scene) override;
+    virtual void setInstanceOrigin(const Vec3d& origin) override;
     virtual void setTransform(const AffineSpace3fa& local2world, unsigned int timeStep) override;
     virtual void setQuaternionDecomposition(const AffineSpace3ff& qd, unsigned int timeStep) override;
     virtual AffineSpace3fa getTransform(float time) override;
     virtual void setMask (unsigned mask) override;
     virtual void build() {}
     virtual void addElementsToCount (GeometryCounts & counts) const override;
+    void addExpensiveElementsToCount (GeometryCounts & counts) const;
     virtual void commit() override;
 
   public:
@@ -61,13 +63,29 @@ namespace embree
     __forceinline BBox3fa bounds(size_t i) const {
       assert(i == 0);
       if (unlikely(gsubtype == GTY_SUBTYPE_INSTANCE_QUATERNION))
-        return xfmBounds(quaternionDecompositionToAffineSpace(local2world[0]),object->bounds.bounds());
-      return xfmBounds(local2world[0],object->bounds.bounds());
+        return xfmBounds(quaternionDecompositionToAffineSpace(local2world[0]),getObjectBounds());
+      return xfmBounds(local2world[0],getObjectBounds());
+    }
+
+    /*! gets the bounds of the instanced scene in the local frame of the instance */
+    __forceinline BBox3fa getObjectBounds() const {
+      const BBox3fa b = object->bounds.bounds();
+      const Vec3fa objectOrigin = getObjectOrigin();
+      return BBox3fa(b.lower+objectOrigin,b.upper+objectOrigin);
     }
 
-    /*! gets the bounds of the instanced scene */
     __forceinline BBox3fa getObjectBounds(size_t itime) const {
-      return object->getBounds(timeStep(itime));
+      const BBox3fa b = object->getBounds(timeStep(itime));
+      const Vec3fa objectOrigin = getObjectOrigin();
+      return BBox3fa(b.lower+objectOrigin,b.upper+objectOrigin);
+    }
+
+    /*! returns the origin of the instanced scene, its geometry is stored relative to that origin */
+    Vec3fa getObjectOrigin() const;
+
+    /*! returns the offset of the instance origin to the origin of a scene, the difference is calculated in double precision */
+    __forceinline Vec3fa getOriginOffset(const Vec3d& sceneOrigin) const {
+      return Vec3fa(float(origin.x-sceneOrigin.x),float(origin.y-sceneOrigin.y),float(origin.z-sceneOrigin.z));
     }
 
      /*! calculates the bounds of instance */
@@ -85,6 +103,13 @@ namespace embree
       return lbbox;
     }
 
+    /*! calculates the linear bounds of the i'th primitive for the specified time range, translated by the specified offset */
+    __forceinline LBBox3fa linearBounds(size_t i, const BBox1f& dt, const Vec3fa& offset) const {
+      const LBBox3fa lbbox = linearBounds(i,dt);
+      return LBBox3fa(BBox3fa(lbbox.bounds0.lower+offset,lbbox.bounds0.upper+offset),
+                      BBox3fa(lbbox.bounds1.lower+offset,lbbox.bounds1.upper+offset));
+    }
+
     /*! calculates the build bounds of the i'th item, if it's valid */
     __forceinline bool buildBounds(size_t i, BBox3fa* bbox = nullptr) const
     {
@@ -211,6 +236,7 @@ namespace embree
     Accel* object;                 //!< pointer to instanced acceleration structure
     AffineSpace3ff* local2world;   //!< transformation from local space to world space for each timestep (either normal matrix or quaternion decomposition)
     AffineSpace3fa world2local0;   //!< transformation from world space to local space for timestep 0
+    Vec3d origin;                  //!< double precision origin of the instance
   };
 
   namespace isa
@@ -220,7 +246,21 @@ namespace embree
       InstanceISA (Device* device)
         : Instance(device) {}
 
-      PrimInfo createPrimRefArray(mvector<PrimRef>& prims, const range<size_t>& r, size_t k, unsigned int geomID) const
+      PrimInfo createPrimRefArray(mvector<PrimRef>& prims, const range<size_t>& r, size_t k, unsigned int geomID) const {
+        return createPrimRefArray(prims,r,k,geomID,Vec3d(zero));
+      }
+
+      PrimInfo createPrimRefArrayMB(mvector<PrimRef>& prims, size_t itime, const range<size_t>& r, size_t k, unsigned int geomID) const {
+        return createPrimRefArrayMB(prims,itime,r,k,geomID,Vec3d(zero));
+      }
+
+      PrimInfoMB createPrimRefMBArray(mvector<PrimRefMB>& prims, const BBox1f& t0t1, const range<size_t>& r, size_t k, unsigned int geomID) const {
+        return createPrimRefMBArray(prims,t0t1,r,k,geomID,Vec3d(zero));
+      }
+
+      /* the following functions place the instance relative to the origin of the scene it gets built into */
+
+      PrimInfo createPrimRefArray(mvector<PrimRef>& prims, const range<size_t>& r, size_t k, unsigned int geomID, const Vec3d& sceneOrigin) const
       {
         assert(r.begin() == 0);
         assert(r.end()   == 1);
@@ -231,13 +271,14 @@ namespace embree
         // const BBox3fa b = bounds(0);
         // if (!isvalid(b)) return pinfo;
 
-        const PrimRef prim(b,geomID,unsigned(0));
+        const Vec3fa offset = getOriginOffset(sceneOrigin);
+        const PrimRef prim(BBox3fa(b.lower+offset,b.upper+offset),geomID,unsigned(0));
         pinfo.add_center2(prim);
         prims[k++] = prim;
         return pinfo;
       }
 
-      PrimInfo createPrimRefArrayMB(mvector<PrimRef>& prims, size_t itime, const range<size_t>& r, size_t k, unsigned int geomID) const
+      PrimInfo createPrimRefArrayMB(mvector<PrimRef>& prims, size_t itime, const range<size_t>& r, size_t k, unsigned int geomID, const Vec3d& sceneOrigin) const
       {
         assert(r.begin() == 0);
         assert(r.end()   == 1);
@@ -247,20 +288,21 @@ namespace embree
         if (!buildBounds(0,&b)) return pinfo;
         // if (!valid(0,range<size_t>(itime))) return pinfo;
         // const PrimRef prim(linearBounds(0,itime).bounds(),geomID,unsigned(0));
-        const PrimRef prim(b,geomID,unsigned(0));
+        const Vec3fa offset = getOriginOffset(sceneOrigin);
+        const PrimRef prim(BBox3fa(b.lower+offset,b.upper+offset),geomID,unsigned(0));
         pinfo.add_center2(prim);
         prims[k++] = prim;
         return pinfo;
       }
       
-      PrimInfoMB createPrimRefMBArray(mvector<PrimRefMB>& prims, const BBox1f& t0t1, const range<size_t>& r, size_t k, unsigned int geomID) const
+      PrimInfoMB createPrimRefMBArray(mvector<PrimRefMB>& prims, const BBox1f& t0t1, const range<size_t>& r, size_t k, unsigned int geomID, const Vec3d& sceneOrigin) const
       {
         assert(r.begin() == 0);
         assert(r.end()   == 1);
 
         PrimInfoMB pinfo(empty);
         if (!valid(0, timeSegmentRange(t0t1))) return pinfo;
-        const PrimRefMB prim(linearBounds(0,t0t1),this->numTimeSegments(),this->time_range,this->numTimeSegments(),geomID,unsigned(0));
+        const PrimRefMB prim(linearBounds(0,t0t1,getOriginOffset(sceneOrigin)),this->numTimeSegments(),this->time_range,this->numTimeSegments(),geomID,unsigned(0));
         pinfo.add_primref(prim);
         prims[k++] = prim;
         return pinfo;
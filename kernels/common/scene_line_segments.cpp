@@ -270,6 +270,10 @@ namespace embree
   void LineSegments::interpolate(const RTCInterpolateArguments* const args) {
     interpolate_impl<4>(args);
   }
+
+  void LineSegments::interpolateN(const RTCInterpolateNArguments* const args) {
+    interpolateN_impl<4>(args);
+  }
 #endif
 
   namespace isa
@@ -30,6 +30,7 @@ namespace embree
     void commit();
     bool verify ();
     void interpolate(const RTCInterpolateArguments* const args);
+    void interpolateN(const RTCInterpolateNArguments* const args);
     void setTessellationRate(float N);
     void setMaxRadiusScale(float s);
     void addElementsToCount (GeometryCounts & counts) const;
@@ -71,6 +72,70 @@ namespace embree
         if (ddPdudu) mem<vfloat<N>>::storeu(valid,dPdu+i,vfloat<N>(zero));
       }
     }
+
+    template<int K>
+    void interpolateN_impl(const RTCInterpolateNArguments* const args)
+    {
+      const int* valid_i = (const int*) args->valid;
+      const unsigned* primIDs = args->primIDs;
+      const float* u = args->u;
+      unsigned int N = args->N;
+      RTCBufferType bufferType = args->bufferType;
+      unsigned int bufferSlot = args->bufferSlot;
+      float* P = args->P;
+      float* dPdu = args->dPdu;
+      float* ddPdudu = args->ddPdudu;
+      unsigned int valueCount = args->valueCount;
+
+      /* calculate base pointer and stride */
+      assert((bufferType == RTC_BUFFER_TYPE_VERTEX && bufferSlot < numTimeSteps) ||
+             (bufferType == RTC_BUFFER_TYPE_VERTEX_ATTRIBUTE && bufferSlot <= vertexAttribs.size()));
+      const char* src = nullptr; 
+      size_t stride = 0, num = 0;
+      if (bufferType == RTC_BUFFER_TYPE_VERTEX_ATTRIBUTE) {
+        src    = vertexAttribs[bufferSlot].getPtr();
+        stride = vertexAttribs[bufferSlot].getStride();
+        num    = vertexAttribs[bufferSlot].size();
+      } else {
+        src    = vertices[bufferSlot].getPtr();
+        stride = vertices[bufferSlot].getStride();
+        num    = vertices[bufferSlot].size();
+      }
+
+      /* gathers use 32 bit offsets, huge buffers use the scalar path */
+      if (unlikely(!isGatherable(num,stride))) {
+        Geometry::interpolateN(args);
+        return;
+      }
+      const float* fsrc = (const float*) src;
+      const int fstride = int(stride/sizeof(float));
+
+      for (unsigned int i=0; i<N; i+=K)
+      {
+        const vbool<K> valid0 = vint<K>((int)i)+vint<K>(step) < vint<K>(int(N));
+        vbool<K> valid = valid0;
+        if (valid_i) valid &= vint<K>::loadu(valid0,&valid_i[i]) != vint<K>(zero);
+        if (none(valid)) continue;
+
+        /* gather vertex offsets of all lanes */
+        const vint<K> primID = vint<K>::loadu(valid,&primIDs[i]);
+        vint<K> ofs0(zero);
+        for (size_t m=movemask(valid), k=bsf(m); m!=0; m=btc(m,k), k=bsf(m))
+          ofs0[k] = int(segment(primID[k])*fstride);
+        const vint<K> ofs1 = ofs0+fstride;
+        const vfloat<K> uu = vfloat<K>::loadu(valid,&u[i]);
+
+        for (unsigned int j=0; j<valueCount; j++)
+        {
+          const size_t ofs = j*N+i;
+          const vfloat<K> p0 = vfloat<K>::template gather<4>(valid,fsrc+j,ofs0);
+          const vfloat<K> p1 = vfloat<K>::template gather<4>(valid,fsrc+j,ofs1);
+          if (P      ) vfloat<K>::storeu(valid,P+ofs,lerp(p0,p1,uu));
+          if (dPdu   ) vfloat<K>::storeu(valid,dPdu+ofs,p1-p0);
+          if (ddPdudu) vfloat<K>::storeu(valid,ddPdudu+ofs,vfloat<K>(zero));
+        }
+      }
+    }
     
   public:
 
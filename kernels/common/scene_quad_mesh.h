@@ -41,6 +41,8 @@ namespace embree
     void commit();
     bool verify();
     void interpolate(const RTCInterpolateArguments* const args);
+    void interpolateN(const RTCInterpolateNArguments* const args);
+    void setVertexDequantization(const Vec3fa& scale, const Vec3fa& offset);
     void addElementsToCount (GeometryCounts & counts) const;
 
     template<int N>
@@ -71,12 +73,24 @@ namespace embree
         src    = vertices[bufferSlot].getPtr();
         stride = vertices[bufferSlot].getStride();
       }
+
+      /* compact vertex positions get decoded into a local buffer first */
+      Quad tri = quad(primID);
+      Vec3fa decoded[4];
+      if (bufferType == RTC_BUFFER_TYPE_VERTEX && hasCompactVertices())
+      {
+        for (unsigned int k=0; k<4; k++) {
+          decoded[k] = vertex(tri.v[k],bufferSlot);
+          tri.v[k] = k;
+        }
+        src = (const char*) decoded;
+        stride = sizeof(Vec3fa);
+      }
       
       for (unsigned int i=0; i<valueCount; i+=N)
       {
         const vbool<N> valid = vint<N>((int)i)+vint<N>(step) < vint<N>(int(valueCount));
         const size_t ofs = i*sizeof(float);
-        const Quad& tri = quad(primID);
         const vfloat<N> p0 = mem<vfloat<N>>::loadu(valid,(float*)&src[tri.v[0]*stride+ofs]);
         const vfloat<N> p1 = mem<vfloat<N>>::loadu(valid,(float*)&src[tri.v[1]*stride+ofs]);
         const vfloat<N> p2 = mem<vfloat<N>>::loadu(valid,(float*)&src[tri.v[2]*stride+ofs]);
@@ -102,21 +116,126 @@ namespace embree
         }
       }
     }
+
+    template<int K>
+    void interpolateN_impl(const RTCInterpolateNArguments* const args)
+    {
+      const int* valid_i = (const int*) args->valid;
+      const unsigned* primIDs = args->primIDs;
+      const float* u = args->u;
+      const float* v = args->v;
+      unsigned int N = args->N;
+      RTCBufferType bufferType = args->bufferType;
+      unsigned int bufferSlot = args->bufferSlot;
+      float* P = args->P;
+      float* dPdu = args->dPdu;
+      float* dPdv = args->dPdv;
+      float* ddPdudu = args->ddPdudu;
+      float* ddPdvdv = args->ddPdvdv;
+      float* ddPdudv = args->ddPdudv;
+      unsigned int valueCount = args->valueCount;
+
+      /* calculate base pointer and stride */
+      assert((bufferType == RTC_BUFFER_TYPE_VERTEX && bufferSlot < numTimeSteps) ||
+             (bufferType == RTC_BUFFER_TYPE_VERTEX_ATTRIBUTE && bufferSlot <= vertexAttribs.size()));
+      const char* src = nullptr; 
+      size_t stride = 0, num = 0;
+      if (bufferType == RTC_BUFFER_TYPE_VERTEX_ATTRIBUTE) {
+        src    = vertexAttribs[bufferSlot].getPtr();
+        stride = vertexAttribs[bufferSlot].getStride();
+        num    = vertexAttribs[bufferSlot].size();
+      } else {
+        src    = vertices[bufferSlot].getPtr();
+        stride = vertices[bufferSlot].getStride();
+        num    = vertices[bufferSlot].size();
+      }
+
+      /* gathers use 32 bit offsets, huge buffers and compact vertex positions use the scalar path */
+      if (unlikely(!isGatherable(num,stride) || (bufferType == RTC_BUFFER_TYPE_VERTEX && hasCompactVertices()))) {
+        Geometry::interpolateN(args);
+        return;
+      }
+      const float* fsrc = (const float*) src;
+      const int fstride = int(stride/sizeof(float));
+
+      for (unsigned int i=0; i<N; i+=K)
+      {
+        const vbool<K> valid0 = vint<K>((int)i)+vint<K>(step) < vint<K>(int(N));
+        vbool<K> valid = valid0;
+        if (valid_i) valid &= vint<K>::loadu(valid0,&valid_i[i]) != vint<K>(zero);
+        if (none(valid)) continue;
+
+        /* gather vertex offsets of all lanes */
+        const vint<K> primID = vint<K>::loadu(valid,&primIDs[i]);
+        vint<K> ofs0(zero), ofs1(zero), ofs2(zero), ofs3(zero);
+        for (size_t m=movemask(valid), k=bsf(m); m!=0; m=btc(m,k), k=bsf(m)) {
+          const Quad& q = quad(primID[k]);
+          ofs0[k] = int(q.v[0]*fstride);
+          ofs1[k] = int(q.v[1]*fstride);
+          ofs2[k] = int(q.v[2]*fstride);
+          ofs3[k] = int(q.v[3]*fstride);
+        }
+        const vfloat<K> uu = vfloat<K>::loadu(valid,&u[i]);
+        const vfloat<K> vv = vfloat<K>::loadu(valid,&v[i]);
+        const vbool<K> left = uu+vv <= 1.0f;
+        const vfloat<K> U = select(left,uu,vfloat<K>(1.0f)-uu);
+        const vfloat<K> V = select(left,vv,vfloat<K>(1.0f)-vv);
+        const vfloat<K> W = 1.0f-U-V;
+
+        for (unsigned int j=0; j<valueCount; j++)
+        {
+          const size_t ofs = j*N+i;
+          const vfloat<K> p0 = vfloat<K>::template gather<4>(valid,fsrc+j,ofs0);
+          const vfloat<K> p1 = vfloat<K>::template gather<4>(valid,fsrc+j,ofs1);
+          const vfloat<K> p2 = vfloat<K>::template gather<4>(valid,fsrc+j,ofs2);
+          const vfloat<K> p3 = vfloat<K>::template gather<4>(valid,fsrc+j,ofs3);
+          const vfloat<K> Q0 = select(left,p0,p2);
+          const vfloat<K> Q1 = select(left,p1,p3);
+          const vfloat<K> Q2 = select(left,p3,p1);
+
+          if (P) {
+            vfloat<K>::storeu(valid,P+ofs,madd(W,Q0,madd(U,Q1,V*Q2)));
+          }
+          if (dPdu) {
+            assert(dPdu); vfloat<K>::storeu(valid,dPdu+ofs,select(left,Q1-Q0,Q0-Q1));
+            assert(dPdv); vfloat<K>::storeu(valid,dPdv+ofs,select(left,Q2-Q0,Q0-Q2));
+          }
+          if (ddPdudu) {
+            assert(ddPdudu); vfloat<K>::storeu(valid,ddPdudu+ofs,vfloat<K>(zero));
+            assert(ddPdvdv); vfloat<K>::storeu(valid,ddPdvdv+ofs,vfloat<K>(zero));
+            assert(ddPdudv); vfloat<K>::storeu(valid,ddPdudv+ofs,vfloat<K>(zero));
+          }
+        }
+      }
+    }
         
   public:
 
+    /*! returns true if vertex positions are stored as half or 16-bit normalized values */
+    __forceinline bool hasCompactVertices() const {
+      return isCompactVertexFormat(vertices0.getFormat());
+    }
+
     /*! returns number of vertices */
     __forceinline size_t numVertices() const {
       return vertices[0].size();
     }
     
     /*! returns i'th quad */
-    __forceinline const Quad& quad(size_t i) const {
+    __forceinline const Quad quad(size_t i) const
+    {
+      if (unlikely(quads.getFormat() == RTC_FORMAT_USHORT4)) {
+        const unsigned short* idx = (const unsigned short*) quads.getPtr(i);
+        return { { idx[0], idx[1], idx[2], idx[3] } };
+      }
       return quads[i];
     }
 
     /*! returns i'th vertex of itime'th timestep */
-    __forceinline const Vec3fa vertex(size_t i) const {
+    __forceinline const Vec3fa vertex(size_t i) const
+    {
+      if (unlikely(hasCompactVertices()))
+        return vertices0.decode(i,dequantScale,dequantOffset);
       return vertices0[i];
     }
 
@@ -126,7 +245,10 @@ namespace embree
     }
 
     /*! returns i'th vertex of itime'th timestep */
-    __forceinline const Vec3fa vertex(size_t i, size_t itime) const {
+    __forceinline const Vec3fa vertex(size_t i, size_t itime) const
+    {
+      if (unlikely(hasCompactVertices()))
+        return vertices[itime].decode(i,dequantScale,dequantOffset);
       return vertices[itime][i];
     }
 
@@ -252,6 +374,7 @@ namespace embree
 
     /*! get fast access to first vertex buffer */
     __forceinline float * getCompactVertexArray () const {
+      if (hasCompactVertices()) return nullptr;
       return (float*) vertices0.getPtr();
     }
 
@@ -280,6 +403,8 @@ namespace embree
     BufferView<Quad> quads;                 //!< array of quads
     BufferView<Vec3fa> vertices0;           //!< fast access to first vertex buffer
     vector<BufferView<Vec3fa>> vertices;    //!< vertex array for each timestep
+    Vec3fa dequantScale;                    //!< scale to dequantize compact vertex positions
+    Vec3fa dequantOffset;                   //!< offset to dequantize compact vertex positions
     vector<BufferView<char>> vertexAttribs; //!< vertex attribute buffers
   };
 
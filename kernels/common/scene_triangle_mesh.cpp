@@ -12,6 +12,8 @@ namespace embree
     : Geometry(device,GTY_TRIANGLE_MESH,0,1)
   {
     vertices.resize(numTimeSteps);
+    dequantScale = Vec3fa(one);
+    dequantOffset = Vec3fa(zero);
   }
 
   void TriangleMesh::setMask (unsigned mask) 
@@ -34,13 +36,14 @@ namespace embree
   
   void TriangleMesh::setBuffer(RTCBufferType type, unsigned int slot, RTCFormat format, const Ref<Buffer>& buffer, size_t offset, size_t stride, unsigned int num)
   {
-    /* verify that all accesses are 4 bytes aligned */
-    if (((size_t(buffer->getPtr()) + offset) & 0x3) || (stride & 0x3)) 
+    /* verify that all accesses are 4 bytes aligned, 16-bit formats only have to be 2 bytes aligned */
+    const size_t align = is16BitFormat(format) ? 0x1 : 0x3;
+    if (((size_t(buffer->getPtr()) + offset) & align) || (stride & align))
       throw_RTCError(RTC_ERROR_INVALID_OPERATION, "data must be 4 bytes aligned");
 
     if (type == RTC_BUFFER_TYPE_VERTEX)
     {
-      if (format != RTC_FORMAT_FLOAT3)
+      if (format != RTC_FORMAT_FLOAT3 && !isCompactVertexFormat(format))
         throw_RTCError(RTC_ERROR_INVALID_OPERATION, "invalid vertex buffer format");
 
       /* if buffer is larger than 16GB the premultiplied index optimization does not work */
@@ -51,7 +54,8 @@ namespace embree
         throw_RTCError(RTC_ERROR_INVALID_ARGUMENT, "invalid vertex buffer slot");
 
       vertices[slot].set(buffer, offset, stride, num, format);
-      vertices[slot].checkPadding16();
+      if (!isCompactVertexFormat(format))
+        vertices[slot].checkPadding16();
       vertices0 = vertices[0];
     }
     else if (type == RTC_BUFFER_TYPE_VERTEX_ATTRIBUTE)
@@ -69,7 +73,7 @@ namespace embree
     {
       if (slot != 0)
         throw_RTCError(RTC_ERROR_INVALID_ARGUMENT, "invalid buffer slot");
-      if (format != RTC_FORMAT_UINT3)
+      if (format != RTC_FORMAT_UINT3 && format != RTC_FORMAT_USHORT3)
         throw_RTCError(RTC_ERROR_INVALID_OPERATION, "invalid index buffer format");
 
       triangles.set(buffer, offset, stride, num, format);
@@ -141,6 +145,11 @@ namespace embree
       if (vertices[t].getStride() != vertices[0].getStride())
         throw_RTCError(RTC_ERROR_INVALID_OPERATION,"stride of vertex buffers have to be identical for each time step");
 
+    /* verify that format of all time steps are identical */
+    for (unsigned int t=0; t<numTimeSteps; t++)
+      if (vertices[t].getFormat() != vertices[0].getFormat())
+        throw_RTCError(RTC_ERROR_INVALID_OPERATION,"format of vertex buffers have to be identical for each time step");
+
     Geometry::commit();
   }
 
@@ -164,16 +173,17 @@ namespace embree
         return false;
 
     /*! verify triangle indices */
-    for (size_t i=0; i<size(); i++) {     
-      if (triangles[i].v[0] >= numVertices()) return false; 
-      if (triangles[i].v[1] >= numVertices()) return false; 
-      if (triangles[i].v[2] >= numVertices()) return false; 
+    for (size_t i=0; i<size(); i++) {
+      const Triangle prim = triangle(i);
+      if (prim.v[0] >= numVertices()) return false;
+      if (prim.v[1] >= numVertices()) return false;
+      if (prim.v[2] >= numVertices()) return false;
     }
 
     /*! verify vertices */
-    for (const auto& buffer : vertices)
-      for (size_t i=0; i<buffer.size(); i++)
-	if (!isvalid(buffer[i])) 
+    for (size_t t=0; t<vertices.size(); t++)
+      for (size_t i=0; i<vertices[t].size(); i++)
+	if (!isvalid(vertex(i,t)))
 	  return false;
 
     return true;
@@ -182,6 +192,17 @@ namespace embree
   void TriangleMesh::interpolate(const RTCInterpolateArguments* const args) {
     interpolate_impl<4>(args);
   }
+
+  void TriangleMesh::interpolateN(const RTCInterpolateNArguments* const args) {
+    interpolateN_impl<4>(args);
+  }
+
+  void TriangleMesh::setVertexDequantization(const Vec3fa& scale, const Vec3fa& offset)
+  {
+    dequantScale = scale;
+    dequantOffset = offset;
+    Geometry::update();
+  }
  
 #endif
 
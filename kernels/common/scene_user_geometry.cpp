@@ -27,6 +27,10 @@ namespace embree
     this->boundsFunc = bounds;
   }
 
+  void UserGeometry::setSplitFunction (RTCSplitFunction split) {
+    this->splitFunc = split;
+  }
+
   void UserGeometry::setIntersectFunctionN (RTCIntersectFunctionN intersect) {
     intersectorN.intersect = intersect;
   }
@@ -17,6 +17,7 @@ namespace embree
     UserGeometry (Device* device, unsigned int items = 0, unsigned int numTimeSteps = 1);
     virtual void setMask (unsigned mask);
     virtual void setBoundsFunction (RTCBoundsFunction bounds, void* userPtr);
+    virtual void setSplitFunction (RTCSplitFunction split);
     virtual void setIntersectFunctionN (RTCIntersectFunctionN intersect);
     virtual void setOccludedFunctionN (RTCOccludedFunctionN occluded);
     virtual void build() {}
@@ -34,6 +34,7 @@ namespace embree
 
     cout << "    #stack nodes  = " << float(data.normal.trav_stack_nodes )*1E-6 << "M" << std::endl;
     cout << "    #stack pop    = " << float(data.normal.trav_stack_pop )*1E-6 << "M" << std::endl;
+    cout << "    #prefetches   = " << float(data.normal.trav_prefetches )*1E-6 << "M" << std::endl;
 
     size_t normal_box_hits = 0;
     size_t weighted_box_hits = 0;
@@ -63,6 +64,7 @@ namespace embree
 
       cout << "    #stack nodes = " << float(data.shadow.trav_stack_nodes )*1E-6 << "M" << std::endl;
       cout << "    #stack pop   = " << float(data.shadow.trav_stack_pop )*1E-6 << "M" << std::endl;
+      cout << "    #prefetches  = " << float(data.shadow.trav_prefetches )*1E-6 << "M" << std::endl;
 
       size_t shadow_box_hits = 0;
       size_t weighted_shadow_box_hits = 0;
@@ -76,6 +76,7 @@ namespace embree
               trav_stack_pop.store(0);
               trav_stack_nodes.store(0); 
               trav_xfm_nodes.store(0); 
+              trav_prefetches.store(0);
             }
 
           public:
@@ -88,6 +89,7 @@ namespace embree
 	    std::atomic<size_t> trav_stack_pop;
 	    std::atomic<size_t> trav_stack_nodes; 
             std::atomic<size_t> trav_xfm_nodes; 
+            std::atomic<size_t> trav_prefetches;
             
 	  } normal, shadow, point_query;
 	} all, active, code; 
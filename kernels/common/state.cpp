@@ -7,6 +7,7 @@
 namespace embree
 {
   MutexSys g_printMutex;
+  std::atomic<size_t> g_build_primref_bytes(0);
 
   State::ErrorHandler State::g_errorHandler;
 
@@ -82,6 +83,10 @@ namespace embree
     object_accel_mb_max_leaf_size = 1;
 
     max_spatial_split_replications = 1.2f;
+    build_memory_budget = 0;
+    time_split_threshold = 0.0f;
+    curve_lod_scale = 0.0f;
+    point_compression = false;
     useSpatialPreSplits = false;
 
     tessellation_cache_size = 128*1024*1024;
@@ -99,6 +104,7 @@ namespace embree
     instancing_open_factor = 8.0f; 
     instancing_open_max_depth = 32;
     instancing_open_max = 50000000;
+    instancing_expensive_factor = 4.0f;
 
     float_exceptions = false;
     quality_flags = -1;
@@ -122,6 +128,7 @@ namespace embree
 #else
     hugepages = false;
 #endif
+    hugepages_1g = false;
     hugepages_success = true;
 
     alloc_main_block_size = 0;
@@ -291,6 +298,9 @@ namespace embree
       else if (tok == Token::Id("hugepages") && cin->trySymbol("=")) {
         hugepages = cin->get().Int();
       }
+      else if (tok == Token::Id("hugepages_1g") && cin->trySymbol("=")) {
+        hugepages_1g = cin->get().Int();
+      }
 
       else if (tok == Token::Id("float_exceptions") && cin->trySymbol("=")) 
         float_exceptions = cin->get().Int();
@@ -383,6 +393,8 @@ namespace embree
       }
       else if (tok == Token::Id("instancing_open_max") && cin->trySymbol("="))
         instancing_open_max = cin->get().Int();
+      else if (tok == Token::Id("instancing_expensive_factor") && cin->trySymbol("="))
+        instancing_expensive_factor = cin->get().Float();
 
       else if (tok == Token::Id("subdiv_accel") && cin->trySymbol("="))
         subdiv_accel = cin->get().Identifier();
@@ -416,6 +428,7 @@ namespace embree
             if (flag == Token::Id("dynamic") ) scene_flags |= RTC_SCENE_FLAG_DYNAMIC;
             else if (flag == Token::Id("compact")) scene_flags |= RTC_SCENE_FLAG_COMPACT;
             else if (flag == Token::Id("robust")) scene_flags |= RTC_SCENE_FLAG_ROBUST;
+            else if (flag == Token::Id("treelet_layout")) scene_flags |= RTC_SCENE_FLAG_TREELET_LAYOUT;
           } while (cin->trySymbol("|"));
         }
       }
@@ -423,6 +436,18 @@ namespace embree
       else if (tok == Token::Id("max_spatial_split_replications") && cin->trySymbol("="))
         max_spatial_split_replications = cin->get().Float();
 
+      else if (tok == Token::Id("build_memory_budget") && cin->trySymbol("="))
+        build_memory_budget = size_t(cin->get().Float()*1024.0f*1024.0f);
+
+      else if (tok == Token::Id("time_split_threshold") && cin->trySymbol("="))
+        time_split_threshold = cin->get().Float();
+
+      else if (tok == Token::Id("curve_lod_scale") && cin->trySymbol("="))
+        curve_lod_scale = cin->get().Float();
+
+      else if (tok == Token::Id("point_compression") && cin->trySymbol("="))
+        point_compression = cin->get().Int();
+
       else if (tok == Token::Id("presplits") && cin->trySymbol("="))
         useSpatialPreSplits = cin->get().Int() != 0 ? true : false;
 
@@ -467,10 +492,24 @@ namespace embree
     if (!hugepages) std::cout << "disabled" << std::endl;
     else if (hugepages_success) std::cout << "enabled" << std::endl;
     else std::cout << "failed" << std::endl;
+    std::cout << "  hugepages_1g       = " << (hugepages && hugepages_1g ? "enabled" : "disabled") << std::endl;
 
     std::cout << "  verbosity          = " << verbose << std::endl;
     std::cout << "  cache_size         = " << float(tessellation_cache_size)*1E-6 << " MB" << std::endl;
     std::cout << "  max_spatial_split_replications = " << max_spatial_split_replications << std::endl;
+    std::cout << "  build_memory_budget = ";
+    if (build_memory_budget == 0) std::cout << "unlimited" << std::endl;
+    else std::cout << float(build_memory_budget)/float(1024*1024) << " MiB" << std::endl;
+    std::cout << "  time_split_threshold = ";
+    if (time_split_threshold == 0.0f) std::cout << "fixed" << std::endl;
+    else std::cout << time_split_threshold << std::endl;
+    std::cout << "  curve_lod_scale = ";
+    if (curve_lod_scale == 0.0f) std::cout << "disabled" << std::endl;
+    else std::cout << curve_lod_scale << std::endl;
+    std::cout << "  point_compression = " << point_compression << std::endl;
+    std::cout << "  instancing_expensive_factor = ";
+    if (instancing_expensive_factor == 0.0f) std::cout << "disabled" << std::endl;
+    else std::cout << instancing_expensive_factor << std::endl;
     
     std::cout << "triangles:" << std::endl;
     std::cout << "  accel              = " << tri_accel << std::endl;
@@ -10,6 +10,9 @@ namespace embree
   /* mutex to make printing to cout thread safe */
   extern MutexSys g_printMutex;
 
+  /* number of PrimRef bytes streamed through memory by the SAH builders */
+  extern std::atomic<size_t> g_build_primref_bytes;
+
   struct State : public RefCount
   {
   public:
@@ -108,6 +111,10 @@ namespace embree
   public:
     float max_spatial_split_replications;  //!< maximally replications*N many primitives in accel for spatial splits
     bool useSpatialPreSplits;              //!< use spatial pre-splits instead of the full spatial split builder
+    size_t build_memory_budget;            //!< memory budget of a single scene build in bytes (0 = unlimited)
+    float time_split_threshold;            //!< minimal swept bounds reduction to perform a motion blur time split (0 = fixed heuristic)
+    float curve_lod_scale;                 //!< scale of the ray footprint below which curve subtrees get approximated (0 = no curve LOD)
+    bool point_compression;                //!< stores spheres and discs in compressed leaves of quantized points
     size_t tessellation_cache_size;        //!< size of the shared tessellation cache 
 
   public:
@@ -116,6 +123,7 @@ namespace embree
     float  instancing_open_factor;         //!< instancing opens tree up to x times the number of instances
     size_t instancing_open_max_depth;      //!< maximum open depth for geometries
     size_t instancing_open_max;            //!< instancing opens tree to maximally that number of subtrees
+    float  instancing_expensive_factor;    //!< instances more expensive than this multiple of the median instance get traversed last (0 = no classification)
 
   public:
     bool float_exceptions;                 //!< enable floating point exceptions
@@ -138,6 +146,7 @@ namespace embree
     } frequency_level;                     //!< frequency level the app wants to run on (default is SIMD256)
     bool enable_selockmemoryprivilege;     //!< configures the SeLockMemoryPrivilege under Windows to enable huge pages
     bool hugepages;                        //!< true if huge pages should get used
+    bool hugepages_1g;                     //!< true if 1GB huge pages should get used for very large allocations
     bool hugepages_success;                //!< status for enabling huge pages
 
   public:
@@ -37,7 +37,12 @@ namespace embree
           assert(p);
           return p;
         }
-        return (pointer) alignedMalloc(n*sizeof(value_type),alignment);
+        pointer p = (pointer) alignedMalloc(n*sizeof(value_type),alignment);
+
+        /* give hint to transparently convert large arrays to 2MB pages */
+        if (n*sizeof(value_type) >= PAGE_SIZE_2M)
+          os_advise(p,n*sizeof(value_type));
+        return p;
       }
 
       __forceinline void deallocate( pointer p, size_type n ) 
@@ -33,6 +33,10 @@
 #include "curve_intersector_oriented.h"
 #include "curve_intersector_sweep.h"
 
+#include "curve_lod_intersector.h"
+#include "point_lod_intersector.h"
+#include "quantized_points_intersector.h"
+
 namespace embree
 {
   struct VirtualCurveIntersector
@@ -101,6 +105,18 @@ namespace embree
         static __forceinline void intersect(const Accel::Intersectors* This, Precalculations& pre, RayHit& ray, IntersectContext* context, const Primitive* prim, size_t num, const TravRay<N,robust> &tray, size_t& lazy_node)
       {
         assert(num == 1);
+        if (unlikely(*prim == CurveLOD::TY)) {
+          CurveLODIntersector1::intersect(pre,ray,context,(const CurveLOD*)prim,lazy_node);
+          return;
+        }
+        if (unlikely(*prim == PointLOD::TY)) {
+          PointLODIntersector1::intersect(pre,ray,context,(const PointLOD*)prim,lazy_node);
+          return;
+        }
+        if (unlikely(*prim == QuantizedPoints::TY)) {
+          QuantizedPointsIntersector1::intersect(pre,ray,context,(const QuantizedPoints*)prim);
+          return;
+        }
         RTCGeometryType ty = (RTCGeometryType)(*prim);
         assert(This->leafIntersector);
         VirtualCurveIntersector::Intersectors& leafIntersector = ((VirtualCurveIntersector*) This->leafIntersector)->vtbl[ty];
@@ -111,6 +127,12 @@ namespace embree
         static __forceinline bool occluded(const Accel::Intersectors* This, Precalculations& pre, Ray& ray, IntersectContext* context, const Primitive* prim, size_t num, const TravRay<N,robust> &tray, size_t& lazy_node)
       {
         assert(num == 1);
+        if (unlikely(*prim == CurveLOD::TY))
+          return CurveLODIntersector1::occluded(pre,ray,context,(const CurveLOD*)prim,lazy_node);
+        if (unlikely(*prim == PointLOD::TY))
+          return PointLODIntersector1::occluded(pre,ray,context,(const PointLOD*)prim,lazy_node);
+        if (unlikely(*prim == QuantizedPoints::TY))
+          return QuantizedPointsIntersector1::occluded(pre,ray,context,(const QuantizedPoints*)prim);
         RTCGeometryType ty = (RTCGeometryType)(*prim);
         assert(This->leafIntersector);
         VirtualCurveIntersector::Intersectors& leafIntersector = ((VirtualCurveIntersector*) This->leafIntersector)->vtbl[ty];
@@ -128,6 +150,19 @@ namespace embree
         static __forceinline void intersect(const vbool<K>& valid_i, const Accel::Intersectors* This, Precalculations& pre, RayHitK<K>& ray, IntersectContext* context, const Primitive* prim, size_t num, const TravRayK<K, robust> &tray, size_t& lazy_node)
         {
           assert(num == 1);
+          if (unlikely(*prim == CurveLOD::TY)) {
+            lazy_node = ((const CurveLOD*)prim)->child; // packets always continue with the full resolution subtree
+            return;
+          }
+          if (unlikely(*prim == PointLOD::TY)) {
+            lazy_node = ((const PointLOD*)prim)->child;
+            return;
+          }
+          if (unlikely(*prim == QuantizedPoints::TY)) {
+            size_t mask = movemask(valid_i);
+            while (mask) QuantizedPointsIntersectorK<K>::intersect(pre,ray,bscf(mask),context,(const QuantizedPoints*)prim);
+            return;
+          }
           RTCGeometryType ty = (RTCGeometryType)(*prim);
           assert(This->leafIntersector);
           VirtualCurveIntersector::Intersectors& leafIntersector = ((VirtualCurveIntersector*) This->leafIntersector)->vtbl[ty];
@@ -139,6 +174,24 @@ namespace embree
         static __forceinline vbool<K> occluded(const vbool<K>& valid_i, const Accel::Intersectors* This, Precalculations& pre, RayK<K>& ray, IntersectContext* context, const Primitive* prim, size_t num, const TravRayK<K, robust> &tray, size_t& lazy_node)
         {
           assert(num == 1);
+          if (unlikely(*prim == CurveLOD::TY)) {
+            lazy_node = ((const CurveLOD*)prim)->child;
+            return false;
+          }
+          if (unlikely(*prim == PointLOD::TY)) {
+            lazy_node = ((const PointLOD*)prim)->child;
+            return false;
+          }
+          if (unlikely(*prim == QuantizedPoints::TY)) {
+            vbool<K> valid_o = false;
+            size_t mask = movemask(valid_i);
+            while (mask) {
+              size_t k = bscf(mask);
+              if (QuantizedPointsIntersectorK<K>::occluded(pre,ray,k,context,(const QuantizedPoints*)prim))
+                set(valid_o, k);
+            }
+            return valid_o;
+          }
           RTCGeometryType ty = (RTCGeometryType)(*prim);
           assert(This->leafIntersector);
           VirtualCurveIntersector::Intersectors& leafIntersector = ((VirtualCurveIntersector*) This->leafIntersector)->vtbl[ty];
@@ -156,6 +209,18 @@ namespace embree
         static __forceinline void intersect(const Accel::Intersectors* This, Precalculations& pre, RayHitK<K>& ray, size_t k, IntersectContext* context, const Primitive* prim, size_t num, const TravRay<N,robust> &tray, size_t& lazy_node)
         {
           assert(num == 1);
+          if (unlikely(*prim == CurveLOD::TY)) {
+            lazy_node = ((const CurveLOD*)prim)->child;
+            return;
+          }
+          if (unlikely(*prim == PointLOD::TY)) {
+            lazy_node = ((const PointLOD*)prim)->child;
+            return;
+          }
+          if (unlikely(*prim == QuantizedPoints::TY)) {
+            QuantizedPointsIntersectorK<K>::intersect(pre,ray,k,context,(const QuantizedPoints*)prim);
+            return;
+          }
           RTCGeometryType ty = (RTCGeometryType)(*prim);
           assert(This->leafIntersector);
           VirtualCurveIntersector::Intersectors& leafIntersector = ((VirtualCurveIntersector*) This->leafIntersector)->vtbl[ty];
@@ -166,6 +231,16 @@ namespace embree
         static __forceinline bool occluded(const Accel::Intersectors* This, Precalculations& pre, RayK<K>& ray, size_t k, IntersectContext* context, const Primitive* prim, size_t num, const TravRay<N,robust> &tray, size_t& lazy_node)
         {
           assert(num == 1);
+          if (unlikely(*prim == CurveLOD::TY)) {
+            lazy_node = ((const CurveLOD*)prim)->child;
+            return false;
+          }
+          if (unlikely(*prim == PointLOD::TY)) {
+            lazy_node = ((const PointLOD*)prim)->child;
+            return false;
+          }
+          if (unlikely(*prim == QuantizedPoints::TY))
+            return QuantizedPointsIntersectorK<K>::occluded(pre,ray,k,context,(const QuantizedPoints*)prim);
           RTCGeometryType ty = (RTCGeometryType)(*prim);
           assert(This->leafIntersector);
           VirtualCurveIntersector::Intersectors& leafIntersector = ((VirtualCurveIntersector*) This->leafIntersector)->vtbl[ty];
@@ -0,0 +1,121 @@
+// Copyright 2009-2021 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include "primitive.h"
+
+namespace embree
+{
+  /*! Level of detail leaf of the curve BVH. The leaf stores a single
+   *  cone that approximates all curves of a subtree, and a reference
+   *  to the full resolution subtree. Traversal intersects the cone if
+   *  the ray footprint covers the entire subtree, and otherwise
+   *  continues with the subtree. */
+  struct CurveLOD
+  {
+    /*! type tag stored in place of the geometry type of curve leaves */
+    static const unsigned char TY = 0xFF;
+
+    /*! only subtrees with at least this many primitives get a LOD */
+    static const size_t MIN_PRIMITIVES = 16;
+
+  public:
+
+    /*! Default constructor. */
+    __forceinline CurveLOD () {}
+
+    /*! approximates all primitives of the range by a single cone */
+    __forceinline void fill(const PrimRef* prims, const range<size_t>& set, const BBox3fa& bounds, const float lodScale, Scene* scene)
+    {
+      ty = TY;
+      N = 0;
+      geomID = prims[set.begin()].geomID();
+      primID = prims[set.begin()].primID();
+      lodSize = length(bounds.size())/lodScale;
+      child = 0;
+
+      /* the subtree may mix geometries with different radius scales */
+      maxRadiusScale = 0.0f;
+      for (size_t i=set.begin(); i<set.end(); i++)
+        maxRadiusScale = max(maxRadiusScale,getMaxRadiusScale(scene->get(prims[i].geomID())));
+
+      /* average strand direction, all curves are oriented along the first one */
+      Vec3fa dir = zero;
+      for (size_t i=set.begin(); i<set.end(); i++)
+      {
+        const Geometry* geom = scene->get(prims[i].geomID());
+        if (!isCubicCurve(geom)) continue;
+        const Vec3fa axis = geom->computeAlignedSpace(prims[i].primID()).vz;
+        dir += dot(dir,axis) < 0.0f ? -axis : axis;
+      }
+      if (sqr_length(dir) < 1E-18f) {
+        dir = Vec3fa(zero);
+        dir[maxDim(bounds.size())] = 1.0f;
+      }
+      const LinearSpace3fa space = frame(normalize(dir));
+      const LinearSpace3fa ispace = space.transposed();
+
+      /* bounds along the strand direction and covered area of all primitives */
+      BBox3fa sbounds = empty;
+      float area = 0.0f;
+      for (size_t i=set.begin(); i<set.end(); i++)
+      {
+        const Geometry* geom = scene->get(prims[i].geomID());
+        const unsigned int primID = prims[i].primID();
+        sbounds.extend(geom->vbounds(ispace,primID));
+
+        BBox3fa pbounds = geom->vbounds(primID);
+        if (isCubicCurve(geom))
+          pbounds = geom->vbounds(geom->computeAlignedSpace(primID).transposed(),primID);
+        const Vec3fa psize = pbounds.size();
+        const float plength = reduce_max(psize);
+        const float pwidth  = reduce_min(psize);
+        area += plength*pwidth;
+      }
+
+      /* the cone preserves the covered area but never grows beyond the bounds */
+      const Vec3fa ssize = sbounds.size();
+      const float len = max(ssize.z,1E-3f*max(ssize.x,ssize.y));
+      const float radius = min(0.5f*area/len,0.5f*max(ssize.x,ssize.y));
+      const Vec3fa center = 0.5f*(sbounds.lower+sbounds.upper);
+      p0 = Vec3ff(xfmPoint(space,Vec3fa(center.x,center.y,center.z-0.5f*len)),radius);
+      p1 = Vec3ff(xfmPoint(space,Vec3fa(center.x,center.y,center.z+0.5f*len)),radius);
+    }
+
+    template<typename BVH, typename Allocator>
+      __forceinline static typename BVH::NodeRef createLeaf (BVH* bvh, const PrimRef* prims, const range<size_t>& set, const BBox3fa& bounds, const float lodScale, const Allocator& alloc)
+    {
+      CurveLOD* accel = (CurveLOD*) alloc.malloc1(sizeof(CurveLOD),BVH::byteAlignment);
+      accel->fill(prims,set,bounds,lodScale,bvh->scene);
+      return bvh->encodeLeaf((char*)accel,1);
+    }
+
+  private:
+
+    static __forceinline bool isCubicCurve(const Geometry* geom) {
+      return geom->getTypeMask() & Geometry::MTY_CURVE4;
+    }
+
+    static __forceinline float getMaxRadiusScale(const Geometry* geom)
+    {
+      if (geom->getTypeMask() & Geometry::MTY_POINTS)
+        return ((const Points*)geom)->maxRadiusScale;
+      else if (geom->getCurveBasis() == Geometry::GTY_BASIS_LINEAR)
+        return ((const LineSegments*)geom)->maxRadiusScale;
+      else
+        return ((const CurveGeometry*)geom)->maxRadiusScale;
+    }
+
+  public:
+    unsigned char ty;       //!< always TY to distinguish the LOD from curve leaves
+    unsigned char N;        //!< always 0 such that the LOD reports no primitives
+    unsigned int geomID;    //!< geometry ID of the curve reported for proxy hits
+    unsigned int primID;    //!< primitive ID of the curve reported for proxy hits
+    float lodSize;          //!< size of the subtree divided by the LOD scale
+    Vec3ff p0;              //!< start of the proxy cone, radius in w
+    Vec3ff p1;              //!< end of the proxy cone, radius in w
+    float maxRadiusScale;   //!< maximal min-width scaling of the proxy radius
+    size_t child;           //!< full resolution subtree
+  };
+}
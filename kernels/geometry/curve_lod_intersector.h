@@ -0,0 +1,69 @@
+// Copyright 2009-2021 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include "curve_lod.h"
+#include "coneline_intersector.h"
+#include "intersector_epilog.h"
+
+namespace embree
+{
+  namespace isa
+  {
+    struct CurveLODIntersector1
+    {
+      typedef CurvePrecalculations1 Precalculations;
+
+      /*! returns true if the ray footprint at the distance of the LOD covers the entire subtree */
+      static __forceinline bool useProxy(const Ray& ray, IntersectContext* context, const CurveLOD* lod)
+      {
+#if RTC_MIN_WIDTH
+        const Vec3fa center = 0.5f*(Vec3fa(lod->p0)+Vec3fa(lod->p1));
+        const float d = length(center-Vec3fa(ray.org));
+        return lod->lodSize <= 2.0f*context->user->minWidthDistanceFactor*d;
+#else
+        return false;
+#endif
+      }
+
+      template<typename Epilog>
+      static __forceinline bool intersectProxy(const Precalculations& pre, Ray& ray, IntersectContext* context, const CurveLOD* lod, const Epilog& epilog)
+      {
+        const vbool<4> valid = vint<4>(step) == vint<4>(zero);
+        const Vec3vf<4> ray_org(ray.org.x, ray.org.y, ray.org.z);
+        const Vec3vf<4> ray_dir(ray.dir.x, ray.dir.y, ray.dir.z);
+        const vfloat<4> ray_tnear(ray.tnear());
+        Vec4vf<4> v0(lod->p0.x,lod->p0.y,lod->p0.z,lod->p0.w);
+        Vec4vf<4> v1(lod->p1.x,lod->p1.y,lod->p1.z,lod->p1.w);
+#if RTC_MIN_WIDTH
+        v0.w = clamp(context->user->minWidthDistanceFactor*length(v0.xyz()-ray_org), v0.w, lod->maxRadiusScale*v0.w);
+        v1.w = clamp(context->user->minWidthDistanceFactor*length(v1.xyz()-ray_org), v1.w, lod->maxRadiusScale*v1.w);
+#endif
+        return __coneline_internal::intersectCone<4>(valid,ray_org,ray_dir,ray_tnear,ConeCurveIntersector1<4>::ray_tfar(ray),v0,v1,vbool<4>(true),vbool<4>(true),epilog);
+      }
+
+      static __forceinline void intersect(const Precalculations& pre, RayHit& ray, IntersectContext* context, const CurveLOD* lod, size_t& lazy_node)
+      {
+        if (!useProxy(ray,context,lod)) {
+          lazy_node = lod->child;
+          return;
+        }
+        STAT3(normal.trav_prims,1,1,1);
+        const vuint<4> geomID(lod->geomID), primID(lod->primID);
+        intersectProxy(pre,ray,context,lod,Intersect1EpilogM<4,true>(ray,context,geomID,primID));
+      }
+
+      static __forceinline bool occluded(const Precalculations& pre, Ray& ray, IntersectContext* context, const CurveLOD* lod, size_t& lazy_node)
+      {
+        if (!useProxy(ray,context,lod)) {
+          lazy_node = lod->child;
+          return false;
+        }
+        STAT3(shadow.trav_prims,1,1,1);
+        const vuint<4> geomID(lod->geomID), primID(lod->primID);
+        return intersectProxy(pre,ray,context,lod,Occluded1EpilogM<4,true>(ray,context,geomID,primID));
+      }
+    };
+  }
+}
@@ -32,9 +32,11 @@ namespace embree
 
   public:
 
-    InstancePrimitive (const Instance* instance, unsigned int instID) 
+    InstancePrimitive (const Instance* instance, unsigned int instID, const Vec3fa& originOffset = Vec3fa(zero))
     : instance(instance) 
     , instID_(instID)
+    , originOffset(originOffset)
+    , objectOrigin(instance->getObjectOrigin())
     {}
 
     __forceinline void fill(const PrimRef* prims, size_t& i, size_t end, Scene* scene)
@@ -43,7 +45,7 @@ namespace embree
       const PrimRef& prim = prims[i]; i++;
       const unsigned int geomID = prim.geomID();
       const Instance* instance = scene->get<Instance>(geomID);
-      new (this) InstancePrimitive(instance, geomID);
+      new (this) InstancePrimitive(instance, geomID, instance->getOriginOffset(scene->origin));
     }
 
     __forceinline LBBox3fa fillMB(const PrimRef* prims, size_t& i, size_t end, Scene* scene, size_t itime)
@@ -52,8 +54,8 @@ namespace embree
       const PrimRef& prim = prims[i]; i++;
       const unsigned int geomID = prim.geomID();
       const Instance* instance = scene->get<Instance>(geomID);
-      new (this) InstancePrimitive(instance,geomID);
-      return instance->linearBounds(0,itime);
+      new (this) InstancePrimitive(instance,geomID,instance->getOriginOffset(scene->origin));
+      return instance->linearBounds(0,itime,originOffset);
     }
 
     __forceinline LBBox3fa fillMB(const PrimRefMB* prims, size_t& i, size_t end, Scene* scene, const BBox1f time_range)
@@ -62,17 +64,41 @@ namespace embree
       const PrimRefMB& prim = prims[i]; i++;
       const unsigned int geomID = prim.geomID();
       const Instance* instance = scene->get<Instance>(geomID);
-      new (this) InstancePrimitive(instance,geomID);
-      return instance->linearBounds(0,time_range);
+      new (this) InstancePrimitive(instance,geomID,instance->getOriginOffset(scene->origin));
+      return instance->linearBounds(0,time_range,originOffset);
     }
 
     /* Updates the primitive */
     __forceinline BBox3fa update(Instance* instance) {
-      return instance->bounds(0);
+      const BBox3fa b = instance->bounds(0);
+      return BBox3fa(b.lower+originOffset,b.upper+originOffset);
+    }
+
+    /* Returns the transformation from the frame of the scene into the
+     * frame the instanced scene stores its geometry in. The instance is
+     * first moved by its offset to the origin of the scene, then the
+     * transformation of the instance gets applied, and finally the
+     * result is moved to the origin of the instanced scene. */
+    __forceinline AffineSpace3fa getWorld2Local(const AffineSpace3fa& world2local) const {
+      return AffineSpace3fa(world2local.l,world2local.p-xfmVector(world2local,originOffset)-objectOrigin);
+    }
+
+    template<int K>
+    __forceinline AffineSpace3vf<K> getWorld2Local(const AffineSpace3vf<K>& world2local) const
+    {
+      const Vec3vf<K> offset(originOffset.x,originOffset.y,originOffset.z);
+      const Vec3vf<K> origin(objectOrigin.x,objectOrigin.y,objectOrigin.z);
+      return AffineSpace3vf<K>(world2local.l,world2local.p-xfmVector(world2local,offset)-origin);
+    }
+
+    __forceinline AffineSpace3fa getLocal2World(const AffineSpace3fa& local2world) const {
+      return AffineSpace3fa(local2world.l,xfmPoint(local2world,objectOrigin)+originOffset);
     }
 
   public:
     const Instance* instance;
     const unsigned int instID_ = std::numeric_limits<unsigned int>::max ();
+    Vec3fa originOffset;  //!< origin of the instance relative to the origin of the scene
+    Vec3fa objectOrigin;  //!< origin of the instanced scene
   };
 }
@@ -57,7 +57,7 @@ namespace embree
       RTCIntersectContext* user_context = context->user;
       if (likely(instance_id_stack::push(user_context, prim.instID_)))
       {
-        const AffineSpace3fa world2local = instance->getWorld2Local();
+        const AffineSpace3fa world2local = prim.getWorld2Local(instance->getWorld2Local());
         const Vec3ff ray_org = ray.org;
         const Vec3ff ray_dir = ray.dir;
         ray.org = Vec3ff(xfmPoint(world2local, ray_org), ray.tnear());
@@ -84,7 +84,7 @@ namespace embree
       bool occluded = false;
       if (likely(instance_id_stack::push(user_context, prim.instID_)))
       {
-        const AffineSpace3fa world2local = instance->getWorld2Local();
+        const AffineSpace3fa world2local = prim.getWorld2Local(instance->getWorld2Local());
         const Vec3ff ray_org = ray.org;
         const Vec3ff ray_dir = ray.dir;
         ray.org = Vec3ff(xfmPoint(world2local, ray_org), ray.tnear());
@@ -103,8 +103,8 @@ namespace embree
     {
       const Instance* instance = prim.instance;
 
-      const AffineSpace3fa local2world = instance->getLocal2World();
-      const AffineSpace3fa world2local = instance->getWorld2Local();
+      const AffineSpace3fa local2world = prim.getLocal2World(instance->getLocal2World());
+      const AffineSpace3fa world2local = prim.getWorld2Local(instance->getWorld2Local());
       float similarityScale = 0.f;
       const bool similtude = context->query_type == POINT_QUERY_TYPE_SPHERE
                            && similarityTransform(world2local, &similarityScale);
@@ -146,7 +146,7 @@ namespace embree
       RTCIntersectContext* user_context = context->user;
       if (likely(instance_id_stack::push(user_context, prim.instID_)))
       {
-        const AffineSpace3fa world2local = instance->getWorld2Local(ray.time());
+        const AffineSpace3fa world2local = prim.getWorld2Local(instance->getWorld2Local(ray.time()));
         const Vec3ff ray_org = ray.org;
         const Vec3ff ray_dir = ray.dir;
         ray.org = Vec3ff(xfmPoint(world2local, ray_org), ray.tnear());
@@ -173,7 +173,7 @@ namespace embree
       bool occluded = false;
       if (likely(instance_id_stack::push(user_context, prim.instID_)))
       {
-        const AffineSpace3fa world2local = instance->getWorld2Local(ray.time());
+        const AffineSpace3fa world2local = prim.getWorld2Local(instance->getWorld2Local(ray.time()));
         const Vec3ff ray_org = ray.org;
         const Vec3ff ray_dir = ray.dir;
         ray.org = Vec3ff(xfmPoint(world2local, ray_org), ray.tnear());
@@ -192,8 +192,8 @@ namespace embree
     {
       const Instance* instance = prim.instance;
 
-      const AffineSpace3fa local2world = instance->getLocal2World(query->time);
-      const AffineSpace3fa world2local = instance->getWorld2Local(query->time);
+      const AffineSpace3fa local2world = prim.getLocal2World(instance->getLocal2World(query->time));
+      const AffineSpace3fa world2local = prim.getWorld2Local(instance->getWorld2Local(query->time));
       float similarityScale = 0.f;
       const bool similtude = context->query_type == POINT_QUERY_TYPE_SPHERE
                            && similarityTransform(world2local, &similarityScale);
@@ -237,7 +237,7 @@ namespace embree
       RTCIntersectContext* user_context = context->user;
       if (likely(instance_id_stack::push(user_context, prim.instID_)))
       {
-        AffineSpace3vf<K> world2local = instance->getWorld2Local();
+        AffineSpace3vf<K> world2local = prim.getWorld2Local(instance->getWorld2Local());
         const Vec3vf<K> ray_org = ray.org;
         const Vec3vf<K> ray_dir = ray.dir;
         ray.org = xfmPoint(world2local, ray_org);
@@ -266,7 +266,7 @@ namespace embree
       vbool<K> occluded = false;
       if (likely(instance_id_stack::push(user_context, prim.instID_)))
       {
-        AffineSpace3vf<K> world2local = instance->getWorld2Local();
+        AffineSpace3vf<K> world2local = prim.getWorld2Local(instance->getWorld2Local());
         const Vec3vf<K> ray_org = ray.org;
         const Vec3vf<K> ray_dir = ray.dir;
         ray.org = xfmPoint(world2local, ray_org);
@@ -296,7 +296,7 @@ namespace embree
       RTCIntersectContext* user_context = context->user;
       if (likely(instance_id_stack::push(user_context, prim.instID_)))
       {
-        AffineSpace3vf<K> world2local = instance->getWorld2Local<K>(valid, ray.time());
+        AffineSpace3vf<K> world2local = prim.getWorld2Local<K>(instance->getWorld2Local<K>(valid, ray.time()));
         const Vec3vf<K> ray_org = ray.org;
         const Vec3vf<K> ray_dir = ray.dir;
         ray.org = xfmPoint(world2local, ray_org);
@@ -325,7 +325,7 @@ namespace embree
       vbool<K> occluded = false;
       if (likely(instance_id_stack::push(user_context, prim.instID_)))
       {
-        AffineSpace3vf<K> world2local = instance->getWorld2Local<K>(valid, ray.time());
+        AffineSpace3vf<K> world2local = prim.getWorld2Local<K>(instance->getWorld2Local<K>(valid, ray.time()));
         const Vec3vf<K> ray_org = ray.org;
         const Vec3vf<K> ray_dir = ray.dir;
         ray.org = xfmPoint(world2local, ray_org);
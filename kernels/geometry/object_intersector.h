@@ -89,6 +89,10 @@ namespace embree
         valid &= (ray.mask & accel->mask) != 0;
         if (none(valid)) return;
 #endif
+        /* rays of streams with deferred user geometry invoke the callback after traversal */
+        if (unlikely(context->userGeometryQueue) && context->userGeometryQueue->push<K>(valid,&ray,prim.geomID(),prim.primID()))
+          return;
+
         accel->intersect(valid,ray,prim.geomID(),prim.primID(),context);
       }
 
@@ -102,6 +106,10 @@ namespace embree
         valid &= (ray.mask & accel->mask) != 0;
         if (none(valid)) return false;
 #endif
+        /* rays of streams with deferred user geometry invoke the callback after traversal */
+        if (unlikely(context->userGeometryQueue) && context->userGeometryQueue->push<K>(valid,&ray,prim.geomID(),prim.primID()))
+          return ray.tfar < 0.0f;
+
         accel->occluded(valid,ray,prim.geomID(),prim.primID(),context);
         return ray.tfar < 0.0f;
       }
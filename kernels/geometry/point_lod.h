@@ -0,0 +1,166 @@
+// Copyright 2009-2021 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include "primitive.h"
+
+namespace embree
+{
+  /*! Level of detail leaf of the point BVH. The leaf approximates all
+   *  points of a subtree by up to eight proxy spheres, one per octant
+   *  of the subtree bounds. Proxy centers are quantized to 16 bits
+   *  relative to the subtree bounds and proxy radii are stored as
+   *  indices into a small radius palette. Traversal intersects the
+   *  proxies if the ray footprint covers the entire subtree, and
+   *  otherwise continues with the full resolution subtree. */
+  struct PointLOD
+  {
+    /*! type tag stored in place of the geometry type of point leaves */
+    static const unsigned char TY = 0xFE;
+
+    /*! only subtrees with at least this many primitives get a LOD */
+    static const size_t MIN_PRIMITIVES = 32;
+
+    /*! maximal number of proxy spheres */
+    static const size_t MAX_PROXIES = 8;
+
+    /*! number of entries of the radius palette */
+    static const size_t PALETTE_SIZE = 4;
+
+  public:
+
+    /*! Default constructor. */
+    __forceinline PointLOD () {}
+
+    /*! approximates all primitives of the range by up to eight spheres */
+    __forceinline void fill(const PrimRef* prims, const range<size_t>& set, const BBox3fa& bounds, const float lodScale, Scene* scene)
+    {
+      ty = TY;
+      N = 0;
+      geomID = prims[set.begin()].geomID();
+      lodSize = length(bounds.size())/lodScale;
+      child = 0;
+
+      const Geometry* geom0 = scene->get(geomID);
+      if (geom0->getTypeMask() & Geometry::MTY_POINTS)
+        maxRadiusScale = ((Points*)geom0)->maxRadiusScale;
+      else if (geom0->getCurveBasis() == Geometry::GTY_BASIS_LINEAR)
+        maxRadiusScale = ((LineSegments*)geom0)->maxRadiusScale;
+      else
+        maxRadiusScale = ((CurveGeometry*)geom0)->maxRadiusScale;
+
+      /* bin primitives into the octants of the subtree bounds, weighted by their projected area */
+      const Vec3fa split = center(bounds);
+      Vec3fa wcenter[MAX_PROXIES];
+      float area[MAX_PROXIES];
+      BBox3fa obounds[MAX_PROXIES];
+      unsigned int oprimID[MAX_PROXIES];
+      for (size_t i=0; i<MAX_PROXIES; i++) {
+        wcenter[i] = Vec3fa(zero);
+        area[i] = 0.0f;
+        obounds[i] = empty;
+        oprimID[i] = RTC_INVALID_GEOMETRY_ID;
+      }
+
+      for (size_t i=set.begin(); i<set.end(); i++)
+      {
+        const BBox3fa pbounds = prims[i].bounds();
+        const Vec3fa c = center(pbounds);
+        const float r = 0.5f*reduce_min(pbounds.size());
+        const size_t o = (c.x > split.x ? 1 : 0) | (c.y > split.y ? 2 : 0) | (c.z > split.z ? 4 : 0);
+        const float a = max(r*r,1E-18f);
+        wcenter[o] += a*c;
+        area[o] += a;
+        obounds[o].extend(pbounds);
+        if (oprimID[o] == RTC_INVALID_GEOMETRY_ID && prims[i].geomID() == geomID)
+          oprimID[o] = prims[i].primID();
+      }
+
+      /* the proxy preserves the covered area but never grows beyond the octant */
+      float radius[MAX_PROXIES];
+      Vec3fa pos[MAX_PROXIES];
+      numProxies = 0;
+      for (size_t i=0; i<MAX_PROXIES; i++)
+      {
+        if (area[i] == 0.0f) continue;
+        const size_t j = numProxies++;
+        pos[j] = wcenter[i]/area[i];
+        radius[j] = min(sqrt(area[i]),0.5f*reduce_max(obounds[i].size()));
+        primIDs[j] = oprimID[i] != RTC_INVALID_GEOMETRY_ID ? oprimID[i] : prims[set.begin()].primID();
+      }
+
+      /* quantize proxy centers relative to the subtree bounds */
+      lower = Vec3f(bounds.lower.x,bounds.lower.y,bounds.lower.z);
+      const Vec3fa size = max(bounds.size(),Vec3fa(1E-18f));
+      scale = Vec3f(size.x/65535.0f,size.y/65535.0f,size.z/65535.0f);
+      for (size_t i=0; i<numProxies; i++) {
+        const Vec3fa q = clamp((pos[i]-bounds.lower)/size*65535.0f,Vec3fa(0.0f),Vec3fa(65535.0f));
+        qx[i] = (unsigned short) floorf(q.x+0.5f);
+        qy[i] = (unsigned short) floorf(q.y+0.5f);
+        qz[i] = (unsigned short) floorf(q.z+0.5f);
+      }
+
+      /* build radius palette from equally sized groups of the sorted radii */
+      size_t order[MAX_PROXIES];
+      for (size_t i=0; i<numProxies; i++) {
+        size_t j = i;
+        for (; j>0 && radius[order[j-1]] > radius[i]; j--) order[j] = order[j-1];
+        order[j] = i;
+      }
+      const size_t numGroups = min(size_t(numProxies),size_t(PALETTE_SIZE));
+      for (size_t g=0; g<PALETTE_SIZE; g++) radii[g] = 0.0f;
+      for (size_t g=0; g<numGroups; g++)
+      {
+        const size_t begin = (g+0)*numProxies/numGroups;
+        const size_t end   = (g+1)*numProxies/numGroups;
+        float sum = 0.0f;
+        for (size_t i=begin; i<end; i++) {
+          sum += radius[order[i]];
+          radiusIndex[order[i]] = (unsigned char) g;
+        }
+        radii[g] = sum/float(end-begin);
+      }
+    }
+
+    template<typename BVH, typename Allocator>
+      __forceinline static typename BVH::NodeRef createLeaf (BVH* bvh, const PrimRef* prims, const range<size_t>& set, const BBox3fa& bounds, const float lodScale, const Allocator& alloc)
+    {
+      PointLOD* accel = (PointLOD*) alloc.malloc1(sizeof(PointLOD),BVH::byteAlignment);
+      accel->fill(prims,set,bounds,lodScale,bvh->scene);
+      return bvh->encodeLeaf((char*)accel,1);
+    }
+
+    /*! returns the center of the subtree bounds */
+    __forceinline Vec3fa boundsCenter() const {
+      return Vec3fa(lower.x+32767.5f*scale.x,lower.y+32767.5f*scale.y,lower.z+32767.5f*scale.z);
+    }
+
+    /*! returns the i'th proxy sphere, radius in w */
+    __forceinline Vec3ff proxy(size_t i) const
+    {
+      assert(i < numProxies);
+      return Vec3ff(lower.x+float(qx[i])*scale.x,
+                    lower.y+float(qy[i])*scale.y,
+                    lower.z+float(qz[i])*scale.z,
+                    radii[radiusIndex[i]]);
+    }
+
+  public:
+    unsigned char ty;                        //!< always TY to distinguish the LOD from point leaves
+    unsigned char N;                         //!< always 0 such that the LOD reports no primitives
+    unsigned char numProxies;                //!< number of valid proxy spheres
+    unsigned char radiusIndex[MAX_PROXIES];  //!< palette index of the radius of each proxy
+    unsigned int geomID;                     //!< geometry ID reported for proxy hits
+    unsigned int primIDs[MAX_PROXIES];       //!< primitive ID reported for hits of each proxy
+    float lodSize;                           //!< size of the subtree divided by the LOD scale
+    Vec3f lower;                             //!< lower bounds of the subtree
+    Vec3f scale;                             //!< size of one quantization step
+    unsigned short qx[MAX_PROXIES];          //!< quantized x coordinate of proxy centers
+    unsigned short qy[MAX_PROXIES];          //!< quantized y coordinate of proxy centers
+    unsigned short qz[MAX_PROXIES];          //!< quantized z coordinate of proxy centers
+    float radii[PALETTE_SIZE];               //!< radius palette
+    float maxRadiusScale;                    //!< maximal min-width scaling of the proxy radii
+    size_t child;                            //!< full resolution subtree
+  };
+}
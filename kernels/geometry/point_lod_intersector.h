@@ -0,0 +1,84 @@
+// Copyright 2009-2021 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include "point_lod.h"
+#include "sphere_intersector.h"
+#include "intersector_epilog.h"
+
+namespace embree
+{
+  namespace isa
+  {
+    struct PointLODIntersector1
+    {
+      typedef CurvePrecalculations1 Precalculations;
+
+      /*! returns true if the ray footprint at the distance of the LOD covers the entire subtree */
+      static __forceinline bool useProxy(const Ray& ray, IntersectContext* context, const PointLOD* lod)
+      {
+#if RTC_MIN_WIDTH
+        const float d = length(lod->boundsCenter()-Vec3fa(ray.org));
+        return lod->lodSize <= 2.0f*context->user->minWidthDistanceFactor*d;
+#else
+        return false;
+#endif
+      }
+
+      /*! gathers four proxy spheres starting at the specified one */
+      static __forceinline Vec4vf<4> gather(const Ray& ray, IntersectContext* context, const PointLOD* lod, size_t begin, vuint<4>& primID)
+      {
+        Vec4vf<4> v0;
+        for (size_t i=0; i<4; i++)
+        {
+          const size_t j = min(begin+i,size_t(lod->numProxies)-1);
+          const Vec3ff p = lod->proxy(j);
+          v0.x[i] = p.x; v0.y[i] = p.y; v0.z[i] = p.z; v0.w[i] = p.w;
+          primID[i] = lod->primIDs[j];
+        }
+#if RTC_MIN_WIDTH
+        const Vec3vf<4> ray_org(ray.org.x, ray.org.y, ray.org.z);
+        v0.w = clamp(context->user->minWidthDistanceFactor*length(v0.xyz()-ray_org), v0.w, lod->maxRadiusScale*v0.w);
+#endif
+        return v0;
+      }
+
+      static __forceinline void intersect(const Precalculations& pre, RayHit& ray, IntersectContext* context, const PointLOD* lod, size_t& lazy_node)
+      {
+        if (!useProxy(ray,context,lod)) {
+          lazy_node = lod->child;
+          return;
+        }
+        STAT3(normal.trav_prims,1,1,1);
+        const vuint<4> geomID(lod->geomID);
+        for (size_t i=0; i<lod->numProxies; i+=4)
+        {
+          vuint<4> primID;
+          const Vec4vf<4> v0 = gather(ray,context,lod,i,primID);
+          const vbool<4> valid = vint<4>(step) < vint<4>(int(lod->numProxies-i));
+          SphereIntersector1<4>::intersect(valid,ray,pre,v0,Intersect1EpilogM<4,true>(ray,context,geomID,primID));
+        }
+      }
+
+      static __forceinline bool occluded(const Precalculations& pre, Ray& ray, IntersectContext* context, const PointLOD* lod, size_t& lazy_node)
+      {
+        if (!useProxy(ray,context,lod)) {
+          lazy_node = lod->child;
+          return false;
+        }
+        STAT3(shadow.trav_prims,1,1,1);
+        const vuint<4> geomID(lod->geomID);
+        for (size_t i=0; i<lod->numProxies; i+=4)
+        {
+          vuint<4> primID;
+          const Vec4vf<4> v0 = gather(ray,context,lod,i,primID);
+          const vbool<4> valid = vint<4>(step) < vint<4>(int(lod->numProxies-i));
+          if (SphereIntersector1<4>::intersect(valid,ray,pre,v0,Occluded1EpilogM<4,true>(ray,context,geomID,primID)))
+            return true;
+        }
+        return false;
+      }
+    };
+  }
+}
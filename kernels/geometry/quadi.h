@@ -195,6 +195,16 @@ namespace embree
     using embree::QuadMi<M>::geomID;
     using embree::QuadMi<M>::primID;
     using embree::QuadMi<M>::valid;
+
+#if !defined(EMBREE_COMPACT_POLYS)
+    /* decodes a single vertex of meshes with half or 16-bit normalized vertex positions */
+    template<int vid>
+    __forceinline Vec3fa getCompactVertex(const size_t index, const QuadMesh* mesh, const size_t itime) const
+    {
+      if (unlikely(primID(index) == -1)) return Vec3fa(zero);
+      return mesh->vertex(mesh->quad(primID(index)).v[vid],itime);
+    }
+#endif
     
     template<int vid>
     __forceinline Vec3f getVertex(const size_t index, const Scene *const scene) const
@@ -202,10 +212,12 @@ namespace embree
 #if defined(EMBREE_COMPACT_POLYS)
       const QuadMesh* mesh = scene->get<QuadMesh>(geomID(index));
       const QuadMesh::Quad& quad = mesh->quad(primID(index));
-      return (Vec3f) mesh->vertices[0][quad.v[vid]];
+      return (Vec3f) mesh->vertex(quad.v[vid]);
 #else
       const vuint<M>& v = getVertexOffset<vid>();
       const float* vertices = scene->vertices[geomID(index)];
+      if (unlikely(vertices == nullptr))
+        return (Vec3f) getCompactVertex<vid>(index,scene->get<QuadMesh>(geomID(index)),0);
       return (Vec3f&) vertices[v[index]];
 #endif
     }
@@ -216,15 +228,21 @@ namespace embree
 #if defined(EMBREE_COMPACT_POLYS)
       const QuadMesh* mesh = scene->get<QuadMesh>(geomID(index));
       const QuadMesh::Quad& quad = mesh->quad(primID(index));
-      const Vec3fa v0 = mesh->vertices[itime+0][quad.v[vid]];
-      const Vec3fa v1 = mesh->vertices[itime+1][quad.v[vid]];
+      const Vec3fa v0 = mesh->vertex(quad.v[vid],itime+0);
+      const Vec3fa v1 = mesh->vertex(quad.v[vid],itime+1);
 #else
       const vuint<M>& v = getVertexOffset<vid>();
       const QuadMesh* mesh = scene->get<QuadMesh>(geomID(index));
-      const float* vertices0 = (const float*) mesh->vertexPtr(0,itime+0);
-      const float* vertices1 = (const float*) mesh->vertexPtr(0,itime+1);
-      const Vec3fa v0 = Vec3fa::loadu(vertices0+v[index]);
-      const Vec3fa v1 = Vec3fa::loadu(vertices1+v[index]);
+      Vec3fa v0, v1;
+      if (unlikely(mesh->hasCompactVertices())) {
+        v0 = getCompactVertex<vid>(index,mesh,itime+0);
+        v1 = getCompactVertex<vid>(index,mesh,itime+1);
+      } else {
+        const float* vertices0 = (const float*) mesh->vertexPtr(0,itime+0);
+        const float* vertices1 = (const float*) mesh->vertexPtr(0,itime+1);
+        v0 = Vec3fa::loadu(vertices0+v[index]);
+        v1 = Vec3fa::loadu(vertices1+v[index]);
+      }
 #endif
       const Vec3<T> p0(v0.x,v0.y,v0.z);
       const Vec3<T> p1(v1.x,v1.y,v1.z);
@@ -241,14 +259,20 @@ namespace embree
       {
 #if defined(EMBREE_COMPACT_POLYS)
         const QuadMesh::Quad& quad = mesh->quad(primID(index));
-        const Vec3fa v0 = mesh->vertices[itime[i]+0][quad.v[vid]];
-        const Vec3fa v1 = mesh->vertices[itime[i]+1][quad.v[vid]];
+        const Vec3fa v0 = mesh->vertex(quad.v[vid],itime[i]+0);
+        const Vec3fa v1 = mesh->vertex(quad.v[vid],itime[i]+1);
 #else
         const vuint<M>& v = getVertexOffset<vid>();
-        const float* vertices0 = (const float*) mesh->vertexPtr(0,itime[i]+0);
-        const float* vertices1 = (const float*) mesh->vertexPtr(0,itime[i]+1);
-        const Vec3fa v0 = Vec3fa::loadu(vertices0+v[index]);
-        const Vec3fa v1 = Vec3fa::loadu(vertices1+v[index]);
+        Vec3fa v0, v1;
+        if (unlikely(mesh->hasCompactVertices())) {
+          v0 = getCompactVertex<vid>(index,mesh,itime[i]+0);
+          v1 = getCompactVertex<vid>(index,mesh,itime[i]+1);
+        } else {
+          const float* vertices0 = (const float*) mesh->vertexPtr(0,itime[i]+0);
+          const float* vertices1 = (const float*) mesh->vertexPtr(0,itime[i]+1);
+          v0 = Vec3fa::loadu(vertices0+v[index]);
+          v1 = Vec3fa::loadu(vertices1+v[index]);
+        }
 #endif
         p0.x[i] = v0.x; p0.y[i] = v0.y; p0.z[i] = v0.z;
         p1.x[i] = v1.x; p1.y[i] = v1.y; p1.z[i] = v1.z;
@@ -269,10 +293,10 @@ namespace embree
       if (unlikely(primID == -1)) return { zero, zero, zero, zero };
       const QuadMesh* mesh = scene->get<QuadMesh>(geomID);
       const QuadMesh::Quad& quad = mesh->quad(primID);
-      const vfloat4 v0 = (vfloat4) mesh->vertices0[quad.v[0]];
-      const vfloat4 v1 = (vfloat4) mesh->vertices0[quad.v[1]];
-      const vfloat4 v2 = (vfloat4) mesh->vertices0[quad.v[2]];
-      const vfloat4 v3 = (vfloat4) mesh->vertices0[quad.v[3]];
+      const vfloat4 v0 = (vfloat4) mesh->vertex(quad.v[0]);
+      const vfloat4 v1 = (vfloat4) mesh->vertex(quad.v[1]);
+      const vfloat4 v2 = (vfloat4) mesh->vertex(quad.v[2]);
+      const vfloat4 v3 = (vfloat4) mesh->vertex(quad.v[3]);
       return { v0, v1, v2, v3 };
     }
 
@@ -283,10 +307,10 @@ namespace embree
       if (unlikely(primID == -1)) return { zero, zero, zero, zero };
       const QuadMesh* mesh = scene->get<QuadMesh>(geomID);
       const QuadMesh::Quad& quad = mesh->quad(primID);
-      const vfloat4 v0 = (vfloat4) mesh->vertices[itime][quad.v[0]];
-      const vfloat4 v1 = (vfloat4) mesh->vertices[itime][quad.v[1]];
-      const vfloat4 v2 = (vfloat4) mesh->vertices[itime][quad.v[2]];
-      const vfloat4 v3 = (vfloat4) mesh->vertices[itime][quad.v[3]];
+      const vfloat4 v0 = (vfloat4) mesh->vertex(quad.v[0],itime);
+      const vfloat4 v1 = (vfloat4) mesh->vertex(quad.v[1],itime);
+      const vfloat4 v2 = (vfloat4) mesh->vertex(quad.v[2],itime);
+      const vfloat4 v3 = (vfloat4) mesh->vertex(quad.v[3],itime);
       return { v0, v1, v2, v3 };
     }
     
@@ -295,6 +319,11 @@ namespace embree
     __forceinline Quad loadQuad(const int i, const Scene* const scene) const 
     {
       const float* vertices = scene->vertices[geomID(i)];
+      if (unlikely(vertices == nullptr)) {
+        const QuadMesh* mesh = scene->get<QuadMesh>(geomID(i));
+        return { (vfloat4) getCompactVertex<0>(i,mesh,0), (vfloat4) getCompactVertex<1>(i,mesh,0),
+                 (vfloat4) getCompactVertex<2>(i,mesh,0), (vfloat4) getCompactVertex<3>(i,mesh,0) };
+      }
       const vfloat4 v0 = vfloat4::loadu(vertices + v0_[i]);
       const vfloat4 v1 = vfloat4::loadu(vertices + v1_[i]);
       const vfloat4 v2 = vfloat4::loadu(vertices + v2_[i]);
@@ -306,6 +335,9 @@ namespace embree
     {
       const unsigned int geomID = geomIDs[i];
       const QuadMesh* mesh = scene->get<QuadMesh>(geomID);
+      if (unlikely(mesh->hasCompactVertices()))
+        return { (vfloat4) getCompactVertex<0>(i,mesh,itime), (vfloat4) getCompactVertex<1>(i,mesh,itime),
+                 (vfloat4) getCompactVertex<2>(i,mesh,itime), (vfloat4) getCompactVertex<3>(i,mesh,itime) };
       const float* vertices = (const float*) mesh->vertexPtr(0,itime);
       const vfloat4 v0 = vfloat4::loadu(vertices + v0_[i]);
       const vfloat4 v1 = vfloat4::loadu(vertices + v1_[i]);
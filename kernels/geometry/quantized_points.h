@@ -0,0 +1,188 @@
+// Copyright 2009-2021 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include "primitive.h"
+
+namespace embree
+{
+  /*! Compressed leaf of the point BVH that stores up to 32 spheres or
+   *  discs of a single geometry. Point centers are quantized to 16 bits
+   *  relative to the bounds of the centers of the leaf and radii are
+   *  stored as indices into a four entry radius palette. Ray queries
+   *  only read the leaf and never the vertex buffer of the geometry. */
+  struct QuantizedPoints
+  {
+    /*! type tag stored in place of the geometry type of point leaves */
+    static const unsigned char TY = 0xFD;
+
+    /*! maximal number of points of a leaf */
+    static const size_t MAX_POINTS = 32;
+
+    /*! number of entries of the radius palette */
+    static const size_t PALETTE_SIZE = 4;
+
+    /*! quantized point stored after the leaf header */
+    struct Point
+    {
+      unsigned short x,y,z;  //!< quantized center
+      unsigned short radius; //!< index into the radius palette
+    };
+
+  public:
+
+    /*! Default constructor. */
+    __forceinline QuantizedPoints () {}
+
+    /*! returns the number of bytes of a leaf with N points */
+    static __forceinline size_t bytes(size_t N) {
+      return sizeof(QuantizedPoints) + N*(sizeof(Point)+sizeof(unsigned int));
+    }
+
+    /*! returns the estimated number of bytes required to store N points */
+    static __forceinline size_t estimatedBytes(size_t N) {
+      return ((N+MAX_POINTS-1)/MAX_POINTS)*sizeof(QuantizedPoints) + N*(sizeof(Point)+sizeof(unsigned int));
+    }
+
+    /*! checks if the range consists of few spheres or discs of one geometry */
+    static __forceinline bool supported(const PrimRef* prims, const range<size_t>& set, Scene* scene)
+    {
+      if (set.size() == 0 || set.size() > MAX_POINTS)
+        return false;
+
+      const unsigned int geomID0 = prims[set.begin()].geomID();
+      const Geometry::GType gtype = scene->get(geomID0)->getType();
+      if (gtype != Geometry::GTY_SPHERE_POINT && gtype != Geometry::GTY_DISC_POINT)
+        return false;
+
+      for (size_t i=set.begin(); i<set.end(); i++)
+        if (prims[i].geomID() != geomID0) return false;
+      return true;
+    }
+
+    /*! quantizes all points of the range */
+    __forceinline void fill(const PrimRef* prims, const range<size_t>& set, Scene* scene)
+    {
+      assert(supported(prims,set,scene));
+      const Points* geom = scene->get<Points>(prims[set.begin()].geomID());
+
+      ty = TY;
+      N = (unsigned char) set.size();
+      gtype = (unsigned char) geom->getType();
+      geomID = prims[set.begin()].geomID();
+
+      /* quantize centers relative to their bounds */
+      Vec3ff v[MAX_POINTS];
+      BBox3fa cbounds = empty;
+      for (size_t i=0; i<N; i++) {
+        v[i] = geom->vertex(prims[set.begin()+i].primID());
+        cbounds.extend(Vec3fa(v[i]));
+      }
+      const Vec3fa size = cbounds.size();
+      lower = Vec3f(cbounds.lower.x,cbounds.lower.y,cbounds.lower.z);
+      scale = Vec3f(size.x/65535.0f,size.y/65535.0f,size.z/65535.0f);
+
+      Point* p = points();
+      for (size_t i=0; i<N; i++) {
+        p[i].x = quantize(v[i].x,cbounds.lower.x,size.x);
+        p[i].y = quantize(v[i].y,cbounds.lower.y,size.y);
+        p[i].z = quantize(v[i].z,cbounds.lower.z,size.z);
+        p[i].radius = 0;
+        primIDs()[i] = prims[set.begin()+i].primID();
+      }
+
+      /* sort radii */
+      size_t order[MAX_POINTS];
+      for (size_t i=0; i<N; i++) {
+        size_t j = i;
+        for (; j>0 && v[order[j-1]].w > v[i].w; j--) order[j] = order[j-1];
+        order[j] = i;
+      }
+      size_t numDistinct = 0;
+      for (size_t i=0; i<N; i++)
+        if (i == 0 || v[order[i]].w != v[order[i-1]].w) numDistinct++;
+
+      /* few distinct radii are stored exactly, otherwise the palette
+       * stores the average radius of equally sized groups of the sorted
+       * radii */
+      for (size_t g=0; g<PALETTE_SIZE; g++) radii[g] = 0.0f;
+      if (numDistinct <= PALETTE_SIZE)
+      {
+        size_t g = 0;
+        for (size_t i=0; i<N; i++) {
+          if (i > 0 && v[order[i]].w != v[order[i-1]].w) g++;
+          radii[g] = v[order[i]].w;
+          p[order[i]].radius = (unsigned short) g;
+        }
+      }
+      else
+      {
+        for (size_t g=0; g<PALETTE_SIZE; g++)
+        {
+          const size_t begin = (g+0)*N/PALETTE_SIZE;
+          const size_t end   = (g+1)*N/PALETTE_SIZE;
+          float sum = 0.0f;
+          for (size_t i=begin; i<end; i++) {
+            sum += v[order[i]].w;
+            p[order[i]].radius = (unsigned short) g;
+          }
+          radii[g] = sum/float(end-begin);
+        }
+      }
+    }
+
+    template<typename BVH, typename Allocator>
+      __forceinline static typename BVH::NodeRef createLeaf (BVH* bvh, const PrimRef* prims, const range<size_t>& set, const Allocator& alloc)
+    {
+      QuantizedPoints* accel = (QuantizedPoints*) alloc.malloc1(bytes(set.size()),BVH::byteAlignment);
+      accel->fill(prims,set,bvh->scene);
+      return bvh->encodeLeaf((char*)accel,1);
+    }
+
+    /*! returns the quantized points stored after the header */
+    __forceinline       Point* points()       { return (      Point*)(this+1); }
+    __forceinline const Point* points() const { return (const Point*)(this+1); }
+
+    /*! returns the primitive IDs stored after the quantized points */
+    __forceinline       unsigned int* primIDs()       { return (      unsigned int*)(points()+N); }
+    __forceinline const unsigned int* primIDs() const { return (const unsigned int*)(points()+N); }
+
+    /*! returns the i'th point, radius in w */
+    __forceinline Vec3ff point(size_t i) const
+    {
+      assert(i < N);
+      const Point& p = points()[i];
+      return Vec3ff(lower.x+float(p.x)*scale.x,
+                    lower.y+float(p.y)*scale.y,
+                    lower.z+float(p.z)*scale.z,
+                    radii[p.radius]);
+    }
+
+    /*! returns the primitive ID of the i'th point */
+    __forceinline unsigned int primID(size_t i) const
+    {
+      assert(i < N);
+      return primIDs()[i];
+    }
+
+  private:
+
+    static __forceinline unsigned short quantize(float x, float lower, float size)
+    {
+      if (size <= 0.0f) return 0;
+      const float q = clamp((x-lower)/size*65535.0f,0.0f,65535.0f);
+      return (unsigned short) floorf(q+0.5f);
+    }
+
+  public:
+    unsigned char ty;            //!< always TY to distinguish the leaf from point leaves
+    unsigned char N;             //!< number of points
+    unsigned char gtype;         //!< geometry type of the points, sphere or disc
+    unsigned char reserved;
+    unsigned int geomID;         //!< geometry ID of all points
+    Vec3f lower;                 //!< lower bounds of the point centers
+    Vec3f scale;                 //!< size of one quantization step
+    float radii[PALETTE_SIZE];   //!< radius palette
+  };
+}
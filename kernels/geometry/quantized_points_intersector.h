@@ -0,0 +1,111 @@
+// Copyright 2009-2021 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include "quantized_points.h"
+#include "sphere_intersector.h"
+#include "disc_intersector.h"
+#include "intersector_epilog.h"
+
+namespace embree
+{
+  namespace isa
+  {
+    /*! dequantizes four points starting at the specified one */
+    static __forceinline vbool<4> gatherQuantizedPoints(const QuantizedPoints* leaf, size_t begin, Vec4vf<4>& v0, vuint<4>& primID)
+    {
+      for (size_t i=0; i<4; i++)
+      {
+        const size_t j = min(begin+i,size_t(leaf->N)-1);
+        const Vec3ff p = leaf->point(j);
+        v0.x[i] = p.x; v0.y[i] = p.y; v0.z[i] = p.z; v0.w[i] = p.w;
+        primID[i] = leaf->primID(j);
+      }
+      return vint<4>(step) < vint<4>(int(leaf->N-begin));
+    }
+
+    struct QuantizedPointsIntersector1
+    {
+      typedef CurvePrecalculations1 Precalculations;
+
+      static __forceinline void intersect(const Precalculations& pre, RayHit& ray, IntersectContext* context, const QuantizedPoints* leaf)
+      {
+        const Points* geom = context->scene->get<Points>(leaf->geomID);
+        const vuint<4> geomID(leaf->geomID);
+        for (size_t i=0; i<leaf->N; i+=4)
+        {
+          STAT3(normal.trav_prims,1,1,1);
+          Vec4vf<4> v0; vuint<4> primID;
+          const vbool<4> valid = gatherQuantizedPoints(leaf,i,v0,primID);
+          if (leaf->gtype == Geometry::GTY_SPHERE_POINT)
+            SphereIntersector1<4>::intersect(valid,ray,context,geom,pre,v0,Intersect1EpilogM<4,true>(ray,context,geomID,primID));
+          else
+            DiscIntersector1<4>::intersect(valid,ray,context,geom,pre,v0,Intersect1EpilogM<4,true>(ray,context,geomID,primID));
+        }
+      }
+
+      static __forceinline bool occluded(const Precalculations& pre, Ray& ray, IntersectContext* context, const QuantizedPoints* leaf)
+      {
+        const Points* geom = context->scene->get<Points>(leaf->geomID);
+        const vuint<4> geomID(leaf->geomID);
+        for (size_t i=0; i<leaf->N; i+=4)
+        {
+          STAT3(shadow.trav_prims,1,1,1);
+          Vec4vf<4> v0; vuint<4> primID;
+          const vbool<4> valid = gatherQuantizedPoints(leaf,i,v0,primID);
+          if (leaf->gtype == Geometry::GTY_SPHERE_POINT) {
+            if (SphereIntersector1<4>::intersect(valid,ray,context,geom,pre,v0,Occluded1EpilogM<4,true>(ray,context,geomID,primID)))
+              return true;
+          } else {
+            if (DiscIntersector1<4>::intersect(valid,ray,context,geom,pre,v0,Occluded1EpilogM<4,true>(ray,context,geomID,primID)))
+              return true;
+          }
+        }
+        return false;
+      }
+    };
+
+    template<int K>
+    struct QuantizedPointsIntersectorK
+    {
+      typedef CurvePrecalculationsK<K> Precalculations;
+
+      static __forceinline void intersect(const Precalculations& pre, RayHitK<K>& ray, size_t k, IntersectContext* context, const QuantizedPoints* leaf)
+      {
+        const Points* geom = context->scene->get<Points>(leaf->geomID);
+        const vuint<4> geomID(leaf->geomID);
+        for (size_t i=0; i<leaf->N; i+=4)
+        {
+          STAT3(normal.trav_prims,1,1,1);
+          Vec4vf<4> v0; vuint<4> primID;
+          const vbool<4> valid = gatherQuantizedPoints(leaf,i,v0,primID);
+          if (leaf->gtype == Geometry::GTY_SPHERE_POINT)
+            SphereIntersectorK<4,K>::intersect(valid,ray,k,context,geom,pre,v0,Intersect1KEpilogM<4,K,true>(ray,k,context,geomID,primID));
+          else
+            DiscIntersectorK<4,K>::intersect(valid,ray,k,context,geom,pre,v0,Intersect1KEpilogM<4,K,true>(ray,k,context,geomID,primID));
+        }
+      }
+
+      static __forceinline bool occluded(const Precalculations& pre, RayK<K>& ray, size_t k, IntersectContext* context, const QuantizedPoints* leaf)
+      {
+        const Points* geom = context->scene->get<Points>(leaf->geomID);
+        const vuint<4> geomID(leaf->geomID);
+        for (size_t i=0; i<leaf->N; i+=4)
+        {
+          STAT3(shadow.trav_prims,1,1,1);
+          Vec4vf<4> v0; vuint<4> primID;
+          const vbool<4> valid = gatherQuantizedPoints(leaf,i,v0,primID);
+          if (leaf->gtype == Geometry::GTY_SPHERE_POINT) {
+            if (SphereIntersectorK<4,K>::intersect(valid,ray,k,context,geom,pre,v0,Occluded1KEpilogM<4,K,true>(ray,k,context,geomID,primID)))
+              return true;
+          } else {
+            if (DiscIntersectorK<4,K>::intersect(valid,ray,k,context,geom,pre,v0,Occluded1KEpilogM<4,K,true>(ray,k,context,geomID,primID)))
+              return true;
+          }
+        }
+        return false;
+      }
+    };
+  }
+}
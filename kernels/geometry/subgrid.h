@@ -253,6 +253,111 @@ namespace embree
         }        
           
 
+        /* 2x2 quads of a refined displaced subgrid */
+        struct DisplacedBlock
+        {
+          __forceinline DisplacedBlock(const Vec3fa* vtx, size_t lineVtxOffset, size_t deltaX, size_t deltaY)
+            : vtx(vtx), lineVtxOffset(lineVtxOffset), deltaX(deltaX), deltaY(deltaY) {}
+
+          /* Gather the quads */
+          __forceinline void gather(Vec3vf4& p0, Vec3vf4& p1, Vec3vf4& p2, Vec3vf4& p3) const
+          {
+            const vfloat4 vtx00 = vfloat4::loadu(&vtx[0]);
+            const vfloat4 vtx01 = vfloat4::loadu(&vtx[1]);
+            const vfloat4 vtx02 = vfloat4::loadu(&vtx[1+deltaX]);
+            const vfloat4 vtx10 = vfloat4::loadu(&vtx[lineVtxOffset]);
+            const vfloat4 vtx11 = vfloat4::loadu(&vtx[lineVtxOffset+1]);
+            const vfloat4 vtx12 = vfloat4::loadu(&vtx[lineVtxOffset+1+deltaX]);
+            const vfloat4 vtx20 = vfloat4::loadu(&vtx[lineVtxOffset+deltaY]);
+            const vfloat4 vtx21 = vfloat4::loadu(&vtx[lineVtxOffset+deltaY+1]);
+            const vfloat4 vtx22 = vfloat4::loadu(&vtx[lineVtxOffset+deltaY+1+deltaX]);
+
+            transpose(vtx00,vtx01,vtx11,vtx10,p0.x,p0.y,p0.z);
+            transpose(vtx01,vtx02,vtx12,vtx11,p1.x,p1.y,p1.z);
+            transpose(vtx11,vtx12,vtx22,vtx21,p2.x,p2.y,p2.z);
+            transpose(vtx10,vtx11,vtx21,vtx20,p3.x,p3.y,p3.z);
+          }
+
+          /* Gather the quads */
+          __forceinline void gather(Vec3fa v[16]) const
+          {
+            const Vec3fa vtx00 = vtx[0];
+            const Vec3fa vtx01 = vtx[1];
+            const Vec3fa vtx02 = vtx[1+deltaX];
+            const Vec3fa vtx10 = vtx[lineVtxOffset];
+            const Vec3fa vtx11 = vtx[lineVtxOffset+1];
+            const Vec3fa vtx12 = vtx[lineVtxOffset+1+deltaX];
+            const Vec3fa vtx20 = vtx[lineVtxOffset+deltaY];
+            const Vec3fa vtx21 = vtx[lineVtxOffset+deltaY+1];
+            const Vec3fa vtx22 = vtx[lineVtxOffset+deltaY+1+deltaX];
+
+            v[ 0] = vtx00; v[ 1] = vtx01; v[ 2] = vtx11; v[ 3] = vtx10;
+            v[ 4] = vtx01; v[ 5] = vtx02; v[ 6] = vtx12; v[ 7] = vtx11;
+            v[ 8] = vtx10; v[ 9] = vtx11; v[10] = vtx21; v[11] = vtx20;
+            v[12] = vtx11; v[13] = vtx12; v[14] = vtx22; v[15] = vtx21;
+          }
+
+          const Vec3fa* vtx;
+          size_t lineVtxOffset;
+          size_t deltaX;
+          size_t deltaY;
+        };
+
+        /* Iterates over the 2x2 quad blocks of the refined displaced
+         * subgrid. The cull functor tests bounds against the rays, cells
+         * of the subgrid get culled by the bounds calculated during the
+         * build before the displaced vertices get evaluated lazily into
+         * the tessellation cache, the remaining blocks by their cached
+         * bounds. The functor gets the refined grid and subgrid to
+         * calculate hit UVs and stops the iteration by returning true. */
+        template<typename Cull, typename Func>
+        __forceinline bool foreachDisplacedBlock(const GridMesh* const mesh, const Cull& cull, const Func& func) const
+        {
+          const GridMesh::Grid& g = mesh->grid(primID());
+          const unsigned int R = mesh->displacementRate;
+          const unsigned int cellsX = invalid3x3X() ? 1 : 2;
+          const unsigned int cellsY = invalid3x3Y() ? 1 : 2;
+          const unsigned int width  = cellsX*R;
+          const unsigned int height = cellsY*R;
+
+          const BBox3fa* cellBounds = mesh->displacedCellBounds(primID(),x(),y());
+          unsigned int cellMask = 0;
+          for (unsigned int cy=0; cy<cellsY; cy++)
+            for (unsigned int cx=0; cx<cellsX; cx++)
+              if (cull(cellBounds[2*cy+cx])) cellMask |= 1 << (2*cy+cx);
+          if (cellMask == 0) return false;
+
+          const BBox3fa* blockBounds;
+          const Vec3fa* vtx = mesh->lookupDisplacedSubGrid(primID(),x(),y(),cellsX,cellsY,blockBounds);
+          const unsigned int blocksX = (width+1)/2;
+
+          GridMesh::Grid rg;
+          rg.startVtxID = 0;
+          rg.lineVtxOffset = width+1;
+          rg.resX = (unsigned short)((g.resX-1)*R+1);
+          rg.resY = (unsigned short)((g.resY-1)*R+1);
+
+          bool stop = false;
+          for (unsigned int by=0; by<height && !stop; by+=2)
+          {
+            /* rows of cells the refined cells of the block row belong to */
+            const unsigned int cy0 = by/R, cy1 = min(by+1,height-1)/R;
+            for (unsigned int bx=0; bx<width && !stop; bx+=2)
+            {
+              const unsigned int cx0 = bx/R, cx1 = min(bx+1,width-1)/R;
+              const unsigned int blockMask = ((1 << cx0) | (1 << cx1)) * ((1 << 2*cy0) | (1 << 2*cy1));
+              if ((blockMask & cellMask) == 0) continue;
+              if (!cull(blockBounds[(by/2)*blocksX+bx/2])) continue;
+
+              const DisplacedBlock block(&vtx[by*rg.lineVtxOffset+bx],rg.lineVtxOffset,
+                                         bx+2 <= width ? 1 : 0, by+2 <= height ? rg.lineVtxOffset : 0);
+              stop = func(block,rg,SubGrid(x()*R+bx,y()*R+by,geomID(),primID()));
+            }
+          }
+          mesh->releaseDisplacedSubGrid();
+          return stop;
+        }
+
         /* Calculate the bounds of the subgrid */
         __forceinline const BBox3fa bounds(const Scene *const scene, const size_t itime=0) const
         {
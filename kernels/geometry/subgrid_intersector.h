@@ -17,6 +17,56 @@ namespace embree
     // =======================================================================================
 
 
+    /* Conservative tests of the bounds of displaced cells and blocks
+     * against rays. The bounds get enlarged and the distances rounded
+     * such that no hit of the refined quads gets culled. */
+    struct DisplacedBoundsCuller1
+    {
+      __forceinline DisplacedBoundsCuller1(const Ray& ray)
+        : org(ray.org), rdir(rcp_safe(Vec3fa(ray.dir))), tnear(ray.tnear()), tfar(ray.tfar) {}
+
+      template<int K>
+      __forceinline DisplacedBoundsCuller1(const RayK<K>& ray, size_t k)
+        : org(ray.org.x[k],ray.org.y[k],ray.org.z[k]), rdir(rcp_safe(Vec3fa(ray.dir.x[k],ray.dir.y[k],ray.dir.z[k]))), tnear(ray.tnear()[k]), tfar(ray.tfar[k]) {}
+
+      __forceinline bool operator() (const BBox3fa& bounds) const
+      {
+        const Vec3fa eps = 4.0f*float(ulp)*max(abs(org),max(abs(bounds.lower),abs(bounds.upper)));
+        const Vec3fa t0 = (bounds.lower-eps-org)*rdir;
+        const Vec3fa t1 = (bounds.upper+eps-org)*rdir;
+        const float tNear = max(reduce_max(min(t0,t1)),tnear);
+        const float tFar  = min(reduce_min(max(t0,t1)),tfar);
+        return (1.0f-3.0f*float(ulp))*tNear <= (1.0f+3.0f*float(ulp))*tFar;
+      }
+
+      const Vec3fa org;
+      const Vec3fa rdir;
+      const float tnear;
+      const float& tfar;
+    };
+
+    template<int K>
+    struct DisplacedBoundsCullerK
+    {
+      __forceinline DisplacedBoundsCullerK(const vbool<K>& valid, const RayK<K>& ray)
+        : valid(valid), ray(ray), rdir(rcp_safe(ray.dir)) {}
+
+      __forceinline bool operator() (const BBox3fa& bounds) const
+      {
+        const Vec3vf<K> lower(bounds.lower), upper(bounds.upper);
+        const Vec3vf<K> eps = vfloat<K>(4.0f*float(ulp))*max(abs(ray.org),max(abs(lower),abs(upper)));
+        const Vec3vf<K> t0 = (lower-eps-ray.org)*rdir;
+        const Vec3vf<K> t1 = (upper+eps-ray.org)*rdir;
+        const vfloat<K> tNear = max(max(min(t0.x,t1.x),min(t0.y,t1.y),min(t0.z,t1.z)),ray.tnear());
+        const vfloat<K> tFar  = min(min(max(t0.x,t1.x),max(t0.y,t1.y),max(t0.z,t1.z)),ray.tfar);
+        return any(valid & ((1.0f-3.0f*float(ulp))*tNear <= (1.0f+3.0f*float(ulp))*tFar));
+      }
+
+      const vbool<K>& valid;
+      const RayK<K>& ray;
+      const Vec3vf<K> rdir;
+    };
+
     template<int N, bool filter>
     struct SubGridIntersector1Moeller
     {
@@ -29,6 +79,15 @@ namespace embree
         const GridMesh* mesh    = context->scene->get<GridMesh>(subgrid.geomID());
         const GridMesh::Grid &g = mesh->grid(subgrid.primID());
 
+        if (unlikely(mesh->isDisplaced())) {
+          subgrid.foreachDisplacedBlock(mesh,DisplacedBoundsCuller1(ray),[&] (const SubGrid::DisplacedBlock& block, const GridMesh::Grid& rg, const SubGrid& rsubgrid) {
+              Vec3vf4 v0,v1,v2,v3; block.gather(v0,v1,v2,v3);
+              pre.intersect(ray,context,v0,v1,v2,v3,rg,rsubgrid);
+              return false;
+            });
+          return;
+        }
+
         Vec3vf4 v0,v1,v2,v3; subgrid.gather(v0,v1,v2,v3,context->scene);
         pre.intersect(ray,context,v0,v1,v2,v3,g,subgrid);
       }
@@ -39,6 +98,13 @@ namespace embree
         const GridMesh* mesh    = context->scene->get<GridMesh>(subgrid.geomID());
         const GridMesh::Grid &g = mesh->grid(subgrid.primID());
 
+        if (unlikely(mesh->isDisplaced())) {
+          return subgrid.foreachDisplacedBlock(mesh,DisplacedBoundsCuller1(ray),[&] (const SubGrid::DisplacedBlock& block, const GridMesh::Grid& rg, const SubGrid& rsubgrid) {
+              Vec3vf4 v0,v1,v2,v3; block.gather(v0,v1,v2,v3);
+              return pre.occluded(ray,context,v0,v1,v2,v3,rg,rsubgrid);
+            });
+        }
+
         Vec3vf4 v0,v1,v2,v3; subgrid.gather(v0,v1,v2,v3,context->scene);
         return pre.occluded(ray,context,v0,v1,v2,v3,g,subgrid);
       }
@@ -132,6 +198,15 @@ namespace embree
         const GridMesh* mesh    = context->scene->get<GridMesh>(subgrid.geomID());
         const GridMesh::Grid &g = mesh->grid(subgrid.primID());
 
+        if (unlikely(mesh->isDisplaced())) {
+          subgrid.foreachDisplacedBlock(mesh,DisplacedBoundsCuller1(ray),[&] (const SubGrid::DisplacedBlock& block, const GridMesh::Grid& rg, const SubGrid& rsubgrid) {
+              Vec3vf4 v0,v1,v2,v3; block.gather(v0,v1,v2,v3);
+              pre.intersect(ray,context,v0,v1,v2,v3,rg,rsubgrid);
+              return false;
+            });
+          return;
+        }
+
         Vec3vf4 v0,v1,v2,v3; subgrid.gather(v0,v1,v2,v3,context->scene);
         pre.intersect(ray,context,v0,v1,v2,v3,g,subgrid);
       }
@@ -142,6 +217,13 @@ namespace embree
         const GridMesh* mesh    = context->scene->get<GridMesh>(subgrid.geomID());
         const GridMesh::Grid &g = mesh->grid(subgrid.primID());
 
+        if (unlikely(mesh->isDisplaced())) {
+          return subgrid.foreachDisplacedBlock(mesh,DisplacedBoundsCuller1(ray),[&] (const SubGrid::DisplacedBlock& block, const GridMesh::Grid& rg, const SubGrid& rsubgrid) {
+              Vec3vf4 v0,v1,v2,v3; block.gather(v0,v1,v2,v3);
+              return pre.occluded(ray,context,v0,v1,v2,v3,rg,rsubgrid);
+            });
+        }
+
         Vec3vf4 v0,v1,v2,v3; subgrid.gather(v0,v1,v2,v3,context->scene);
         return pre.occluded(ray,context,v0,v1,v2,v3,g,subgrid);
       }
@@ -237,6 +319,23 @@ namespace embree
         const GridMesh* mesh    = context->scene->get<GridMesh>(subgrid.geomID());
         const GridMesh::Grid &g = mesh->grid(subgrid.primID());
 
+        if (unlikely(mesh->isDisplaced())) {
+          subgrid.foreachDisplacedBlock(mesh,DisplacedBoundsCullerK<K>(valid_i,ray),[&] (const SubGrid::DisplacedBlock& block, const GridMesh::Grid& rg, const SubGrid& rsubgrid) {
+              block.gather(vtx);
+              for (unsigned int i=0; i<4; i++)
+              {
+                const Vec3vf<K> p0 = vtx[i*4+0];
+                const Vec3vf<K> p1 = vtx[i*4+1];
+                const Vec3vf<K> p2 = vtx[i*4+2];
+                const Vec3vf<K> p3 = vtx[i*4+3];
+                STAT3(normal.trav_prims,1,popcnt(valid_i),K);
+                pre.intersectK(valid_i,ray,p0,p1,p2,p3,rg,rsubgrid,i,IntersectKEpilogM<4,K,filter>(ray,context,subgrid.geomID(),subgrid.primID(),i));
+              }
+              return false;
+            });
+          return;
+        }
+
         subgrid.gather(vtx,context->scene);
         for (unsigned int i=0; i<4; i++)
         {
@@ -256,6 +355,24 @@ namespace embree
         const GridMesh* mesh    = context->scene->get<GridMesh>(subgrid.geomID());
         const GridMesh::Grid &g = mesh->grid(subgrid.primID());
 
+        if (unlikely(mesh->isDisplaced())) {
+          subgrid.foreachDisplacedBlock(mesh,DisplacedBoundsCullerK<K>(valid0,ray),[&] (const SubGrid::DisplacedBlock& block, const GridMesh::Grid& rg, const SubGrid& rsubgrid) {
+              block.gather(vtx);
+              for (unsigned int i=0; i<4; i++)
+              {
+                const Vec3vf<K> p0 = vtx[i*4+0];
+                const Vec3vf<K> p1 = vtx[i*4+1];
+                const Vec3vf<K> p2 = vtx[i*4+2];
+                const Vec3vf<K> p3 = vtx[i*4+3];
+                STAT3(shadow.trav_prims,1,popcnt(valid0),K);
+                pre.intersectK(valid0,ray,p0,p1,p2,p3,rg,rsubgrid,i,OccludedKEpilogM<4,K,filter>(valid0,ray,context,subgrid.geomID(),subgrid.primID(),i));
+                if (none(valid0)) break;
+              }
+              return none(valid0);
+            });
+          return !valid0;
+        }
+
         subgrid.gather(vtx,context->scene);
         for (unsigned int i=0; i<4; i++)
         {
@@ -276,6 +393,15 @@ namespace embree
         const GridMesh* mesh    = context->scene->get<GridMesh>(subgrid.geomID());
         const GridMesh::Grid &g = mesh->grid(subgrid.primID());
 
+        if (unlikely(mesh->isDisplaced())) {
+          subgrid.foreachDisplacedBlock(mesh,DisplacedBoundsCuller1(ray,k),[&] (const SubGrid::DisplacedBlock& block, const GridMesh::Grid& rg, const SubGrid& rsubgrid) {
+              Vec3vf4 v0,v1,v2,v3; block.gather(v0,v1,v2,v3);
+              pre.intersect1(ray,k,context,v0,v1,v2,v3,rg,rsubgrid);
+              return false;
+            });
+          return;
+        }
+
         Vec3vf4 v0,v1,v2,v3; subgrid.gather(v0,v1,v2,v3,context->scene);
         pre.intersect1(ray,k,context,v0,v1,v2,v3,g,subgrid);
       }
@@ -285,6 +411,12 @@ namespace embree
         STAT3(shadow.trav_prims,1,1,1);
         const GridMesh* mesh    = context->scene->get<GridMesh>(subgrid.geomID());
         const GridMesh::Grid &g = mesh->grid(subgrid.primID());
+        if (unlikely(mesh->isDisplaced())) {
+          return subgrid.foreachDisplacedBlock(mesh,DisplacedBoundsCuller1(ray,k),[&] (const SubGrid::DisplacedBlock& block, const GridMesh::Grid& rg, const SubGrid& rsubgrid) {
+              Vec3vf4 v0,v1,v2,v3; block.gather(v0,v1,v2,v3);
+              return pre.occluded1(ray,k,context,v0,v1,v2,v3,rg,rsubgrid);
+            });
+        }
         Vec3vf4 v0,v1,v2,v3; subgrid.gather(v0,v1,v2,v3,context->scene);
         return pre.occluded1(ray,k,context,v0,v1,v2,v3,g,subgrid);
       }
@@ -381,6 +513,23 @@ namespace embree
         const GridMesh* mesh    = context->scene->get<GridMesh>(subgrid.geomID());
         const GridMesh::Grid &g = mesh->grid(subgrid.primID());
 
+        if (unlikely(mesh->isDisplaced())) {
+          subgrid.foreachDisplacedBlock(mesh,DisplacedBoundsCullerK<K>(valid_i,ray),[&] (const SubGrid::DisplacedBlock& block, const GridMesh::Grid& rg, const SubGrid& rsubgrid) {
+              block.gather(vtx);
+              for (unsigned int i=0; i<4; i++)
+              {
+                const Vec3vf<K> p0 = vtx[i*4+0];
+                const Vec3vf<K> p1 = vtx[i*4+1];
+                const Vec3vf<K> p2 = vtx[i*4+2];
+                const Vec3vf<K> p3 = vtx[i*4+3];
+                STAT3(normal.trav_prims,1,popcnt(valid_i),K);
+                pre.intersectK(valid_i,ray,p0,p1,p2,p3,rg,rsubgrid,i,IntersectKEpilogM<4,K,filter>(ray,context,subgrid.geomID(),subgrid.primID(),i));
+              }
+              return false;
+            });
+          return;
+        }
+
         subgrid.gather(vtx,context->scene);
         for (unsigned int i=0; i<4; i++)
         {
@@ -400,6 +549,24 @@ namespace embree
         const GridMesh* mesh    = context->scene->get<GridMesh>(subgrid.geomID());
         const GridMesh::Grid &g = mesh->grid(subgrid.primID());
 
+        if (unlikely(mesh->isDisplaced())) {
+          subgrid.foreachDisplacedBlock(mesh,DisplacedBoundsCullerK<K>(valid0,ray),[&] (const SubGrid::DisplacedBlock& block, const GridMesh::Grid& rg, const SubGrid& rsubgrid) {
+              block.gather(vtx);
+              for (unsigned int i=0; i<4; i++)
+              {
+                const Vec3vf<K> p0 = vtx[i*4+0];
+                const Vec3vf<K> p1 = vtx[i*4+1];
+                const Vec3vf<K> p2 = vtx[i*4+2];
+                const Vec3vf<K> p3 = vtx[i*4+3];
+                STAT3(shadow.trav_prims,1,popcnt(valid0),K);
+                pre.occludedK(valid0,ray,p0,p1,p2,p3,rg,rsubgrid,i,OccludedKEpilogM<4,K,filter>(valid0,ray,context,subgrid.geomID(),subgrid.primID(),i));
+                if (none(valid0)) break;
+              }
+              return none(valid0);
+            });
+          return !valid0;
+        }
+
         subgrid.gather(vtx,context->scene);
         for (unsigned int i=0; i<4; i++)
         {
@@ -420,6 +587,15 @@ namespace embree
         const GridMesh* mesh    = context->scene->get<GridMesh>(subgrid.geomID());
         const GridMesh::Grid &g = mesh->grid(subgrid.primID());
 
+        if (unlikely(mesh->isDisplaced())) {
+          subgrid.foreachDisplacedBlock(mesh,DisplacedBoundsCuller1(ray,k),[&] (const SubGrid::DisplacedBlock& block, const GridMesh::Grid& rg, const SubGrid& rsubgrid) {
+              Vec3vf4 v0,v1,v2,v3; block.gather(v0,v1,v2,v3);
+              pre.intersect1(ray,k,context,v0,v1,v2,v3,rg,rsubgrid);
+              return false;
+            });
+          return;
+        }
+
         Vec3vf4 v0,v1,v2,v3; subgrid.gather(v0,v1,v2,v3,context->scene);
         pre.intersect1(ray,k,context,v0,v1,v2,v3,g,subgrid);
       }
@@ -429,6 +605,12 @@ namespace embree
         STAT3(shadow.trav_prims,1,1,1);
         const GridMesh* mesh    = context->scene->get<GridMesh>(subgrid.geomID());
         const GridMesh::Grid &g = mesh->grid(subgrid.primID());
+        if (unlikely(mesh->isDisplaced())) {
+          return subgrid.foreachDisplacedBlock(mesh,DisplacedBoundsCuller1(ray,k),[&] (const SubGrid::DisplacedBlock& block, const GridMesh::Grid& rg, const SubGrid& rsubgrid) {
+              Vec3vf4 v0,v1,v2,v3; block.gather(v0,v1,v2,v3);
+              return pre.occluded1(ray,k,context,v0,v1,v2,v3,rg,rsubgrid);
+            });
+        }
         Vec3vf4 v0,v1,v2,v3; subgrid.gather(v0,v1,v2,v3,context->scene);
         return pre.occluded1(ray,k,context,v0,v1,v2,v3,g,subgrid);
       }
@@ -0,0 +1,4 @@
+// Copyright 2009-2021 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#define RTC_HASH "2a9cd1c04d4bc88a06c6ac904025c86d92e9b2f7"
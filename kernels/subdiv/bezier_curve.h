@@ -147,6 +147,9 @@ namespace embree
   template<typename Vertex>
     struct CubicBezierCurve
     {
+      /*! basis functions used to evaluate the curve */
+      typedef BezierBasis Basis;
+
       Vertex v0,v1,v2,v3;
       
       __forceinline CubicBezierCurve() {}
@@ -76,6 +76,9 @@ namespace embree
   template<typename Vertex>
     struct BSplineCurveT
     {
+      /*! basis functions used to evaluate the curve */
+      typedef BSplineBasis Basis;
+
       Vertex v0,v1,v2,v3;
       
       __forceinline BSplineCurveT() {}
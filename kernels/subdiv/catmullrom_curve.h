@@ -83,6 +83,9 @@ namespace embree
   template<typename Vertex>
     struct CatmullRomCurveT
     {
+      /*! basis functions used to evaluate the curve */
+      typedef CatmullRomBasis Basis;
+
       Vertex v0,v1,v2,v3;
       
       __forceinline CatmullRomCurveT() {}
@@ -181,6 +181,11 @@ namespace embree {
   }
 #endif
   
+  /* number of PrimRef bytes the SAH builders streamed through memory so far */
+  inline size_t getBuildPrimRefBytes() {
+    return (size_t) rtcGetDeviceProperty(g_device,RTC_DEVICE_PROPERTY_BUILD_PRIMREF_BYTES);
+  }
+
   void Benchmark_Dynamic_Update_Legacy(ISPCScene* scene_in, BenchParams& params, RTCBuildQuality quality = RTC_BUILD_QUALITY_LOW)
   {
     size_t benchmark_iterations = params.minTimeOrIterations;
@@ -368,6 +373,7 @@ namespace embree {
     size_t objects = getNumObjects(scene_in);
     size_t iterations = 0;
     double time = 0.0;
+    size_t bytes = 0;
 
     for(size_t i=0;i<benchmark_iterations+params.skipIterations;i++)
     {
@@ -378,12 +384,15 @@ namespace embree {
       std::vector<std::thread> threads;
       threads.reserve(numThreads);
 
+      const size_t bytes0 = getBuildPrimRefBytes();
       double t0 = getSeconds();
       rtcCommitScene (scene);
       double t1 = getSeconds();
+      const size_t bytes1 = getBuildPrimRefBytes();
       if (i >= params.skipIterations)
       {
         time += t1 - t0;
+        bytes += bytes1 - bytes0;
         iterations++;
       }
       rtcReleaseScene (scene);
@@ -406,7 +415,8 @@ namespace embree {
     if (iterations == 0) iterations = 1;
     std::cout << iterations << " iterations, " << primitives << " primitives, " << objects << " objects, "
               << time/iterations << " s, "
-              << 1.0 / (time/iterations) * primitives / 1000000.0 << " Mprims/s" << std::endl;
+              << 1.0 / (time/iterations) * primitives / 1000000.0 << " Mprims/s, "
+              << double(bytes) / double(iterations*primitives) << " bytes/prim" << std::endl;
   }
 
   void Benchmark_Static_Create(
@@ -437,6 +447,7 @@ namespace embree {
       rtcReleaseScene(scene);
     }
 
+    size_t bytes = 0;
     for(auto _ : *state.state) {
       state.state->PauseTiming();
 
@@ -447,11 +458,13 @@ namespace embree {
       std::vector<std::thread> threads;
       threads.reserve(numThreads);
 
+      const size_t bytes0 = getBuildPrimRefBytes();
       state.state->ResumeTiming();
 
       rtcCommitScene(scene);
 
       state.state->PauseTiming();
+      bytes += getBuildPrimRefBytes() - bytes0;
 
       rtcReleaseScene(scene);
       
@@ -459,6 +472,7 @@ namespace embree {
     }
 
     addCounter(state, primitives, objects);
+    state.state->counters["BytesPerPrim"] = ::benchmark::Counter(double(bytes) / double(state.state->iterations() * primitives));
 #else
     Benchmark_Static_Create_Legacy(ispc_scene, params, quality, qflags);
 #endif
@@ -20,6 +20,7 @@ struct DifferentialGeometry
   Vec3fa Tx; //direction along hair
   Vec3fa Ty;
   float eps;
+  float footprint; // width of the ray footprint in texture coordinates
 };
 
 } // namespace embree
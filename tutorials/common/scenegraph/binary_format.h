@@ -0,0 +1,109 @@
+// Copyright 2009-2021 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include "../default.h"
+
+#include <sys/stat.h>
+
+namespace embree
+{
+  /*! Layout of the binary scene cache (.ebs files). The file starts
+   *  with a header followed by a number of page aligned sections. The
+   *  node section stores one record per scene graph node, texture and
+   *  material in an order such that every record only references
+   *  records stored before it. All bulk data (vertex arrays, index
+   *  arrays, transformations, texels) is stored in the other sections
+   *  in its in-memory layout, thus it can directly get used from or
+   *  copied out of the memory mapped file. The source section lists
+   *  the files the scene got loaded from, such that a stale cache can
+   *  get detected. */
+  namespace BinaryScene
+  {
+    static const char MAGIC[8] = { 'E','M','B','R','S','C','N','\0' };
+    static const unsigned VERSION = 2;
+    static const size_t SECTION_ALIGNMENT = PAGE_SIZE;
+    static const size_t ARRAY_ALIGNMENT = 64;
+    static const unsigned INVALID_ID = 0xFFFFFFFF;
+
+    enum Section
+    {
+      SECTION_NODES,      //!< node, material, and texture records
+      SECTION_MESHES,     //!< triangle, quad, subdivision, grid and point data
+      SECTION_CURVES,     //!< curve data
+      SECTION_INSTANCES,  //!< transformations and group children
+      SECTION_MATERIALS,  //!< material parameters
+      SECTION_TEXTURES,   //!< embedded texels
+      SECTION_SOURCES,    //!< names, sizes and modification times of the source files
+      NUM_SECTIONS
+    };
+
+    enum RecordType
+    {
+      RECORD_TEXTURE,
+      RECORD_MATERIAL,
+      RECORD_TRIANGLE_MESH,
+      RECORD_QUAD_MESH,
+      RECORD_SUBDIV_MESH,
+      RECORD_GRID_MESH,
+      RECORD_POINT_SET,
+      RECORD_HAIR_SET,
+      RECORD_PERSPECTIVE_CAMERA,
+      RECORD_ANIMATED_PERSPECTIVE_CAMERA,
+      RECORD_LIGHT,
+      RECORD_ANIMATED_LIGHT,
+      RECORD_TRANSFORM,
+      RECORD_GROUP
+    };
+
+    struct SectionInfo
+    {
+      uint64_t offset;  //!< page aligned file offset of section
+      uint64_t size;    //!< size of section in bytes
+    };
+
+    struct Header
+    {
+      char magic[8];
+      uint32_t version;
+      uint32_t pageSize;
+      uint64_t fileSize;
+      uint64_t numRecords;
+      uint64_t root;    //!< record ID of root node
+      uint64_t numSources;
+      SectionInfo sections[NUM_SECTIONS];
+    };
+
+    /*! reference to an array stored in some section */
+    struct ArrayRef
+    {
+      uint32_t section;
+      uint32_t elementSize;
+      uint64_t offset;  //!< offset relative to start of section
+      uint64_t size;    //!< number of elements
+    };
+
+    /*! size and modification time of a source file */
+    struct SourceInfo
+    {
+      int64_t size;
+      int64_t time;
+    };
+
+    /*! queries size and modification time of some source file */
+    inline bool getSourceInfo(const FileName& fileName, SourceInfo& info)
+    {
+#if defined(__WIN32__)
+      struct _stat64 st;
+      if (_stat64(fileName.c_str(),&st) != 0) return false;
+#else
+      struct stat st;
+      if (stat(fileName.c_str(),&st) != 0) return false;
+#endif
+      info.size = int64_t(st.st_size);
+      info.time = int64_t(st.st_mtime);
+      return true;
+    }
+  }
+}
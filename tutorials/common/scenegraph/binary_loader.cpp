@@ -0,0 +1,590 @@
+// Copyright 2009-2021 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "binary_loader.h"
+#include "binary_format.h"
+
+#if defined(__WIN32__)
+#  define WIN32_LEAN_AND_MEAN
+#  include <windows.h>
+#else
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#  include <fcntl.h>
+#  include <unistd.h>
+#endif
+
+namespace embree
+{
+  using namespace BinaryScene;
+
+  /*! read-only memory mapping of an entire file */
+  class MappedFile
+  {
+  public:
+    MappedFile (const FileName& fileName);
+    ~MappedFile ();
+
+  private:
+    MappedFile (const MappedFile& other) DELETED; // do not implement
+    MappedFile& operator= (const MappedFile& other) DELETED; // do not implement
+
+  public:
+    const char* ptr;
+    size_t bytes;
+
+  private:
+#if defined(__WIN32__)
+    HANDLE file;
+    HANDLE mapping;
+#else
+    int fd;
+#endif
+  };
+
+#if defined(__WIN32__)
+
+  MappedFile::MappedFile (const FileName& fileName)
+    : ptr(nullptr), bytes(0), file(INVALID_HANDLE_VALUE), mapping(nullptr)
+  {
+    file = CreateFileA(fileName.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) THROW_RUNTIME_ERROR("cannot open file " + fileName.str());
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file,&size)) { CloseHandle(file); THROW_RUNTIME_ERROR("cannot stat file " + fileName.str()); }
+    bytes = size_t(size.QuadPart);
+    mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mapping) ptr = (const char*) MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (ptr == nullptr) {
+      if (mapping) CloseHandle(mapping);
+      CloseHandle(file);
+      THROW_RUNTIME_ERROR("cannot map file " + fileName.str());
+    }
+  }
+
+  MappedFile::~MappedFile ()
+  {
+    UnmapViewOfFile(ptr);
+    CloseHandle(mapping);
+    CloseHandle(file);
+  }
+
+#else
+
+  MappedFile::MappedFile (const FileName& fileName)
+    : ptr(nullptr), bytes(0), fd(-1)
+  {
+    fd = open(fileName.c_str(), O_RDONLY);
+    if (fd == -1) THROW_RUNTIME_ERROR("cannot open file " + fileName.str());
+    struct stat st;
+    if (fstat(fd,&st) != 0) { close(fd); THROW_RUNTIME_ERROR("cannot stat file " + fileName.str()); }
+    bytes = size_t(st.st_size);
+    void* p = mmap(nullptr, bytes, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (p == MAP_FAILED) { close(fd); THROW_RUNTIME_ERROR("cannot map file " + fileName.str()); }
+    ptr = (const char*) p;
+  }
+
+  MappedFile::~MappedFile ()
+  {
+    munmap((void*)ptr,bytes);
+    close(fd);
+  }
+
+#endif
+
+  /*! list of material parameters as stored in the material section */
+  struct MaterialParameters
+  {
+    MaterialParameters (const std::vector<float>& params)
+      : params(params), i(0) {}
+
+    float getFloat() {
+      if (i >= params.size()) THROW_RUNTIME_ERROR("corrupt binary scene: too few material parameters");
+      return params[i++];
+    }
+
+    Vec3fa getVec3fa() {
+      const float x = getFloat(); const float y = getFloat(); const float z = getFloat();
+      return Vec3fa(x,y,z);
+    }
+
+    const std::vector<float>& params;
+    size_t i;
+  };
+
+  class BinaryLoader
+  {
+  public:
+
+    BinaryLoader(const FileName& fileName);
+
+    /*! loads all records of the node section and returns the root node */
+    Ref<SceneGraph::Node> load();
+
+    /*! checks that the scene got created from the specified source files in their current state */
+    bool upToDate(const std::vector<FileName>& sources);
+
+  private:
+    void read(void* dst, size_t bytes);
+    template<typename T> T read() { T v; read(&v,sizeof(T)); return v; }
+    std::string readString();
+
+    const char* readArray(size_t elementSize, size_t& N);
+    template<typename T> void readArray(std::vector<T>& vec);
+    template<typename T> void readArray(avector<T>& vec);
+    template<typename T> void readTimeSteps(std::vector<avector<T>>& steps);
+
+    Ref<SceneGraph::Node> getNode(unsigned id);
+    Ref<SceneGraph::MaterialNode> getMaterial(unsigned id);
+    std::shared_ptr<Texture> getTexture(unsigned id);
+
+    std::shared_ptr<Texture> loadTexture();
+    Ref<SceneGraph::Node> loadMaterial();
+    Ref<SceneGraph::Node> loadTriangleMesh();
+    Ref<SceneGraph::Node> loadQuadMesh();
+    Ref<SceneGraph::Node> loadSubdivMesh();
+    Ref<SceneGraph::Node> loadGridMesh();
+    Ref<SceneGraph::Node> loadPointSet();
+    Ref<SceneGraph::Node> loadHairSet();
+    Ref<SceneGraph::Node> loadPerspectiveCamera();
+    Ref<SceneGraph::Node> loadAnimatedPerspectiveCamera();
+    template<typename Light> Ref<SceneGraph::Node> loadLight();
+    Ref<SceneGraph::Node> loadLight();
+    Ref<SceneGraph::Node> loadAnimatedLight();
+    Ref<SceneGraph::Node> loadTransform();
+    Ref<SceneGraph::Node> loadGroup();
+
+  private:
+    std::shared_ptr<MappedFile> file; //!< shared with textures that reference their texels in the mapping
+    Header header;
+    const char* cur;  //!< read position in node section
+    const char* end;  //!< end of node section
+    std::vector<Ref<SceneGraph::Node>> nodes;
+    std::vector<std::shared_ptr<Texture>> textures;
+  };
+
+  //////////////////////////////////////////////////////////////////////////////
+  //// Loading of objects from binary file
+  //////////////////////////////////////////////////////////////////////////////
+
+  void BinaryLoader::read(void* dst, size_t bytes)
+  {
+    if (size_t(end-cur) < bytes) THROW_RUNTIME_ERROR("corrupt binary scene: unexpected end of section");
+    memcpy(dst,cur,bytes);
+    cur += bytes;
+  }
+
+  std::string BinaryLoader::readString()
+  {
+    const size_t N = read<uint32_t>();
+    if (size_t(end-cur) < N) THROW_RUNTIME_ERROR("corrupt binary scene: unexpected end of section");
+    std::string str(cur,N);
+    cur += N;
+    return str;
+  }
+
+  const char* BinaryLoader::readArray(size_t elementSize, size_t& N)
+  {
+    const ArrayRef ref = read<ArrayRef>();
+    if (ref.section >= NUM_SECTIONS || ref.elementSize != elementSize)
+      THROW_RUNTIME_ERROR("corrupt binary scene: invalid array");
+    const SectionInfo& section = header.sections[ref.section];
+    if (ref.offset > section.size || ref.size > (section.size-ref.offset)/elementSize)
+      THROW_RUNTIME_ERROR("corrupt binary scene: array out of bounds");
+    N = ref.size;
+    return file->ptr + section.offset + ref.offset;
+  }
+
+  template<typename T>
+  void BinaryLoader::readArray(std::vector<T>& vec)
+  {
+    size_t N = 0;
+    const char* data = readArray(sizeof(T),N);
+    vec.resize(N);
+    if (N) memcpy((void*)vec.data(),data,N*sizeof(T));
+  }
+
+  template<typename T>
+  void BinaryLoader::readArray(avector<T>& vec)
+  {
+    size_t N = 0;
+    const char* data = readArray(sizeof(T),N);
+    vec.resize(N);
+    if (N) memcpy((void*)vec.data(),data,N*sizeof(T));
+  }
+
+  template<typename T>
+  void BinaryLoader::readTimeSteps(std::vector<avector<T>>& steps)
+  {
+    steps.resize(read<uint32_t>());
+    for (auto& step : steps)
+      readArray(step);
+  }
+
+  Ref<SceneGraph::Node> BinaryLoader::getNode(unsigned id)
+  {
+    if (id >= nodes.size() || !nodes[id]) THROW_RUNTIME_ERROR("corrupt binary scene: invalid node reference");
+    return nodes[id];
+  }
+
+  Ref<SceneGraph::MaterialNode> BinaryLoader::getMaterial(unsigned id)
+  {
+    if (id == INVALID_ID) return nullptr;
+    Ref<SceneGraph::MaterialNode> material = getNode(id).dynamicCast<SceneGraph::MaterialNode>();
+    if (!material) THROW_RUNTIME_ERROR("corrupt binary scene: invalid material reference");
+    return material;
+  }
+
+  std::shared_ptr<Texture> BinaryLoader::getTexture(unsigned id)
+  {
+    if (id == INVALID_ID) return nullptr;
+    if (id >= textures.size() || !textures[id]) THROW_RUNTIME_ERROR("corrupt binary scene: invalid texture reference");
+    return textures[id];
+  }
+
+  std::shared_ptr<Texture> BinaryLoader::loadTexture()
+  {
+    const Texture::Format format = (Texture::Format) read<uint32_t>();
+    const unsigned width = read<uint32_t>();
+    const unsigned height = read<uint32_t>();
+    const std::string fileName = readString();
+    size_t N = 0;
+    const char* texels = readArray(sizeof(char),N);
+
+    /* textures that are not embedded get reloaded from their image */
+    if (N == 0)
+      return Texture::load(fileName);
+
+    if (format == Texture::INVALID || format == Texture::TILED || N != size_t(width)*size_t(height)*Texture::getFormatBytesPerTexel(format))
+      THROW_RUNTIME_ERROR("corrupt binary scene: invalid texture");
+    /* embedded texels are used directly from the mapping, the texture keeps the mapping alive */
+    std::shared_ptr<Texture> tex(new Texture(width,height,format,texels,file));
+    tex->fileName = fileName;
+    return tex;
+  }
+
+  Ref<SceneGraph::Node> BinaryLoader::loadMaterial()
+  {
+    const int type = read<int32_t>();
+    std::shared_ptr<Texture> maps[5];
+    for (size_t i=0; i<5; i++) maps[i] = getTexture(read<uint32_t>());
+    std::vector<float> params; readArray(params);
+    MaterialParameters parms(params);
+
+    switch (type)
+    {
+    case MATERIAL_OBJ: {
+      const int illum = int(parms.getFloat());
+      const float d = parms.getFloat();
+      const float Ns = parms.getFloat();
+      const float Ni = parms.getFloat();
+      const Vec3fa Ka = parms.getVec3fa();
+      const Vec3fa Kd = parms.getVec3fa();
+      const Vec3fa Ks = parms.getVec3fa();
+      const Vec3fa Kt = parms.getVec3fa();
+      Ref<OBJMaterial> material = new OBJMaterial(d,maps[0],Kd,maps[1],Ks,maps[2],Ns,maps[3],maps[4]);
+      material->illum = illum;
+      material->Ni = Ni;
+      material->Ka = Ka;
+      material->Kt = Kt;
+      return material.dynamicCast<SceneGraph::Node>();
+    }
+    case MATERIAL_THIN_DIELECTRIC: {
+      const Vec3fa transmission = parms.getVec3fa();
+      const float eta = parms.getFloat();
+      const float thickness = parms.getFloat();
+      return new ThinDielectricMaterial(transmission,eta,thickness);
+    }
+    case MATERIAL_METAL:
+    case MATERIAL_REFLECTIVE_METAL: {
+      const Vec3fa reflectance = parms.getVec3fa();
+      const Vec3fa eta = parms.getVec3fa();
+      const Vec3fa k = parms.getVec3fa();
+      const float roughness = parms.getFloat();
+      if (type == MATERIAL_REFLECTIVE_METAL) return new MetalMaterial(reflectance,eta,k);
+      else                                   return new MetalMaterial(reflectance,eta,k,roughness);
+    }
+    case MATERIAL_VELVET: {
+      const Vec3fa reflectance = parms.getVec3fa();
+      const float backScattering = parms.getFloat();
+      const Vec3fa horizonScatteringColor = parms.getVec3fa();
+      const float horizonScatteringFallOff = parms.getFloat();
+      return new VelvetMaterial(reflectance,backScattering,horizonScatteringColor,horizonScatteringFallOff);
+    }
+    case MATERIAL_DIELECTRIC: {
+      const Vec3fa transmissionOutside = parms.getVec3fa();
+      const Vec3fa transmissionInside = parms.getVec3fa();
+      const float etaOutside = parms.getFloat();
+      const float etaInside = parms.getFloat();
+      return new DielectricMaterial(transmissionOutside,transmissionInside,etaOutside,etaInside);
+    }
+    case MATERIAL_METALLIC_PAINT: {
+      const Vec3fa shadeColor = parms.getVec3fa();
+      const Vec3fa glitterColor = parms.getVec3fa();
+      const float glitterSpread = parms.getFloat();
+      const float eta = parms.getFloat();
+      return new MetallicPaintMaterial(shadeColor,glitterColor,glitterSpread,eta);
+    }
+    case MATERIAL_MATTE: {
+      return new MatteMaterial(parms.getVec3fa());
+    }
+    case MATERIAL_MIRROR: {
+      return new MirrorMaterial(parms.getVec3fa());
+    }
+    case MATERIAL_HAIR: {
+      const Vec3fa Kr = parms.getVec3fa();
+      const Vec3fa Kt = parms.getVec3fa();
+      const float nx = parms.getFloat();
+      const float ny = parms.getFloat();
+      return new HairMaterial(Kr,Kt,nx,ny);
+    }
+    default:
+      THROW_RUNTIME_ERROR("corrupt binary scene: unknown material type");
+    }
+  }
+
+  Ref<SceneGraph::Node> BinaryLoader::loadTriangleMesh()
+  {
+    Ref<SceneGraph::MaterialNode> material = getMaterial(read<uint32_t>());
+    const BBox1f time_range = read<BBox1f>();
+    Ref<SceneGraph::TriangleMeshNode> mesh = new SceneGraph::TriangleMeshNode(material,time_range,0);
+    readTimeSteps(mesh->positions);
+    readTimeSteps(mesh->normals);
+    readArray(mesh->texcoords);
+    readArray(mesh->triangles);
+    return mesh.dynamicCast<SceneGraph::Node>();
+  }
+
+  Ref<SceneGraph::Node> BinaryLoader::loadQuadMesh()
+  {
+    Ref<SceneGraph::MaterialNode> material = getMaterial(read<uint32_t>());
+    const BBox1f time_range = read<BBox1f>();
+    Ref<SceneGraph::QuadMeshNode> mesh = new SceneGraph::QuadMeshNode(material,time_range,0);
+    readTimeSteps(mesh->positions);
+    readTimeSteps(mesh->normals);
+    readArray(mesh->texcoords);
+    readArray(mesh->quads);
+    return mesh.dynamicCast<SceneGraph::Node>();
+  }
+
+  Ref<SceneGraph::Node> BinaryLoader::loadSubdivMesh()
+  {
+    Ref<SceneGraph::MaterialNode> material = getMaterial(read<uint32_t>());
+    const BBox1f time_range = read<BBox1f>();
+    Ref<SceneGraph::SubdivMeshNode> mesh = new SceneGraph::SubdivMeshNode(material,time_range,0);
+    mesh->position_subdiv_mode = (RTCSubdivisionMode) read<int32_t>();
+    mesh->normal_subdiv_mode = (RTCSubdivisionMode) read<int32_t>();
+    mesh->texcoord_subdiv_mode = (RTCSubdivisionMode) read<int32_t>();
+    mesh->tessellationRate = read<float>();
+    readTimeSteps(mesh->positions);
+    readTimeSteps(mesh->normals);
+    readArray(mesh->texcoords);
+    readArray(mesh->position_indices);
+    readArray(mesh->normal_indices);
+    readArray(mesh->texcoord_indices);
+    readArray(mesh->verticesPerFace);
+    readArray(mesh->holes);
+    readArray(mesh->edge_creases);
+    readArray(mesh->edge_crease_weights);
+    readArray(mesh->vertex_creases);
+    readArray(mesh->vertex_crease_weights);
+    mesh->zero_pad_arrays();
+    return mesh.dynamicCast<SceneGraph::Node>();
+  }
+
+  Ref<SceneGraph::Node> BinaryLoader::loadGridMesh()
+  {
+    Ref<SceneGraph::MaterialNode> material = getMaterial(read<uint32_t>());
+    const BBox1f time_range = read<BBox1f>();
+    Ref<SceneGraph::GridMeshNode> mesh = new SceneGraph::GridMeshNode(material,time_range,0);
+    readTimeSteps(mesh->positions);
+    readArray(mesh->grids);
+    return mesh.dynamicCast<SceneGraph::Node>();
+  }
+
+  Ref<SceneGraph::Node> BinaryLoader::loadPointSet()
+  {
+    Ref<SceneGraph::MaterialNode> material = getMaterial(read<uint32_t>());
+    const BBox1f time_range = read<BBox1f>();
+    const RTCGeometryType type = (RTCGeometryType) read<int32_t>();
+    Ref<SceneGraph::PointSetNode> mesh = new SceneGraph::PointSetNode(type,material,time_range,0);
+    readTimeSteps(mesh->positions);
+    readTimeSteps(mesh->normals);
+    return mesh.dynamicCast<SceneGraph::Node>();
+  }
+
+  Ref<SceneGraph::Node> BinaryLoader::loadHairSet()
+  {
+    Ref<SceneGraph::MaterialNode> material = getMaterial(read<uint32_t>());
+    const BBox1f time_range = read<BBox1f>();
+    const RTCGeometryType type = (RTCGeometryType) read<int32_t>();
+    Ref<SceneGraph::HairSetNode> mesh = new SceneGraph::HairSetNode(type,material,time_range,0);
+    mesh->tessellation_rate = read<unsigned>();
+    readTimeSteps(mesh->positions);
+    readTimeSteps(mesh->normals);
+    readTimeSteps(mesh->tangents);
+    readTimeSteps(mesh->dnormals);
+    readArray(mesh->hairs);
+    readArray(mesh->flags);
+    return mesh.dynamicCast<SceneGraph::Node>();
+  }
+
+  Ref<SceneGraph::Node> BinaryLoader::loadPerspectiveCamera()
+  {
+    Ref<SceneGraph::PerspectiveCameraNode> camera = new SceneGraph::PerspectiveCameraNode;
+    camera->data = read<SceneGraph::PerspectiveCameraData>();
+    return camera.dynamicCast<SceneGraph::Node>();
+  }
+
+  Ref<SceneGraph::Node> BinaryLoader::loadAnimatedPerspectiveCamera()
+  {
+    const BBox1f time_range = read<BBox1f>();
+    std::vector<unsigned> ids; readArray(ids);
+    std::vector<Ref<SceneGraph::PerspectiveCameraNode>> cameras(ids.size());
+    for (size_t i=0; i<ids.size(); i++) {
+      cameras[i] = getNode(ids[i]).dynamicCast<SceneGraph::PerspectiveCameraNode>();
+      if (!cameras[i]) THROW_RUNTIME_ERROR("corrupt binary scene: invalid camera reference");
+    }
+    return new SceneGraph::AnimatedPerspectiveCameraNode(std::move(cameras),time_range);
+  }
+
+  template<typename Light>
+  Ref<SceneGraph::Node> BinaryLoader::loadLight()
+  {
+    /* lights are stored as plain copies of the light objects */
+    typename std::aligned_storage<sizeof(Light),alignof(Light)>::type light;
+    read(&light,sizeof(Light));
+    return new SceneGraph::LightNodeImpl<Light>(*(const Light*)&light);
+  }
+
+  Ref<SceneGraph::Node> BinaryLoader::loadLight()
+  {
+    switch (read<int32_t>())
+    {
+    case SceneGraph::LIGHT_AMBIENT    : return loadLight<SceneGraph::AmbientLight>();
+    case SceneGraph::LIGHT_POINT      : return loadLight<SceneGraph::PointLight>();
+    case SceneGraph::LIGHT_DIRECTIONAL: return loadLight<SceneGraph::DirectionalLight>();
+    case SceneGraph::LIGHT_SPOT       : return loadLight<SceneGraph::SpotLight>();
+    case SceneGraph::LIGHT_DISTANT    : return loadLight<SceneGraph::DistantLight>();
+    case SceneGraph::LIGHT_TRIANGLE   : return loadLight<SceneGraph::TriangleLight>();
+    case SceneGraph::LIGHT_QUAD       : return loadLight<SceneGraph::QuadLight>();
+    default: THROW_RUNTIME_ERROR("corrupt binary scene: unknown light type");
+    }
+  }
+
+  Ref<SceneGraph::Node> BinaryLoader::loadAnimatedLight()
+  {
+    const BBox1f time_range = read<BBox1f>();
+    std::vector<unsigned> ids; readArray(ids);
+    std::vector<Ref<SceneGraph::LightNode>> lights(ids.size());
+    for (size_t i=0; i<ids.size(); i++) {
+      lights[i] = getNode(ids[i]).dynamicCast<SceneGraph::LightNode>();
+      if (!lights[i]) THROW_RUNTIME_ERROR("corrupt binary scene: invalid light reference");
+    }
+    return new SceneGraph::AnimatedLightNode(std::move(lights),time_range);
+  }
+
+  Ref<SceneGraph::Node> BinaryLoader::loadTransform()
+  {
+    Ref<SceneGraph::Node> child = getNode(read<uint32_t>());
+    SceneGraph::Transformations spaces;
+    spaces.time_range = read<BBox1f>();
+    spaces.quaternion = read<uint32_t>() != 0;
+    readArray(spaces.spaces);
+    if (spaces.size() == 0) THROW_RUNTIME_ERROR("corrupt binary scene: transformation without spaces");
+    return new SceneGraph::TransformNode(spaces,child);
+  }
+
+  Ref<SceneGraph::Node> BinaryLoader::loadGroup()
+  {
+    std::vector<unsigned> ids; readArray(ids);
+    Ref<SceneGraph::GroupNode> group = new SceneGraph::GroupNode(ids.size());
+    for (size_t i=0; i<ids.size(); i++)
+      group->set(i,getNode(ids[i]));
+    return group.dynamicCast<SceneGraph::Node>();
+  }
+
+  BinaryLoader::BinaryLoader(const FileName& fileName)
+    : file(new MappedFile(fileName)), cur(nullptr), end(nullptr)
+  {
+    if (file->bytes < sizeof(Header)) THROW_RUNTIME_ERROR("invalid binary scene file " + fileName.str());
+    memcpy(&header,file->ptr,sizeof(Header));
+    if (memcmp(header.magic,MAGIC,sizeof(MAGIC)) != 0) THROW_RUNTIME_ERROR("invalid binary scene file " + fileName.str());
+    if (header.version != VERSION) THROW_RUNTIME_ERROR("unsupported binary scene version in " + fileName.str());
+    if (header.fileSize > file->bytes) THROW_RUNTIME_ERROR("truncated binary scene file " + fileName.str());
+    for (size_t i=0; i<NUM_SECTIONS; i++) {
+      const SectionInfo& section = header.sections[i];
+      if (section.offset > header.fileSize || section.size > header.fileSize-section.offset)
+        THROW_RUNTIME_ERROR("corrupt binary scene file " + fileName.str());
+    }
+  }
+
+  bool BinaryLoader::upToDate(const std::vector<FileName>& sources)
+  {
+    if (header.numSources != sources.size())
+      return false;
+
+    cur = file->ptr + header.sections[SECTION_SOURCES].offset;
+    end = cur + header.sections[SECTION_SOURCES].size;
+    for (const FileName& source : sources)
+    {
+      const std::string name = readString();
+      const SourceInfo stored = read<SourceInfo>();
+      SourceInfo info;
+      if (name != source.str() || !getSourceInfo(source,info) || info.size != stored.size || info.time != stored.time)
+        return false;
+    }
+    return true;
+  }
+
+  Ref<SceneGraph::Node> BinaryLoader::load()
+  {
+    cur = file->ptr + header.sections[SECTION_NODES].offset;
+    end = cur + header.sections[SECTION_NODES].size;
+    nodes.resize(header.numRecords);
+    textures.resize(header.numRecords);
+
+    for (size_t id=0; id<header.numRecords; id++)
+    {
+      const RecordType type = (RecordType) read<uint32_t>();
+      const std::string name = readString();
+
+      Ref<SceneGraph::Node> node;
+      switch (type)
+      {
+      case RECORD_TEXTURE                    : textures[id] = loadTexture(); continue;
+      case RECORD_MATERIAL                   : node = loadMaterial(); break;
+      case RECORD_TRIANGLE_MESH              : node = loadTriangleMesh(); break;
+      case RECORD_QUAD_MESH                  : node = loadQuadMesh(); break;
+      case RECORD_SUBDIV_MESH                : node = loadSubdivMesh(); break;
+      case RECORD_GRID_MESH                  : node = loadGridMesh(); break;
+      case RECORD_POINT_SET                  : node = loadPointSet(); break;
+      case RECORD_HAIR_SET                   : node = loadHairSet(); break;
+      case RECORD_PERSPECTIVE_CAMERA         : node = loadPerspectiveCamera(); break;
+      case RECORD_ANIMATED_PERSPECTIVE_CAMERA: node = loadAnimatedPerspectiveCamera(); break;
+      case RECORD_LIGHT                      : node = loadLight(); break;
+      case RECORD_ANIMATED_LIGHT             : node = loadAnimatedLight(); break;
+      case RECORD_TRANSFORM                  : node = loadTransform(); break;
+      case RECORD_GROUP                      : node = loadGroup(); break;
+      default: THROW_RUNTIME_ERROR("corrupt binary scene: unknown record type");
+      }
+      node->name = name;
+      nodes[id] = node;
+    }
+
+    return getNode(unsigned(header.root));
+  }
+
+  Ref<SceneGraph::Node> SceneGraph::loadBinary(const FileName& fileName) {
+    return BinaryLoader(fileName).load();
+  }
+
+  bool SceneGraph::isBinaryUpToDate(const FileName& fileName, const std::vector<FileName>& sources)
+  {
+    /* missing or corrupt caches are never up to date */
+    try {
+      return BinaryLoader(fileName).upToDate(sources);
+    } catch (const std::exception&) {
+      return false;
+    }
+  }
+}
@@ -0,0 +1,18 @@
+// Copyright 2009-2021 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include "scenegraph.h"
+
+namespace embree
+{
+  namespace SceneGraph
+  {
+    Ref<Node> loadBinary(const FileName& fileName);
+
+    /*! checks that a binary scene cache exists and got created from
+     *  the specified source files in their current state */
+    bool isBinaryUpToDate(const FileName& fileName, const std::vector<FileName>& sources);
+  }
+}
@@ -0,0 +1,499 @@
+// Copyright 2009-2021 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "binary_writer.h"
+#include "binary_format.h"
+
+namespace embree
+{
+  using namespace BinaryScene;
+
+  class BinaryWriter
+  {
+  public:
+
+    BinaryWriter(Ref<SceneGraph::Node> root, const FileName& fileName, bool embedTextures, const std::vector<FileName>& sources);
+
+  private:
+    void write(Section section, const void* ptr, size_t bytes);
+    void write(Section section, const std::string& str);
+    void flush(Section section);
+    void align(Section section, size_t alignment);
+
+    template<typename T> void write(const T& v) { write(SECTION_NODES,&v,sizeof(T)); }
+    void write(const std::string& str) { write(SECTION_NODES,str); }
+    template<typename T> void writeObject(const T& v);
+
+    template<typename T> void writeArray(Section section, const T* data, size_t N);
+    template<typename T> void writeArray(Section section, const std::vector<T>& vec) { writeArray(section,vec.data(),vec.size()); }
+    template<typename T> void writeArray(Section section, const avector<T>& vec) { writeArray(section,vec.data(),vec.size()); }
+    template<typename T> void writeTimeSteps(Section section, const std::vector<avector<T>>& steps);
+
+    unsigned beginRecord(RecordType type, const std::string& name);
+    unsigned storeScene(Ref<SceneGraph::Node> root, const std::vector<FileName>& sources);
+
+    unsigned store(std::shared_ptr<Texture> tex);
+    unsigned store(Ref<SceneGraph::MaterialNode> material);
+
+    unsigned store(Ref<SceneGraph::TriangleMeshNode> mesh);
+    unsigned store(Ref<SceneGraph::QuadMeshNode> mesh);
+    unsigned store(Ref<SceneGraph::SubdivMeshNode> mesh);
+    unsigned store(Ref<SceneGraph::GridMeshNode> mesh);
+    unsigned store(Ref<SceneGraph::PointSetNode> mesh);
+    unsigned store(Ref<SceneGraph::HairSetNode> mesh);
+
+    unsigned store(Ref<SceneGraph::PerspectiveCameraNode> camera);
+    unsigned store(Ref<SceneGraph::AnimatedPerspectiveCameraNode> camera);
+    template<typename Light> unsigned store(Ref<SceneGraph::LightNodeImpl<Light>> light);
+    unsigned store(Ref<SceneGraph::LightNode> light);
+    unsigned store(Ref<SceneGraph::AnimatedLightNode> light);
+    unsigned store(Ref<SceneGraph::TransformNode> node);
+    unsigned store(Ref<SceneGraph::GroupNode> group);
+    unsigned store(Ref<SceneGraph::Node> node);
+
+  private:
+    std::fstream file;                         //!< only open while the second pass writes the sections
+    size_t sectionSize[NUM_SECTIONS];          //!< bytes stored to each section so far
+    size_t sectionOffset[NUM_SECTIONS];        //!< file offset of each section
+    std::vector<char> buffers[NUM_SECTIONS];   //!< write buffer of each section
+    std::map<Ref<SceneGraph::Node>, unsigned> nodeMap;
+    std::map<std::shared_ptr<Texture>, unsigned> textureMap;
+    unsigned numRecords;
+    bool embedTextures;
+  };
+
+  /*! list of material parameters, stored as floats in the material section */
+  struct MaterialParameters
+  {
+    void add(float f) { params.push_back(f); }
+    void add(const Vec3fa& v) { add(v.x); add(v.y); add(v.z); }
+    std::vector<float> params;
+  };
+
+  //////////////////////////////////////////////////////////////////////////////
+  //// Storing of objects to binary file
+  //////////////////////////////////////////////////////////////////////////////
+
+  /*! maximal number of bytes buffered per section before they get written to the file */
+  static const size_t WRITE_BUFFER_SIZE = 1024*1024;
+
+  void BinaryWriter::write(Section section, const void* ptr, size_t bytes)
+  {
+    /* the first pass only measures the sections */
+    if (!file.is_open()) {
+      sectionSize[section] += bytes;
+      return;
+    }
+
+    std::vector<char>& buffer = buffers[section];
+    if (buffer.size()+bytes > WRITE_BUFFER_SIZE)
+      flush(section);
+
+    /* large arrays get written directly to their place in the file */
+    const char* p = (const char*) ptr;
+    if (bytes > WRITE_BUFFER_SIZE) {
+      file.seekp(sectionOffset[section]+sectionSize[section]);
+      file.write(p,bytes);
+    }
+    else
+      buffer.insert(buffer.end(),p,p+bytes);
+    sectionSize[section] += bytes;
+  }
+
+  void BinaryWriter::write(Section section, const std::string& str)
+  {
+    const uint32_t N = uint32_t(str.size());
+    write(section,&N,sizeof(N));
+    write(section,str.data(),str.size());
+  }
+
+  void BinaryWriter::flush(Section section)
+  {
+    std::vector<char>& buffer = buffers[section];
+    if (buffer.empty()) return;
+    file.seekp(sectionOffset[section]+sectionSize[section]-buffer.size());
+    file.write(buffer.data(),buffer.size());
+    buffer.clear();
+  }
+
+  void BinaryWriter::align(Section section, size_t alignment)
+  {
+    const size_t size = sectionSize[section];
+    const size_t pad = (size+alignment-1)/alignment*alignment - size;
+    const char zeros[ARRAY_ALIGNMENT] = { 0 };
+    assert(alignment <= ARRAY_ALIGNMENT);
+    if (pad) write(section,zeros,pad);
+  }
+
+  template<typename T>
+  void BinaryWriter::writeObject(const T& v)
+  {
+    /* objects get copied into cleared memory first, such that their padding bytes do not end up in the file */
+    typename std::aligned_storage<sizeof(T),alignof(T)>::type copy;
+    memset(&copy,0,sizeof(T));
+    ::new (&copy) T(v);
+    write(copy);
+  }
+
+  template<typename T>
+  void BinaryWriter::writeArray(Section section, const T* data, size_t N)
+  {
+    align(section,ARRAY_ALIGNMENT);
+    ArrayRef ref;
+    ref.section = section;
+    ref.elementSize = sizeof(T);
+    ref.offset = sectionSize[section];
+    ref.size = N;
+    write(ref);
+    if (N) write(section,data,N*sizeof(T));
+  }
+
+  template<typename T>
+  void BinaryWriter::writeTimeSteps(Section section, const std::vector<avector<T>>& steps)
+  {
+    write(uint32_t(steps.size()));
+    for (const auto& step : steps)
+      writeArray(section,step);
+  }
+
+  unsigned BinaryWriter::beginRecord(RecordType type, const std::string& name)
+  {
+    write(uint32_t(type));
+    write(name);
+    return numRecords++;
+  }
+
+  unsigned BinaryWriter::store(std::shared_ptr<Texture> tex)
+  {
+    if (tex == nullptr) return INVALID_ID;
+    if (textureMap.find(tex) != textureMap.end()) return textureMap[tex];
+
+    /* tiled textures always get reloaded from their image */
+    const bool embed = tex->format != Texture::TILED && (embedTextures || tex->fileName == "");
+
+    const unsigned id = textureMap[tex] = beginRecord(RECORD_TEXTURE,"");
+    write(uint32_t(tex->format));
+    write(uint32_t(tex->width));
+    write(uint32_t(tex->height));
+    write(tex->fileName);
+    if (embed) writeArray(SECTION_TEXTURES,(const char*)tex->data,size_t(tex->width)*size_t(tex->height)*tex->bytesPerTexel);
+    else       writeArray(SECTION_TEXTURES,(const char*)nullptr,0);
+    return id;
+  }
+
+  unsigned BinaryWriter::store(Ref<SceneGraph::MaterialNode> mnode)
+  {
+    if (!mnode) return INVALID_ID;
+    Ref<SceneGraph::Node> node = mnode.dynamicCast<SceneGraph::Node>();
+    if (nodeMap.find(node) != nodeMap.end()) return nodeMap[node];
+
+    MaterialParameters parms;
+    unsigned textures[5] = { INVALID_ID, INVALID_ID, INVALID_ID, INVALID_ID, INVALID_ID };
+    const int type = mnode->material()->type;
+
+    if (Ref<OBJMaterial> m = mnode.dynamicCast<OBJMaterial>()) {
+      parms.add(float(m->illum)); parms.add(m->d); parms.add(m->Ns); parms.add(m->Ni);
+      parms.add(m->Ka); parms.add(m->Kd); parms.add(m->Ks); parms.add(m->Kt);
+      textures[0] = store(m->_map_d);
+      textures[1] = store(m->_map_Kd);
+      textures[2] = store(m->_map_Ks);
+      textures[3] = store(m->_map_Ns);
+      textures[4] = store(m->_map_Displ);
+    }
+    else if (Ref<ThinDielectricMaterial> m = mnode.dynamicCast<ThinDielectricMaterial>()) {
+      parms.add(m->transmission); parms.add(m->eta); parms.add(m->thickness);
+    }
+    else if (Ref<MetalMaterial> m = mnode.dynamicCast<MetalMaterial>()) {
+      parms.add(m->reflectance); parms.add(m->eta); parms.add(m->k); parms.add(m->roughness);
+    }
+    else if (Ref<VelvetMaterial> m = mnode.dynamicCast<VelvetMaterial>()) {
+      parms.add(m->reflectance); parms.add(m->backScattering); parms.add(m->horizonScatteringColor); parms.add(m->horizonScatteringFallOff);
+    }
+    else if (Ref<DielectricMaterial> m = mnode.dynamicCast<DielectricMaterial>()) {
+      parms.add(m->transmissionOutside); parms.add(m->transmissionInside); parms.add(m->etaOutside); parms.add(m->etaInside);
+    }
+    else if (Ref<MetallicPaintMaterial> m = mnode.dynamicCast<MetallicPaintMaterial>()) {
+      parms.add(m->shadeColor); parms.add(m->glitterColor); parms.add(m->glitterSpread); parms.add(m->eta);
+    }
+    else if (Ref<MatteMaterial> m = mnode.dynamicCast<MatteMaterial>()) {
+      parms.add(m->reflectance);
+    }
+    else if (Ref<MirrorMaterial> m = mnode.dynamicCast<MirrorMaterial>()) {
+      parms.add(m->reflectance);
+    }
+    else if (Ref<HairMaterial> m = mnode.dynamicCast<HairMaterial>()) {
+      parms.add(m->Kr); parms.add(m->Kt); parms.add(m->nx); parms.add(m->ny);
+    }
+    else throw std::runtime_error("unsupported material");
+
+    const unsigned id = nodeMap[node] = beginRecord(RECORD_MATERIAL,mnode->name);
+    write(int32_t(type));
+    for (size_t i=0; i<5; i++) write(textures[i]);
+    writeArray(SECTION_MATERIALS,parms.params);
+    return id;
+  }
+
+  unsigned BinaryWriter::store(Ref<SceneGraph::TriangleMeshNode> mesh)
+  {
+    const unsigned materialID = store(mesh->material);
+    const unsigned id = beginRecord(RECORD_TRIANGLE_MESH,mesh->name);
+    write(materialID);
+    write(mesh->time_range);
+    writeTimeSteps(SECTION_MESHES,mesh->positions);
+    writeTimeSteps(SECTION_MESHES,mesh->normals);
+    writeArray(SECTION_MESHES,mesh->texcoords);
+    writeArray(SECTION_MESHES,mesh->triangles);
+    return id;
+  }
+
+  unsigned BinaryWriter::store(Ref<SceneGraph::QuadMeshNode> mesh)
+  {
+    const unsigned materialID = store(mesh->material);
+    const unsigned id = beginRecord(RECORD_QUAD_MESH,mesh->name);
+    write(materialID);
+    write(mesh->time_range);
+    writeTimeSteps(SECTION_MESHES,mesh->positions);
+    writeTimeSteps(SECTION_MESHES,mesh->normals);
+    writeArray(SECTION_MESHES,mesh->texcoords);
+    writeArray(SECTION_MESHES,mesh->quads);
+    return id;
+  }
+
+  unsigned BinaryWriter::store(Ref<SceneGraph::SubdivMeshNode> mesh)
+  {
+    const unsigned materialID = store(mesh->material);
+    const unsigned id = beginRecord(RECORD_SUBDIV_MESH,mesh->name);
+    write(materialID);
+    write(mesh->time_range);
+    write(int32_t(mesh->position_subdiv_mode));
+    write(int32_t(mesh->normal_subdiv_mode));
+    write(int32_t(mesh->texcoord_subdiv_mode));
+    write(mesh->tessellationRate);
+    writeTimeSteps(SECTION_MESHES,mesh->positions);
+    writeTimeSteps(SECTION_MESHES,mesh->normals);
+    writeArray(SECTION_MESHES,mesh->texcoords);
+    writeArray(SECTION_MESHES,mesh->position_indices);
+    writeArray(SECTION_MESHES,mesh->normal_indices);
+    writeArray(SECTION_MESHES,mesh->texcoord_indices);
+    writeArray(SECTION_MESHES,mesh->verticesPerFace);
+    writeArray(SECTION_MESHES,mesh->holes);
+    writeArray(SECTION_MESHES,mesh->edge_creases);
+    writeArray(SECTION_MESHES,mesh->edge_crease_weights);
+    writeArray(SECTION_MESHES,mesh->vertex_creases);
+    writeArray(SECTION_MESHES,mesh->vertex_crease_weights);
+    return id;
+  }
+
+  unsigned BinaryWriter::store(Ref<SceneGraph::GridMeshNode> mesh)
+  {
+    const unsigned materialID = store(mesh->material);
+    const unsigned id = beginRecord(RECORD_GRID_MESH,mesh->name);
+    write(materialID);
+    write(mesh->time_range);
+    writeTimeSteps(SECTION_MESHES,mesh->positions);
+    writeArray(SECTION_MESHES,mesh->grids);
+    return id;
+  }
+
+  unsigned BinaryWriter::store(Ref<SceneGraph::PointSetNode> mesh)
+  {
+    const unsigned materialID = store(mesh->material);
+    const unsigned id = beginRecord(RECORD_POINT_SET,mesh->name);
+    write(materialID);
+    write(mesh->time_range);
+    write(int32_t(mesh->type));
+    writeTimeSteps(SECTION_MESHES,mesh->positions);
+    writeTimeSteps(SECTION_MESHES,mesh->normals);
+    return id;
+  }
+
+  unsigned BinaryWriter::store(Ref<SceneGraph::HairSetNode> mesh)
+  {
+    const unsigned materialID = store(mesh->material);
+    const unsigned id = beginRecord(RECORD_HAIR_SET,mesh->name);
+    write(materialID);
+    write(mesh->time_range);
+    write(int32_t(mesh->type));
+    write(mesh->tessellation_rate);
+    writeTimeSteps(SECTION_CURVES,mesh->positions);
+    writeTimeSteps(SECTION_CURVES,mesh->normals);
+    writeTimeSteps(SECTION_CURVES,mesh->tangents);
+    writeTimeSteps(SECTION_CURVES,mesh->dnormals);
+    writeArray(SECTION_CURVES,mesh->hairs);
+    writeArray(SECTION_CURVES,mesh->flags);
+    return id;
+  }
+
+  unsigned BinaryWriter::store(Ref<SceneGraph::PerspectiveCameraNode> camera)
+  {
+    const unsigned id = beginRecord(RECORD_PERSPECTIVE_CAMERA,camera->name);
+    writeObject(camera->data);
+    return id;
+  }
+
+  unsigned BinaryWriter::store(Ref<SceneGraph::AnimatedPerspectiveCameraNode> camera)
+  {
+    std::vector<unsigned> cameras(camera->size());
+    for (size_t i=0; i<camera->size(); i++)
+      cameras[i] = store(camera->cameras[i].dynamicCast<SceneGraph::Node>());
+
+    const unsigned id = beginRecord(RECORD_ANIMATED_PERSPECTIVE_CAMERA,camera->name);
+    write(camera->time_range);
+    writeArray(SECTION_INSTANCES,cameras);
+    return id;
+  }
+
+  template<typename Light>
+  unsigned BinaryWriter::store(Ref<SceneGraph::LightNodeImpl<Light>> light)
+  {
+    const unsigned id = beginRecord(RECORD_LIGHT,light->name);
+    write(int32_t(light->light.getType()));
+    writeObject(light->light);
+    return id;
+  }
+
+  unsigned BinaryWriter::store(Ref<SceneGraph::LightNode> node)
+  {
+    if (auto light = node.dynamicCast<SceneGraph::LightNodeImpl<SceneGraph::AmbientLight>>())
+      return store(light);
+    else if (auto light = node.dynamicCast<SceneGraph::LightNodeImpl<SceneGraph::PointLight>>())
+      return store(light);
+    else if (auto light = node.dynamicCast<SceneGraph::LightNodeImpl<SceneGraph::DirectionalLight>>())
+      return store(light);
+    else if (auto light = node.dynamicCast<SceneGraph::LightNodeImpl<SceneGraph::SpotLight>>())
+      return store(light);
+    else if (auto light = node.dynamicCast<SceneGraph::LightNodeImpl<SceneGraph::DistantLight>>())
+      return store(light);
+    else if (auto light = node.dynamicCast<SceneGraph::LightNodeImpl<SceneGraph::TriangleLight>>())
+      return store(light);
+    else if (auto light = node.dynamicCast<SceneGraph::LightNodeImpl<SceneGraph::QuadLight>>())
+      return store(light);
+    else
+      throw std::runtime_error("unsupported light");
+  }
+
+  unsigned BinaryWriter::store(Ref<SceneGraph::AnimatedLightNode> node)
+  {
+    std::vector<unsigned> lights(node->lights.size());
+    for (size_t i=0; i<node->lights.size(); i++)
+      lights[i] = store(node->lights[i].dynamicCast<SceneGraph::Node>());
+
+    const unsigned id = beginRecord(RECORD_ANIMATED_LIGHT,node->name);
+    write(node->time_range);
+    writeArray(SECTION_INSTANCES,lights);
+    return id;
+  }
+
+  unsigned BinaryWriter::store(Ref<SceneGraph::TransformNode> node)
+  {
+    const unsigned childID = store(node->child);
+    const unsigned id = beginRecord(RECORD_TRANSFORM,node->name);
+    write(childID);
+    write(node->spaces.time_range);
+    write(uint32_t(node->spaces.quaternion));
+    writeArray(SECTION_INSTANCES,node->spaces.spaces);
+    return id;
+  }
+
+  unsigned BinaryWriter::store(Ref<SceneGraph::GroupNode> group)
+  {
+    std::vector<unsigned> children(group->children.size());
+    for (size_t i=0; i<group->children.size(); i++)
+      children[i] = store(group->children[i]);
+
+    const unsigned id = beginRecord(RECORD_GROUP,group->name);
+    writeArray(SECTION_INSTANCES,children);
+    return id;
+  }
+
+  unsigned BinaryWriter::store(Ref<SceneGraph::Node> node)
+  {
+    if (nodeMap.find(node) != nodeMap.end())
+      return nodeMap[node];
+
+    unsigned id = INVALID_ID;
+    if      (Ref<SceneGraph::AnimatedLightNode> cnode = node.dynamicCast<SceneGraph::AnimatedLightNode>()) id = store(cnode);
+    else if (Ref<SceneGraph::LightNode> cnode = node.dynamicCast<SceneGraph::LightNode>()) id = store(cnode);
+    else if (Ref<SceneGraph::MaterialNode> cnode = node.dynamicCast<SceneGraph::MaterialNode>()) id = store(cnode);
+    else if (Ref<SceneGraph::TriangleMeshNode> cnode = node.dynamicCast<SceneGraph::TriangleMeshNode>()) id = store(cnode);
+    else if (Ref<SceneGraph::QuadMeshNode> cnode = node.dynamicCast<SceneGraph::QuadMeshNode>()) id = store(cnode);
+    else if (Ref<SceneGraph::SubdivMeshNode> cnode = node.dynamicCast<SceneGraph::SubdivMeshNode>()) id = store(cnode);
+    else if (Ref<SceneGraph::GridMeshNode> cnode = node.dynamicCast<SceneGraph::GridMeshNode>()) id = store(cnode);
+    else if (Ref<SceneGraph::PointSetNode> cnode = node.dynamicCast<SceneGraph::PointSetNode>()) id = store(cnode);
+    else if (Ref<SceneGraph::HairSetNode> cnode = node.dynamicCast<SceneGraph::HairSetNode>()) id = store(cnode);
+    else if (Ref<SceneGraph::AnimatedPerspectiveCameraNode> cnode = node.dynamicCast<SceneGraph::AnimatedPerspectiveCameraNode>()) id = store(cnode);
+    else if (Ref<SceneGraph::PerspectiveCameraNode> cnode = node.dynamicCast<SceneGraph::PerspectiveCameraNode>()) id = store(cnode);
+    else if (Ref<SceneGraph::TransformNode> cnode = node.dynamicCast<SceneGraph::TransformNode>()) id = store(cnode);
+    else if (Ref<SceneGraph::GroupNode> cnode = node.dynamicCast<SceneGraph::GroupNode>()) id = store(cnode);
+    else throw std::runtime_error("unknown node type");
+
+    return nodeMap[node] = id;
+  }
+
+  unsigned BinaryWriter::storeScene(Ref<SceneGraph::Node> root, const std::vector<FileName>& sources)
+  {
+    for (const FileName& source : sources)
+    {
+      SourceInfo info;
+      if (!getSourceInfo(source,info)) THROW_RUNTIME_ERROR("cannot stat file " + source.str());
+      write(SECTION_SOURCES,source.str());
+      write(SECTION_SOURCES,&info,sizeof(info));
+    }
+    return store(root);
+  }
+
+  BinaryWriter::BinaryWriter(Ref<SceneGraph::Node> root, const FileName& fileName, bool embedTextures, const std::vector<FileName>& sources)
+    : numRecords(0), embedTextures(embedTextures)
+  {
+    /* the first pass only measures the sections, thus the scene never gets buffered in memory */
+    for (size_t i=0; i<NUM_SECTIONS; i++) sectionSize[i] = 0;
+    const unsigned rootID = storeScene(root,sources);
+
+    /* layout sections page aligned after the header */
+    Header header;
+    memset(&header,0,sizeof(header));
+    memcpy(header.magic,MAGIC,sizeof(MAGIC));
+    header.version = VERSION;
+    header.pageSize = SECTION_ALIGNMENT;
+    header.numRecords = numRecords;
+    header.root = rootID;
+    header.numSources = sources.size();
+
+    size_t offset = SECTION_ALIGNMENT;
+    for (size_t i=0; i<NUM_SECTIONS; i++) {
+      header.sections[i].offset = sectionOffset[i] = offset;
+      header.sections[i].size = sectionSize[i];
+      offset += (sectionSize[i]+SECTION_ALIGNMENT-1)/SECTION_ALIGNMENT*SECTION_ALIGNMENT;
+    }
+    header.fileSize = offset;
+
+    file.exceptions (std::fstream::failbit | std::fstream::badbit);
+    file.open (fileName, std::fstream::out | std::fstream::binary | std::fstream::trunc);
+
+    const std::vector<char> padding(SECTION_ALIGNMENT,0);
+    file.write((char*)&header,sizeof(header));
+    file.write(padding.data(),SECTION_ALIGNMENT-sizeof(header));
+
+    /* the second pass streams every section to its offset in the file */
+    for (size_t i=0; i<NUM_SECTIONS; i++) sectionSize[i] = 0;
+    nodeMap.clear();
+    textureMap.clear();
+    numRecords = 0;
+    storeScene(root,sources);
+
+    for (size_t i=0; i<NUM_SECTIONS; i++)
+    {
+      flush(Section(i));
+      assert(sectionSize[i] == header.sections[i].size);
+      const size_t pad = (SECTION_ALIGNMENT - sectionSize[i]%SECTION_ALIGNMENT) % SECTION_ALIGNMENT;
+      if (pad) {
+        file.seekp(sectionOffset[i]+sectionSize[i]);
+        file.write(padding.data(),pad);
+      }
+    }
+  }
+
+  void SceneGraph::storeBinary(Ref<SceneGraph::Node> root, const FileName& fileName, bool embedTextures, const std::vector<FileName>& sources) {
+    BinaryWriter(root,fileName,embedTextures,sources);
+  }
+}
@@ -0,0 +1,17 @@
+// Copyright 2009-2021 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include "scenegraph.h"
+
+namespace embree
+{
+  namespace SceneGraph
+  {
+    /*! stores the scene to a binary scene cache, the names, sizes and
+     *  modification times of the source files get stored as well */
+    void storeBinary(Ref<SceneGraph::Node> root, const FileName& fileName, bool embedTextures,
+                     const std::vector<FileName>& sources = std::vector<FileName>());
+  }
+}
@@ -7,6 +7,9 @@
 #include "obj_loader.h"
 #include "ply_loader.h"
 #include "corona_loader.h"
+#include "binary_loader.h"
+#include "binary_writer.h"
+#include "../../../common/algorithms/parallel_prefix_sum.h"
 
 namespace embree
 {
@@ -20,6 +23,7 @@ namespace embree
     else if (toLowerCase(filename.ext()) == std::string("ply" )) return loadPLY(filename);
     else if (toLowerCase(filename.ext()) == std::string("xml" )) return loadXML(filename);
     else if (toLowerCase(filename.ext()) == std::string("scn" )) return loadCorona(filename);
+    else if (toLowerCase(filename.ext()) == std::string("ebs" )) return loadBinary(filename);
     else throw std::runtime_error("unknown scene format: " + filename.ext());
   }
 
@@ -28,6 +32,9 @@ namespace embree
     if (toLowerCase(filename.ext()) == std::string("xml")) {
       storeXML(root,filename,embedTextures,referenceMaterials,binaryFormat);
     }
+    else if (toLowerCase(filename.ext()) == std::string("ebs")) {
+      storeBinary(root,filename,embedTextures);
+    }
     else
       throw std::runtime_error("unknown scene format: " + filename.ext());
   }
@@ -636,18 +643,20 @@ namespace embree
   {
     avector<Vec3ff> positions_o;
     positions_o.resize(4*indices.size());
-    for (size_t i=0; i<indices.size(); i++) 
-    {
-      const size_t idx = indices[i].vertex;
-      const vfloat4 v0 = vfloat4::loadu(&positions[idx+0]);  
-      const vfloat4 v1 = vfloat4::loadu(&positions[idx+1]);
-      const vfloat4 v2 = vfloat4::loadu(&positions[idx+2]);
-      const vfloat4 v3 = vfloat4::loadu(&positions[idx+3]);
-      positions_o[4*i+0] = Vec3ff((1.0f/6.0f)*v0 + (2.0f/3.0f)*v1 + (1.0f/6.0f)*v2);
-      positions_o[4*i+1] = Vec3ff((2.0f/3.0f)*v1 + (1.0f/3.0f)*v2);
-      positions_o[4*i+2] = Vec3ff((1.0f/3.0f)*v1 + (2.0f/3.0f)*v2);
-      positions_o[4*i+3] = Vec3ff((1.0f/6.0f)*v1 + (2.0f/3.0f)*v2 + (1.0f/6.0f)*v3);
-    }
+    parallel_for(size_t(0),indices.size(),size_t(4096),[&](const range<size_t>& r) {
+      for (size_t i=r.begin(); i<r.end(); i++)
+      {
+          const size_t idx = indices[i].vertex;
+          const vfloat4 v0 = vfloat4::loadu(&positions[idx+0]);  
+          const vfloat4 v1 = vfloat4::loadu(&positions[idx+1]);
+          const vfloat4 v2 = vfloat4::loadu(&positions[idx+2]);
+          const vfloat4 v3 = vfloat4::loadu(&positions[idx+3]);
+          positions_o[4*i+0] = Vec3ff((1.0f/6.0f)*v0 + (2.0f/3.0f)*v1 + (1.0f/6.0f)*v2);
+          positions_o[4*i+1] = Vec3ff((2.0f/3.0f)*v1 + (1.0f/3.0f)*v2);
+          positions_o[4*i+2] = Vec3ff((1.0f/3.0f)*v1 + (2.0f/3.0f)*v2);
+          positions_o[4*i+3] = Vec3ff((1.0f/6.0f)*v1 + (2.0f/3.0f)*v2 + (1.0f/6.0f)*v3);
+      }
+    });
     return positions_o;
   }
 
@@ -655,18 +664,20 @@ namespace embree
   {
     avector<Vec3ff> positions_o;
     positions_o.resize(4*indices.size());
-    for (size_t i=0; i<indices.size(); i++) 
-    {
-      const size_t idx = indices[i].vertex;
-      vfloat4 v0 = vfloat4::loadu(&positions[idx+0]);  
-      vfloat4 v1 = vfloat4::loadu(&positions[idx+1]);
-      vfloat4 v2 = vfloat4::loadu(&positions[idx+2]);
-      vfloat4 v3 = vfloat4::loadu(&positions[idx+3]);
-      positions_o[4*i+0] = Vec3ff( 6.0f*v0 - 7.0f*v1 + 2.0f*v2);
-      positions_o[4*i+1] = Vec3ff( 2.0f*v1 - 1.0f*v2);
-      positions_o[4*i+2] = Vec3ff(-1.0f*v1 + 2.0f*v2);
-      positions_o[4*i+3] = Vec3ff( 2.0f*v1 - 7.0f*v2 + 6.0f*v3);
-    }
+    parallel_for(size_t(0),indices.size(),size_t(4096),[&](const range<size_t>& r) {
+      for (size_t i=r.begin(); i<r.end(); i++)
+      {
+          const size_t idx = indices[i].vertex;
+          vfloat4 v0 = vfloat4::loadu(&positions[idx+0]);  
+          vfloat4 v1 = vfloat4::loadu(&positions[idx+1]);
+          vfloat4 v2 = vfloat4::loadu(&positions[idx+2]);
+          vfloat4 v3 = vfloat4::loadu(&positions[idx+3]);
+          positions_o[4*i+0] = Vec3ff( 6.0f*v0 - 7.0f*v1 + 2.0f*v2);
+          positions_o[4*i+1] = Vec3ff( 2.0f*v1 - 1.0f*v2);
+          positions_o[4*i+2] = Vec3ff(-1.0f*v1 + 2.0f*v2);
+          positions_o[4*i+3] = Vec3ff( 2.0f*v1 - 7.0f*v2 + 6.0f*v3);
+      }
+    });
     return positions_o;
   }
 
@@ -675,18 +686,20 @@ namespace embree
     avector<Vec3ff> positions_o; positions_o.resize(2*indices.size());
     avector<Vec3ff> tangents_o;  tangents_o.resize(2*indices.size());
     
-    for (size_t i=0; i<indices.size(); i++) 
-    {
-      const size_t idx = indices[i].vertex;
-      vfloat4 v0 = vfloat4::loadu(&positions[idx+0]);  
-      vfloat4 v1 = vfloat4::loadu(&positions[idx+1]);
-      vfloat4 v2 = vfloat4::loadu(&positions[idx+2]);
-      vfloat4 v3 = vfloat4::loadu(&positions[idx+3]);
-      positions_o[2*i+0] = Vec3ff(v0);
-      positions_o[2*i+1] = Vec3ff(v3);
-      tangents_o[2*i+0] = Vec3ff(3.0f*(v1-v0));
-      tangents_o[2*i+1] = Vec3ff(3.0f*(v3-v2));
-    }
+    parallel_for(size_t(0),indices.size(),size_t(4096),[&](const range<size_t>& r) {
+      for (size_t i=r.begin(); i<r.end(); i++)
+      {
+          const size_t idx = indices[i].vertex;
+          vfloat4 v0 = vfloat4::loadu(&positions[idx+0]);  
+          vfloat4 v1 = vfloat4::loadu(&positions[idx+1]);
+          vfloat4 v2 = vfloat4::loadu(&positions[idx+2]);
+          vfloat4 v3 = vfloat4::loadu(&positions[idx+3]);
+          positions_o[2*i+0] = Vec3ff(v0);
+          positions_o[2*i+1] = Vec3ff(v3);
+          tangents_o[2*i+0] = Vec3ff(3.0f*(v1-v0));
+          tangents_o[2*i+1] = Vec3ff(3.0f*(v3-v2));
+      }
+    });
     return std::make_pair(positions_o,tangents_o);
   }
 
@@ -1189,6 +1202,74 @@ namespace embree
     else return std::make_pair(0,-1);
   }
   
+  /*! collects all distinct meshes of type Mesh reachable from node */
+  template<typename Mesh>
+  static void collect_meshes(const Ref<SceneGraph::Node>& node, std::set<Ref<SceneGraph::Node>>& visited, std::vector<Ref<Mesh>>& meshes)
+  {
+    if (!node || visited.find(node) != visited.end()) return;
+    visited.insert(node);
+
+    if (Ref<SceneGraph::TransformNode> xfmNode = node.dynamicCast<SceneGraph::TransformNode>()) {
+      collect_meshes(xfmNode->child,visited,meshes);
+    }
+    else if (Ref<SceneGraph::GroupNode> groupNode = node.dynamicCast<SceneGraph::GroupNode>()) {
+      for (const auto& child : groupNode->children) collect_meshes(child,visited,meshes);
+    }
+    else if (Ref<Mesh> mesh = node.dynamicCast<Mesh>()) {
+      meshes.push_back(mesh);
+    }
+  }
+
+  /*! replaces nodes according to mapping, transform and group nodes are updated in place */
+  static Ref<SceneGraph::Node> replace_nodes(const Ref<SceneGraph::Node>& node, const std::map<Ref<SceneGraph::Node>,Ref<SceneGraph::Node>>& mapping, std::set<Ref<SceneGraph::Node>>& visited)
+  {
+    auto m = mapping.find(node);
+    if (m != mapping.end()) return m->second;
+    if (!node || visited.find(node) != visited.end()) return node;
+    visited.insert(node);
+
+    if (Ref<SceneGraph::TransformNode> xfmNode = node.dynamicCast<SceneGraph::TransformNode>()) {
+      xfmNode->child = replace_nodes(xfmNode->child,mapping,visited);
+    }
+    else if (Ref<SceneGraph::GroupNode> groupNode = node.dynamicCast<SceneGraph::GroupNode>()) {
+      for (auto& child : groupNode->children) child = replace_nodes(child,mapping,visited);
+    }
+    return node;
+  }
+
+  /*! converts all meshes of type Mesh reachable from node in parallel,
+   *  meshes referenced multiple times are converted only once and the
+   *  converted mesh is shared by all references, the select function
+   *  is called sequentially and decides which meshes get converted */
+  template<typename Mesh, typename Select, typename Convert>
+  static Ref<SceneGraph::Node> convert_meshes(const Ref<SceneGraph::Node>& node, const Select& select, const Convert& convert)
+  {
+    std::set<Ref<SceneGraph::Node>> visited;
+    std::vector<Ref<Mesh>> meshes;
+    collect_meshes(node,visited,meshes);
+
+    std::vector<Ref<Mesh>> selected;
+    for (const auto& mesh : meshes)
+      if (select(mesh)) selected.push_back(mesh);
+
+    std::vector<Ref<SceneGraph::Node>> converted(selected.size());
+    parallel_for(selected.size(), [&](size_t i) {
+      converted[i] = convert(selected[i]);
+    });
+
+    std::map<Ref<SceneGraph::Node>,Ref<SceneGraph::Node>> mapping;
+    for (size_t i=0; i<selected.size(); i++)
+      mapping[selected[i].template dynamicCast<SceneGraph::Node>()] = converted[i];
+
+    visited.clear();
+    return replace_nodes(node,mapping,visited);
+  }
+
+  template<typename Mesh, typename Convert>
+  static Ref<SceneGraph::Node> convert_meshes(const Ref<SceneGraph::Node>& node, const Convert& convert) {
+    return convert_meshes<Mesh>(node, [] (const Ref<Mesh>&) { return true; }, convert);
+  }
+
   Ref<SceneGraph::Node> SceneGraph::convert_triangles_to_quads ( Ref<SceneGraph::TriangleMeshNode> tmesh )
   {
     Ref<SceneGraph::QuadMeshNode> qmesh = new SceneGraph::QuadMeshNode(tmesh->material,tmesh->time_range,0);
@@ -1198,125 +1279,142 @@ namespace embree
     
     qmesh->normals = tmesh->normals;
     qmesh->texcoords = tmesh->texcoords;
-    
-    for (size_t i=0; i<tmesh->triangles.size(); i++)
-    {
-      const int a0 = tmesh->triangles[i+0].v0;
-      const int a1 = tmesh->triangles[i+0].v1;
-      const int a2 = tmesh->triangles[i+0].v2;
-      if (i+1 == tmesh->triangles.size()) {
-        qmesh->quads.push_back(SceneGraph::QuadMeshNode::Quad(a0,a1,a2,a2));
-        continue;
-      }
-      
-      const int b0 = tmesh->triangles[i+1].v0;
-      const int b1 = tmesh->triangles[i+1].v1;
-      const int b2 = tmesh->triangles[i+1].v2;
-      const std::pair<int,int> q = quad_index3(a0,a1,a2,b0,b1,b2);
-      const int a3 = q.second;
-      if (a3 == -1) {
-        qmesh->quads.push_back(SceneGraph::QuadMeshNode::Quad(a0,a1,a2,a2));
-        continue;
+
+    /* test in parallel which consecutive triangles form a quad */
+    const size_t N = tmesh->triangles.size();
+    std::vector<std::pair<int,int>> pairs(N);
+    parallel_for(size_t(0),N,size_t(4096),[&](const range<size_t>& r) {
+      for (size_t i=r.begin(); i<r.end(); i++)
+      {
+        if (i+1 == N) { pairs[i] = std::make_pair(0,-1); continue; }
+        const SceneGraph::TriangleMeshNode::Triangle& a = tmesh->triangles[i+0];
+        const SceneGraph::TriangleMeshNode::Triangle& b = tmesh->triangles[i+1];
+        pairs[i] = quad_index3(a.v0,a.v1,a.v2,b.v0,b.v1,b.v2);
       }
-      
-      if      (q.first == -1) qmesh->quads.push_back(SceneGraph::QuadMeshNode::Quad(a1,a2,a3,a0));
-      else if (q.first ==  0) qmesh->quads.push_back(SceneGraph::QuadMeshNode::Quad(a3,a1,a2,a0));
-      else if (q.first ==  1) qmesh->quads.push_back(SceneGraph::QuadMeshNode::Quad(a0,a1,a3,a2));
-      else if (q.first ==  2) qmesh->quads.push_back(SceneGraph::QuadMeshNode::Quad(a1,a2,a3,a0)); 
-      i++;
+    });
+
+    /* greedily pair triangles front to back, a triangle merged into the previous quad gets no quad */
+    std::vector<unsigned int> quadID(N);
+    unsigned int numQuads = 0;
+    for (size_t i=0; i<N; i++)
+    {
+      quadID[i] = numQuads++;
+      if (pairs[i].second != -1) quadID[++i] = -1;
     }
+
+    qmesh->quads.resize(numQuads);
+    parallel_for(size_t(0),N,size_t(4096),[&](const range<size_t>& r) {
+      for (size_t i=r.begin(); i<r.end(); i++)
+      {
+        if (quadID[i] == (unsigned int)-1) continue;
+        const int a0 = tmesh->triangles[i].v0;
+        const int a1 = tmesh->triangles[i].v1;
+        const int a2 = tmesh->triangles[i].v2;
+        const std::pair<int,int> q = pairs[i];
+        const int a3 = q.second;
+        SceneGraph::QuadMeshNode::Quad& quad = qmesh->quads[quadID[i]];
+        if      (a3 == -1     ) quad = SceneGraph::QuadMeshNode::Quad(a0,a1,a2,a2);
+        else if (q.first == -1) quad = SceneGraph::QuadMeshNode::Quad(a1,a2,a3,a0);
+        else if (q.first ==  0) quad = SceneGraph::QuadMeshNode::Quad(a3,a1,a2,a0);
+        else if (q.first ==  1) quad = SceneGraph::QuadMeshNode::Quad(a0,a1,a3,a2);
+        else if (q.first ==  2) quad = SceneGraph::QuadMeshNode::Quad(a1,a2,a3,a0);
+      }
+    });
     return qmesh.dynamicCast<SceneGraph::Node>();
   }
 
   Ref<SceneGraph::Node> SceneGraph::convert_triangles_to_quads(Ref<SceneGraph::Node> node, float prop)
   {
-    if (Ref<SceneGraph::TransformNode> xfmNode = node.dynamicCast<SceneGraph::TransformNode>()) {
-      xfmNode->child = convert_triangles_to_quads(xfmNode->child,prop);
-    } 
-    else if (Ref<SceneGraph::GroupNode> groupNode = node.dynamicCast<SceneGraph::GroupNode>()) 
-    {
-      for (size_t i=0; i<groupNode->children.size(); i++) 
-        groupNode->children[i] = convert_triangles_to_quads(groupNode->children[i],prop);
-    }
-    else if (Ref<SceneGraph::TriangleMeshNode> tmesh = node.dynamicCast<SceneGraph::TriangleMeshNode>()) {
-      if (random<float>() <= prop) return convert_triangles_to_quads(tmesh);
-      else                         return node;
-    }
-    return node;
+    return convert_meshes<SceneGraph::TriangleMeshNode>(node,
+      [&] (const Ref<SceneGraph::TriangleMeshNode>&) { return random<float>() <= prop; },
+      [&] (const Ref<SceneGraph::TriangleMeshNode>& tmesh) { return convert_triangles_to_quads(tmesh); });
   }
 
   Ref<SceneGraph::Node> SceneGraph::convert_quads_to_grids ( Ref<SceneGraph::QuadMeshNode> qmesh , const unsigned int resX, const unsigned int resY )
   {
     const size_t timeSteps = qmesh->positions.size();
     Ref<SceneGraph::GridMeshNode> gmesh = new SceneGraph::GridMeshNode(qmesh->material,qmesh->time_range,timeSteps);
-    std::vector<SceneGraph::QuadMeshNode::Quad>& quads = qmesh->quads;
+    const std::vector<SceneGraph::QuadMeshNode::Quad>& quads = qmesh->quads;
 
-    for (size_t i=0;i<quads.size();i++)
-    {
-      const unsigned int startVtx = (unsigned int) gmesh->positions[0].size();
-      const unsigned int lineStride = resX;
-      for (size_t t=0;t<timeSteps;t++)
+    /* every quad produces a grid with resX*resY vertices, thus all output locations are known upfront */
+    const size_t numQuads = quads.size();
+    const unsigned int numGridVertices = resX*resY;
+    for (size_t t=0;t<timeSteps;t++)
+      gmesh->positions[t].resize(numQuads*numGridVertices);
+    gmesh->grids.resize(numQuads);
+
+    parallel_for(size_t(0),numQuads,size_t(1024),[&](const range<size_t>& r) {
+      for (size_t i=r.begin(); i<r.end(); i++)
       {
-        const SceneGraph::GridMeshNode::Vertex v00 = qmesh->positions[t][quads[i].v0];
-        const SceneGraph::GridMeshNode::Vertex v01 = qmesh->positions[t][quads[i].v1];
-        const SceneGraph::GridMeshNode::Vertex v10 = qmesh->positions[t][quads[i].v3];
-        const SceneGraph::GridMeshNode::Vertex v11 = qmesh->positions[t][quads[i].v2];
-        for (unsigned int y=0; y<resY; y++)
+        const unsigned int startVtx = (unsigned int) (i*numGridVertices);
+        const unsigned int lineStride = resX;
+        for (size_t t=0;t<timeSteps;t++)
         {
-          for (unsigned int x=0; x<resX; x++)
+          const SceneGraph::GridMeshNode::Vertex v00 = qmesh->positions[t][quads[i].v0];
+          const SceneGraph::GridMeshNode::Vertex v01 = qmesh->positions[t][quads[i].v1];
+          const SceneGraph::GridMeshNode::Vertex v10 = qmesh->positions[t][quads[i].v3];
+          const SceneGraph::GridMeshNode::Vertex v11 = qmesh->positions[t][quads[i].v2];
+          for (unsigned int y=0; y<resY; y++)
           {
-            const float u = (float)x / (resX-1);
-            const float v = (float)y / (resY-1);
-            const SceneGraph::GridMeshNode::Vertex vtx = v00 * (1.0f-u) * (1.0f-v) + v01 * u * (1.0f-v) + v10 * (1.0f-u) * v + v11 * u * v;
-            gmesh->positions[t].push_back( vtx );
+            for (unsigned int x=0; x<resX; x++)
+            {
+              const float u = (float)x / (resX-1);
+              const float v = (float)y / (resY-1);
+              const SceneGraph::GridMeshNode::Vertex vtx = v00 * (1.0f-u) * (1.0f-v) + v01 * u * (1.0f-v) + v10 * (1.0f-u) * v + v11 * u * v;
+              gmesh->positions[t][startVtx + y*lineStride + x] = vtx;
+            }
           }
         }
+        gmesh->grids[i] = SceneGraph::GridMeshNode::Grid(startVtx,lineStride,resX,resY);
       }
-      assert(startVtx + resX * resY == gmesh->positions[0].size());
-      gmesh->grids.push_back(SceneGraph::GridMeshNode::Grid(startVtx,lineStride,resX,resY));
-    }
+    });
     return gmesh.dynamicCast<SceneGraph::Node>();
   }
 
   Ref<SceneGraph::Node> SceneGraph::convert_quads_to_grids(Ref<SceneGraph::Node> node, const unsigned int resX, const unsigned int resY )
   {
-    if (Ref<SceneGraph::TransformNode> xfmNode = node.dynamicCast<SceneGraph::TransformNode>()) {
-      xfmNode->child = convert_quads_to_grids(xfmNode->child, resX, resY);
-    } 
-    else if (Ref<SceneGraph::GroupNode> groupNode = node.dynamicCast<SceneGraph::GroupNode>()) 
-    {
-      for (size_t i=0; i<groupNode->children.size(); i++) 
-        groupNode->children[i] = convert_quads_to_grids(groupNode->children[i], resX, resY);
-    }
-    else if (Ref<SceneGraph::QuadMeshNode> qmesh = node.dynamicCast<SceneGraph::QuadMeshNode>()) {
+    return convert_meshes<SceneGraph::QuadMeshNode>(node, [&] (const Ref<SceneGraph::QuadMeshNode>& qmesh) {
       return convert_quads_to_grids(qmesh, resX, resY);
-    }
-    return node;
+    });
   }
 
   Ref<SceneGraph::Node> SceneGraph::convert_grids_to_quads ( Ref<SceneGraph::GridMeshNode> gmesh )
   {
     Ref<SceneGraph::QuadMeshNode> qmesh = new SceneGraph::QuadMeshNode(gmesh->material,gmesh->time_range,0);
 
-    for (size_t i=0; i<gmesh->numPrimitives(); i++)
-    {
-      const unsigned int startVtx = gmesh->grids[i].startVtx;
-      const unsigned int lineStride = gmesh->grids[i].lineStride;
-      const unsigned int resX = gmesh->grids[i].resX;
-      const unsigned int resY = gmesh->grids[i].resY;
-
-      for (unsigned int y=0; y<resY-1; y++)
+    /* calculate location of the quads of each grid */
+    const size_t numGrids = gmesh->numPrimitives();
+    std::vector<unsigned int> numGridQuads(numGrids);
+    parallel_for(size_t(0),numGrids,size_t(4096),[&](const range<size_t>& r) {
+      for (size_t i=r.begin(); i<r.end(); i++)
+        numGridQuads[i] = (gmesh->grids[i].resX-1)*(gmesh->grids[i].resY-1);
+    });
+    std::vector<unsigned int> quadOffset(numGrids);
+    const unsigned int numQuads = parallel_prefix_sum(numGridQuads,quadOffset,numGrids,0u,std::plus<unsigned int>());
+    qmesh->quads.resize(numQuads);
+
+    parallel_for(size_t(0),numGrids,size_t(1024),[&](const range<size_t>& r) {
+      for (size_t i=r.begin(); i<r.end(); i++)
       {
-        for (unsigned int x=0; x<resX-1; x++)
+        const unsigned int startVtx = gmesh->grids[i].startVtx;
+        const unsigned int lineStride = gmesh->grids[i].lineStride;
+        const unsigned int resX = gmesh->grids[i].resX;
+        const unsigned int resY = gmesh->grids[i].resY;
+
+        unsigned int quadID = quadOffset[i];
+        for (unsigned int y=0; y<resY-1; y++)
         {
-          const unsigned int a0 = startVtx + y * lineStride + x;
-          const unsigned int a1 = a0 + 1;
-          const unsigned int a3 = a0 + lineStride;
-          const unsigned int a2 = a0 + lineStride + 1;
-          qmesh->quads.push_back(SceneGraph::QuadMeshNode::Quad(a0,a1,a2,a3));
+          for (unsigned int x=0; x<resX-1; x++)
+          {
+            const unsigned int a0 = startVtx + y * lineStride + x;
+            const unsigned int a1 = a0 + 1;
+            const unsigned int a3 = a0 + lineStride;
+            const unsigned int a2 = a0 + lineStride + 1;
+            qmesh->quads[quadID++] = SceneGraph::QuadMeshNode::Quad(a0,a1,a2,a3);
+          }
         }
       }
-    }
+    });
     const size_t timeSteps = gmesh->positions.size();
     for (size_t t=0;t<timeSteps;t++)
       qmesh->positions.push_back(gmesh->positions[t]);
@@ -1325,18 +1423,9 @@ namespace embree
 
   Ref<SceneGraph::Node> SceneGraph::convert_grids_to_quads(Ref<SceneGraph::Node> node)
   {
-    if (Ref<SceneGraph::TransformNode> xfmNode = node.dynamicCast<SceneGraph::TransformNode>()) {
-      xfmNode->child = convert_grids_to_quads(xfmNode->child);
-    } 
-    else if (Ref<SceneGraph::GroupNode> groupNode = node.dynamicCast<SceneGraph::GroupNode>()) 
-    {
-      for (size_t i=0; i<groupNode->children.size(); i++) 
-        groupNode->children[i] = convert_grids_to_quads(groupNode->children[i]);
-    }
-    else if (Ref<SceneGraph::GridMeshNode> gmesh = node.dynamicCast<SceneGraph::GridMeshNode>()) {
+    return convert_meshes<SceneGraph::GridMeshNode>(node, [&] (const Ref<SceneGraph::GridMeshNode>& gmesh) {
       return convert_grids_to_quads(gmesh);
-    }
-    return node;
+    });
   }
   
   bool extend_grid(RTCGeometry geom, std::vector<bool>& visited, std::deque<unsigned int>& left, std::deque<unsigned int>& top, std::deque<unsigned int>& right)
@@ -1447,166 +1536,155 @@ namespace embree
     positions[height*(width+1)+width] = vertices[indices[edgex]];
   }
 
-  Ref<SceneGraph::Node> SceneGraph::my_merge_quads_to_grids(Ref<SceneGraph::Node> node)
+  static Ref<SceneGraph::Node> merge_quads_to_grids(Ref<SceneGraph::QuadMeshNode> qmesh)
   {
-    if (Ref<SceneGraph::TransformNode> xfmNode = node.dynamicCast<SceneGraph::TransformNode>()) {
-      xfmNode->child = my_merge_quads_to_grids(xfmNode->child);
-    }
-    else if (Ref<SceneGraph::GroupNode> groupNode = node.dynamicCast<SceneGraph::GroupNode>()) 
-    {
-      for (size_t i=0; i<groupNode->children.size(); i++) 
-        groupNode->children[i] = my_merge_quads_to_grids(groupNode->children[i]);
-    }
-    else if (Ref<SceneGraph::QuadMeshNode> qmesh = node.dynamicCast<SceneGraph::QuadMeshNode>()) 
-    {
-      Ref<SceneGraph::GridMeshNode> gmesh = new SceneGraph::GridMeshNode(qmesh->material,qmesh->time_range,qmesh->numTimeSteps());
+    Ref<SceneGraph::GridMeshNode> gmesh = new SceneGraph::GridMeshNode(qmesh->material,qmesh->time_range,qmesh->numTimeSteps());
+    
+    std::vector<bool> visited;
+    visited.resize(qmesh->numPrimitives());
+    for (size_t i=0; i<visited.size(); i++) visited[i] = false;
+    std::vector<unsigned int> faces(qmesh->numPrimitives());
+    for (size_t i=0; i<faces.size(); i++) faces[i] = 4;
+
+    /* create temporary subdiv mesh to get access to mesh topology */
+    RTCGeometry geom = rtcNewGeometry(g_device,RTC_GEOMETRY_TYPE_SUBDIVISION);
+    rtcSetSharedGeometryBuffer(geom, RTC_BUFFER_TYPE_FACE,   0, RTC_FORMAT_UINT,   faces.data(), 0, sizeof(unsigned int), qmesh->numPrimitives());
+    rtcSetSharedGeometryBuffer(geom, RTC_BUFFER_TYPE_INDEX,  0, RTC_FORMAT_UINT,   qmesh->quads.data(), 0, sizeof(unsigned int), 4*qmesh->numPrimitives());
+    rtcSetSharedGeometryBuffer(geom, RTC_BUFFER_TYPE_VERTEX, 0, RTC_FORMAT_FLOAT3, qmesh->positions[0].data(), 0, sizeof(Vec3fa), qmesh->numVertices());
+    rtcCommitGeometry(geom);
+
+    /* iterate over mesh and collect all grids */
+    for (unsigned int i=0; i<qmesh->numPrimitives(); i++)
+    {
+      /* skip face if already added to some grid */
+      if (visited[i]) continue;
+      visited[i] = true;
+
+      /* initialize grid with start quad */
+      unsigned int edge = rtcGetGeometryFirstHalfEdge(geom,i);
+      std::deque<unsigned int> left, right, top, bottom;
+      left.push_back(edge);   edge = rtcGetGeometryNextHalfEdge(geom,edge);
+      bottom.push_back(edge); edge = rtcGetGeometryNextHalfEdge(geom,edge);
+      right.push_back(edge);  edge = rtcGetGeometryNextHalfEdge(geom,edge);
+      top.push_back(edge);    edge = rtcGetGeometryNextHalfEdge(geom,edge);
+      assert(edge == rtcGetGeometryFirstHalfEdge(geom,i));
       
-      std::vector<bool> visited;
-      visited.resize(qmesh->numPrimitives());
-      for (size_t i=0; i<visited.size(); i++) visited[i] = false;
-      std::vector<unsigned int> faces(qmesh->numPrimitives());
-      for (size_t i=0; i<faces.size(); i++) faces[i] = 4;
-
-      /* create temporary subdiv mesh to get access to mesh topology */
-      RTCGeometry geom = rtcNewGeometry(g_device,RTC_GEOMETRY_TYPE_SUBDIVISION);
-      rtcSetSharedGeometryBuffer(geom, RTC_BUFFER_TYPE_FACE,   0, RTC_FORMAT_UINT,   faces.data(), 0, sizeof(unsigned int), qmesh->numPrimitives());
-      rtcSetSharedGeometryBuffer(geom, RTC_BUFFER_TYPE_INDEX,  0, RTC_FORMAT_UINT,   qmesh->quads.data(), 0, sizeof(unsigned int), 4*qmesh->numPrimitives());
-      rtcSetSharedGeometryBuffer(geom, RTC_BUFFER_TYPE_VERTEX, 0, RTC_FORMAT_FLOAT3, qmesh->positions[0].data(), 0, sizeof(Vec3fa), qmesh->numVertices());
-      rtcCommitGeometry(geom);
-
-      /* iterate over mesh and collect all grids */
-      for (unsigned int i=0; i<qmesh->numPrimitives(); i++)
+      /* extend grid unless no longer possible */
+      unsigned int width = 1;
+      unsigned int height = 1;
+      while (true)
       {
-        /* skip face if already added to some grid */
-        if (visited[i]) continue;
-        visited[i] = true;
-
-        /* initialize grid with start quad */
-        unsigned int edge = rtcGetGeometryFirstHalfEdge(geom,i);
-        std::deque<unsigned int> left, right, top, bottom;
-        left.push_back(edge);   edge = rtcGetGeometryNextHalfEdge(geom,edge);
-        bottom.push_back(edge); edge = rtcGetGeometryNextHalfEdge(geom,edge);
-        right.push_back(edge);  edge = rtcGetGeometryNextHalfEdge(geom,edge);
-        top.push_back(edge);    edge = rtcGetGeometryNextHalfEdge(geom,edge);
-        assert(edge == rtcGetGeometryFirstHalfEdge(geom,i));
-        
-        /* extend grid unless no longer possible */
-        unsigned int width = 1;
-        unsigned int height = 1;
-        while (true)
-        {
-          const bool extended_top    = extend_grid(geom,visited,left,top,right);
-          const bool extended_right  = extend_grid(geom,visited,top,right,bottom);
-          const bool extended_bottom = extend_grid(geom,visited,right,bottom,left);
-          const bool extended_left   = extend_grid(geom,visited,bottom,left,top);
-          width  += extended_left + extended_right;
-          height += extended_top  + extended_bottom;
-          if (!extended_top && !extended_right && !extended_bottom && !extended_left) break;
-          if (width+2  > SceneGraph::GridMeshNode::GRID_RES_MAX) break;
-          if (height+2 > SceneGraph::GridMeshNode::GRID_RES_MAX) break;
-        }
-        
-        /* add new grid to grid mesh */
-        unsigned int startVertex = (unsigned int) gmesh->positions[0].size();
-        gmesh->grids.push_back(SceneGraph::GridMeshNode::Grid(startVertex,width+1,width+1,height+1));
+        const bool extended_top    = extend_grid(geom,visited,left,top,right);
+        const bool extended_right  = extend_grid(geom,visited,top,right,bottom);
+        const bool extended_bottom = extend_grid(geom,visited,right,bottom,left);
+        const bool extended_left   = extend_grid(geom,visited,bottom,left,top);
+        width  += extended_left + extended_right;
+        height += extended_top  + extended_bottom;
+        if (!extended_top && !extended_right && !extended_bottom && !extended_left) break;
+        if (width+2  > SceneGraph::GridMeshNode::GRID_RES_MAX) break;
+        if (height+2 > SceneGraph::GridMeshNode::GRID_RES_MAX) break;
+      }
+      
+      /* add new grid to grid mesh */
+      unsigned int startVertex = (unsigned int) gmesh->positions[0].size();
+      gmesh->grids.push_back(SceneGraph::GridMeshNode::Grid(startVertex,width+1,width+1,height+1));
 
-        /* gather all vertices of grid */
-        for (size_t t=0; t<qmesh->numTimeSteps(); t++)
-        {
-          avector<Vec3fa> positions;
-          positions.resize((width+1)*(height+1));
-          gather_grid(geom,positions,width,height,(unsigned int*)qmesh->quads.data(), qmesh->positions[t], left.front());
-          for (size_t i=0; i<positions.size(); i++)
-            gmesh->positions[t].push_back(positions[i]);
-        }
+      /* gather all vertices of grid */
+      for (size_t t=0; t<qmesh->numTimeSteps(); t++)
+      {
+        avector<Vec3fa> positions;
+        positions.resize((width+1)*(height+1));
+        gather_grid(geom,positions,width,height,(unsigned int*)qmesh->quads.data(), qmesh->positions[t], left.front());
+        for (size_t i=0; i<positions.size(); i++)
+          gmesh->positions[t].push_back(positions[i]);
       }
+    }
 
-      rtcReleaseGeometry(geom);
+    rtcReleaseGeometry(geom);
 
-      return gmesh.dynamicCast<SceneGraph::Node>();
-    }
-    return node;
+    return gmesh.dynamicCast<SceneGraph::Node>();
+  }
+
+  Ref<SceneGraph::Node> SceneGraph::my_merge_quads_to_grids(Ref<SceneGraph::Node> node)
+  {
+    return convert_meshes<SceneGraph::QuadMeshNode>(node, [&] (const Ref<SceneGraph::QuadMeshNode>& qmesh) {
+      return merge_quads_to_grids(qmesh);
+    });
   }
       
-  Ref<SceneGraph::Node> SceneGraph::convert_quads_to_subdivs(Ref<SceneGraph::Node> node)
+  static Ref<SceneGraph::Node> quad_mesh_to_subdiv_mesh(Ref<SceneGraph::QuadMeshNode> tmesh)
   {
-    if (Ref<SceneGraph::TransformNode> xfmNode = node.dynamicCast<SceneGraph::TransformNode>()) {
-      xfmNode->child = convert_quads_to_subdivs(xfmNode->child);
-    } 
-    else if (Ref<SceneGraph::GroupNode> groupNode = node.dynamicCast<SceneGraph::GroupNode>()) 
-    {
-      for (size_t i=0; i<groupNode->children.size(); i++) 
-        groupNode->children[i] = convert_quads_to_subdivs(groupNode->children[i]);
-    }
-    else if (Ref<SceneGraph::QuadMeshNode> tmesh = node.dynamicCast<SceneGraph::QuadMeshNode>()) 
-    {
-      Ref<SceneGraph::SubdivMeshNode> smesh = new SceneGraph::SubdivMeshNode(tmesh->material,tmesh->time_range,0);
+    Ref<SceneGraph::SubdivMeshNode> smesh = new SceneGraph::SubdivMeshNode(tmesh->material,tmesh->time_range,0);
 
-      for (auto& p : tmesh->positions)
-        smesh->positions.push_back(p);
-
-      for (size_t i=0; i<tmesh->quads.size(); i++) {
-        smesh->position_indices.push_back(tmesh->quads[i].v0);
-        smesh->position_indices.push_back(tmesh->quads[i].v1);
-        smesh->position_indices.push_back(tmesh->quads[i].v2);
+    for (auto& p : tmesh->positions)
+      smesh->positions.push_back(p);
+
+    /* quads with v2 == v3 are triangles, thus faces have 3 or 4 vertices */
+    const size_t numQuads = tmesh->quads.size();
+    smesh->verticesPerFace.resize(numQuads);
+    parallel_for(size_t(0),numQuads,size_t(4096),[&](const range<size_t>& r) {
+      for (size_t i=r.begin(); i<r.end(); i++)
+        smesh->verticesPerFace[i] = 3 + (int)(tmesh->quads[i].v2 != tmesh->quads[i].v3);
+    });
+    std::vector<unsigned int> faceOffset(numQuads);
+    const unsigned int numIndices = parallel_prefix_sum(smesh->verticesPerFace,faceOffset,numQuads,0u,std::plus<unsigned int>());
+
+    smesh->position_indices.resize(numIndices);
+    parallel_for(size_t(0),numQuads,size_t(4096),[&](const range<size_t>& r) {
+      for (size_t i=r.begin(); i<r.end(); i++)
+      {
+        unsigned int* indices = &smesh->position_indices[faceOffset[i]];
+        indices[0] = tmesh->quads[i].v0;
+        indices[1] = tmesh->quads[i].v1;
+        indices[2] = tmesh->quads[i].v2;
         if (tmesh->quads[i].v2 != tmesh->quads[i].v3)
-          smesh->position_indices.push_back(tmesh->quads[i].v3);
+          indices[3] = tmesh->quads[i].v3;
       }
-      
-      smesh->normals = tmesh->normals;
-      if (smesh->normals.size())
-        smesh->normal_indices = smesh->position_indices;
-      
-      smesh->texcoords = tmesh->texcoords;
-      if (smesh->texcoords.size())
-        smesh->texcoord_indices = smesh->position_indices;
-      
-      for (size_t i=0; i<tmesh->quads.size(); i++) 
-        smesh->verticesPerFace.push_back(3 + (int)(tmesh->quads[i].v2 != tmesh->quads[i].v3));
+    });
+    
+    smesh->normals = tmesh->normals;
+    if (smesh->normals.size())
+      smesh->normal_indices = smesh->position_indices;
+    
+    smesh->texcoords = tmesh->texcoords;
+    if (smesh->texcoords.size())
+      smesh->texcoord_indices = smesh->position_indices;
 
-      return smesh.dynamicCast<SceneGraph::Node>();
-    }
-    return node;
+    return smesh.dynamicCast<SceneGraph::Node>();
+  }
+
+  Ref<SceneGraph::Node> SceneGraph::convert_quads_to_subdivs(Ref<SceneGraph::Node> node)
+  {
+    return convert_meshes<SceneGraph::QuadMeshNode>(node, [&] (const Ref<SceneGraph::QuadMeshNode>& tmesh) {
+      return quad_mesh_to_subdiv_mesh(tmesh);
+    });
   }
 
   Ref<SceneGraph::Node> SceneGraph::convert_bezier_to_lines(Ref<SceneGraph::Node> node)
   {
-    if (Ref<SceneGraph::TransformNode> xfmNode = node.dynamicCast<SceneGraph::TransformNode>()) {
-      xfmNode->child = convert_bezier_to_lines(xfmNode->child);
-    }
-    else if (Ref<SceneGraph::GroupNode> groupNode = node.dynamicCast<SceneGraph::GroupNode>()) 
-    {
-      for (size_t i=0; i<groupNode->children.size(); i++) 
-        groupNode->children[i] = convert_bezier_to_lines(groupNode->children[i]);
-    }
-    else if (Ref<SceneGraph::HairSetNode> hmesh = node.dynamicCast<SceneGraph::HairSetNode>()) 
+    return convert_meshes<SceneGraph::HairSetNode>(node, [&] (Ref<SceneGraph::HairSetNode> hmesh)
     {
       Ref<SceneGraph::HairSetNode> lmesh = new SceneGraph::HairSetNode(RTC_GEOMETRY_TYPE_FLAT_LINEAR_CURVE, hmesh->material, hmesh->time_range, 0);
 
       for (auto& p : hmesh->positions)
         lmesh->positions.push_back(p);
 
-      for (auto hair : hmesh->hairs) {
-        lmesh->hairs.push_back(SceneGraph::HairSetNode::Hair(hair.vertex+0,hair.id));
-        lmesh->hairs.push_back(SceneGraph::HairSetNode::Hair(hair.vertex+1,hair.id));
-        lmesh->hairs.push_back(SceneGraph::HairSetNode::Hair(hair.vertex+2,hair.id));
-      }
+      lmesh->hairs.resize(3*hmesh->hairs.size());
+      parallel_for(size_t(0),hmesh->hairs.size(),size_t(4096),[&](const range<size_t>& r) {
+        for (size_t i=r.begin(); i<r.end(); i++) {
+          const SceneGraph::HairSetNode::Hair hair = hmesh->hairs[i];
+          lmesh->hairs[3*i+0] = SceneGraph::HairSetNode::Hair(hair.vertex+0,hair.id);
+          lmesh->hairs[3*i+1] = SceneGraph::HairSetNode::Hair(hair.vertex+1,hair.id);
+          lmesh->hairs[3*i+2] = SceneGraph::HairSetNode::Hair(hair.vertex+2,hair.id);
+        }
+      });
       return lmesh.dynamicCast<SceneGraph::Node>();
-    }
-    return node;
+    });
   }
 
   Ref<SceneGraph::Node> SceneGraph::convert_flat_to_round_curves(Ref<SceneGraph::Node> node)
   {
-    if (Ref<SceneGraph::TransformNode> xfmNode = node.dynamicCast<SceneGraph::TransformNode>()) {
-      xfmNode->child = convert_flat_to_round_curves(xfmNode->child);
-    }
-    else if (Ref<SceneGraph::GroupNode> groupNode = node.dynamicCast<SceneGraph::GroupNode>()) 
-    {
-      for (size_t i=0; i<groupNode->children.size(); i++) 
-        groupNode->children[i] = convert_flat_to_round_curves(groupNode->children[i]);
-    }
-    else if (Ref<SceneGraph::HairSetNode> hmesh = node.dynamicCast<SceneGraph::HairSetNode>()) 
+    return convert_meshes<SceneGraph::HairSetNode>(node, [&] (Ref<SceneGraph::HairSetNode> hmesh)
     {
       if (hmesh->type == RTC_GEOMETRY_TYPE_FLAT_LINEAR_CURVE)
         hmesh->type = RTC_GEOMETRY_TYPE_ROUND_LINEAR_CURVE;
@@ -1616,21 +1694,12 @@ namespace embree
         hmesh->type = RTC_GEOMETRY_TYPE_ROUND_BSPLINE_CURVE;
 
       return hmesh.dynamicCast<SceneGraph::Node>();
-    }
-    return node;
+    });
   }
 
-   Ref<SceneGraph::Node> SceneGraph::convert_round_to_flat_curves(Ref<SceneGraph::Node> node)
+  Ref<SceneGraph::Node> SceneGraph::convert_round_to_flat_curves(Ref<SceneGraph::Node> node)
   {
-    if (Ref<SceneGraph::TransformNode> xfmNode = node.dynamicCast<SceneGraph::TransformNode>()) {
-      xfmNode->child = convert_round_to_flat_curves(xfmNode->child);
-    }
-    else if (Ref<SceneGraph::GroupNode> groupNode = node.dynamicCast<SceneGraph::GroupNode>()) 
-    {
-      for (size_t i=0; i<groupNode->children.size(); i++) 
-        groupNode->children[i] = convert_round_to_flat_curves(groupNode->children[i]);
-    }
-    else if (Ref<SceneGraph::HairSetNode> hmesh = node.dynamicCast<SceneGraph::HairSetNode>()) 
+    return convert_meshes<SceneGraph::HairSetNode>(node, [&] (Ref<SceneGraph::HairSetNode> hmesh)
     {
       if (hmesh->type == RTC_GEOMETRY_TYPE_ROUND_LINEAR_CURVE)
         hmesh->type = RTC_GEOMETRY_TYPE_FLAT_LINEAR_CURVE;
@@ -1640,58 +1709,33 @@ namespace embree
         hmesh->type = RTC_GEOMETRY_TYPE_FLAT_BSPLINE_CURVE;
 
       return hmesh.dynamicCast<SceneGraph::Node>();
-    }
-    return node;
+    });
   }
 
   Ref<SceneGraph::Node> SceneGraph::convert_bezier_to_bspline(Ref<SceneGraph::Node> node)
   {
-    if (Ref<SceneGraph::TransformNode> xfmNode = node.dynamicCast<SceneGraph::TransformNode>()) {
-      convert_bezier_to_bspline(xfmNode->child);
-    }
-    else if (Ref<SceneGraph::GroupNode> groupNode = node.dynamicCast<SceneGraph::GroupNode>()) 
-    {
-      for (size_t i=0; i<groupNode->children.size(); i++) 
-        convert_bezier_to_bspline(groupNode->children[i]);
-    }
-    else if (Ref<SceneGraph::HairSetNode> hmesh = node.dynamicCast<SceneGraph::HairSetNode>()) {
+    return convert_meshes<SceneGraph::HairSetNode>(node, [&] (Ref<SceneGraph::HairSetNode> hmesh) {
       hmesh->convert_bezier_to_bspline();
       //hmesh->compact_vertices();
-    }
-    return node;
+      return hmesh.dynamicCast<SceneGraph::Node>();
+    });
   }
 
   Ref<SceneGraph::Node> SceneGraph::convert_bspline_to_bezier(Ref<SceneGraph::Node> node)
   {
-    if (Ref<SceneGraph::TransformNode> xfmNode = node.dynamicCast<SceneGraph::TransformNode>()) {
-      convert_bspline_to_bezier(xfmNode->child);
-    }
-    else if (Ref<SceneGraph::GroupNode> groupNode = node.dynamicCast<SceneGraph::GroupNode>()) 
-    {
-      for (size_t i=0; i<groupNode->children.size(); i++) 
-        convert_bspline_to_bezier(groupNode->children[i]);
-    }
-    else if (Ref<SceneGraph::HairSetNode> hmesh = node.dynamicCast<SceneGraph::HairSetNode>()) {
+    return convert_meshes<SceneGraph::HairSetNode>(node, [&] (Ref<SceneGraph::HairSetNode> hmesh) {
       hmesh->convert_bspline_to_bezier();
-    }
-    return node;
+      return hmesh.dynamicCast<SceneGraph::Node>();
+    });
   }
 
   Ref<SceneGraph::Node> SceneGraph::convert_bezier_to_hermite(Ref<SceneGraph::Node> node)
   {
-    if (Ref<SceneGraph::TransformNode> xfmNode = node.dynamicCast<SceneGraph::TransformNode>()) {
-      convert_bezier_to_hermite(xfmNode->child);
-    }
-    else if (Ref<SceneGraph::GroupNode> groupNode = node.dynamicCast<SceneGraph::GroupNode>()) 
-    {
-      for (size_t i=0; i<groupNode->children.size(); i++) 
-        convert_bezier_to_hermite(groupNode->children[i]);
-    }
-    else if (Ref<SceneGraph::HairSetNode> hmesh = node.dynamicCast<SceneGraph::HairSetNode>()) {
+    return convert_meshes<SceneGraph::HairSetNode>(node, [&] (Ref<SceneGraph::HairSetNode> hmesh) {
       hmesh->convert_bezier_to_hermite();
       //hmesh->compact_vertices();
-    }
-    return node;
+      return hmesh.dynamicCast<SceneGraph::Node>();
+    });
   }
 
   Ref<SceneGraph::Node> SceneGraph::remove_mblur(Ref<SceneGraph::Node> node, bool mblur)
@@ -1782,6 +1826,7 @@ namespace embree
     Ref<SceneGraph::Node> node;
     std::map<Ref<SceneGraph::Node>,Ref<SceneGraph::Node>> object_mapping;
     std::map<std::string,int> unique_id;
+    std::set<Ref<SceneGraph::Node>> shared_geometries;
     
     SceneGraphFlattener (Ref<SceneGraph::Node> in, SceneGraph::InstancingMode instancing)
     {
@@ -1867,32 +1912,67 @@ namespace embree
       }
     }
 
-    void convertGeometries(std::vector<Ref<SceneGraph::Node>>& group, const Ref<SceneGraph::Node>& node, const SceneGraph::Transformations& spaces)
+    void collectGeometries(std::vector<std::pair<Ref<SceneGraph::Node>,SceneGraph::Transformations>>& geometries, const Ref<SceneGraph::Node>& node, const SceneGraph::Transformations& spaces)
     {
       if (Ref<SceneGraph::TransformNode> xfmNode = node.dynamicCast<SceneGraph::TransformNode>()) {
-        convertGeometries(group,xfmNode->child, spaces*xfmNode->spaces);
+        collectGeometries(geometries,xfmNode->child, spaces*xfmNode->spaces);
       } 
       else if (Ref<SceneGraph::GroupNode> groupNode = node.dynamicCast<SceneGraph::GroupNode>()) {
-        for (const auto& child : groupNode->children) convertGeometries(group,child,spaces);
-      }
-      else if (Ref<SceneGraph::TriangleMeshNode> mesh = node.dynamicCast<SceneGraph::TriangleMeshNode>()) {
-        group.push_back(new SceneGraph::TriangleMeshNode(mesh,spaces));
-      }
-      else if (Ref<SceneGraph::QuadMeshNode> mesh = node.dynamicCast<SceneGraph::QuadMeshNode>()) {
-        group.push_back(new SceneGraph::QuadMeshNode(mesh,spaces));
-      }
-      else if (Ref<SceneGraph::GridMeshNode> mesh = node.dynamicCast<SceneGraph::GridMeshNode>()) {
-        group.push_back(new SceneGraph::GridMeshNode(mesh,spaces));
-      }
-      else if (Ref<SceneGraph::SubdivMeshNode> mesh = node.dynamicCast<SceneGraph::SubdivMeshNode>()) {
-        group.push_back(new SceneGraph::SubdivMeshNode(mesh,spaces));
+        for (const auto& child : groupNode->children) collectGeometries(geometries,child,spaces);
       }
-      else if (Ref<SceneGraph::HairSetNode> mesh = node.dynamicCast<SceneGraph::HairSetNode>()) {
-        group.push_back(new SceneGraph::HairSetNode(mesh,spaces));
+      else if (node.dynamicCast<SceneGraph::TriangleMeshNode>() ||
+               node.dynamicCast<SceneGraph::QuadMeshNode>() ||
+               node.dynamicCast<SceneGraph::GridMeshNode>() ||
+               node.dynamicCast<SceneGraph::SubdivMeshNode>() ||
+               node.dynamicCast<SceneGraph::HairSetNode>() ||
+               node.dynamicCast<SceneGraph::PointSetNode>())
+      {
+        geometries.push_back(std::make_pair(node,spaces));
       }
-      else if (Ref<SceneGraph::PointSetNode> mesh = node.dynamicCast<SceneGraph::PointSetNode>()) {
-        group.push_back(new SceneGraph::PointSetNode(mesh,spaces));
+    }
+
+    static bool isIdentity(const SceneGraph::Transformations& spaces) {
+      return spaces.size() == 1 && !spaces.quaternion && spaces[0] == AffineSpace3ff(one);
+    }
+
+    Ref<SceneGraph::Node> transformGeometry(const Ref<SceneGraph::Node>& node, const SceneGraph::Transformations& spaces)
+    {
+      if (Ref<SceneGraph::TriangleMeshNode> mesh = node.dynamicCast<SceneGraph::TriangleMeshNode>())
+        return new SceneGraph::TriangleMeshNode(mesh,spaces);
+      else if (Ref<SceneGraph::QuadMeshNode> mesh = node.dynamicCast<SceneGraph::QuadMeshNode>())
+        return new SceneGraph::QuadMeshNode(mesh,spaces);
+      else if (Ref<SceneGraph::GridMeshNode> mesh = node.dynamicCast<SceneGraph::GridMeshNode>())
+        return new SceneGraph::GridMeshNode(mesh,spaces);
+      else if (Ref<SceneGraph::SubdivMeshNode> mesh = node.dynamicCast<SceneGraph::SubdivMeshNode>())
+        return new SceneGraph::SubdivMeshNode(mesh,spaces);
+      else if (Ref<SceneGraph::HairSetNode> mesh = node.dynamicCast<SceneGraph::HairSetNode>())
+        return new SceneGraph::HairSetNode(mesh,spaces);
+      else if (Ref<SceneGraph::PointSetNode> mesh = node.dynamicCast<SceneGraph::PointSetNode>())
+        return new SceneGraph::PointSetNode(mesh,spaces);
+      return nullptr;
+    }
+
+    void convertGeometries(std::vector<Ref<SceneGraph::Node>>& group, const Ref<SceneGraph::Node>& node, const SceneGraph::Transformations& spaces)
+    {
+      std::vector<std::pair<Ref<SceneGraph::Node>,SceneGraph::Transformations>> geometries;
+      collectGeometries(geometries,node,spaces);
+
+      /* a geometry with identity transformation is shared with the input
+       * scene instead of copied, but only once as every geometry node
+       * gets converted into a single Embree geometry */
+      std::vector<bool> share(geometries.size());
+      for (size_t i=0; i<geometries.size(); i++) {
+        share[i] = isIdentity(geometries[i].second) && shared_geometries.find(geometries[i].first) == shared_geometries.end();
+        if (share[i]) shared_geometries.insert(geometries[i].first);
       }
+
+      /* transform all other geometries in parallel */
+      const size_t offset = group.size();
+      group.resize(offset+geometries.size());
+      parallel_for(geometries.size(), [&](size_t i) {
+        if (share[i]) group[offset+i] = geometries[i].first;
+        else          group[offset+i] = transformGeometry(geometries[i].first,geometries[i].second);
+      });
     }
 
     Ref<SceneGraph::Node> lookupGeometries(Ref<SceneGraph::Node> node)
@@ -7,6 +7,7 @@
 #include "../../../include/embree3/rtcore.h"
 RTC_NAMESPACE_USE
 #include "../math/random_sampler.h"
+#include "../../../common/algorithms/parallel_for.h"
 
 namespace embree
 {  
@@ -356,10 +357,12 @@ namespace embree
         for (size_t i=0; i<spaces.size(); i++) 
         {
           avector<Vertex> verts(num_vertices);
-          for (size_t j=0; j<num_vertices; j++) {
-            verts[j] = xfmPoint(spaces[i],positions_in[0][j]);
-            verts[j].w = positions_in[0][j].w;
-          }
+          parallel_for(size_t(0),num_vertices,size_t(4096),[&](const range<size_t>& r) {
+            for (size_t j=r.begin(); j<r.end(); j++) {
+              verts[j] = xfmPoint(spaces[i],positions_in[0][j]);
+              verts[j].w = positions_in[0][j].w;
+            }
+          });
           positions_out.push_back(std::move(verts));
         }
       } 
@@ -371,10 +374,12 @@ namespace embree
           float time = num_time_steps > 1 ? float(t)/float(num_time_steps-1) : 0.0f;
           const AffineSpace3ff space = spaces.interpolate(time);
           avector<Vertex> verts(num_vertices);
-          for (size_t i=0; i<num_vertices; i++) {
-            verts[i] = xfmPoint (space,positions_in[t][i]);
-            verts[i].w = positions_in[t][i].w;
-          }
+          parallel_for(size_t(0),num_vertices,size_t(4096),[&](const range<size_t>& r) {
+            for (size_t i=r.begin(); i<r.end(); i++) {
+              verts[i] = xfmPoint (space,positions_in[t][i]);
+              verts[i].w = positions_in[t][i].w;
+            }
+          });
           positions_out.push_back(std::move(verts));
         }
       }
@@ -393,9 +398,11 @@ namespace embree
         for (size_t i=0; i<spaces.size(); i++) 
         {
           avector<Vec3fa> verts(num_vertices);
-          for (size_t j=0; j<num_vertices; j++) {
-            verts[j] = xfmPoint((AffineSpace3fa)spaces[i],positions_in[0][j]);
-          }
+          parallel_for(size_t(0),num_vertices,size_t(4096),[&](const range<size_t>& r) {
+            for (size_t j=r.begin(); j<r.end(); j++) {
+              verts[j] = xfmPoint((AffineSpace3fa)spaces[i],positions_in[0][j]);
+            }
+          });
           positions_out.push_back(std::move(verts));
         }
       } 
@@ -407,9 +414,11 @@ namespace embree
           float time = num_time_steps > 1 ? float(t)/float(num_time_steps-1) : 0.0f;
           const AffineSpace3ff space = spaces.interpolate(time);
           avector<Vec3fa> verts(num_vertices);
-          for (size_t i=0; i<num_vertices; i++) {
-            verts[i] = xfmPoint ((AffineSpace3fa)space,positions_in[t][i]);
-          }
+          parallel_for(size_t(0),num_vertices,size_t(4096),[&](const range<size_t>& r) {
+            for (size_t i=r.begin(); i<r.end(); i++) {
+              verts[i] = xfmPoint ((AffineSpace3fa)space,positions_in[t][i]);
+            }
+          });
           positions_out.push_back(std::move(verts));
         }
       }
@@ -432,10 +441,12 @@ namespace embree
         for (size_t i=0; i<spaces.size(); i++) 
         {
           avector<Vertex> vecs(num_vertices);
-          for (size_t j=0; j<num_vertices; j++) {
-            vecs[j] = xfmVector(spaces[i],vectors_in[0][j]);
-            vecs[j].w = vectors_in[0][j].w;
-          }
+          parallel_for(size_t(0),num_vertices,size_t(4096),[&](const range<size_t>& r) {
+            for (size_t j=r.begin(); j<r.end(); j++) {
+              vecs[j] = xfmVector(spaces[i],vectors_in[0][j]);
+              vecs[j].w = vectors_in[0][j].w;
+            }
+          });
           vectors_out.push_back(std::move(vecs));
         }
       } 
@@ -447,10 +458,12 @@ namespace embree
           float time = num_time_steps > 1 ? float(t)/float(num_time_steps-1) : 0.0f;
           const AffineSpace3ff space = spaces.interpolate(time);
           avector<Vertex> vecs(num_vertices);
-          for (size_t i=0; i<num_vertices; i++) {
-            vecs[i] = xfmVector (space,vectors_in[t][i]);
-            vecs[i].w = vectors_in[t][i].w;
-          }
+          parallel_for(size_t(0),num_vertices,size_t(4096),[&](const range<size_t>& r) {
+            for (size_t i=r.begin(); i<r.end(); i++) {
+              vecs[i] = xfmVector (space,vectors_in[t][i]);
+              vecs[i].w = vectors_in[t][i].w;
+            }
+          });
           vectors_out.push_back(std::move(vecs));
         }
       }
@@ -473,9 +486,11 @@ namespace embree
         for (size_t i=0; i<spaces.size(); i++) 
         {
           avector<Vertex> vecs(num_vertices);
-          for (size_t j=0; j<num_vertices; j++) {
-            vecs[j] = xfmVector((AffineSpace3fa)spaces[i],vectors_in[0][j]);
-          }
+          parallel_for(size_t(0),num_vertices,size_t(4096),[&](const range<size_t>& r) {
+            for (size_t j=r.begin(); j<r.end(); j++) {
+              vecs[j] = xfmVector((AffineSpace3fa)spaces[i],vectors_in[0][j]);
+            }
+          });
           vectors_out.push_back(std::move(vecs));
         }
       } 
@@ -487,9 +502,11 @@ namespace embree
           float time = num_time_steps > 1 ? float(t)/float(num_time_steps-1) : 0.0f;
           const AffineSpace3ff space = spaces.interpolate(time);
           avector<Vertex> vecs(num_vertices);
-          for (size_t i=0; i<num_vertices; i++) {
-            vecs[i] = xfmVector ((AffineSpace3fa)space,vectors_in[t][i]);
-          }
+          parallel_for(size_t(0),num_vertices,size_t(4096),[&](const range<size_t>& r) {
+            for (size_t i=r.begin(); i<r.end(); i++) {
+              vecs[i] = xfmVector ((AffineSpace3fa)space,vectors_in[t][i]);
+            }
+          });
           vectors_out.push_back(std::move(vecs));
         }
       }
@@ -512,9 +529,11 @@ namespace embree
         for (size_t i=0; i<spaces.size(); i++) 
         {
           avector<Vertex> norms(num_vertices);
-          for (size_t j=0; j<num_vertices; j++) {
-            norms[j] = xfmNormal((AffineSpace3fa)spaces[i],normals_in[0][j]);
-          }
+          parallel_for(size_t(0),num_vertices,size_t(4096),[&](const range<size_t>& r) {
+            for (size_t j=r.begin(); j<r.end(); j++) {
+              norms[j] = xfmNormal((AffineSpace3fa)spaces[i],normals_in[0][j]);
+            }
+          });
           normals_out.push_back(std::move(norms));
         }
       } 
@@ -526,9 +545,11 @@ namespace embree
           float time = num_time_steps > 1 ? float(t)/float(num_time_steps-1) : 0.0f;
           const AffineSpace3ff space = spaces.interpolate(time);
           avector<Vertex> norms(num_vertices);
-          for (size_t i=0; i<num_vertices; i++) {
-            norms[i] = xfmNormal ((AffineSpace3fa)space,normals_in[t][i]);
-          }
+          parallel_for(size_t(0),num_vertices,size_t(4096),[&](const range<size_t>& r) {
+            for (size_t i=r.begin(); i<r.end(); i++) {
+              norms[i] = xfmNormal ((AffineSpace3fa)space,normals_in[t][i]);
+            }
+          });
           normals_out.push_back(std::move(norms));
         }
       }
@@ -742,68 +763,57 @@ namespace embree
 
       void triangles_to_quads(float prop = inf)
       {
-        for (size_t i=0; i<children.size(); i++)
-          children[i] = convert_triangles_to_quads(children[i],prop);
+        convert_triangles_to_quads(this,prop);
       }
 
       void quads_to_grids(unsigned int resX, unsigned int resY)
       {
-        for (size_t i=0; i<children.size(); i++)
-          children[i] = convert_quads_to_grids(children[i],resX, resY);
+        convert_quads_to_grids(this,resX, resY);
       }
 
       void grids_to_quads()
       {
-        for (size_t i=0; i<children.size(); i++)
-          children[i] = convert_grids_to_quads(children[i]);
+        convert_grids_to_quads(this);
       }
 
       void quads_to_subdivs()
       {
-        for (size_t i=0; i<children.size(); i++)
-          children[i] = convert_quads_to_subdivs(children[i]);
+        convert_quads_to_subdivs(this);
       }
       
       void bezier_to_lines()
       {
-        for (size_t i=0; i<children.size(); i++)
-          children[i] = convert_bezier_to_lines(children[i]);
+        convert_bezier_to_lines(this);
       }
 
       void flat_to_round_curves()
       {
-        for (size_t i=0; i<children.size(); i++)
-          children[i] = convert_flat_to_round_curves(children[i]);
+        convert_flat_to_round_curves(this);
       }
 
       void round_to_flat_curves()
       {
-        for (size_t i=0; i<children.size(); i++)
-          children[i] = convert_round_to_flat_curves(children[i]);
+        convert_round_to_flat_curves(this);
       }
 
       void bezier_to_bspline()
       {
-        for (size_t i=0; i<children.size(); i++)
-          children[i] = convert_bezier_to_bspline(children[i]);
+        convert_bezier_to_bspline(this);
       }
 
       void bezier_to_hermite()
       {
-        for (size_t i=0; i<children.size(); i++)
-          children[i] = convert_bezier_to_hermite(children[i]);
+        convert_bezier_to_hermite(this);
       }
 
       void bspline_to_bezier()
       {
-        for (size_t i=0; i<children.size(); i++)
-          children[i] = convert_bspline_to_bezier(children[i]);
+        convert_bspline_to_bezier(this);
       }
 
       void merge_quads_to_grids()
       {
-        for (size_t i=0; i<children.size(); i++)
-          children[i] = my_merge_quads_to_grids(children[i]);
+        my_merge_quads_to_grids(this);
       }
 
       void remove_mblur(bool mblur)
@@ -47,8 +47,22 @@ namespace embree
     }   
   }
 
+  Texture::Texture (std::shared_ptr<TiledTexture> tiled, const std::string fileName)
+    : width(tiled->width), height(tiled->height), format(TILED), bytesPerTexel(4), width_mask(0), height_mask(0), data(tiled.get()), fileName(fileName), tiled(tiled)
+  {
+    width_mask  = isPowerOf2(width) ? width-1 : 0;
+    height_mask = isPowerOf2(height) ? height-1 : 0;
+  }
+
+  Texture::Texture (unsigned width, unsigned height, const Format format, const char* in, std::shared_ptr<void> storage)
+    : width(width), height(height), format(format), bytesPerTexel(getFormatBytesPerTexel(format)), width_mask(0), height_mask(0), data((void*)in), storage(storage)
+  {
+    width_mask  = isPowerOf2(width) ? width-1 : 0;
+    height_mask = isPowerOf2(height) ? height-1 : 0;
+  }
+
   Texture::~Texture () {
-    alignedFree(data);
+    if (!tiled && !storage) alignedFree(data);
   }
 
   const char* Texture::format_to_string(const Format format)
@@ -57,6 +71,7 @@ namespace embree
     case RGBA8  : return "RGBA8";
     case RGB8   : return "RGB8";
     case FLOAT32: return "FLOAT32";
+    case TILED  : return "TILED";
     default     : THROW_RUNTIME_ERROR("invalid texture format");
     }
   }
@@ -75,6 +90,7 @@ namespace embree
     case RGBA8  : return 4;
     case RGB8   : return 3;
     case FLOAT32: return 4;
+    case TILED  : return 4;
     default     : THROW_RUNTIME_ERROR("invalid texture format");
     }
   }
@@ -85,7 +101,11 @@ namespace embree
     if (texture_cache.find(fileName.str()) != texture_cache.end())
       return texture_cache[fileName.str()];
     
-    std::shared_ptr<Texture> tex(new Texture(loadImage(fileName),fileName));
+    std::shared_ptr<Texture> tex;
+    if (TextureTileCache::enabled())
+      tex = std::shared_ptr<Texture>(new Texture(TiledTexture::open(fileName),fileName));
+    else
+      tex = std::shared_ptr<Texture>(new Texture(loadImage(fileName),fileName));
     return texture_cache[fileName.str()] = tex;
   }
 }
@@ -9,6 +9,7 @@ enum TEXTURE_FORMAT {
     Texture_RGBA8        = 1,
     Texture_RGB8         = 2,
     Texture_FLOAT32      = 3,
+    Texture_TILED        = 4,
   };
 
 struct Texture {
@@ -25,6 +26,7 @@ struct Texture {
 
 #include "../default.h"
 #include "../image/image.h"
+#include "texture_cache.h"
 
 namespace embree
 {
@@ -35,12 +37,15 @@ namespace embree
       RGBA8   = 1,
       RGB8    = 2,
       FLOAT32 = 3,
+      TILED   = 4,  //!< MIP-mapped texture with lazily loaded tiles, data points to TiledTexture
     };
     
   public:
     Texture (); 
     Texture (Ref<Image> image, const std::string fileName); 
     Texture (unsigned width, unsigned height, const Format format, const char* in = nullptr);
+    Texture (std::shared_ptr<TiledTexture> tiled, const std::string fileName);
+    Texture (unsigned width, unsigned height, const Format format, const char* in, std::shared_ptr<void> storage);
     ~Texture ();
 
   private:
@@ -64,6 +69,8 @@ namespace embree
     unsigned height_mask;
     void* data;
     std::string fileName;
+    std::shared_ptr<TiledTexture> tiled;
+    std::shared_ptr<void> storage;  //!< keeps texels alive that are not owned by the texture
   };
 }
 #endif
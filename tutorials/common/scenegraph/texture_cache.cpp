@@ -0,0 +1,399 @@
+// Copyright 2009-2021 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "texture_cache.h"
+#include "../image/image.h"
+
+#include <atomic>
+#include <cmath>
+#include <sys/stat.h>
+
+namespace embree
+{
+  /*! header of a tile file, the tiles of all MIP levels follow the
+   *  header, ordered by level and in row major order inside a level */
+  struct TileFileHeader
+  {
+    char magic[8];
+    unsigned int width;
+    unsigned int height;
+    unsigned int numLevels;
+    unsigned int tileSize;
+    long long sourceSize;  //!< size of the image the tiles got created from
+    long long sourceTime;  //!< modification time of the image the tiles got created from
+  };
+
+  static const char tileFileMagic[8] = { 'E','M','B','T','I','L','E','2' };
+  static const size_t tileBytes = TiledTexture::TILE_SIZE*TiledTexture::TILE_SIZE*4;
+
+  static std::atomic<size_t> nextTextureID(0);
+
+  /*! queries size and modification time of a file */
+  static bool getFileInfo(const FileName& fileName, long long& size, long long& time)
+  {
+#if defined(__WIN32__)
+    struct _stat64 st;
+    if (_stat64(fileName.c_str(),&st) != 0) return false;
+#else
+    struct stat st;
+    if (stat(fileName.c_str(),&st) != 0) return false;
+#endif
+    size = (long long) st.st_size;
+    time = (long long) st.st_mtime;
+    return true;
+  }
+
+  /*! seeks to some offset, also for tile files larger than 2GB */
+  static int seek64(FILE* file, size_t offset)
+  {
+#if defined(__WIN32__)
+    return _fseeki64(file,(__int64)offset,SEEK_SET);
+#else
+    return fseeko(file,(off_t)offset,SEEK_SET);
+#endif
+  }
+
+  TiledTexture::TiledTexture (const FileName& tileFileName, unsigned width, unsigned height)
+    : width(width), height(height), tileFileName(tileFileName), textureID(nextTextureID++), file(nullptr)
+  {
+    size_t firstTile = 0;
+    unsigned w = width, h = height;
+    while (true)
+    {
+      Level level;
+      level.width  = w;
+      level.height = h;
+      level.tilesX = (w+TILE_SIZE-1)/TILE_SIZE;
+      level.tilesY = (h+TILE_SIZE-1)/TILE_SIZE;
+      level.firstTile = firstTile;
+      levels.push_back(level);
+      firstTile += level.tilesX*level.tilesY;
+      if (w == 1 && h == 1) break;
+      w = max(1u,w/2);
+      h = max(1u,h/2);
+    }
+    file = fopen(tileFileName.c_str(),"rb");
+  }
+
+  TiledTexture::~TiledTexture ()
+  {
+    TextureTileCache::evict(this);
+    if (file) fclose(file);
+  }
+
+  std::shared_ptr<TiledTexture> TiledTexture::open(const FileName& imageFileName)
+  {
+    const FileName tileFileName = imageFileName.addExt(".tiles");
+
+    /* the tile file is stale when the image changed after the tiles got created */
+    long long sourceSize = 0, sourceTime = 0;
+    const bool haveSourceInfo = getFileInfo(imageFileName,sourceSize,sourceTime);
+
+    /* reuse existing tile file */
+    if (FILE* f = fopen(tileFileName.c_str(),"rb"))
+    {
+      TileFileHeader header;
+      const bool valid = fread(&header,sizeof(header),1,f) == 1 && memcmp(header.magic,tileFileMagic,sizeof(tileFileMagic)) == 0 && header.tileSize == TILE_SIZE
+        && haveSourceInfo && header.sourceSize == sourceSize && header.sourceTime == sourceTime;
+      fclose(f);
+      if (valid) {
+        std::shared_ptr<TiledTexture> texture(new TiledTexture(tileFileName,header.width,header.height));
+        if (texture->file && texture->numLevels() == header.numLevels) return texture;
+      }
+    }
+
+    /* otherwise create the tile file from the image */
+    Ref<Image> img = loadImage(imageFileName);
+    std::shared_ptr<TiledTexture> texture(new TiledTexture(tileFileName,unsigned(img->width),unsigned(img->height)));
+    std::vector<std::shared_ptr<Tile>> tiles(texture->numTiles());
+
+    std::vector<unsigned char> src(4*img->width*img->height);
+    img->convertToRGBA8(src.data());
+    img = nullptr;
+
+    for (size_t l=0; l<texture->levels.size(); l++)
+    {
+      const Level& level = texture->levels[l];
+
+      /* box filter the previous level */
+      if (l > 0)
+      {
+        const Level& prev = texture->levels[l-1];
+        std::vector<unsigned char> dst(4*level.width*level.height);
+        for (unsigned y=0; y<level.height; y++)
+        {
+          for (unsigned x=0; x<level.width; x++)
+          {
+            /* averages all texels covered by the destination texel, this handles odd level sizes */
+            const unsigned x0 = x*prev.width/level.width, x1 = max(x0+1,(x+1)*prev.width/level.width);
+            const unsigned y0 = y*prev.height/level.height, y1 = max(y0+1,(y+1)*prev.height/level.height);
+            for (size_t c=0; c<4; c++)
+            {
+              unsigned sum = 0;
+              for (unsigned sy=y0; sy<y1; sy++)
+                for (unsigned sx=x0; sx<x1; sx++)
+                  sum += src[4*(sy*prev.width+sx)+c];
+              const unsigned n = (x1-x0)*(y1-y0);
+              dst[4*(y*level.width+x)+c] = (unsigned char)((sum+n/2)/n);
+            }
+          }
+        }
+        src.swap(dst);
+      }
+
+      /* cut level into tiles, texels outside the level replicate the border */
+      for (unsigned ty=0; ty<level.tilesY; ty++)
+      {
+        for (unsigned tx=0; tx<level.tilesX; tx++)
+        {
+          std::shared_ptr<Tile> tile(new Tile(tileBytes));
+          for (unsigned y=0; y<TILE_SIZE; y++)
+          {
+            for (unsigned x=0; x<TILE_SIZE; x++)
+            {
+              const unsigned sx = min(tx*TILE_SIZE+x,level.width-1);
+              const unsigned sy = min(ty*TILE_SIZE+y,level.height-1);
+              memcpy(&(*tile)[4*(y*TILE_SIZE+x)],&src[4*(sy*level.width+sx)],4);
+            }
+          }
+          tiles[level.firstTile+ty*level.tilesX+tx] = tile;
+        }
+      }
+    }
+
+    /* write tile file */
+    bool written = false;
+    if (FILE* f = fopen(tileFileName.c_str(),"wb"))
+    {
+      TileFileHeader header;
+      memcpy(header.magic,tileFileMagic,sizeof(tileFileMagic));
+      header.width = texture->width;
+      header.height = texture->height;
+      header.numLevels = (unsigned int) texture->numLevels();
+      header.tileSize = TILE_SIZE;
+      header.sourceSize = sourceSize;
+      header.sourceTime = sourceTime;
+      written = fwrite(&header,sizeof(header),1,f) == 1;
+      for (size_t i=0; i<tiles.size() && written; i++)
+        written = fwrite(tiles[i]->data(),tileBytes,1,f) == 1;
+      written &= fclose(f) == 0;
+      if (!written) remove(tileFileName.c_str());
+    }
+
+    if (written) {
+      if (texture->file) fclose(texture->file);
+      texture->file = fopen(tileFileName.c_str(),"rb");
+    }
+
+    /* keep all tiles in memory if the tile file is not usable */
+    if (!texture->file)
+      texture->resident.swap(tiles);
+
+    return texture;
+  }
+
+  std::shared_ptr<TiledTexture::Tile> TiledTexture::loadTile(size_t tile) const
+  {
+    std::shared_ptr<Tile> data(new Tile(tileBytes));
+    Lock<MutexSys> lock(fileMutex);
+    if (seek64(file,sizeof(TileFileHeader)+tile*tileBytes) != 0 || fread(data->data(),tileBytes,1,file) != 1)
+      THROW_RUNTIME_ERROR("error reading tile from " + tileFileName.str());
+    return data;
+  }
+
+  const unsigned char* TiledTexture::texel(size_t level, int x, int y, std::shared_ptr<Tile>& tile, size_t& tileID) const
+  {
+    const Level& L = levels[level];
+    const size_t id = L.firstTile + size_t(y/TILE_SIZE)*L.tilesX + size_t(x/TILE_SIZE);
+    if (id != tileID) {
+      tile = resident.size() ? resident[id] : TextureTileCache::get(this,id);
+      tileID = id;
+    }
+    return &(*tile)[4*((y%TILE_SIZE)*TILE_SIZE + (x%TILE_SIZE))];
+  }
+
+  Vec4f TiledTexture::lookupLevel(size_t level, float s, float t) const
+  {
+    const Level& L = levels[level];
+    const float x = s*float(L.width)-0.5f;
+    const float y = t*float(L.height)-0.5f;
+    const float fx = floor(x), fy = floor(y);
+    const float dx = x-fx, dy = y-fy;
+
+    int x0 = int(fx) % int(L.width);  if (x0 < 0) x0 += L.width;
+    int y0 = int(fy) % int(L.height); if (y0 < 0) y0 += L.height;
+    const int x1 = (x0+1) % int(L.width);
+    const int y1 = (y0+1) % int(L.height);
+
+    std::shared_ptr<Tile> tile; size_t tileID = size_t(-1);
+    const unsigned char* c00 = texel(level,x0,y0,tile,tileID);
+    const Vec4f t00(c00[0],c00[1],c00[2],c00[3]);
+    const unsigned char* c10 = texel(level,x1,y0,tile,tileID);
+    const Vec4f t10(c10[0],c10[1],c10[2],c10[3]);
+    const unsigned char* c01 = texel(level,x0,y1,tile,tileID);
+    const Vec4f t01(c01[0],c01[1],c01[2],c01[3]);
+    const unsigned char* c11 = texel(level,x1,y1,tile,tileID);
+    const Vec4f t11(c11[0],c11[1],c11[2],c11[3]);
+
+    const Vec4f c0 = (1.0f-dx)*t00 + dx*t10;
+    const Vec4f c1 = (1.0f-dx)*t01 + dx*t11;
+    return ((1.0f-dy)*c0 + dy*c1) * (1.0f/255.0f);
+  }
+
+  Vec4f TiledTexture::lookup(float s, float t, float footprint) const
+  {
+    /* select MIP level such that the footprint covers about one texel */
+    const float texels = footprint*float(max(width,height));
+    if (!(texels > 1.0f)) return lookupLevel(0,s,t);
+
+    const float lod = min(std::log2(texels),float(levels.size()-1));
+    const size_t l0 = size_t(floor(lod));
+    const float f = lod-float(l0);
+    if (l0+1 >= levels.size() || f == 0.0f) return lookupLevel(l0,s,t);
+
+    /* trilinear interpolation between neighboring levels */
+    return (1.0f-f)*lookupLevel(l0,s,t) + f*lookupLevel(l0+1,s,t);
+  }
+
+  ////////////////////////////////////////////////////////////////////////////////
+  /// Texture Tile Cache
+  ////////////////////////////////////////////////////////////////////////////////
+
+  /*! The cache is split into shards that each have their own lock, LRU
+   *  list and share of the memory budget, thus lookups of different
+   *  tiles from many render threads rarely contend for the same lock. */
+  struct TextureTileCacheState
+  {
+    enum { NUM_SHARDS = 64 };
+
+    typedef unsigned long long Key;
+    typedef std::list<Key> LRUList;
+
+    struct Entry
+    {
+      std::shared_ptr<TiledTexture::Tile> tile;
+      LRUList::iterator lru;
+    };
+
+    struct __aligned(64) Shard
+    {
+      Shard () : bytesUsed(0) {}
+
+      MutexSys mutex;
+      size_t bytesUsed;
+      LRUList lru;                         //!< most recently used tile first
+      std::unordered_map<Key,Entry> tiles;
+    };
+
+    TextureTileCacheState ()
+      : budget(0), hits(0), misses(0) {}
+
+    static Key key(const TiledTexture* texture, size_t tile) {
+      return (Key(texture->textureID) << 32) | Key(tile);
+    }
+
+    Shard& shard(Key key) {
+      return shards[(key ^ (key >> 32)) % NUM_SHARDS];
+    }
+
+    std::atomic<size_t> budget;
+    std::atomic<size_t> hits;
+    std::atomic<size_t> misses;
+    Shard shards[NUM_SHARDS];
+  };
+
+  static TextureTileCacheState& cacheState()
+  {
+    static TextureTileCacheState state;
+    return state;
+  }
+
+  void TextureTileCache::setMemoryBudget(size_t bytes) {
+    cacheState().budget = bytes;
+  }
+
+  size_t TextureTileCache::getMemoryBudget() {
+    return cacheState().budget;
+  }
+
+  std::shared_ptr<TiledTexture::Tile> TextureTileCache::get(const TiledTexture* texture, size_t tile)
+  {
+    TextureTileCacheState& state = cacheState();
+    const TextureTileCacheState::Key key = TextureTileCacheState::key(texture,tile);
+    TextureTileCacheState::Shard& shard = state.shard(key);
+    {
+      Lock<MutexSys> lock(shard.mutex);
+      auto i = shard.tiles.find(key);
+      if (i != shard.tiles.end()) {
+        state.hits++;
+        shard.lru.splice(shard.lru.begin(),shard.lru,i->second.lru);
+        return i->second.tile;
+      }
+    }
+    state.misses++;
+
+    /* load tile without holding the shard lock */
+    std::shared_ptr<TiledTexture::Tile> data = texture->loadTile(tile);
+
+    Lock<MutexSys> lock(shard.mutex);
+    auto i = shard.tiles.find(key);
+    if (i != shard.tiles.end()) // other thread was faster
+      return i->second.tile;
+
+    shard.lru.push_front(key);
+    TextureTileCacheState::Entry& entry = shard.tiles[key];
+    entry.tile = data;
+    entry.lru = shard.lru.begin();
+    shard.bytesUsed += data->size();
+
+    /* evict least recently used tiles of the shard, tiles still referenced by lookups stay alive through their shared pointer */
+    const size_t budget = state.budget/TextureTileCacheState::NUM_SHARDS;
+    while (shard.bytesUsed > budget && shard.lru.size() > 1)
+    {
+      auto e = shard.tiles.find(shard.lru.back());
+      shard.bytesUsed -= e->second.tile->size();
+      shard.tiles.erase(e);
+      shard.lru.pop_back();
+    }
+    return data;
+  }
+
+  void TextureTileCache::evict(const TiledTexture* texture)
+  {
+    TextureTileCacheState& state = cacheState();
+    for (size_t s=0; s<TextureTileCacheState::NUM_SHARDS; s++)
+    {
+      TextureTileCacheState::Shard& shard = state.shards[s];
+      Lock<MutexSys> lock(shard.mutex);
+      for (auto i = shard.lru.begin(); i != shard.lru.end(); )
+      {
+        if ((*i >> 32) != texture->textureID) { i++; continue; }
+        auto e = shard.tiles.find(*i);
+        shard.bytesUsed -= e->second.tile->size();
+        shard.tiles.erase(e);
+        i = shard.lru.erase(i);
+      }
+    }
+  }
+
+  size_t TextureTileCache::getHits() {
+    return cacheState().hits;
+  }
+
+  size_t TextureTileCache::getMisses() {
+    return cacheState().misses;
+  }
+
+  size_t TextureTileCache::getBytesUsed()
+  {
+    TextureTileCacheState& state = cacheState();
+    size_t bytes = 0;
+    for (size_t s=0; s<TextureTileCacheState::NUM_SHARDS; s++)
+    {
+      TextureTileCacheState::Shard& shard = state.shards[s];
+      Lock<MutexSys> lock(shard.mutex);
+      bytes += shard.bytesUsed;
+    }
+    return bytes;
+  }
+}
@@ -0,0 +1,98 @@
+// Copyright 2009-2021 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include "../default.h"
+#include "../../../common/sys/mutex.h"
+
+#include <list>
+#include <unordered_map>
+
+namespace embree
+{
+  /*! MIP-mapped RGBA8 texture that is stored on disk as a pyramid of
+   *  square tiles. Tiles are loaded on first access through the
+   *  global TextureTileCache, thus only the tiles touched by texture
+   *  lookups occupy memory. */
+  struct TiledTexture
+  {
+    enum { TILE_SIZE = 64 };
+
+    /*! a single TILE_SIZE x TILE_SIZE tile of RGBA8 texels */
+    typedef std::vector<unsigned char> Tile;
+
+    struct Level
+    {
+      unsigned width, height;   //!< size of this MIP level in texels
+      unsigned tilesX, tilesY;  //!< number of tiles of this MIP level
+      size_t firstTile;         //!< index of first tile of this level
+    };
+
+  public:
+
+    /*! opens the tile file of some image, the tile file is created
+     *  from the image when it does not exist yet */
+    static std::shared_ptr<TiledTexture> open(const FileName& imageFileName);
+
+    TiledTexture (const FileName& tileFileName, unsigned width, unsigned height);
+    ~TiledTexture ();
+
+  private:
+    TiledTexture (const TiledTexture& other) DELETED; // do not implement
+    TiledTexture& operator= (const TiledTexture& other) DELETED; // do not implement
+
+  public:
+
+    /*! filtered lookup, the MIP level is selected from the width of
+     *  the lookup footprint in texture coordinates */
+    Vec4f lookup(float s, float t, float footprint) const;
+
+    /*! bilinear lookup in some MIP level */
+    Vec4f lookupLevel(size_t level, float s, float t) const;
+
+    /*! loads some tile from the tile file */
+    std::shared_ptr<Tile> loadTile(size_t tile) const;
+
+    size_t numLevels() const { return levels.size(); }
+    size_t numTiles() const { return levels.back().firstTile + levels.back().tilesX*levels.back().tilesY; }
+
+  private:
+    const unsigned char* texel(size_t level, int x, int y, std::shared_ptr<Tile>& tile, size_t& tileID) const;
+
+  public:
+    unsigned width;
+    unsigned height;
+    std::vector<Level> levels;
+    FileName tileFileName;
+    size_t textureID;                          //!< identifies the texture in the tile cache
+    std::vector<std::shared_ptr<Tile>> resident; //!< all tiles when the tile file could not get written
+
+  private:
+    FILE* file;
+    mutable MutexSys fileMutex;
+  };
+
+  /*! LRU cache of texture tiles with bounded memory consumption */
+  class TextureTileCache
+  {
+  public:
+
+    /*! sets the memory budget of the cache in bytes, a budget of 0
+     *  disables tiled textures */
+    static void setMemoryBudget(size_t bytes);
+    static size_t getMemoryBudget();
+    static bool enabled() { return getMemoryBudget() != 0; }
+
+    /*! returns some tile of a texture, loads the tile on a miss */
+    static std::shared_ptr<TiledTexture::Tile> get(const TiledTexture* texture, size_t tile);
+
+    /*! removes all tiles of a texture from the cache */
+    static void evict(const TiledTexture* texture);
+
+    /*! statistics */
+    static size_t getHits();
+    static size_t getMisses();
+    static size_t getBytesUsed();
+  };
+}
@@ -26,6 +26,7 @@ namespace embree
     void store_array_elt(const Vec3f& v);
     void store_array_elt(const Vec3fa& v);
     void store_array_elt(const Vec3ff& v);
+    void store_array_elt(const Vec4i& v);
     void store_array_elt(const SceneGraph::TriangleMeshNode::Triangle& v);
     void store_array_elt(const SceneGraph::QuadMeshNode::Quad& v);
     
@@ -70,6 +71,8 @@ namespace embree
     void store(Ref<SceneGraph::TriangleMeshNode> mesh, ssize_t id);
     void store(Ref<SceneGraph::QuadMeshNode> mesh, ssize_t id);
     void store(Ref<SceneGraph::SubdivMeshNode> mesh, ssize_t id);
+    void store(Ref<SceneGraph::GridMeshNode> mesh, ssize_t id);
+    void store(Ref<SceneGraph::PointSetNode> mesh, ssize_t id);
     void store(Ref<SceneGraph::HairSetNode> hair, ssize_t id);
 
     void store(Ref<SceneGraph::PerspectiveCameraNode> camera, ssize_t id);
@@ -154,6 +157,10 @@ namespace embree
     xml << v.x << " " << v.y << " " << v.z << " " << v.w << std::endl;
   }
 
+  void XMLWriter::store_array_elt(const Vec4i& v) {
+    xml << v.x << " " << v.y << " " << v.z << " " << v.w << std::endl;
+  }
+
   void XMLWriter::store_array_elt(const SceneGraph::TriangleMeshNode::Triangle& v) {
     xml << v.v0 << " " << v.v1 << " " << v.v2 << std::endl;
   }
@@ -245,7 +252,7 @@ namespace embree
 
     if (textureMap.find(tex) != textureMap.end()) {
       tab(); xml << "<texture3d name=\"" << name << "\" id=\"" << textureMap[tex] << "\"/>" << std::endl;
-    } else if (embedTextures) {
+    } else if (embedTextures && tex->format != Texture::TILED) {
       std::streampos offset = bin.tellg();
       bin.write((char*)tex->data,tex->width*tex->height*tex->bytesPerTexel);
       const size_t id = textureMap[tex] = currentNodeID++;
@@ -567,6 +574,46 @@ namespace embree
     close("SubdivisionMesh");
   }
 
+  void XMLWriter::store(Ref<SceneGraph::GridMeshNode> mesh, ssize_t id)
+  {
+    std::vector<Vec4i> grids(mesh->grids.size());
+    for (size_t i=0; i<mesh->grids.size(); i++) {
+      const SceneGraph::GridMeshNode::Grid& g = mesh->grids[i];
+      grids[i] = Vec4i(g.startVtx,g.lineStride,g.resX,g.resY);
+    }
+
+    open("GridMesh",id);
+    store(mesh->material);
+    if (mesh->numTimeSteps() != 1) open("animated_positions");
+    for (const auto& p : mesh->positions) store("positions",p);
+    if (mesh->numTimeSteps() != 1) close("animated_positions");
+    store("grids",grids);
+    close("GridMesh");
+  }
+
+  void XMLWriter::store(Ref<SceneGraph::PointSetNode> mesh, ssize_t id)
+  {
+    std::string str_type = "";
+    switch (mesh->type) {
+    case RTC_GEOMETRY_TYPE_SPHERE_POINT         : str_type = "sphere"; break;
+    case RTC_GEOMETRY_TYPE_DISC_POINT           : str_type = "disc"; break;
+    case RTC_GEOMETRY_TYPE_ORIENTED_DISC_POINT  : str_type = "oriented"; break;
+    default: throw std::runtime_error("invalid point type");
+    }
+
+    open("Points type=\""+str_type+"\"",id);
+    store(mesh->material);
+    if (mesh->numTimeSteps() != 1) open("animated_positions");
+    for (const auto& p : mesh->positions) store("positions",p);
+    if (mesh->numTimeSteps() != 1) close("animated_positions");
+    if (mesh->normals.size()) {
+      if (mesh->numTimeSteps() != 1) open("animated_normals");
+      for (const auto& p : mesh->normals) store("normals",p);
+      if (mesh->numTimeSteps() != 1) close("animated_normals");
+    }
+    close("Points");
+  }
+
   void XMLWriter::store(Ref<SceneGraph::HairSetNode> mesh, ssize_t id)
   {
     std::string str_type = "";
@@ -750,6 +797,8 @@ namespace embree
     else if (Ref<SceneGraph::TriangleMeshNode> cnode = node.dynamicCast<SceneGraph::TriangleMeshNode>()) store(cnode,id);
     else if (Ref<SceneGraph::QuadMeshNode> cnode = node.dynamicCast<SceneGraph::QuadMeshNode>()) store(cnode,id);
     else if (Ref<SceneGraph::SubdivMeshNode> cnode = node.dynamicCast<SceneGraph::SubdivMeshNode>()) store(cnode,id);
+    else if (Ref<SceneGraph::GridMeshNode> cnode = node.dynamicCast<SceneGraph::GridMeshNode>()) store(cnode,id);
+    else if (Ref<SceneGraph::PointSetNode> cnode = node.dynamicCast<SceneGraph::PointSetNode>()) store(cnode,id);
     else if (Ref<SceneGraph::HairSetNode> cnode = node.dynamicCast<SceneGraph::HairSetNode>()) store(cnode,id);
     else if (Ref<SceneGraph::AnimatedPerspectiveCameraNode> cnode = node.dynamicCast<SceneGraph::AnimatedPerspectiveCameraNode>()) store(cnode,id);
     else if (Ref<SceneGraph::PerspectiveCameraNode> cnode = node.dynamicCast<SceneGraph::PerspectiveCameraNode>()) store(cnode,id);
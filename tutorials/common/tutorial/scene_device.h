@@ -80,6 +80,7 @@ namespace embree
     Texture_RGBA8        = 1,
     Texture_RGB8         = 2,
     Texture_FLOAT32      = 3,
+    Texture_TILED        = 4,
   };
 #endif
 
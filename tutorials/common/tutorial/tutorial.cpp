@@ -24,6 +24,8 @@
 #include "../scenegraph/geometry_creation.h"
 #include "../scenegraph/obj_loader.h"
 #include "../scenegraph/xml_loader.h"
+#include "../scenegraph/binary_loader.h"
+#include "../scenegraph/binary_writer.h"
 #include "../image/image.h"
 
 namespace embree
@@ -329,6 +331,10 @@ namespace embree
         sceneFilename.push_back(path + cin->getFileName());
       }, "-i <filename>: parses scene from <filename>");
 
+    registerOption("scene-cache", [this] (Ref<ParseStream> cin, const FileName& path) {
+        sceneCacheFilename = path + cin->getFileName();
+      }, "--scene-cache <filename>: loads the scene from the binary scene cache <filename> if it exists and is up to date, otherwise loads the scenes specified with -i and writes them to <filename>");
+
     registerOption("animlist", [this] (Ref<ParseStream> cin, const FileName& path) {
         FileName listFilename = path + cin->getFileName();
 
@@ -349,6 +355,10 @@ namespace embree
         }
       }, "-animlist <filename>: parses a sequence of .obj/.xml files listed in <filename> and adds them to the scene");
 
+    registerOption("texture-cache", [] (Ref<ParseStream> cin, const FileName& path) {
+        TextureTileCache::setMemoryBudget(size_t(cin->getFloat()*1024.0f*1024.0f));
+      }, "--texture-cache <float>: loads image textures as MIP-mapped tiled textures whose tiles are paged through a cache of the specified size in MB");
+
     registerOption("convert-triangles-to-quads", [this] (Ref<ParseStream> cin, const FileName& path) {
         sgop.push_back(CONVERT_TRIANGLES_TO_QUADS);
         convert_tris_to_quads_prop = inf;
@@ -1215,15 +1225,30 @@ namespace embree
     /* execute postponed scene graph operations */
     for (auto& f : futures) f();
     
+    /* load scene from scene cache, a cache created from other or modified scene files gets written again */
+    if (sceneCacheFilename.str() != "" && std::ifstream(sceneCacheFilename.c_str()).good() &&
+        (sceneFilename.empty() || SceneGraph::isBinaryUpToDate(sceneCacheFilename,sceneFilename)))
+    {
+      scene->add(SceneGraph::loadBinary(sceneCacheFilename));
+    }
+
     /* load scene */
-    if (sceneFilename.size())
+    else if (sceneFilename.size())
     {
+      /* the scene cache only contains the scenes loaded from file */
+      Ref<SceneGraph::GroupNode> loaded = sceneCacheFilename.str() != "" ? new SceneGraph::GroupNode : scene;
       for (auto& file : sceneFilename)
       {
         if (toLowerCase(file.ext()) == std::string("obj"))
-          scene->add(loadOBJ(file,subdiv_mode != ""));
+          loaded->add(loadOBJ(file,subdiv_mode != ""));
         else if (file.ext() != "")
-          scene->add(SceneGraph::load(file));
+          loaded->add(SceneGraph::load(file));
+      }
+
+      /* write scene cache, later runs skip parsing of the scene files */
+      if (loaded != scene) {
+        SceneGraph::storeBinary(loaded.dynamicCast<SceneGraph::Node>(),sceneCacheFilename,true,sceneFilename);
+        scene->add(loaded.dynamicCast<SceneGraph::Node>());
       }
     }
 
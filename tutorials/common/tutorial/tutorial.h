@@ -198,7 +198,7 @@ namespace embree
     virtual int main(int argc, char** argv);
 
     bool scene_empty_post_parse() const {
-      return scene->size() == 0 && sceneFilename.size() == 0 && futures.size() == 0;
+      return scene->size() == 0 && sceneFilename.size() == 0 && sceneCacheFilename.str() == "" && futures.size() == 0;
     }
 
   public:
@@ -227,6 +227,7 @@ namespace embree
     bool remove_mblur;
     bool remove_non_mblur;
     std::vector<FileName> sceneFilename;
+    FileName sceneCacheFilename;
     std::vector<FileName> keyFramesFilenames;
     SceneGraph::InstancingMode instancing_mode;
     std::string subdiv_mode;
@@ -641,10 +641,19 @@ Vec2f getTextureCoordinatesSubdivMesh(void* _mesh, const unsigned int primID, co
   return st;
 }
 
-float getTextureTexel1f(const Texture* texture, float s, float t)
+extern "C" void lookupTiledTexture(const Texture* texture, float s, float t, float footprint, float* rgba)
+{
+  const Vec4f c = ((const TiledTexture*)texture->data)->lookup(s,t,footprint);
+  rgba[0] = c.x; rgba[1] = c.y; rgba[2] = c.z; rgba[3] = c.w;
+}
+
+float getTextureTexel1f(const Texture* texture, float s, float t, float footprint)
 {
   if (!texture) return 0.0f;
 
+  if (texture->format == Texture::TILED)
+    return ((const TiledTexture*)texture->data)->lookup(s,t,footprint).x;
+
   int iu = (int)floor(s * (float)(texture->width));
   iu = iu % texture->width; if (iu < 0) iu += texture->width;
   int iv = (int)floor(t * (float)(texture->height));
@@ -664,10 +673,15 @@ float getTextureTexel1f(const Texture* texture, float s, float t)
   return 0.0f;
 }
 
-Vec3fa getTextureTexel3f(const Texture* texture, float s, float t)
+Vec3fa getTextureTexel3f(const Texture* texture, float s, float t, float footprint)
 {
   if (!texture) return Vec3fa(0.0f,0.0f,0.0f);
 
+  if (texture->format == Texture::TILED) {
+    const Vec4f c = ((const TiledTexture*)texture->data)->lookup(s,t,footprint);
+    return Vec3fa(c.x,c.y,c.z);
+  }
+
   int iu = (int)floor(s * (float)(texture->width));
   iu = iu % texture->width; if (iu < 0) iu += texture->width;
   int iv = (int)floor(t * (float)(texture->height));
@@ -33,7 +33,8 @@ namespace embree {
 
 enum Mode {
   MODE_NORMAL = 0,
-  MODE_STREAM = 1
+  MODE_STREAM = 1,
+  MODE_WAVEFRONT = 2
 };
 
 extern "C" RTCDevice g_device;
@@ -98,8 +99,12 @@ extern "C" void progressEnd();
 
 Vec2f  getTextureCoordinatesSubdivMesh(void* mesh, const unsigned int primID, const float u, const float v);
 
-float  getTextureTexel1f(const Texture* texture, float u, float v);
-Vec3fa  getTextureTexel3f(const Texture* texture, float u, float v);
+/* footprint is the width of the lookup region in texture coordinates and selects the MIP level of tiled textures */
+float  getTextureTexel1f(const Texture* texture, float u, float v, float footprint = 0.0f);
+Vec3fa  getTextureTexel3f(const Texture* texture, float u, float v, float footprint = 0.0f);
+
+/* filtered lookup into tiled texture, returns RGBA in rgba */
+extern "C" void lookupTiledTexture(const Texture* texture, float u, float v, float footprint, float* rgba);
 
 enum ISPCInstancingMode { ISPC_INSTANCING_NONE, ISPC_INSTANCING_GEOMETRY, ISPC_INSTANCING_GROUP };
 
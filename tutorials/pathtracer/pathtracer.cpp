@@ -3,6 +3,7 @@
 
 #include "../common/tutorial/tutorial.h"
 #include "../common/tutorial/benchmark_render.h"
+#include "../common/tutorial/tutorial_device.h"
 
 namespace embree
 {
@@ -28,6 +29,16 @@ namespace embree
       registerOption("accumulate", [] (Ref<ParseStream> cin, const FileName& path) {
           g_accumulate = cin->getInt();
         }, "--accumulate <bool>: accumulate samples (on by default)");
+
+      registerOption("mode", [] (Ref<ParseStream> cin, const FileName& path) {
+          std::string mode = cin->getString();
+          if      (mode == "normal"   ) g_mode = MODE_NORMAL;
+          else if (mode == "wavefront") g_mode = MODE_WAVEFRONT;
+          else throw std::runtime_error("invalid mode:" +mode);
+        },
+        "--mode: sets rendering mode\n"
+        "  normal    : traces each path separately\n"
+        "  wavefront : traces all paths of a tile bounce by bounce as ray streams (C++ version only)\n");
     }
     
     void postParseCommandLine() override
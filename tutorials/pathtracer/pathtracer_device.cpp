@@ -477,11 +477,11 @@ Vec3fa MirrorMaterial__sample(ISPCMirrorMaterial* This, const BRDF& brdf, const
 void OBJMaterial__preprocess(ISPCOBJMaterial* material, BRDF& brdf, const Vec3fa& wo, const DifferentialGeometry& dg, const Medium& medium)
 {
     float d = material->d;
-    if (material->map_d) d *= getTextureTexel1f(material->map_d,dg.u,dg.v);
+    if (material->map_d) d *= getTextureTexel1f(material->map_d,dg.u,dg.v,dg.footprint);
     brdf.Ka = Vec3fa(material->Ka);
     //if (material->map_Ka) { brdf.Ka *= material->map_Ka->get(dg.st); }
     brdf.Kd = d * Vec3fa(material->Kd);
-    if (material->map_Kd) brdf.Kd = brdf.Kd * getTextureTexel3f(material->map_Kd,dg.u,dg.v);
+    if (material->map_Kd) brdf.Kd = brdf.Kd * getTextureTexel3f(material->map_Kd,dg.u,dg.v,dg.footprint);
     brdf.Ks = d * Vec3fa(material->Ks);
     //if (material->map_Ks) brdf.Ks *= material->map_Ks->get(dg.st);
     brdf.Ns = material->Ns;
@@ -870,6 +870,9 @@ extern "C" int g_instancing_mode;
 
 bool g_animation = true;
 bool g_use_smooth_normals = false;
+
+/* angle covered by a pixel, used to estimate texture footprints */
+float g_pixel_spread = 0.0f;
 #if 0
 void device_key_pressed_handler(int key)
 {
@@ -1129,6 +1132,14 @@ void postIntersectGeometry(const Ray& ray, DifferentialGeometry& dg, ISPCGeometr
       const Vec2f st = w*st0 + u*st1 + v*st2;
       dg.u = st.x;
       dg.v = st.y;
+
+      /* change of texture coordinates per unit length on the triangle */
+      const Vec3fa p0 = Vec3fa(mesh->positions[0][tri->v0]);
+      const Vec3fa p1 = Vec3fa(mesh->positions[0][tri->v1]);
+      const Vec3fa p2 = Vec3fa(mesh->positions[0][tri->v2]);
+      const float area = length(cross(p1-p0,p2-p0));
+      const float st_area = abs((st1.x-st0.x)*(st2.y-st0.y)-(st2.x-st0.x)*(st1.y-st0.y));
+      dg.footprint = area > 0.0f ? sqrt(st_area/area) : 0.0f;
     }
     if (mesh->normals)
     {
@@ -1345,6 +1356,7 @@ typedef ISPCInstance* ISPCInstancePtr;
 inline int postIntersect(const Ray& ray, DifferentialGeometry& dg)
 {
   dg.eps = 32.0f*1.19209e-07f*max(max(abs(dg.P.x),abs(dg.P.y)),max(abs(dg.P.z),ray.tfar));
+  dg.footprint = 0.0f;
    
   AffineSpace3fa local2world = AffineSpace3fa::scale(Vec3fa(1));
   ISPCGeometry** geometries = g_ispc_scene->geometries;
@@ -1368,6 +1380,11 @@ inline int postIntersect(const Ray& ray, DifferentialGeometry& dg)
   }
   dg.Ng = xfmVector(local2world,dg.Ng);
   dg.Ns = xfmVector(local2world,dg.Ns);
+
+  /* width of the pixel footprint in texture coordinates, only the
+   * last path segment is considered as there are no ray differentials */
+  const float scale = pow(abs(local2world.l.det()),1.0f/3.0f);
+  if (scale > 0.0f) dg.footprint *= g_pixel_spread*ray.tfar/scale;
   
   return materialID;
 }
@@ -1379,23 +1396,23 @@ void intersectionFilterReject(const RTCFilterFunctionNArguments* args)
   if (!valid) return;
 }
 
-void intersectionFilterOBJ(const RTCFilterFunctionNArguments* args)
+/* gathers a ray passed to a filter function, ray streams invoke filter functions with ray packets */
+inline Ray getFilterRay(RTCRayN* ray, const unsigned int N, const unsigned int rayID)
 {
-  int* valid_i = args->valid;
-  struct RTCRayHitN* _ray = (struct RTCRayHitN*)args->ray;
-  struct RTCHitN* hit = args->hit;
-  const unsigned int N = args->N;
-  
-  assert(N == 1);
-  bool valid = *((int*) valid_i);
-  if (!valid) return;
-  
-  const unsigned int rayID = 0;
-  Ray *ray = (Ray*)_ray;
+  Ray r(Vec3fa(RTCRayN_org_x(ray,N,rayID),RTCRayN_org_y(ray,N,rayID),RTCRayN_org_z(ray,N,rayID)),
+        Vec3fa(RTCRayN_dir_x(ray,N,rayID),RTCRayN_dir_y(ray,N,rayID),RTCRayN_dir_z(ray,N,rayID)),
+        RTCRayN_tnear(ray,N,rayID),RTCRayN_tfar(ray,N,rayID),RTCRayN_time(ray,N,rayID));
+  r.id = RTCRayN_id(ray,N,rayID);
+  return r;
+}
 
+/* returns the BRDF transmission at a hit passed to a filter function */
+inline Vec3fa getFilterTransmission(const Ray& ray, RTCHitN* hit, const unsigned int N, const unsigned int rayID)
+{
   /* compute differential geometry */
   //const float tfar          = RTCHitN_t(hit,N,rayID);
-  const float tfar          = ray->tfar;
+  const float tfar          = ray.tfar;
+
   DifferentialGeometry dg;
   for (int i=0; i<RTC_MAX_INSTANCE_LEVEL_COUNT; i++)
     dg.instIDs[i] = RTCHitN_instID(hit,N,rayID, i);
@@ -1407,14 +1424,14 @@ void intersectionFilterOBJ(const RTCFilterFunctionNArguments* args)
   Vec3fa Ng = Vec3fa(RTCHitN_Ng_x(hit,N,rayID),
                         RTCHitN_Ng_y(hit,N,rayID),
                         RTCHitN_Ng_z(hit,N,rayID));
-  dg.P  = ray->org+tfar*ray->dir;
+  dg.P  = ray.org+tfar*ray.dir;
   dg.Ng = Ng;
   dg.Ns = Ng;
-  int materialID = postIntersect(*ray,dg);
-  dg.Ng = face_forward(ray->dir,normalize(dg.Ng));
+  int materialID = postIntersect(ray,dg);
+  dg.Ng = face_forward(ray.dir,normalize(dg.Ng));
   if (length(dg.Ns) < 1E-6f) dg.Ns = dg.Ng;
-  else dg.Ns = face_forward(ray->dir,normalize(dg.Ns));
-  const Vec3fa wo = neg(ray->dir);
+  else dg.Ns = face_forward(ray.dir,normalize(dg.Ns));
+  const Vec3fa wo = neg(ray.dir);
 
   /* calculate BRDF */
   BRDF brdf; brdf.Kt = Vec3fa(0,0,0);
@@ -1422,12 +1439,27 @@ void intersectionFilterOBJ(const RTCFilterFunctionNArguments* args)
   ISPCMaterial** material_array = &g_ispc_scene->materials[0];
   Medium medium = make_Medium_Vacuum();
   Material__preprocess(material_array,materialID,numMaterials,brdf,wo,dg,medium);
-  if (min(min(brdf.Kt.x,brdf.Kt.y),brdf.Kt.z) < 1.0f)
-    ray->tfar   = tfar;
-  else
-    valid_i[0] = 0;
+  return brdf.Kt;
+}
+
+void intersectionFilterOBJ(const RTCFilterFunctionNArguments* args)
+{
+  int* valid_i = args->valid;
+  struct RTCHitN* hit = args->hit;
+  const unsigned int N = args->N;
+  
+  for (unsigned int rayID=0; rayID<N; rayID++)
+  {
+    if (!valid_i[rayID]) continue;
+    
+    const Ray ray = getFilterRay(args->ray,N,rayID);
+    const Vec3fa Kt = getFilterTransmission(ray,hit,N,rayID);
+    if (min(min(Kt.x,Kt.y),Kt.z) >= 1.0f)
+      valid_i[rayID] = 0;
+  }
 }
 
+/* the transparency of a shadow ray is looked up through its ray ID */
 void occlusionFilterOpaque(const RTCFilterFunctionNArguments* args)
 {
   IntersectContext* context = (IntersectContext*) args->context;
@@ -1435,12 +1467,13 @@ void occlusionFilterOpaque(const RTCFilterFunctionNArguments* args)
   if (!transparency) return;
   
   int* valid_i = args->valid;
+  const unsigned int N = args->N;
   
-  assert(args->N == 1);
-  bool valid = *((int*) valid_i);
-  if (!valid) return;
-   
-  *transparency = Vec3fa(0.0f);
+  for (unsigned int rayID=0; rayID<N; rayID++)
+  {
+    if (!valid_i[rayID]) continue;
+    transparency[RTCRayN_id(args->ray,N,rayID)] = Vec3fa(0.0f);
+  }
 }
 
 void occlusionFilterOBJ(const RTCFilterFunctionNArguments* args)
@@ -1450,51 +1483,19 @@ void occlusionFilterOBJ(const RTCFilterFunctionNArguments* args)
   if (!transparency) return;
   
   int* valid_i = args->valid;
-  struct RTCRayHitN* _ray = (struct RTCRayHitN*)args->ray;
   struct RTCHitN* hit = args->hit;
   const unsigned int N = args->N;
   
-  assert(N == 1);
-  bool valid = *((int*) valid_i);
-  if (!valid) return;
-  
-  const unsigned int rayID = 0;
-  Ray *ray = (Ray*)_ray;
-
-  /* compute differential geometry */
-  //const float tfar          = RTCHitN_t(hit,N,rayID);
-  const float tfar          = ray->tfar;
-
-  DifferentialGeometry dg;
-  for (int i=0; i<RTC_MAX_INSTANCE_LEVEL_COUNT; i++)
-    dg.instIDs[i] = RTCHitN_instID(hit,N,rayID, i);
-  
-  dg.geomID = RTCHitN_geomID(hit,N,rayID);
-  dg.primID = RTCHitN_primID(hit,N,rayID);
-  dg.u = RTCHitN_u(hit,N,rayID);
-  dg.v = RTCHitN_v(hit,N,rayID);
-  Vec3fa Ng = Vec3fa(RTCHitN_Ng_x(hit,N,rayID),
-                        RTCHitN_Ng_y(hit,N,rayID),
-                        RTCHitN_Ng_z(hit,N,rayID));
-  dg.P  = ray->org+tfar*ray->dir;
-  dg.Ng = Ng;
-  dg.Ns = Ng;
-
-  int materialID = postIntersect(*ray,dg);
-  dg.Ng = face_forward(ray->dir,normalize(dg.Ng));
-  dg.Ns = face_forward(ray->dir,normalize(dg.Ns));
-  const Vec3fa wo = neg(ray->dir);
-
-  /* calculate BRDF */
-  BRDF brdf; brdf.Kt = Vec3fa(0,0,0);
-  int numMaterials = g_ispc_scene->numMaterials;
-  ISPCMaterial** material_array = &g_ispc_scene->materials[0];
-  Medium medium = make_Medium_Vacuum();
-  Material__preprocess(material_array,materialID,numMaterials,brdf,wo,dg,medium);
-
-  *transparency = *transparency * brdf.Kt;
-  if (max(max(transparency->x,transparency->y),transparency->z) > 0.0f)
-    valid_i[0] = 0;
+  for (unsigned int rayID=0; rayID<N; rayID++)
+  {
+    if (!valid_i[rayID]) continue;
+    
+    const Ray ray = getFilterRay(args->ray,N,rayID);
+    Vec3fa& T = transparency[ray.id];
+    T = T * getFilterTransmission(ray,hit,N,rayID);
+    if (max(max(T.x,T.y),T.z) > 0.0f)
+      valid_i[rayID] = 0;
+  }
 }
 
 /* occlusion filter function */
@@ -1508,32 +1509,31 @@ void occlusionFilterHair(const RTCFilterFunctionNArguments* args)
   struct RTCHitN* hit = args->hit;
   const unsigned int N = args->N;
   
-  assert(N == 1);
-  bool valid = *((int*) valid_i);
-  if (!valid) return;
-  
-  const unsigned int rayID = 0;
-  
-  unsigned int hit_geomID = RTCHitN_geomID(hit,N,rayID);
-  Vec3fa Kt = Vec3fa(0.0f);
-  auto geomID = hit_geomID;
+  for (unsigned int rayID=0; rayID<N; rayID++)
   {
-    ISPCGeometry* geometry = g_ispc_scene->geometries[geomID];
-    if (geometry->type == CURVES)
+    if (!valid_i[rayID]) continue;
+    
+    unsigned int hit_geomID = RTCHitN_geomID(hit,N,rayID);
+    Vec3fa Kt = Vec3fa(0.0f);
+    auto geomID = hit_geomID;
     {
-      int materialID = ((ISPCHairSet*)geometry)->geom.materialID;
-      ISPCMaterial* material = g_ispc_scene->materials[materialID];
-      switch (material->type) {
-      case MATERIAL_HAIR: Kt = Vec3fa(((ISPCHairMaterial*)material)->Kt); break;
-      default: break;
+      ISPCGeometry* geometry = g_ispc_scene->geometries[geomID];
+      if (geometry->type == CURVES)
+      {
+        int materialID = ((ISPCHairSet*)geometry)->geom.materialID;
+        ISPCMaterial* material = g_ispc_scene->materials[materialID];
+        switch (material->type) {
+        case MATERIAL_HAIR: Kt = Vec3fa(((ISPCHairMaterial*)material)->Kt); break;
+        default: break;
+        }
       }
     }
-  }
 
-  Kt = Kt * *transparency;
-  *transparency = Kt;
-  if (max(max(transparency->x,transparency->y),transparency->z) > 0.0f)
-    valid_i[0] = 0;
+    Vec3fa& T = transparency[RTCRayN_id(args->ray,N,rayID)];
+    T = Kt * T;
+    if (max(max(T.x,T.y),T.z) > 0.0f)
+      valid_i[rayID] = 0;
+  }
 }
 
 Vec3fa renderPixelFunction(float x, float y, RandomSampler& sampler, const ISPCCamera& camera, RayStats& stats)
@@ -1623,6 +1623,7 @@ Vec3fa renderPixelFunction(float x, float y, RandomSampler& sampler, const ISPCC
       if (ls.pdf <= 0.0f) continue;
       Vec3fa transparency = Vec3fa(1.0f);
       Ray shadow(dg.P,ls.dir,dg.eps,ls.dist,time);
+      shadow.id = 0;
       context.userRayExt = &transparency;
       rtcOccluded1(g_scene,&context.context,RTCRay_(shadow));
       RayStats_addShadowRay(stats);
@@ -1708,6 +1709,313 @@ void renderTileTask (int taskIndex, int threadIndex, int* pixels,
 }
 
 
+/***************************************************************************************/
+/*                              Wavefront Renderer                                     */
+/***************************************************************************************/
+
+#define WAVEFRONT_TILE_SIZE_X 64
+#define WAVEFRONT_TILE_SIZE_Y 64
+
+/* ray stream in SOA layout */
+struct RayStreamSOA
+{
+  enum { NUM_COMPONENTS = 19+RTC_MAX_INSTANCE_LEVEL_COUNT };
+  
+  RayStreamSOA (size_t N_in)
+    : N((N_in+3) & ~size_t(3)), data((float*) alignedMalloc(NUM_COMPONENTS*N*sizeof(float),16))
+  {
+    float* ptr = data;
+    auto next = [&] () { float* p = ptr; ptr += N; return p; };
+    rayhit.ray.org_x = next(); rayhit.ray.org_y = next(); rayhit.ray.org_z = next(); rayhit.ray.tnear = next();
+    rayhit.ray.dir_x = next(); rayhit.ray.dir_y = next(); rayhit.ray.dir_z = next(); rayhit.ray.time = next();
+    rayhit.ray.tfar = next();
+    rayhit.ray.mask  = (unsigned int*) next();
+    rayhit.ray.id    = (unsigned int*) next();
+    rayhit.ray.flags = (unsigned int*) next();
+    rayhit.hit.Ng_x = next(); rayhit.hit.Ng_y = next(); rayhit.hit.Ng_z = next();
+    rayhit.hit.u = next(); rayhit.hit.v = next();
+    rayhit.hit.primID = (unsigned int*) next();
+    rayhit.hit.geomID = (unsigned int*) next();
+    for (int l=0; l<RTC_MAX_INSTANCE_LEVEL_COUNT; l++)
+      rayhit.hit.instID[l] = (unsigned int*) next();
+  }
+
+  ~RayStreamSOA () {
+    alignedFree(data);
+  }
+
+  void set(size_t i, const Ray& ray)
+  {
+    rayhit.ray.org_x[i] = ray.org.x; rayhit.ray.org_y[i] = ray.org.y; rayhit.ray.org_z[i] = ray.org.z; rayhit.ray.tnear[i] = ray.tnear();
+    rayhit.ray.dir_x[i] = ray.dir.x; rayhit.ray.dir_y[i] = ray.dir.y; rayhit.ray.dir_z[i] = ray.dir.z; rayhit.ray.time[i] = ray.time();
+    rayhit.ray.tfar[i] = ray.tfar;
+    rayhit.ray.mask[i] = ray.mask;
+    rayhit.ray.id[i] = ray.id;
+    rayhit.ray.flags[i] = 0;
+    rayhit.hit.geomID[i] = RTC_INVALID_GEOMETRY_ID;
+    rayhit.hit.instID[0][i] = RTC_INVALID_GEOMETRY_ID;
+  }
+
+  Ray get(size_t i) const
+  {
+    Ray ray(Vec3fa(rayhit.ray.org_x[i],rayhit.ray.org_y[i],rayhit.ray.org_z[i]),
+            Vec3fa(rayhit.ray.dir_x[i],rayhit.ray.dir_y[i],rayhit.ray.dir_z[i]),
+            rayhit.ray.tnear[i],rayhit.ray.tfar[i],rayhit.ray.time[i],rayhit.ray.mask[i]);
+    ray.id = rayhit.ray.id[i];
+    ray.Ng = Vec3f(rayhit.hit.Ng_x[i],rayhit.hit.Ng_y[i],rayhit.hit.Ng_z[i]);
+    ray.u = rayhit.hit.u[i];
+    ray.v = rayhit.hit.v[i];
+    ray.primID = rayhit.hit.primID[i];
+    ray.geomID = rayhit.hit.geomID[i];
+    for (int l=0; l<RTC_MAX_INSTANCE_LEVEL_COUNT; l++)
+      ray.instID[l] = rayhit.hit.instID[l][i];
+    return ray;
+  }
+  
+private:
+  RayStreamSOA (const RayStreamSOA& other) DELETED; // do not implement
+  RayStreamSOA& operator= (const RayStreamSOA& other) DELETED; // do not implement
+  
+public:
+  size_t N;
+  float* data;
+  RTCRayHitNp rayhit;
+};
+
+/* state of a path that advances bounce by bounce */
+struct WavefrontPath
+{
+  RandomSampler sampler;
+  DifferentialGeometry dg;
+  Medium medium;
+  Vec3fa L;
+  Vec3fa Lw;
+  float time;
+};
+
+/* renders a tile by advancing the paths of all its pixels together, each
+ * bounce traces all continuing paths and all shadow rays as one ray stream */
+void renderTileWavefront(int taskIndex,
+                         int threadIndex,
+                         int* pixels,
+                         const unsigned int width,
+                         const unsigned int height,
+                         const float time,
+                         const ISPCCamera& camera,
+                         const int numTilesX,
+                         const int numTilesY)
+{
+  const unsigned int tileY = taskIndex / numTilesX;
+  const unsigned int tileX = taskIndex - tileY * numTilesX;
+  const unsigned int x0 = tileX * WAVEFRONT_TILE_SIZE_X;
+  const unsigned int x1 = min(x0+WAVEFRONT_TILE_SIZE_X,width);
+  const unsigned int y0 = tileY * WAVEFRONT_TILE_SIZE_Y;
+  const unsigned int y1 = min(y0+WAVEFRONT_TILE_SIZE_Y,height);
+  const unsigned int tileWidth = x1-x0;
+  const unsigned int numPixels = tileWidth*(y1-y0);
+  const unsigned int numLights = g_ispc_scene->numLights;
+  RayStats& stats = g_stats[threadIndex];
+
+  int numMaterials = g_ispc_scene->numMaterials;
+  ISPCMaterial** material_array = &g_ispc_scene->materials[0];
+  
+  std::vector<WavefrontPath> paths(numPixels);
+  std::vector<Vec3fa> colors(numPixels,Vec3fa(0.0f));
+  RayStreamSOA rays0(numPixels), rays1(numPixels);
+  RayStreamSOA shadows(numPixels*max(numLights,1u));
+  std::vector<Vec3fa> transparency(shadows.N);
+  std::vector<Vec3fa> shadowWeight(shadows.N);
+  std::vector<unsigned int> shadowPath(shadows.N);
+  std::vector<std::pair<int,unsigned int>> hits(numPixels); //!< material ID and ray index of all hits
+  
+  for (int s=0; s<g_spp; s++)
+  {
+    /* generate primary rays */
+    RayStreamSOA* rays = &rays0;
+    RayStreamSOA* nextRays = &rays1;
+    for (unsigned int i=0; i<numPixels; i++)
+    {
+      const unsigned int x = x0 + i%tileWidth;
+      const unsigned int y = y0 + i/tileWidth;
+      WavefrontPath& path = paths[i];
+      RandomSampler_init(path.sampler, (int)x, (int)y, g_accu_count*g_spp+s);
+      const float fx = (float)x + RandomSampler_get1D(path.sampler);
+      const float fy = (float)y + RandomSampler_get1D(path.sampler);
+      path.time = RandomSampler_get1D(path.sampler);
+      path.medium = make_Medium_Vacuum();
+      path.L = Vec3fa(0.0f);
+      path.Lw = Vec3fa(1.0f);
+      
+      Ray ray(Vec3fa(camera.xfm.p),
+              Vec3fa(normalize(fx*camera.xfm.l.vx + fy*camera.xfm.l.vy + camera.xfm.l.vz)),0.0f,inf,path.time);
+      ray.id = i;
+      rays->set(i,ray);
+    }
+    unsigned int numRays = numPixels;
+    
+    for (int depth=0; depth<g_max_path_length && numRays; depth++)
+    {
+      /* intersect ray stream with scene */
+      IntersectContext context;
+      InitIntersectionContext(&context);
+      context.context.flags = (depth == 0) ? g_iflags_coherent : g_iflags_incoherent;
+      rtcIntersectNp(g_scene,&context.context,&rays->rayhit,numRays);
+#if defined(RAY_STATS)
+      stats.numRays += numRays;
+#endif
+
+      /* invoke environment lights for all rays that hit nothing */
+      unsigned int numHits = 0;
+      for (unsigned int k=0; k<numRays; k++)
+      {
+        const Ray ray = rays->get(k);
+        WavefrontPath& path = paths[ray.id];
+        if (ray.geomID != RTC_INVALID_GEOMETRY_ID) {
+          hits[numHits++] = std::make_pair(0,k);
+          continue;
+        }
+
+        for (unsigned int i=0; i<numLights; i++)
+        {
+          const Light* l = g_ispc_scene->lights[i];
+          Light_EvalRes le = l->eval(l,path.dg,ray.dir);
+          path.L = path.L + path.Lw*le.value;
+        }
+      }
+
+      /* compute differential geometry of all hits */
+      for (unsigned int h=0; h<numHits; h++)
+      {
+        const Ray ray = rays->get(hits[h].second);
+        DifferentialGeometry& dg = paths[ray.id].dg;
+        for (int i=0; i<RTC_MAX_INSTANCE_LEVEL_COUNT; i++)
+          dg.instIDs[i] = ray.instID[i];
+    
+        dg.geomID = ray.geomID;
+        dg.primID = ray.primID;
+        dg.u = ray.u;
+        dg.v = ray.v;
+        dg.P  = ray.org+ray.tfar*ray.dir;
+        dg.Ng = ray.Ng;
+        dg.Ns = normalize(ray.Ng);
+        hits[h].first = postIntersect(ray,dg);
+        dg.Ng = face_forward(ray.dir,normalize(dg.Ng));
+        dg.Ns = face_forward(ray.dir,normalize(dg.Ns));
+      }
+
+      /* sort hits by material to evaluate the same material for consecutive hits */
+      std::sort(hits.begin(),hits.begin()+numHits);
+      
+      /* shade hits, this generates the shadow ray stream and the next bounce */
+      unsigned int numShadows = 0;
+      unsigned int numNextRays = 0;
+      for (unsigned int h=0; h<numHits; h++)
+      {
+        const int materialID = hits[h].first;
+        const Ray ray = rays->get(hits[h].second);
+        WavefrontPath& path = paths[ray.id];
+        DifferentialGeometry& dg = path.dg;
+        const Vec3fa wo = neg(ray.dir);
+        
+        /*! Compute  simple volumetric effect. */
+        Vec3fa c = Vec3fa(1.0f);
+        const Vec3fa transmission = path.medium.transmission;
+        if (ne(transmission,Vec3fa(1.0f)))
+          c = c * pow(transmission,ray.tfar);
+
+        /* calculate BRDF */
+        BRDF brdf;
+        Material__preprocess(material_array,materialID,numMaterials,brdf,wo,dg,path.medium);
+        
+        /* sample BRDF at hit point */
+        Sample3f wi1;
+        c = c * Material__sample(material_array,materialID,numMaterials,brdf,path.Lw, wo, dg, wi1, path.medium, RandomSampler_get2D(path.sampler));
+
+        /* generate shadow rays */
+        for (unsigned int i=0; i<numLights; i++)
+        {
+          const Light* l = g_ispc_scene->lights[i];
+          Light_SampleRes ls = l->sample(l,dg,RandomSampler_get2D(path.sampler));
+          if (ls.pdf <= 0.0f) continue;
+          Ray shadow(dg.P,ls.dir,dg.eps,ls.dist,path.time);
+          shadow.id = numShadows;
+          shadows.set(numShadows,shadow);
+          transparency[numShadows] = Vec3fa(1.0f);
+          shadowWeight[numShadows] = path.Lw*ls.weight*Material__eval(material_array,materialID,numMaterials,brdf,wo,dg,ls.dir);
+          shadowPath[numShadows] = ray.id;
+          numShadows++;
+        }
+
+        if (wi1.pdf <= 1E-4f /* 0.0f */) continue;
+        path.Lw = path.Lw*c/wi1.pdf;
+
+        /* terminate if contribution too low */
+        if (max(path.Lw.x,max(path.Lw.y,path.Lw.z)) < 0.01f)
+          continue;
+        
+        /* setup secondary ray */
+        float sign = dot(wi1.v,dg.Ng) < 0.0f ? -1.0f : 1.0f;
+        dg.P = dg.P + sign*dg.eps*dg.Ng;
+        Ray next(dg.P,normalize(wi1.v),dg.eps,inf,path.time);
+        next.id = ray.id;
+        nextRays->set(numNextRays++,next);
+      }
+
+      /* trace shadow ray stream */
+      context.context.flags = g_iflags_incoherent;
+      context.userRayExt = transparency.data();
+      rtcOccludedNp(g_scene,&context.context,&shadows.rayhit.ray,numShadows);
+#if defined(RAY_STATS)
+      stats.numRays += numShadows;
+#endif
+      
+      for (unsigned int i=0; i<numShadows; i++)
+      {
+        if (max(max(transparency[i].x,transparency[i].y),transparency[i].z) > 0.0f) {
+          WavefrontPath& path = paths[shadowPath[i]];
+          path.L = path.L + shadowWeight[i]*transparency[i];
+        }
+      }
+
+      std::swap(rays,nextRays);
+      numRays = numNextRays;
+    }
+
+    for (unsigned int i=0; i<numPixels; i++)
+      colors[i] = colors[i] + paths[i].L;
+  }
+
+  for (unsigned int i=0; i<numPixels; i++)
+  {
+    const unsigned int x = x0 + i%tileWidth;
+    const unsigned int y = y0 + i/tileWidth;
+    Vec3fa color = colors[i]/(float)g_spp;
+    
+    /* write color to framebuffer */
+    Vec3ff accu_color = g_accu[y*width+x] + Vec3ff(color.x,color.y,color.z,1.0f); g_accu[y*width+x] = accu_color;
+    float f = rcp(max(0.001f,accu_color.w));
+    unsigned int r = (unsigned int) (255.01f * clamp(accu_color.x*f,0.0f,1.0f));
+    unsigned int g = (unsigned int) (255.01f * clamp(accu_color.y*f,0.0f,1.0f));
+    unsigned int b = (unsigned int) (255.01f * clamp(accu_color.z*f,0.0f,1.0f));
+    pixels[y*width+x] = (b << 16) + (g << 8) + r;
+  }
+}
+
+void renderFrameWavefront (int* pixels,
+                           const unsigned int width,
+                           const unsigned int height,
+                           const float time,
+                           const ISPCCamera& camera)
+{
+  const int numTilesX = (width +WAVEFRONT_TILE_SIZE_X-1)/WAVEFRONT_TILE_SIZE_X;
+  const int numTilesY = (height+WAVEFRONT_TILE_SIZE_Y-1)/WAVEFRONT_TILE_SIZE_Y;
+  parallel_for(size_t(0),size_t(numTilesX*numTilesY),[&](const range<size_t>& range) {
+    const int threadIndex = (int)TaskScheduler::threadIndex();
+    for (size_t i=range.begin(); i<range.end(); i++)
+      renderTileWavefront((int)i,threadIndex,pixels,width,height,time,camera,numTilesX,numTilesY);
+  }); 
+}
+
 /***************************************************************************************/
 
 inline float updateEdgeLevel( ISPCSubdivMesh* mesh, const Vec3fa& cam_pos, const unsigned int e0, const unsigned int e1)
@@ -1786,6 +2094,14 @@ extern "C" void renderFrameStandard (int* pixels,
                           const float time,
                           const ISPCCamera& camera)
 {
+  const Vec3fa center = camera.xfm.l.vz + 0.5f*float(width)*camera.xfm.l.vx + 0.5f*float(height)*camera.xfm.l.vy;
+  g_pixel_spread = length(camera.xfm.l.vx)/length(center);
+
+  if (g_mode == MODE_WAVEFRONT) {
+    renderFrameWavefront(pixels,width,height,time,camera);
+    return;
+  }
+  
   /* render image */
   const int numTilesX = (width +TILE_SIZE_X-1)/TILE_SIZE_X;
   const int numTilesY = (height+TILE_SIZE_Y-1)/TILE_SIZE_Y;
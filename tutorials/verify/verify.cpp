@@ -6,6 +6,8 @@
 #include "verify.h"
 #include "../common/scenegraph/scenegraph.h"
 #include "../common/scenegraph/geometry_creation.h"
+#include "../common/scenegraph/binary_loader.h"
+#include "../common/scenegraph/binary_writer.h"
 #include "../common/math/closest_point.h"
 #include "../../common/algorithms/parallel_for.h"
 #include "../../common/simd/simd.h"
@@ -761,6 +763,103 @@ namespace embree
     }
   };
 
+  struct BinarySceneCacheTest : public VerifyApplication::Test
+  {
+    BinarySceneCacheTest (std::string name)
+      : VerifyApplication::Test(name,0,VerifyApplication::TEST_SHOULD_PASS) {}
+
+    static std::vector<char> readFile(const FileName& fileName)
+    {
+      std::ifstream file(fileName.c_str(),std::ios::binary);
+      return std::vector<char>(std::istreambuf_iterator<char>(file),std::istreambuf_iterator<char>());
+    }
+
+    /* checks that some node of type T is reachable from the root */
+    template<typename T>
+    static bool contains(Ref<SceneGraph::Node> node)
+    {
+      if (node.dynamicCast<T>()) return true;
+      if (Ref<SceneGraph::TransformNode> xfm = node.dynamicCast<SceneGraph::TransformNode>())
+        return contains<T>(xfm->child);
+      if (Ref<SceneGraph::GroupNode> group = node.dynamicCast<SceneGraph::GroupNode>()) {
+        for (auto& child : group->children)
+          if (contains<T>(child)) return true;
+      }
+      return false;
+    }
+
+    /* stores the node to .xml and loads it, the loaded scene gets
+     * stored to .ebs and the loaded .ebs scene again to .ebs, which
+     * has to give identical files */
+    template<typename T>
+    static bool roundTrip(Ref<SceneGraph::Node> node)
+    {
+      const FileName xmlFile("verify_binary_scene.xml");
+      const FileName ebsFile0("verify_binary_scene0.ebs");
+      const FileName ebsFile1("verify_binary_scene1.ebs");
+      const std::vector<FileName> sources(1,xmlFile);
+
+      Ref<SceneGraph::GroupNode> root = new SceneGraph::GroupNode;
+      root->add(node);
+      SceneGraph::store(root.dynamicCast<SceneGraph::Node>(),xmlFile,false,false,true);
+
+      bool passed = true;
+      {
+        Ref<SceneGraph::Node> xmlScene = SceneGraph::load(xmlFile);
+        SceneGraph::storeBinary(xmlScene,ebsFile0,true,sources);
+        Ref<SceneGraph::Node> ebsScene = SceneGraph::loadBinary(ebsFile0);
+        SceneGraph::storeBinary(ebsScene,ebsFile1,true,sources);
+        passed &= contains<T>(xmlScene) && contains<T>(ebsScene);
+        passed &= readFile(ebsFile0) == readFile(ebsFile1);
+        passed &= SceneGraph::isBinaryUpToDate(ebsFile1,sources);
+        passed &= !SceneGraph::isBinaryUpToDate(ebsFile1,std::vector<FileName>(1,ebsFile0));
+        passed &= !SceneGraph::isBinaryUpToDate(ebsFile1,std::vector<FileName>());
+      }
+
+      /* a modified source file makes the cache stale */
+      std::ofstream(xmlFile.c_str(),std::ios::app) << "<!-- modified -->" << std::endl;
+      passed &= !SceneGraph::isBinaryUpToDate(ebsFile1,sources);
+
+      remove(xmlFile.c_str());
+      remove(xmlFile.addExt(".bin").c_str());
+      remove(ebsFile0.c_str());
+      remove(ebsFile1.c_str());
+      return passed;
+    }
+
+    VerifyApplication::TestReturnValue run(VerifyApplication* state, bool silent)
+    {
+      Ref<SceneGraph::MaterialNode> material = new OBJMaterial(1.0f,Vec3fa(0.5f),Vec3fa(0.1f),10.0f,"material");
+      const Vec3fa p0(-1,-1,0), dx(2,0,0), dy(0,2,0);
+
+      if (!roundTrip<SceneGraph::TriangleMeshNode>(SceneGraph::createTrianglePlane(p0,dx,dy,4,4,material))) return VerifyApplication::FAILED;
+      if (!roundTrip<SceneGraph::QuadMeshNode>(SceneGraph::createQuadPlane(p0,dx,dy,4,4,material))) return VerifyApplication::FAILED;
+      if (!roundTrip<SceneGraph::SubdivMeshNode>(SceneGraph::createSubdivPlane(p0,dx,dy,4,4,4.0f,material))) return VerifyApplication::FAILED;
+      if (!roundTrip<SceneGraph::GridMeshNode>(SceneGraph::createGridPlane(p0,dx,dy,4,4,material))) return VerifyApplication::FAILED;
+      if (!roundTrip<SceneGraph::PointSetNode>(SceneGraph::createPointSphere(Vec3fa(0.0f),1.0f,0.05f,8,SceneGraph::SPHERE,material))) return VerifyApplication::FAILED;
+      if (!roundTrip<SceneGraph::HairSetNode>(SceneGraph::createHairyPlane(7,p0,dx,dy,0.2f,0.01f,16,SceneGraph::ROUND_CURVE,material))) return VerifyApplication::FAILED;
+      if (!roundTrip<SceneGraph::TransformNode>(new SceneGraph::TransformNode(AffineSpace3fa::translate(Vec3fa(1,2,3)),SceneGraph::createQuadPlane(p0,dx,dy,2,2,material)))) return VerifyApplication::FAILED;
+      if (!roundTrip<SceneGraph::LightNode>(new SceneGraph::LightNodeImpl<SceneGraph::PointLight>(SceneGraph::PointLight(Vec3fa(0,4,0),Vec3fa(1.0f))))) return VerifyApplication::FAILED;
+      if (!roundTrip<SceneGraph::PerspectiveCameraNode>(new SceneGraph::PerspectiveCameraNode(Vec3fa(0,0,-5),Vec3fa(0.0f),Vec3fa(0,1,0),60.0f))) return VerifyApplication::FAILED;
+
+      /* embedded texels are used directly from the mapped file */
+      const FileName ebsFile("verify_binary_texture.ebs");
+      std::shared_ptr<Texture> texture(new Texture(4,4,Texture::RGBA8));
+      for (size_t i=0; i<64; i++) ((unsigned char*)texture->data)[i] = (unsigned char)(7*i);
+      Ref<SceneGraph::MaterialNode> textured = new OBJMaterial(1.0f,nullptr,Vec3fa(1.0f),texture,Vec3fa(0.0f),nullptr,1.0f,nullptr,nullptr);
+      SceneGraph::storeBinary(SceneGraph::createTrianglePlane(p0,dx,dy,1,1,textured),ebsFile,true);
+      bool passed = false;
+      {
+        Ref<SceneGraph::TriangleMeshNode> mesh = SceneGraph::loadBinary(ebsFile).dynamicCast<SceneGraph::TriangleMeshNode>();
+        Ref<OBJMaterial> m = mesh ? mesh->material.dynamicCast<OBJMaterial>() : nullptr;
+        std::shared_ptr<Texture> tex = m ? m->_map_Kd : nullptr;
+        passed = tex && tex->storage && tex->width == 4 && tex->height == 4 && memcmp(tex->data,texture->data,64) == 0;
+      }
+      remove(ebsFile.c_str());
+      return passed ? VerifyApplication::PASSED : VerifyApplication::FAILED;
+    }
+  };
+
   struct MultipleDevicesTest : public VerifyApplication::Test
   {
     MultipleDevicesTest (std::string name, int isa)
@@ -1016,6 +1115,130 @@ namespace embree
     }
   };
 
+  /* encodes small integers as half precision float */
+  static unsigned short half_of_int(int n)
+  {
+    if (n == 0) return 0;
+    const unsigned short sign = n < 0 ? 0x8000 : 0;
+    const unsigned int a = n < 0 ? -n : n;
+    unsigned int e = 0;
+    while ((a >> e) > 1) e++;
+    return sign | ((e+15) << 10) | (((a << 10) >> e) & 0x3ff);
+  }
+
+  struct CompactFormatsTest : public VerifyApplication::Test
+  {
+    SceneFlags sflags;
+    RTCGeometryType gtype;
+    RTCFormat vertexFormat;
+
+    CompactFormatsTest (std::string name, int isa, SceneFlags sflags, RTCGeometryType gtype, RTCFormat vertexFormat)
+      : VerifyApplication::Test(name,isa,VerifyApplication::TEST_SHOULD_PASS), sflags(sflags), gtype(gtype), vertexFormat(vertexFormat) {}
+
+    VerifyApplication::TestReturnValue run (VerifyApplication* state, bool silent)
+    {
+      std::string cfg = state->rtcore + ",isa="+stringOfISA(isa);
+      RTCDeviceRef device = rtcNewDevice(cfg.c_str());
+      errorHandler(nullptr,rtcGetDeviceError(device));
+
+      /* height field of G*G vertices, stored as float and in compact form */
+      const unsigned G = 17;
+      const unsigned numVertices = G*G;
+      const unsigned numFaces = (G-1)*(G-1);
+      const unsigned numIndices = gtype == RTC_GEOMETRY_TYPE_QUAD ? 4 : 3;
+      const unsigned numPrims = gtype == RTC_GEOMETRY_TYPE_QUAD ? numFaces : 2*numFaces;
+      const float scale[3] = { 0.25f, 0.5f, 0.125f };
+      const float offset[3] = { -2.0f, 3.0f, -4.0f };
+
+      std::vector<Vec3fa> positions(numVertices);
+      std::vector<unsigned short> compact(3*numVertices);
+      for (unsigned y=0; y<G; y++) {
+        for (unsigned x=0; x<G; x++)
+        {
+          const unsigned i = y*G+x;
+          const int q[3] = { int(x)-8, int(random_int() & 7), int(y)-8 };
+          for (size_t k=0; k<3; k++)
+          {
+            if (vertexFormat == RTC_FORMAT_HALF3) {
+              compact[3*i+k] = half_of_int(q[k]);
+              positions[i][k] = float(q[k])*scale[k]+offset[k];
+            } else {
+              const short s = short(q[k]*4000);
+              compact[3*i+k] = (unsigned short) s;
+              positions[i][k] = max(float(s)*(1.0f/32767.0f),-1.0f)*scale[k]+offset[k];
+            }
+          }
+        }
+      }
+      std::vector<unsigned> indices;
+      for (unsigned y=0; y<G-1; y++) {
+        for (unsigned x=0; x<G-1; x++)
+        {
+          const unsigned v00 = y*G+x, v01 = v00+1, v10 = v00+G, v11 = v10+1;
+          if (gtype == RTC_GEOMETRY_TYPE_QUAD) {
+            indices.push_back(v00); indices.push_back(v01); indices.push_back(v11); indices.push_back(v10);
+          } else {
+            indices.push_back(v00); indices.push_back(v01); indices.push_back(v11);
+            indices.push_back(v00); indices.push_back(v11); indices.push_back(v10);
+          }
+        }
+      }
+
+      VerifyScene scene0(device,sflags);
+      RTCGeometry geom0 = rtcNewGeometry(device,gtype);
+      rtcSetGeometryBuildQuality(geom0,sflags.qflags);
+      unsigned* index0 = (unsigned*) rtcSetNewGeometryBuffer(geom0,RTC_BUFFER_TYPE_INDEX,0,gtype == RTC_GEOMETRY_TYPE_QUAD ? RTC_FORMAT_UINT4 : RTC_FORMAT_UINT3,numIndices*sizeof(unsigned),numPrims);
+      float* vertex0 = (float*) rtcSetNewGeometryBuffer(geom0,RTC_BUFFER_TYPE_VERTEX,0,RTC_FORMAT_FLOAT3,3*sizeof(float),numVertices);
+      for (size_t i=0; i<indices.size(); i++) index0[i] = indices[i];
+      for (size_t i=0; i<numVertices; i++) for (size_t k=0; k<3; k++) vertex0[3*i+k] = positions[i][k];
+      rtcCommitGeometry(geom0);
+      rtcAttachGeometry(scene0,geom0);
+      rtcReleaseGeometry(geom0);
+      rtcCommitScene(scene0);
+      AssertNoError(device);
+
+      VerifyScene scene1(device,sflags);
+      RTCGeometry geom1 = rtcNewGeometry(device,gtype);
+      rtcSetGeometryBuildQuality(geom1,sflags.qflags);
+      unsigned short* index1 = (unsigned short*) rtcSetNewGeometryBuffer(geom1,RTC_BUFFER_TYPE_INDEX,0,gtype == RTC_GEOMETRY_TYPE_QUAD ? RTC_FORMAT_USHORT4 : RTC_FORMAT_USHORT3,numIndices*sizeof(unsigned short),numPrims);
+      unsigned short* vertex1 = (unsigned short*) rtcSetNewGeometryBuffer(geom1,RTC_BUFFER_TYPE_VERTEX,0,vertexFormat,3*sizeof(unsigned short),numVertices);
+      AssertNoError(device);
+      for (size_t i=0; i<indices.size(); i++) index1[i] = (unsigned short) indices[i];
+      for (size_t i=0; i<compact.size(); i++) vertex1[i] = compact[i];
+      rtcSetGeometryVertexDequantization(geom1,scale,offset);
+      rtcCommitGeometry(geom1);
+      rtcAttachGeometry(scene1,geom1);
+      rtcReleaseGeometry(geom1);
+      rtcCommitScene(scene1);
+      AssertNoError(device);
+
+      /* both scenes have to produce the same hits */
+      RTCIntersectContext context;
+      rtcInitIntersectContext(&context);
+      for (size_t i=0; i<1000; i++)
+      {
+        const float x = lerp(positions[0].x,positions[numVertices-1].x,random_float());
+        const float z = lerp(positions[0].z,positions[numVertices-1].z,random_float());
+        RTCRayHit ray0 = makeRay(Vec3fa(x,100,z),Vec3fa(0,-1,0));
+        RTCRayHit ray1 = ray0;
+        rtcIntersect1(scene0,&context,&ray0);
+        rtcIntersect1(scene1,&context,&ray1);
+        if (ray0.hit.geomID != ray1.hit.geomID) return VerifyApplication::FAILED;
+        if (ray0.hit.geomID == RTC_INVALID_GEOMETRY_ID) continue;
+        if (abs(ray0.ray.tfar-ray1.ray.tfar) > 1E-3f) return VerifyApplication::FAILED;
+
+        /* interpolation of the vertex buffer returns decoded positions */
+        float P[3];
+        rtcInterpolate0(rtcGetGeometry(scene1,ray1.hit.geomID),ray1.hit.primID,ray1.hit.u,ray1.hit.v,RTC_BUFFER_TYPE_VERTEX,0,P,3);
+        const Vec3fa hit = Vec3fa(x,100,z) + ray1.ray.tfar*Vec3fa(0,-1,0);
+        if (length(Vec3fa(P[0],P[1],P[2])-hit) > 1E-3f) return VerifyApplication::FAILED;
+      }
+      AssertNoError(device);
+
+      return VerifyApplication::PASSED;
+    }
+  };
+
   /////////////////////////////////////////////////////////////////////////////////
 
   /*
@@ -1206,166 +1429,1229 @@ namespace embree
     }
   };
 
-  struct OverlappingGeometryTest : public VerifyApplication::Test
+  struct MemoryBudgetTest : public VerifyApplication::Test
   {
     SceneFlags sflags;
-    RTCBuildQuality quality; 
-    size_t N;
-    
-    OverlappingGeometryTest (std::string name, int isa, SceneFlags sflags, RTCBuildQuality quality, size_t N)
-      : VerifyApplication::Test(name,isa,VerifyApplication::TEST_SHOULD_PASS), sflags(sflags), quality(quality), N(N) {}
-    
-    VerifyApplication::TestReturnValue run(VerifyApplication* state, bool silent)
-    {
-      std::string cfg = state->rtcore + ",isa="+stringOfISA(isa);
-      RTCDeviceRef device = rtcNewDevice(cfg.c_str());
-      errorHandler(nullptr,rtcGetDeviceError(device));
-      VerifyScene scene(device,sflags);
-      AssertNoError(device);
 
-      const Vec3fa p (0,0,0);
-      const Vec3fa dx(1,0,0);
-      const Vec3fa dy(0,1,0);
-      
-      Ref<SceneGraph::TriangleMeshNode> trimesh = SceneGraph::createTrianglePlane(p,dx,dy,1,1).dynamicCast<SceneGraph::TriangleMeshNode>();
-      for (size_t i=0; i<N; i++) trimesh->triangles.push_back(trimesh->triangles.back());
-      scene.addGeometry(quality,trimesh.dynamicCast<SceneGraph::Node>());
+    MemoryBudgetTest (std::string name, int isa, SceneFlags sflags)
+      : VerifyApplication::Test(name,isa,VerifyApplication::TEST_SHOULD_PASS), sflags(sflags) {}
 
-      Ref<SceneGraph::TriangleMeshNode> trimesh2 = SceneGraph::createTrianglePlane(p,dx,dy,1,1)->set_motion_vector(random_motion_vector(1.0f)).dynamicCast<SceneGraph::TriangleMeshNode>();
-      for (size_t i=0; i<N; i++) trimesh2->triangles.push_back(trimesh2->triangles.back());
-      scene.addGeometry(quality,trimesh2.dynamicCast<SceneGraph::Node>());
+    struct MemoryUsage
+    {
+      MemoryUsage () : bytes(0), peakBytes(0) {}
+      std::atomic<ssize_t> bytes;
+      std::atomic<ssize_t> peakBytes;
+    };
 
-      Ref<SceneGraph::QuadMeshNode> quadmesh = SceneGraph::createQuadPlane(p,dx,dy,1,1).dynamicCast<SceneGraph::QuadMeshNode>();
-      for (size_t i=0; i<N; i++) quadmesh->quads.push_back(quadmesh->quads.back());
-      scene.addGeometry(quality,quadmesh.dynamicCast<SceneGraph::Node>());
+    static bool memoryMonitor(void* userPtr, const ssize_t bytes, const bool /*post*/)
+    {
+      MemoryUsage* usage = (MemoryUsage*) userPtr;
+      const ssize_t current = usage->bytes += bytes;
+      ssize_t peak = usage->peakBytes;
+      while (current > peak && !usage->peakBytes.compare_exchange_weak(peak,current));
+      return true;
+    }
 
-      Ref<SceneGraph::QuadMeshNode> quadmesh2 = SceneGraph::createQuadPlane(p,dx,dy,1,1)->set_motion_vector(random_motion_vector(1.0f)).dynamicCast<SceneGraph::QuadMeshNode>();
-      for (size_t i=0; i<N; i++) quadmesh2->quads.push_back(quadmesh2->quads.back());
-      scene.addGeometry(quality,quadmesh2.dynamicCast<SceneGraph::Node>());
+    VerifyApplication::TestReturnValue run (VerifyApplication* state, bool silent)
+    {
+      RTCIntersectContext context;
+      rtcInitIntersectContext(&context);
 
-      Ref<SceneGraph::GridMeshNode> gridmesh = SceneGraph::createGridPlane(p,dx,dy,1,1).dynamicCast<SceneGraph::GridMeshNode>();
-      for (size_t i=0; i<N; i++) gridmesh->grids.push_back(gridmesh->grids.back());
-      scene.addGeometry(quality,gridmesh.dynamicCast<SceneGraph::Node>());
+      /* the same scene gets built with a budget of 10 KiB and of 1000 MiB on separate devices that track their memory consumption */
+      const float budgets[2] = { 0.01f, 1000.0f };
+      ssize_t committedBytes[2], peakBytes[2];
+      for (size_t i=0; i<2; i++)
+      {
+        std::string cfg = state->rtcore + ",isa="+stringOfISA(isa)+",build_memory_budget="+std::to_string((long double)budgets[i]);
+        RTCDeviceRef device = rtcNewDevice(cfg.c_str());
+        errorHandler(nullptr,rtcGetDeviceError(device));
+        MemoryUsage usage;
+        rtcSetDeviceMemoryMonitorFunction(device,memoryMonitor,&usage);
+        VerifyScene scene(device,sflags);
+        AssertNoError(device);
 
-      Ref<SceneGraph::GridMeshNode> gridmesh2 = SceneGraph::createGridPlane(p,dx,dy,1,1)->set_motion_vector(random_motion_vector(1.0f)).dynamicCast<SceneGraph::GridMeshNode>();
-      for (size_t i=0; i<N; i++) gridmesh2->grids.push_back(gridmesh2->grids.back());
-      scene.addGeometry(quality,gridmesh2.dynamicCast<SceneGraph::Node>());
-      
-      Ref<SceneGraph::SubdivMeshNode> subdivmesh = new SceneGraph::SubdivMeshNode(nullptr,BBox1f(0,1),1);
-      for (unsigned i=0; i<unsigned(N); i++) {
-        subdivmesh->verticesPerFace.push_back(4);
-        subdivmesh->position_indices.push_back(4*i+0);
-        subdivmesh->position_indices.push_back(4*i+1);
-        subdivmesh->position_indices.push_back(4*i+2);
-        subdivmesh->position_indices.push_back(4*i+3);
-        subdivmesh->positions[0].push_back(Vec3fa(0,0,0));
-        subdivmesh->positions[0].push_back(Vec3fa(0,1,0));
-        subdivmesh->positions[0].push_back(Vec3fa(1,1,0));
-        subdivmesh->positions[0].push_back(Vec3fa(1,0,0));
+        unsigned geom0 = scene.addSphere    (sampler,RTC_BUILD_QUALITY_MEDIUM,Vec3fa(-1,0,-1),1.0f,50).first;
+        unsigned geom1 = scene.addQuadSphere(sampler,RTC_BUILD_QUALITY_MEDIUM,Vec3fa(+1,0,+1),1.0f,50).first;
+        rtcCommitScene (scene);
+        AssertNoError(device);
+        committedBytes[i] = usage.bytes;
+        peakBytes[i] = usage.peakBytes;
+
+        RTCRayHit ray0 = makeRay(Vec3fa(-1,10,-1),Vec3fa(0,-1,0));
+        RTCRayHit ray1 = makeRay(Vec3fa(+1,10,+1),Vec3fa(0,-1,0));
+        RTCRayHit ray2 = makeRay(Vec3fa(+1,10,-1),Vec3fa(0,-1,0));
+        rtcIntersect1(scene,&context,&ray0);
+        rtcIntersect1(scene,&context,&ray1);
+        rtcIntersect1(scene,&context,&ray2);
+        if (ray0.hit.geomID != geom0) return VerifyApplication::FAILED;
+        if (ray1.hit.geomID != geom1) return VerifyApplication::FAILED;
+        if (ray2.hit.geomID != RTC_INVALID_GEOMETRY_ID) return VerifyApplication::FAILED;
+        AssertNoError(device);
       }
-      scene.addGeometry(quality,subdivmesh.dynamicCast<SceneGraph::Node>());
 
-      Ref<SceneGraph::SubdivMeshNode> subdivmesh2 = new SceneGraph::SubdivMeshNode(nullptr,BBox1f(0,1),1);
-      for (unsigned i=0; i<unsigned(N); i++) {
-        subdivmesh2->verticesPerFace.push_back(4);
-        subdivmesh2->position_indices.push_back(4*i+0);
-        subdivmesh2->position_indices.push_back(4*i+1);
-        subdivmesh2->position_indices.push_back(4*i+2);
-        subdivmesh2->position_indices.push_back(4*i+3);
-        subdivmesh2->positions[0].push_back(Vec3fa(0,0,0));
-        subdivmesh2->positions[0].push_back(Vec3fa(0,1,0));
-        subdivmesh2->positions[0].push_back(Vec3fa(1,1,0));
-        subdivmesh2->positions[0].push_back(Vec3fa(1,0,0));
+      /* the small budget switches to compact leaves, which lowers the peak and final memory consumption, scenes that use compact leaves anyway must not grow */
+      if (sflags.sflags & RTC_SCENE_FLAG_COMPACT) {
+        if (committedBytes[0] > committedBytes[1] || peakBytes[0] > peakBytes[1]) return VerifyApplication::FAILED;
+      } else {
+        if (committedBytes[0] >= committedBytes[1] || peakBytes[0] >= peakBytes[1]) return VerifyApplication::FAILED;
       }
-      subdivmesh2->set_motion_vector(random_motion_vector(1.0f));
-      scene.addGeometry(quality,subdivmesh2.dynamicCast<SceneGraph::Node>());
-      
-      Ref<SceneGraph::HairSetNode> hairgeom = SceneGraph::createHairyPlane(RandomSampler_getInt(sampler),p,dx,dy,0.2f,0.01f,1,SceneGraph::FLAT_CURVE).dynamicCast<SceneGraph::HairSetNode>();
-      for (size_t i=0; i<N; i++) hairgeom->hairs.push_back(hairgeom->hairs.back());
-      scene.addGeometry(quality,hairgeom.dynamicCast<SceneGraph::Node>());
 
-      Ref<SceneGraph::HairSetNode> hairgeom2 = SceneGraph::createHairyPlane(RandomSampler_getInt(sampler),p,dx,dy,0.2f,0.01f,1,SceneGraph::FLAT_CURVE)->set_motion_vector(random_motion_vector(1.0f)).dynamicCast<SceneGraph::HairSetNode>();
-      for (size_t i=0; i<N; i++) hairgeom2->hairs.push_back(hairgeom2->hairs.back());
-      scene.addGeometry(quality,hairgeom2.dynamicCast<SceneGraph::Node>());
+      return VerifyApplication::PASSED;
+    }
+  };
 
-      Ref<SceneGraph::Node> curvegeom = SceneGraph::convert_flat_to_round_curves(hairgeom.dynamicCast<SceneGraph::Node>());
-      scene.addGeometry(quality,curvegeom);
+  struct StreamingBuildTest : public VerifyApplication::Test
+  {
+    std::string builder_cfg;
 
-      Ref<SceneGraph::Node> curvegeom2 = SceneGraph::convert_flat_to_round_curves(hairgeom2.dynamicCast<SceneGraph::Node>());
-      scene.addGeometry(quality,curvegeom2);
+    StreamingBuildTest (std::string name, int isa, std::string builder_cfg)
+      : VerifyApplication::Test(name,isa,VerifyApplication::TEST_SHOULD_PASS), builder_cfg(builder_cfg) {}
 
-      Ref<SceneGraph::Node> linegeom = SceneGraph::convert_bezier_to_lines(hairgeom.dynamicCast<SceneGraph::Node>());
-      scene.addGeometry(quality,linegeom);
+    VerifyApplication::TestReturnValue run (VerifyApplication* state, bool silent)
+    {
+      RTCIntersectContext context;
+      rtcInitIntersectContext(&context);
 
-      Ref<SceneGraph::Node> linegeom2 = SceneGraph::convert_bezier_to_lines(hairgeom2.dynamicCast<SceneGraph::Node>());
-      scene.addGeometry(quality,linegeom2);
-      
+      std::string cfg = state->rtcore + ",isa="+stringOfISA(isa)+","+builder_cfg;
+      RTCDeviceRef device = rtcNewDevice(cfg.c_str());
+      errorHandler(nullptr,rtcGetDeviceError(device));
+      VerifyScene scene(device,SceneFlags(RTC_SCENE_FLAG_NONE,RTC_BUILD_QUALITY_MEDIUM));
+      AssertNoError(device);
+
+      /* a small dense sphere far away from the others puts more triangles into a single morton cell than fit into a bucket */
+      const unsigned dense = scene.addSphere(sampler,RTC_BUILD_QUALITY_MEDIUM,Vec3fa(-1000.0f,0,0),0.01f,100).first;
+
+      /* enough triangles to get split into many buckets */
+      unsigned geom[4][4];
+      for (int x=0; x<4; x++)
+        for (int z=0; z<4; z++)
+          geom[x][z] = scene.addSphere(sampler,RTC_BUILD_QUALITY_MEDIUM,Vec3fa(3.0f*x,0,3.0f*z),1.0f,50).first;
       rtcCommitScene (scene);
       AssertNoError(device);
+
+      for (int i=-4; i<=4; i++)
+      {
+        RTCRayHit ray = makeRay(Vec3fa(-1000.0f+0.002f*i,10,0.001f*i),Vec3fa(0,-1,0));
+        rtcIntersect1(scene,&context,&ray);
+        if (ray.hit.geomID != dense) return VerifyApplication::FAILED;
+      }
+
+      for (int x=0; x<4; x++)
+      {
+        for (int z=0; z<4; z++)
+        {
+          RTCRayHit ray = makeRay(Vec3fa(3.0f*x,10,3.0f*z),Vec3fa(0,-1,0));
+          rtcIntersect1(scene,&context,&ray);
+          if (ray.hit.geomID != geom[x][z]) return VerifyApplication::FAILED;
+        }
+      }
+      AssertNoError(device);
+
       return VerifyApplication::PASSED;
     }
   };
 
-  static std::atomic<ssize_t> memory_consumption_bytes_used(0);
-
-  struct MemoryConsumptionTest : public VerifyApplication::Test
+  struct TreeletLayoutTest : public VerifyApplication::Test
   {
-    GeometryType gtype;
-    SceneFlags sflags;
     RTCBuildQuality quality;
-    
-    MemoryConsumptionTest (std::string name, int isa, GeometryType gtype, SceneFlags sflags, RTCBuildQuality quality)
-      : VerifyApplication::Test(name,isa,VerifyApplication::TEST_SHOULD_PASS), gtype(gtype), sflags(sflags), quality(quality) {}
+    bool motion_blur;
+
+    TreeletLayoutTest (std::string name, int isa, RTCBuildQuality quality, bool motion_blur)
+      : VerifyApplication::Test(name,isa,VerifyApplication::TEST_SHOULD_PASS), quality(quality), motion_blur(motion_blur) {}
 
     static bool memoryMonitor(void* userPtr, const ssize_t bytes, const bool /*post*/)
     {
-      memory_consumption_bytes_used += bytes;
+      *(std::atomic<ssize_t>*)userPtr += bytes;
       return true;
     }
 
-    double expected_size_helper(VerifyApplication* state, size_t NN)
+    VerifyApplication::TestReturnValue run (VerifyApplication* state, bool silent)
     {
-      bool has_avx = (isa & AVX) == AVX;
-      bool has_avx2 = (isa & AVX2) == AVX2;
-      
-      if (sflags.qflags == RTC_BUILD_QUALITY_LOW)
-      {
-        switch (gtype) {
-        case TRIANGLE_MESH: return has_avx ? 131.0f*NN : 117.0f*NN; // triangle4
-        default: return inf;
+      RTCIntersectContext context;
+      rtcInitIntersectContext(&context);
+
+      /* separate devices track the memory consumption of both scenes */
+      std::string cfg = state->rtcore + ",isa="+stringOfISA(isa);
+      RTCDeviceRef device0 = rtcNewDevice(cfg.c_str());
+      errorHandler(nullptr,rtcGetDeviceError(device0));
+      RTCDeviceRef device1 = rtcNewDevice(cfg.c_str());
+      errorHandler(nullptr,rtcGetDeviceError(device1));
+      std::atomic<ssize_t> bytes0(0), bytes1(0);
+      rtcSetDeviceMemoryMonitorFunction(device0,memoryMonitor,&bytes0);
+      rtcSetDeviceMemoryMonitorFunction(device1,memoryMonitor,&bytes1);
+
+      avector<Vec3fa> motion_vector;
+      if (motion_blur) {
+        motion_vector.push_back(Vec3fa(0.0f,0.0f,0.0f));
+        motion_vector.push_back(Vec3fa(0.0f,0.0f,1.0f));
+      }
+
+      /* the same scene with default and treelet layout, large enough to require many treelets */
+      VerifyScene scene0(device0,SceneFlags(RTC_SCENE_FLAG_NONE,quality));
+      VerifyScene scene1(device1,SceneFlags(RTC_SCENE_FLAG_TREELET_LAYOUT,quality));
+      for (int x=0; x<8; x++) {
+        for (int z=0; z<8; z++) {
+          scene0.addSphere(sampler,quality,Vec3fa(3.0f*x,0,3.0f*z),1.0f,20,-1,motion_vector);
+          scene1.addSphere(sampler,quality,Vec3fa(3.0f*x,0,3.0f*z),1.0f,20,-1,motion_vector);
         }
       }
-      else
+      rtcCommitScene (scene0);
+      rtcCommitScene (scene1);
+      AssertNoError(device0);
+      AssertNoError(device1);
+      if (rtcGetSceneFlags(scene1) != RTC_SCENE_FLAG_TREELET_LAYOUT)
+        return VerifyApplication::FAILED;
+
+      /* the nodes get relaid out in place */
+      if (bytes0 != bytes1)
+        return VerifyApplication::FAILED;
+
+      for (size_t i=0; i<1000; i++)
       {
-        switch (gtype)
-        {
-        case TRIANGLE_MESH: switch (sflags.sflags) {
-          case RTC_SCENE_FLAG_NONE: return has_avx ?  70.0f*NN :  63.0f*NN; // triangle4
-          case RTC_SCENE_FLAG_ROBUST : return has_avx ?  70.0f*NN :  63.0f*NN; // triangle4v
-          case RTC_SCENE_FLAG_COMPACT: return has_avx ?  35.0f*NN :  35.0f*NN; // triangle4i
-          default: return inf;
-          }
-          
-          
-        case TRIANGLE_MESH_MB: switch (sflags.sflags) {
-          case RTC_SCENE_FLAG_NONE: return has_avx2 ? 55.0f*NN : 45.0f*NN; // triangle4imb
-          case RTC_SCENE_FLAG_ROBUST : return has_avx2 ? 55.0f*NN : 45.0f*NN; // triangle4imb
-          case RTC_SCENE_FLAG_COMPACT: return has_avx2 ? 45.0f*NN : 45.0f*NN; // triangle4imb
-          default: return inf;
-          }
-          
-        case QUAD_MESH: switch (sflags.sflags) {
-          case RTC_SCENE_FLAG_NONE: return has_avx ? 85.0f*NN : 79.0f*NN; // quad4v
-          case RTC_SCENE_FLAG_ROBUST : return has_avx ? 85.0f*NN : 79.0f*NN; // quad4v
-          case RTC_SCENE_FLAG_COMPACT: return has_avx ? 41.0f*NN : 41.0f*NN; // quad4i
-          default: return inf;
-          }
-        case QUAD_MESH_MB: switch (sflags.sflags) {
-          case RTC_SCENE_FLAG_NONE: return has_avx ? 68.0f*NN : 53.0f*NN; // quad4imb
-          case RTC_SCENE_FLAG_ROBUST : return has_avx ? 68.0f*NN : 53.0f*NN; // quad4imb
-          case RTC_SCENE_FLAG_COMPACT: return has_avx ? 53.0f*NN : 53.0f*NN; // quad4imb
-          default: return inf;
-          }
+        const Vec3fa org = Vec3fa(24.0f*random_float()-1.5f,10.0f,24.0f*random_float()-1.5f);
+        const Vec3fa dir = Vec3fa(random_float()-0.5f,-1.0f,random_float()-0.5f);
+        const float time = random_float();
+        RTCRayHit ray0 = makeRay(org,dir); ray0.ray.time = time; rtcIntersect1(scene0,&context,&ray0);
+        RTCRayHit ray1 = makeRay(org,dir); ray1.ray.time = time; rtcIntersect1(scene1,&context,&ray1);
+        if (ray0.hit.geomID != ray1.hit.geomID) return VerifyApplication::FAILED;
+        if (ray0.hit.primID != ray1.hit.primID) return VerifyApplication::FAILED;
+        if (ray0.ray.tfar != ray1.ray.tfar) return VerifyApplication::FAILED;
+
+        RTCRayHit shadow0 = makeRay(org,dir); shadow0.ray.time = time; rtcOccluded1(scene0,&context,&shadow0.ray);
+        RTCRayHit shadow1 = makeRay(org,dir); shadow1.ray.time = time; rtcOccluded1(scene1,&context,&shadow1.ray);
+        if (shadow0.ray.tfar != shadow1.ray.tfar) return VerifyApplication::FAILED;
+      }
+      AssertNoError(device0);
+      AssertNoError(device1);
+
+      return VerifyApplication::PASSED;
+    }
+  };
+
+  struct NoFilterContextTest : public VerifyApplication::Test
+  {
+    bool quads;
+
+    NoFilterContextTest (std::string name, int isa, bool quads)
+      : VerifyApplication::Test(name,isa,VerifyApplication::TEST_SHOULD_PASS), quads(quads) {}
+
+    static void rejectAll(const RTCFilterFunctionNArguments* args)
+    {
+      for (unsigned int i=0; i<args->N; i++)
+        args->valid[i] = 0;
+    }
+
+    VerifyApplication::TestReturnValue run (VerifyApplication* state, bool silent)
+    {
+      std::string cfg = state->rtcore + ",isa="+stringOfISA(isa);
+      RTCDeviceRef device = rtcNewDevice(cfg.c_str());
+      errorHandler(nullptr,rtcGetDeviceError(device));
+
+      /* geometry with filter functions that reject all hits */
+      VerifyScene scene(device,SceneFlags(RTC_SCENE_FLAG_NONE,RTC_BUILD_QUALITY_MEDIUM));
+      unsigned int geomID = quads
+        ? scene.addQuadSphere(sampler,RTC_BUILD_QUALITY_MEDIUM,Vec3fa(0,0,0),1.0f,20).first
+        : scene.addSphere(sampler,RTC_BUILD_QUALITY_MEDIUM,Vec3fa(0,0,0),1.0f,20).first;
+      RTCGeometry geom = rtcGetGeometry(scene,geomID);
+      rtcSetGeometryIntersectFilterFunction(geom,rejectAll);
+      rtcSetGeometryOccludedFilterFunction(geom,rejectAll);
+      rtcCommitGeometry(geom);
+      rtcCommitScene (scene);
+      AssertNoError(device);
+
+      /* filter functions are invoked by default */
+      RTCIntersectContext context;
+      rtcInitIntersectContext(&context);
+      RTCRayHit ray0 = makeRay(Vec3fa(0,10,0),Vec3fa(0,-1,0)); rtcIntersect1(scene,&context,&ray0);
+      RTCRayHit shadow0 = makeRay(Vec3fa(0,10,0),Vec3fa(0,-1,0)); rtcOccluded1(scene,&context,&shadow0.ray);
+      if (ray0.hit.geomID != RTC_INVALID_GEOMETRY_ID) return VerifyApplication::FAILED;
+      if (shadow0.ray.tfar < 0.0f) return VerifyApplication::FAILED;
+
+      /* and skipped when the caller promises not to need them */
+      context.flags = RTC_INTERSECT_CONTEXT_FLAG_NO_FILTER;
+      RTCRayHit ray1 = makeRay(Vec3fa(0,10,0),Vec3fa(0,-1,0)); rtcIntersect1(scene,&context,&ray1);
+      RTCRayHit shadow1 = makeRay(Vec3fa(0,10,0),Vec3fa(0,-1,0)); rtcOccluded1(scene,&context,&shadow1.ray);
+      if (ray1.hit.geomID != geomID) return VerifyApplication::FAILED;
+      if (std::abs(ray1.ray.tfar-9.0f) > 0.1f) return VerifyApplication::FAILED;
+      if (shadow1.ray.tfar >= 0.0f) return VerifyApplication::FAILED;
+      AssertNoError(device);
+
+      return VerifyApplication::PASSED;
+    }
+  };
+
+  struct ProgressiveCommitTest : public VerifyApplication::Test
+  {
+    bool quads;
+
+    ProgressiveCommitTest (std::string name, int isa, bool quads)
+      : VerifyApplication::Test(name,isa,VerifyApplication::TEST_SHOULD_PASS), quads(quads) {}
+
+    VerifyApplication::TestReturnValue run (VerifyApplication* state, bool silent)
+    {
+      std::string cfg = state->rtcore + ",isa="+stringOfISA(isa);
+      RTCDeviceRef device = rtcNewDevice(cfg.c_str());
+      errorHandler(nullptr,rtcGetDeviceError(device));
+      VerifyScene scene(device,SceneFlags(RTC_SCENE_FLAG_NONE,RTC_BUILD_QUALITY_MEDIUM));
+      AssertNoError(device);
+
+      /* a loader thread attaches spheres while the scene gets built
+       * progressively, the last sphere has a different type and some
+       * spheres get detached again */
+      const size_t numSpheres = 16;
+      std::vector<unsigned int> geomIDs(numSpheres);
+      std::atomic<bool> loaded(false);
+      std::thread loader([&] () {
+          for (size_t i=0; i<numSpheres; i++) {
+            const Vec3fa pos(3.0f*i,0.0f,0.0f);
+            geomIDs[i] = quads != (i == numSpheres-1)
+              ? scene.addQuadSphere(sampler,RTC_BUILD_QUALITY_MEDIUM,pos,1.0f,50).first
+              : scene.addSphere(sampler,RTC_BUILD_QUALITY_MEDIUM,pos,1.0f,50).first;
+            if (i%4 == 0) {
+              const unsigned int geomID = scene.addSphere(sampler,RTC_BUILD_QUALITY_MEDIUM,pos+Vec3fa(0,5,0),1.0f,50).first;
+              rtcDetachGeometry(scene,geomID);
+            }
+          }
+          loaded = true;
+        });
+      
+      while (!loaded)
+        rtcCommitSceneProgressive(scene);
+      loader.join();
+      AssertNoError(device);
+
+      rtcCommitScene(scene);
+      AssertNoError(device);
+
+      RTCIntersectContext context;
+      rtcInitIntersectContext(&context);
+      for (size_t i=0; i<numSpheres; i++)
+      {
+        RTCRayHit ray = makeRay(Vec3fa(3.0f*i,10.0f,0.0f),Vec3fa(0,-1,0));
+        rtcIntersect1(scene,&context,&ray);
+        if (ray.hit.geomID != geomIDs[i]) return VerifyApplication::FAILED;
+        if (std::abs(ray.ray.tfar-9.0f) > 0.1f) return VerifyApplication::FAILED;
+      }
+      AssertNoError(device);
+
+      /* later regular commits work as before */
+      const unsigned int geomID = scene.addSphere(sampler,RTC_BUILD_QUALITY_MEDIUM,Vec3fa(-3.0f,0.0f,0.0f),1.0f,50).first;
+      rtcCommitScene(scene);
+      AssertNoError(device);
+      RTCRayHit ray = makeRay(Vec3fa(-3.0f,10.0f,0.0f),Vec3fa(0,-1,0));
+      rtcIntersect1(scene,&context,&ray);
+      if (ray.hit.geomID != geomID) return VerifyApplication::FAILED;
+      AssertNoError(device);
+
+      return VerifyApplication::PASSED;
+    }
+  };
+
+  struct AsyncCommitTest : public VerifyApplication::Test
+  {
+    struct Completion
+    {
+      Completion () : completed(false), error(RTC_ERROR_NONE) {}
+      std::atomic<bool> completed;
+      RTCError error;
+    };
+
+    AsyncCommitTest (std::string name, int isa)
+      : VerifyApplication::Test(name,isa,VerifyApplication::TEST_SHOULD_PASS) {}
+
+    static void commitCompleted (void* ptr, RTCScene scene, RTCError error)
+    {
+      Completion* completion = (Completion*) ptr;
+      completion->error = error;
+      completion->completed = true;
+    }
+
+    /* the background thread keeps the scene alive until the callback returned */
+    static void commitCompletedRelease (void* ptr, RTCScene scene, RTCError error)
+    {
+      rtcReleaseScene(scene);
+      commitCompleted(ptr,scene,error);
+    }
+
+    static bool equal (const RTCBounds& a, const RTCBounds& b) {
+      return a.lower_x == b.lower_x && a.lower_y == b.lower_y && a.lower_z == b.lower_z &&
+             a.upper_x == b.upper_x && a.upper_y == b.upper_y && a.upper_z == b.upper_z;
+    }
+
+    static unsigned int trace (RTCScene scene, const Vec3fa& pos)
+    {
+      RTCIntersectContext context;
+      rtcInitIntersectContext(&context);
+      RTCRayHit ray = makeRay(pos+Vec3fa(0,10,0),Vec3fa(0,-1,0));
+      rtcIntersect1(scene,&context,&ray);
+      return ray.hit.geomID;
+    }
+
+    /* rays keep hitting the old spheres while the new sphere gets committed in the background, bounds0 are the bounds of the last commit */
+    static bool commitAsync (RTCDevice device, RTCScene scene, const std::vector<std::pair<unsigned int,Vec3fa>>& spheres, const RTCBounds& bounds0)
+    {
+      Completion completion;
+      rtcCommitSceneAsync(scene,commitCompleted,&completion);
+      std::vector<RTCBounds> bounds;
+      while (!completion.completed) {
+        for (size_t i=0; i+1<spheres.size(); i++)
+          if (trace(scene,spheres[i].second) != spheres[i].first) return false;
+        const unsigned int geomID = trace(scene,spheres.back().second);
+        if (geomID != RTC_INVALID_GEOMETRY_ID && geomID != spheres.back().first) return false;
+        bounds.push_back(RTCBounds());
+        rtcGetSceneBounds(scene,&bounds.back());
+      }
+      rtcCommitScene(scene); // waits until the background thread finished
+      if (completion.error != RTC_ERROR_NONE) return false;
+
+      /* the bounds switch over together with the acceleration structures */
+      RTCBounds bounds1; rtcGetSceneBounds(scene,&bounds1);
+      if (bounds1.upper_x < spheres.back().second.x) return false;
+      for (size_t i=0; i<bounds.size(); i++)
+        if (!equal(bounds[i],bounds0) && !equal(bounds[i],bounds1)) return false;
+      return trace(scene,spheres.back().second) == spheres.back().first;
+    }
+
+    VerifyApplication::TestReturnValue run (VerifyApplication* state, bool silent)
+    {
+      std::string cfg = state->rtcore + ",isa="+stringOfISA(isa);
+      RTCDeviceRef device = rtcNewDevice(cfg.c_str());
+      errorHandler(nullptr,rtcGetDeviceError(device));
+      VerifyScene scene(device,SceneFlags(RTC_SCENE_FLAG_NONE,RTC_BUILD_QUALITY_MEDIUM));
+      AssertNoError(device);
+
+      std::vector<std::pair<unsigned int,Vec3fa>> spheres;
+      auto addSphere = [&] () {
+        const Vec3fa pos(3.0f*spheres.size(),0.0f,0.0f);
+        spheres.push_back(std::make_pair(scene.addSphere(sampler,RTC_BUILD_QUALITY_MEDIUM,pos,1.0f,50).first,pos));
+      };
+      
+      addSphere();
+      rtcCommitScene(scene);
+      AssertNoError(device);
+
+      /* the second asynchronous commit releases the front buffer of the first one */
+      for (size_t i=0; i<2; i++) {
+        RTCBounds bounds0; rtcGetSceneBounds(scene,&bounds0);
+        addSphere();
+        if (!commitAsync(device,scene,spheres,bounds0)) return VerifyApplication::FAILED;
+        AssertNoError(device);
+      }
+
+      /* a regular commit switches back to a single buffer */
+      addSphere();
+      rtcCommitScene(scene);
+      AssertNoError(device);
+
+      for (size_t i=0; i<spheres.size(); i++)
+        if (trace(scene,spheres[i].second) != spheres[i].first) return VerifyApplication::FAILED;
+
+      /* ray packets get forwarded to the active buffer as well */
+      RTCBounds bounds0; rtcGetSceneBounds(scene,&bounds0);
+      addSphere();
+      if (!commitAsync(device,scene,spheres,bounds0)) return VerifyApplication::FAILED;
+      
+      RTCIntersectContext context;
+      rtcInitIntersectContext(&context);
+      RTCRayHit4 ray4;
+      for (size_t i=0; i<4; i++)
+        setRay(ray4,i,makeRay(spheres[i+1].second+Vec3fa(0,10,0),Vec3fa(0,-1,0)));
+      __aligned(16) int valid4[4] = { -1,-1,-1,-1 };
+      rtcIntersect4(valid4,scene,&context,&ray4);
+      for (size_t i=0; i<4; i++)
+        if (ray4.hit.geomID[i] != spheres[i+1].first) return VerifyApplication::FAILED;
+      AssertNoError(device);
+
+      /* rtcJoinCommitScene returns after the asynchronous commit finished */
+      addSphere();
+      Completion completion;
+      rtcCommitSceneAsync(scene,commitCompleted,&completion);
+      rtcJoinCommitScene(scene);
+      if (!completion.completed || completion.error != RTC_ERROR_NONE) return VerifyApplication::FAILED;
+      if (trace(scene,spheres.back().second) != spheres.back().first) return VerifyApplication::FAILED;
+      AssertNoError(device);
+
+      /* the scene can get released while its asynchronous commit is running */
+      for (size_t i=0; i<2; i++)
+      {
+        RTCScene scene2 = rtcNewScene(device);
+        RTCGeometry geom = rtcNewGeometry(device,RTC_GEOMETRY_TYPE_SPHERE_POINT);
+        Vec4f* vertex = (Vec4f*) rtcSetNewGeometryBuffer(geom,RTC_BUFFER_TYPE_VERTEX,0,RTC_FORMAT_FLOAT4,sizeof(Vec4f),1);
+        *vertex = Vec4f(0.0f,0.0f,0.0f,1.0f);
+        rtcCommitGeometry(geom);
+        rtcAttachGeometry(scene2,geom);
+        rtcReleaseGeometry(geom);
+        Completion completion2;
+        if (i == 0) {
+          rtcCommitSceneAsync(scene2,commitCompleted,&completion2);
+          rtcReleaseScene(scene2);
+        } else {
+          rtcCommitSceneAsync(scene2,commitCompletedRelease,&completion2);
+        }
+        while (!completion2.completed) yield();
+        if (completion2.error != RTC_ERROR_NONE) return VerifyApplication::FAILED;
+      }
+      AssertNoError(device);
+      
+      return VerifyApplication::PASSED;
+    }
+  };
+
+  struct DisplacedGridTest : public VerifyApplication::Test
+  {
+    unsigned int rate;
+
+    DisplacedGridTest (std::string name, int isa, unsigned int rate)
+      : VerifyApplication::Test(name,isa,VerifyApplication::TEST_SHOULD_PASS), rate(rate) {}
+
+    static float displacement(float u) {
+      return 2.0f*u*u;
+    }
+
+    static void displacementFunction(const RTCDisplacementFunctionNArguments* args)
+    {
+      for (unsigned int i=0; i<args->N; i++)
+        args->P_y[i] += displacement(args->u[i]);
+    }
+
+    VerifyApplication::TestReturnValue run (VerifyApplication* state, bool silent)
+    {
+      std::string cfg = state->rtcore + ",isa="+stringOfISA(isa);
+      RTCDeviceRef device = rtcNewDevice(cfg.c_str());
+      errorHandler(nullptr,rtcGetDeviceError(device));
+      RTCSceneRef scene = rtcNewScene(device);
+      AssertNoError(device);
+
+      /* 5x4 cells, such that the last subgrid column only covers a single cell */
+      const unsigned int width = 6, height = 5;
+      RTCGeometry geom = rtcNewGeometry(device, RTC_GEOMETRY_TYPE_GRID);
+      RTCGrid* grid = (RTCGrid*) rtcSetNewGeometryBuffer(geom,RTC_BUFFER_TYPE_GRID,0,RTC_FORMAT_GRID,sizeof(RTCGrid),1);
+      grid[0].startVertexID = 0;
+      grid[0].stride = width;
+      grid[0].width = width;
+      grid[0].height = height;
+      Vec3f* vertices = (Vec3f*) rtcSetNewGeometryBuffer(geom,RTC_BUFFER_TYPE_VERTEX,0,RTC_FORMAT_FLOAT3,sizeof(Vec3f),width*height);
+      for (unsigned int y=0; y<height; y++)
+        for (unsigned int x=0; x<width; x++)
+          vertices[y*width+x] = Vec3f(float(x),0.0f,float(y));
+      rtcSetGeometryDisplacementFunction(geom,displacementFunction);
+      rtcSetGeometryTessellationRate(geom,float(rate));
+      rtcCommitGeometry(geom);
+      rtcAttachGeometry(scene,geom);
+      rtcReleaseGeometry(geom);
+      rtcCommitScene(scene);
+      AssertNoError(device);
+
+      /* the refined grid approximates the displaced surface up to the linear interpolation error */
+      const float ddh = 4.0f/float((width-1)*(width-1));
+      const float eps = ddh/(8.0f*float(rate*rate)) + 1E-3f;
+      RTCIntersectContext context;
+      rtcInitIntersectContext(&context);
+      for (size_t i=0; i<64; i++)
+      {
+        /* packets of vertical rays and of oblique rays that aim at a point of the surface */
+        RTCRayHit rays[4];
+        Vec3fa targets[4];
+        for (size_t k=0; k<4; k++)
+        {
+          const float x = random_float()*float(width-1);
+          const float z = random_float()*float(height-1);
+          targets[k] = Vec3fa(x,displacement(x/float(width-1)),z);
+          const Vec3fa dir = k < 2 ? Vec3fa(0,-1,0) : normalize(Vec3fa(2.0f*random_float()-1.0f,-1.0f,2.0f*random_float()-1.0f));
+          rays[k] = makeRay(targets[k]-10.0f*dir,dir);
+        }
+
+        for (size_t k=0; k<4; k++)
+        {
+          RTCRayHit ray = rays[k];
+          rtcIntersect1(scene,&context,&ray);
+          if (ray.hit.geomID == RTC_INVALID_GEOMETRY_ID) return VerifyApplication::FAILED;
+          if (ray.ray.tfar > 10.0f+eps) return VerifyApplication::FAILED;
+
+          /* the hit lies on the displaced surface, vertical rays hit at the expected distance and UVs */
+          const Vec3fa hit = Vec3fa(ray.ray.org_x,ray.ray.org_y,ray.ray.org_z) + ray.ray.tfar*Vec3fa(ray.ray.dir_x,ray.ray.dir_y,ray.ray.dir_z);
+          if (std::abs(hit.y-displacement(hit.x/float(width-1))) > eps) return VerifyApplication::FAILED;
+          if (k < 2)
+          {
+            const float u = targets[k].x/float(width-1);
+            const float v = targets[k].z/float(height-1);
+            if (std::abs(ray.ray.tfar-10.0f) > eps) return VerifyApplication::FAILED;
+            if (std::abs(ray.hit.u-u) > 1E-3f || std::abs(ray.hit.v-v) > 1E-3f) return VerifyApplication::FAILED;
+          }
+
+          RTCRay shadow = rays[k].ray;
+          rtcOccluded1(scene,&context,&shadow);
+          if (shadow.tfar != float(neg_inf)) return VerifyApplication::FAILED;
+          rays[k].ray.tfar = ray.ray.tfar;
+        }
+
+        /* packets with inactive rays find the same hits as single rays */
+        RTCRayHit4 ray4;
+        RTCRayHit4 shadow4;
+        for (size_t k=0; k<4; k++) {
+          RTCRayHit ray = rays[k];
+          ray.ray.tfar = float(inf);
+          setRay(ray4,k,ray);
+          setRay(shadow4,k,ray);
+        }
+        __aligned(16) int valid4[4] = { -1,-1,-1,-1 };
+        valid4[i%4] = 0;
+        rtcIntersect4(valid4,scene,&context,&ray4);
+        rtcOccluded4(valid4,scene,&context,&shadow4.ray);
+        for (size_t k=0; k<4; k++)
+        {
+          if (!valid4[k]) continue;
+          if (std::abs(ray4.ray.tfar[k]-rays[k].ray.tfar) > 1E-4f) return VerifyApplication::FAILED;
+          if (shadow4.ray.tfar[k] != float(neg_inf)) return VerifyApplication::FAILED;
+        }
+      }
+      AssertNoError(device);
+
+      return VerifyApplication::PASSED;
+    }
+  };
+
+  struct FusedBinningTest : public VerifyApplication::Test
+  {
+    bool quads;
+
+    FusedBinningTest (std::string name, int isa, bool quads)
+      : VerifyApplication::Test(name,isa,VerifyApplication::TEST_SHOULD_PASS), quads(quads) {}
+
+    VerifyApplication::TestReturnValue run (VerifyApplication* state, bool silent)
+    {
+      std::string cfg = state->rtcore + ",isa="+stringOfISA(isa);
+      RTCDeviceRef device = rtcNewDevice(cfg.c_str());
+      errorHandler(nullptr,rtcGetDeviceError(device));
+
+      /* large enough for the builder to bin child ranges while partitioning */
+      VerifyScene scene(device,SceneFlags(RTC_SCENE_FLAG_NONE,RTC_BUILD_QUALITY_MEDIUM));
+      unsigned int geomID = quads
+        ? scene.addQuadSphere(sampler,RTC_BUILD_QUALITY_MEDIUM,Vec3fa(0,0,0),1.0f,256).first
+        : scene.addSphere(sampler,RTC_BUILD_QUALITY_MEDIUM,Vec3fa(0,0,0),1.0f,256).first;
+      const size_t bytes0 = rtcGetDeviceProperty(device,RTC_DEVICE_PROPERTY_BUILD_PRIMREF_BYTES);
+      rtcCommitScene (scene);
+      const size_t bytes1 = rtcGetDeviceProperty(device,RTC_DEVICE_PROPERTY_BUILD_PRIMREF_BYTES);
+      AssertNoError(device);
+      if (bytes1 <= bytes0) return VerifyApplication::FAILED;
+
+      RTCIntersectContext context;
+      rtcInitIntersectContext(&context);
+
+      for (size_t i=0; i<1000; i++)
+      {
+        const float u = 2.0f*random_float()-1.0f;
+        const float phi = 2.0f*float(pi)*random_float();
+        const float s = sqrt(max(0.0f,1.0f-u*u));
+        const Vec3fa dir(s*cos(phi),s*sin(phi),u);
+        RTCRayHit ray = makeRay(10.0f*dir,-dir);
+        rtcIntersect1(scene,&context,&ray);
+        if (ray.hit.geomID != geomID) return VerifyApplication::FAILED;
+        if (ray.ray.tfar < 8.9f || ray.ray.tfar > 9.01f) return VerifyApplication::FAILED;
+      }
+      AssertNoError(device);
+
+      return VerifyApplication::PASSED;
+    }
+  };
+
+  struct TimeSplitTest : public VerifyApplication::Test
+  {
+    float threshold;
+
+    TimeSplitTest (std::string name, int isa, float threshold)
+      : VerifyApplication::Test(name,isa,VerifyApplication::TEST_SHOULD_PASS), threshold(threshold) {}
+
+    /* builds a grid of spheres and reads the number of nodes and time split nodes from the benchmark output of the build */
+    static bool countNodes(const std::string& cfg, const avector<Vec3fa>& motion_vector, size_t& numNodes, size_t& numTimeSplitNodes)
+    {
+      std::stringstream output;
+      std::streambuf* cout_buf = std::cout.rdbuf(output.rdbuf());
+      {
+        RTCDeviceRef device = rtcNewDevice((cfg+",benchmark=1").c_str());
+        VerifyScene scene(device,SceneFlags(RTC_SCENE_FLAG_NONE,RTC_BUILD_QUALITY_MEDIUM));
+        RandomSampler sampler;
+        RandomSampler_init(sampler,0);
+        for (int x=0; x<4; x++)
+          for (int z=0; z<4; z++)
+            scene.addSphere(sampler,RTC_BUILD_QUALITY_MEDIUM,Vec3fa(3.0f*x,0,3.0f*z),1.0f,20,-1,motion_vector);
+        rtcCommitScene (scene);
+      }
+      std::cout.rdbuf(cout_buf);
+
+      numNodes = numTimeSplitNodes = 0;
+      size_t numBuilds = 0;
+      std::string line;
+      while (std::getline(output,line))
+      {
+        std::stringstream linestream(line);
+        std::string tag; double dt, prims_per_sec, sah; size_t bytes, nodes, timeSplitNodes;
+        if (!(linestream >> tag) || tag != "BENCHMARK_BUILD") continue;
+        if (!(linestream >> dt >> prims_per_sec >> sah >> bytes >> nodes >> timeSplitNodes)) return false;
+        numNodes += nodes;
+        numTimeSplitNodes += timeSplitNodes;
+        numBuilds++;
+      }
+      return numBuilds > 0;
+    }
+
+    VerifyApplication::TestReturnValue run (VerifyApplication* state, bool silent)
+    {
+      RTCIntersectContext context;
+      rtcInitIntersectContext(&context);
+
+      std::string cfg = state->rtcore + ",isa="+stringOfISA(isa)+",time_split_threshold="+std::to_string((long double)threshold);
+      RTCDeviceRef device = rtcNewDevice(cfg.c_str());
+      errorHandler(nullptr,rtcGetDeviceError(device));
+      VerifyScene scene(device,SceneFlags(RTC_SCENE_FLAG_NONE,RTC_BUILD_QUALITY_MEDIUM));
+      AssertNoError(device);
+
+      /* spheres move far compared to their size, thus time splits pay off */
+      avector<Vec3fa> motion_vector;
+      for (size_t t=0; t<5; t++)
+        motion_vector.push_back(Vec3fa(0.0f,0.0f,3.0f*t));
+
+      unsigned geom[4][4];
+      for (int x=0; x<4; x++)
+        for (int z=0; z<4; z++)
+          geom[x][z] = scene.addSphere(sampler,RTC_BUILD_QUALITY_MEDIUM,Vec3fa(3.0f*x,0,3.0f*z),1.0f,20,-1,motion_vector).first;
+      rtcCommitScene (scene);
+      AssertNoError(device);
+
+      for (size_t i=0; i<=8; i++)
+      {
+        const float time = float(i)/8.0f;
+        for (int x=0; x<4; x++)
+        {
+          for (int z=0; z<4; z++)
+          {
+            RTCRayHit ray = makeRay(Vec3fa(3.0f*x,10,3.0f*z+12.0f*time),Vec3fa(0,-1,0));
+            ray.ray.time = time;
+            rtcIntersect1(scene,&context,&ray);
+            if (ray.hit.geomID != geom[x][z]) return VerifyApplication::FAILED;
+          }
+        }
+      }
+      AssertNoError(device);
+
+      /* the adaptive heuristic never splits static geometry in time, even when it has several time steps */
+      if (threshold > 0.0f)
+      {
+        const std::string cfg_never = state->rtcore + ",isa="+stringOfISA(isa)+",time_split_threshold=1e30";
+        avector<Vec3fa> static_vector;
+        for (size_t i=0; i<5; i++) static_vector.push_back(Vec3fa(zero));
+        size_t numNodes = 0, numTimeSplitNodes = 0;
+        size_t numNodesNever = 0, numTimeSplitNodesNever = 0;
+        if (!countNodes(cfg,static_vector,numNodes,numTimeSplitNodes)) return VerifyApplication::FAILED;
+        if (!countNodes(cfg_never,static_vector,numNodesNever,numTimeSplitNodesNever)) return VerifyApplication::FAILED;
+        if (numTimeSplitNodes != 0 || numTimeSplitNodesNever != 0) return VerifyApplication::FAILED;
+        if (numNodes != numNodesNever) return VerifyApplication::FAILED;
+
+        /* moving spheres get split in time */
+        if (!countNodes(cfg,motion_vector,numNodes,numTimeSplitNodes)) return VerifyApplication::FAILED;
+        if (!countNodes(cfg_never,motion_vector,numNodesNever,numTimeSplitNodesNever)) return VerifyApplication::FAILED;
+        if (numTimeSplitNodes == 0 || numTimeSplitNodesNever != 0) return VerifyApplication::FAILED;
+      }
+
+      return VerifyApplication::PASSED;
+    }
+  };
+
+  struct SceneOriginTest : public VerifyApplication::Test
+  {
+    unsigned int numTimeSteps;
+
+    SceneOriginTest (std::string name, int isa, unsigned int numTimeSteps)
+      : VerifyApplication::Test(name,isa,VerifyApplication::TEST_SHOULD_PASS), numTimeSteps(numTimeSteps) {}
+
+    /* traces a ray along the z axis and returns the hit distance, or -1 when the instance is missed */
+    float trace (RTCScene scene, float x)
+    {
+      RTCIntersectContext context;
+      rtcInitIntersectContext(&context);
+      RTCRayHit ray = makeRay(Vec3fa(x,0,0),Vec3fa(0,0,1));
+      ray.ray.time = 0.5f;
+      rtcIntersect1(scene,&context,&ray);
+      if (ray.hit.geomID == RTC_INVALID_GEOMETRY_ID) return -1.0f;
+      return ray.ray.tfar;
+    }
+
+    VerifyApplication::TestReturnValue run (VerifyApplication* state, bool silent)
+    {
+      std::string cfg = state->rtcore + ",isa="+stringOfISA(isa);
+      RTCDeviceRef device = rtcNewDevice(cfg.c_str());
+      errorHandler(nullptr,rtcGetDeviceError(device));
+
+      /* plane at z=0 covering [-1,1]x[-1,1] in the local frame of the instance */
+      VerifyScene child(device,SceneFlags(RTC_SCENE_FLAG_NONE,RTC_BUILD_QUALITY_MEDIUM));
+      child.addPlane(sampler,RTC_BUILD_QUALITY_MEDIUM,4,Vec3fa(-1,-1,0),Vec3fa(2,0,0),Vec3fa(0,2,0));
+      rtcCommitScene(child);
+      AssertNoError(device);
+
+      /* instance and scene origins far away from zero, where float spacing is 8 units */
+      const double instOrigin[3] = { 6378137.3, -4.0E7+0.7, 1.0E8+0.25 };
+      const double sceneOrigin0[3] = { instOrigin[0]-0.1, instOrigin[1]+0.2, instOrigin[2]-5.0 };
+      const double sceneOrigin1[3] = { instOrigin[0]+0.3, instOrigin[1], instOrigin[2]-10.0 };
+
+      VerifyScene scene(device,SceneFlags(RTC_SCENE_FLAG_NONE,RTC_BUILD_QUALITY_MEDIUM));
+      RTCGeometry inst = rtcNewGeometry(device,RTC_GEOMETRY_TYPE_INSTANCE);
+      rtcSetGeometryInstancedScene(inst,child);
+      rtcSetGeometryTimeStepCount(inst,numTimeSteps);
+      const AffineSpace3fa identity(one);
+      for (unsigned int t=0; t<numTimeSteps; t++)
+        rtcSetGeometryTransform(inst,t,RTC_FORMAT_FLOAT4X4_COLUMN_MAJOR,(float*)&identity);
+      rtcSetGeometryInstanceOrigin(inst,instOrigin);
+      rtcCommitGeometry(inst);
+      rtcAttachGeometry(scene,inst);
+      rtcReleaseGeometry(inst);
+      rtcSetSceneOrigin(scene,sceneOrigin0);
+      rtcCommitScene(scene);
+      AssertNoError(device);
+
+      /* the plane is 5 units away and its edge at x=1.1 in the frame of the scene */
+      if (abs(trace(scene,0.0f)-5.0f) > 1E-4f) return VerifyApplication::FAILED;
+      if (abs(trace(scene,1.05f)-5.0f) > 1E-4f) return VerifyApplication::FAILED;
+      if (trace(scene,1.15f) != -1.0f) return VerifyApplication::FAILED;
+      if (trace(scene,-0.95f) != -1.0f) return VerifyApplication::FAILED;
+
+      /* moving the scene origin rebases the instance */
+      rtcSetSceneOrigin(scene,sceneOrigin1);
+      rtcCommitScene(scene);
+      AssertNoError(device);
+      if (abs(trace(scene,0.0f)-10.0f) > 1E-4f) return VerifyApplication::FAILED;
+      if (abs(trace(scene,-1.25f)-10.0f) > 1E-4f) return VerifyApplication::FAILED;
+      if (trace(scene,-1.35f) != -1.0f) return VerifyApplication::FAILED;
+
+      /* the transformation of the instance is not affected by the origins */
+      AffineSpace3fa xfm;
+      rtcGetGeometryTransform(rtcGetGeometry(scene,0),0.5f,RTC_FORMAT_FLOAT4X4_COLUMN_MAJOR,(float*)&xfm);
+      if (xfm.p != Vec3fa(zero)) return VerifyApplication::FAILED;
+      AssertNoError(device);
+
+      /* the instance can get shared by a scene with a different origin */
+      VerifyScene scene2(device,SceneFlags(RTC_SCENE_FLAG_NONE,RTC_BUILD_QUALITY_MEDIUM));
+      rtcAttachGeometry(scene2,rtcGetGeometry(scene,0));
+      rtcSetSceneOrigin(scene2,sceneOrigin0);
+      rtcCommitScene(scene2);
+      AssertNoError(device);
+      if (abs(trace(scene2,1.05f)-5.0f) > 1E-4f) return VerifyApplication::FAILED;
+      if (trace(scene2,-0.95f) != -1.0f) return VerifyApplication::FAILED;
+      if (abs(trace(scene,-1.25f)-10.0f) > 1E-4f) return VerifyApplication::FAILED;
+      if (trace(scene,-1.35f) != -1.0f) return VerifyApplication::FAILED;
+
+      /* the origin of the instanced scene moves the plane in the local frame of the instance */
+      const double childOrigin[3] = { 0.5, 0.0, -2.0 };
+      rtcSetSceneOrigin(child,childOrigin);
+      rtcCommitScene(child);
+      rtcCommitGeometry(rtcGetGeometry(scene,0));
+      rtcCommitScene(scene);
+      rtcCommitScene(scene2);
+      AssertNoError(device);
+      if (abs(trace(scene,1.15f)-8.0f) > 1E-4f) return VerifyApplication::FAILED;
+      if (trace(scene,1.25f) != -1.0f) return VerifyApplication::FAILED;
+      if (trace(scene,-0.85f) != -1.0f) return VerifyApplication::FAILED;
+      if (abs(trace(scene2,1.55f)-3.0f) > 1E-4f) return VerifyApplication::FAILED;
+      if (trace(scene2,-0.45f) != -1.0f) return VerifyApplication::FAILED;
+
+      return VerifyApplication::PASSED;
+    }
+  };
+
+#if RTC_MIN_WIDTH
+  struct CurveLODTest : public VerifyApplication::Test
+  {
+    CurveLODTest (std::string name, int isa)
+      : VerifyApplication::Test(name,isa,VerifyApplication::TEST_SHOULD_PASS) {}
+
+    VerifyApplication::TestReturnValue run (VerifyApplication* state, bool silent)
+    {
+      std::string cfg = state->rtcore + ",isa="+stringOfISA(isa);
+      RTCDeviceRef device = rtcNewDevice(cfg.c_str());
+      errorHandler(nullptr,rtcGetDeviceError(device));
+      RTCDeviceRef deviceLOD = rtcNewDevice((cfg+",curve_lod_scale=1").c_str());
+      errorHandler(nullptr,rtcGetDeviceError(deviceLOD));
+
+      Ref<SceneGraph::Node> hair = SceneGraph::createHairyPlane(RandomSampler_getInt(sampler),Vec3fa(0,0,0),Vec3fa(1,0,0),Vec3fa(0,0,1),0.2f,0.01f,1000,SceneGraph::ROUND_CURVE);
+      VerifyScene scene(device,SceneFlags(RTC_SCENE_FLAG_NONE,RTC_BUILD_QUALITY_MEDIUM));
+      VerifyScene sceneLOD(deviceLOD,SceneFlags(RTC_SCENE_FLAG_NONE,RTC_BUILD_QUALITY_MEDIUM));
+      scene.addGeometry(RTC_BUILD_QUALITY_MEDIUM,hair);
+      unsigned geomID = sceneLOD.addGeometry(RTC_BUILD_QUALITY_MEDIUM,hair);
+      rtcCommitScene (scene);
+      rtcCommitScene (sceneLOD);
+      AssertNoError(device);
+      AssertNoError(deviceLOD);
+
+      /* without ray footprint the full resolution curves get intersected */
+      RTCIntersectContext context;
+      rtcInitIntersectContext(&context);
+      for (size_t i=0; i<100; i++)
+      {
+        const Vec3fa org(RandomSampler_get1D(sampler),1.0f,RandomSampler_get1D(sampler));
+        RTCRayHit ray0 = makeRay(org,Vec3fa(0,-1,0));
+        RTCRayHit ray1 = makeRay(org,Vec3fa(0,-1,0));
+        rtcIntersect1(scene,&context,&ray0);
+        rtcIntersect1(sceneLOD,&context,&ray1);
+        if (ray0.hit.geomID != ray1.hit.geomID) return VerifyApplication::FAILED;
+        if (ray0.hit.primID != ray1.hit.primID) return VerifyApplication::FAILED;
+        if (ray0.ray.tfar != ray1.ray.tfar) return VerifyApplication::FAILED;
+      }
+
+      /* distant rays with a large footprint hit the approximation near the hair */
+      context.minWidthDistanceFactor = 0.01f;
+      size_t numHits = 0;
+      for (size_t i=0; i<100; i++)
+      {
+        const Vec3fa org(0.25f+0.5f*RandomSampler_get1D(sampler),1000.0f,0.25f+0.5f*RandomSampler_get1D(sampler));
+        RTCRayHit ray = makeRay(org,Vec3fa(0,-1,0));
+        rtcIntersect1(sceneLOD,&context,&ray);
+        if (ray.hit.geomID == RTC_INVALID_GEOMETRY_ID) continue;
+        if (ray.hit.geomID != geomID) return VerifyApplication::FAILED;
+        if (ray.ray.tfar < 999.0f || ray.ray.tfar > 1001.0f) return VerifyApplication::FAILED;
+        numHits++;
+      }
+      if (numHits == 0) return VerifyApplication::FAILED;
+      AssertNoError(deviceLOD);
+
+      return VerifyApplication::PASSED;
+    }
+  };
+
+  struct PointLODTest : public VerifyApplication::Test
+  {
+    PointLODTest (std::string name, int isa)
+      : VerifyApplication::Test(name,isa,VerifyApplication::TEST_SHOULD_PASS) {}
+
+    static unsigned addPoints(RTCDevice device, RTCScene scene, size_t numPoints)
+    {
+      RTCGeometry geom = rtcNewGeometry(device, RTC_GEOMETRY_TYPE_SPHERE_POINT);
+      Vec4f* vertices = (Vec4f*) rtcSetNewGeometryBuffer(geom, RTC_BUFFER_TYPE_VERTEX, 0, RTC_FORMAT_FLOAT4, sizeof(Vec4f), numPoints);
+      RandomSampler points;
+      RandomSampler_init(points,23);
+      for (size_t i=0; i<numPoints; i++) {
+        const float r = 0.002f + 0.003f*RandomSampler_get1D(points);
+        vertices[i] = Vec4f(RandomSampler_get1D(points),0.0f,RandomSampler_get1D(points),r);
+      }
+      rtcCommitGeometry(geom);
+      unsigned geomID = rtcAttachGeometry(scene,geom);
+      rtcReleaseGeometry(geom);
+      return geomID;
+    }
+
+    VerifyApplication::TestReturnValue run (VerifyApplication* state, bool silent)
+    {
+      std::string cfg = state->rtcore + ",isa="+stringOfISA(isa);
+      RTCDeviceRef device = rtcNewDevice(cfg.c_str());
+      errorHandler(nullptr,rtcGetDeviceError(device));
+      RTCDeviceRef deviceLOD = rtcNewDevice((cfg+",curve_lod_scale=1").c_str());
+      errorHandler(nullptr,rtcGetDeviceError(deviceLOD));
+
+      const size_t numPoints = 10000;
+      RTCSceneRef scene = rtcNewScene(device);
+      RTCSceneRef sceneLOD = rtcNewScene(deviceLOD);
+      addPoints(device,scene,numPoints);
+      unsigned geomID = addPoints(deviceLOD,sceneLOD,numPoints);
+      rtcCommitScene (scene);
+      rtcCommitScene (sceneLOD);
+      AssertNoError(device);
+      AssertNoError(deviceLOD);
+
+      /* without ray footprint the full resolution points get intersected */
+      RTCIntersectContext context;
+      rtcInitIntersectContext(&context);
+      for (size_t i=0; i<100; i++)
+      {
+        const Vec3fa org(RandomSampler_get1D(sampler),1.0f,RandomSampler_get1D(sampler));
+        RTCRayHit ray0 = makeRay(org,Vec3fa(0,-1,0));
+        RTCRayHit ray1 = makeRay(org,Vec3fa(0,-1,0));
+        rtcIntersect1(scene,&context,&ray0);
+        rtcIntersect1(sceneLOD,&context,&ray1);
+        if (ray0.hit.geomID != ray1.hit.geomID) return VerifyApplication::FAILED;
+        if (ray0.hit.primID != ray1.hit.primID) return VerifyApplication::FAILED;
+        if (ray0.ray.tfar != ray1.ray.tfar) return VerifyApplication::FAILED;
+      }
+
+      /* distant rays with a large footprint hit the proxy spheres near the point cloud */
+      context.minWidthDistanceFactor = 0.01f;
+      size_t numHits = 0;
+      for (size_t i=0; i<100; i++)
+      {
+        const Vec3fa org(0.25f+0.5f*RandomSampler_get1D(sampler),1000.0f,0.25f+0.5f*RandomSampler_get1D(sampler));
+        RTCRayHit ray = makeRay(org,Vec3fa(0,-1,0));
+        rtcIntersect1(sceneLOD,&context,&ray);
+        if (ray.hit.geomID == RTC_INVALID_GEOMETRY_ID) continue;
+        if (ray.hit.geomID != geomID) return VerifyApplication::FAILED;
+        if (ray.hit.primID >= numPoints) return VerifyApplication::FAILED;
+        if (ray.ray.tfar < 999.0f || ray.ray.tfar > 1001.0f) return VerifyApplication::FAILED;
+        numHits++;
+      }
+      if (numHits == 0) return VerifyApplication::FAILED;
+      AssertNoError(deviceLOD);
+
+      return VerifyApplication::PASSED;
+    }
+  };
+#endif
+
+  struct PointCompressionTest : public VerifyApplication::Test
+  {
+    RTCGeometryType gtype;
+
+    PointCompressionTest (std::string name, int isa, RTCGeometryType gtype)
+      : VerifyApplication::Test(name,isa,VerifyApplication::TEST_SHOULD_PASS), gtype(gtype) {}
+
+    static std::atomic<ssize_t> bytes_used;
+
+    static bool memoryMonitor(void* userPtr, const ssize_t bytes, const bool /*post*/)
+    {
+      bytes_used += bytes;
+      return true;
+    }
+
+    /* returns the number of bytes the scene keeps after the build, the shared vertex buffer is not counted */
+    ssize_t build(RTCDevice device, RTCScene scene, const std::vector<Vec4f>& points)
+    {
+      RTCGeometry geom = rtcNewGeometry(device, gtype);
+      rtcSetSharedGeometryBuffer(geom, RTC_BUFFER_TYPE_VERTEX, 0, RTC_FORMAT_FLOAT4, points.data(), 0, sizeof(Vec4f), points.size());
+      rtcCommitGeometry(geom);
+      rtcAttachGeometry(scene,geom);
+      rtcReleaseGeometry(geom);
+      const ssize_t bytes0 = bytes_used;
+      rtcCommitScene(scene);
+      return bytes_used-bytes0;
+    }
+
+    VerifyApplication::TestReturnValue run (VerifyApplication* state, bool silent)
+    {
+      std::string cfg = state->rtcore + ",isa="+stringOfISA(isa);
+      RTCDeviceRef device = rtcNewDevice(cfg.c_str());
+      errorHandler(nullptr,rtcGetDeviceError(device));
+      RTCDeviceRef deviceCompressed = rtcNewDevice((cfg+",point_compression=1").c_str());
+      errorHandler(nullptr,rtcGetDeviceError(deviceCompressed));
+      rtcSetDeviceMemoryMonitorFunction(device,memoryMonitor,nullptr);
+      rtcSetDeviceMemoryMonitorFunction(deviceCompressed,memoryMonitor,nullptr);
+
+      /* four distinct radii are stored exactly in the radius palette,
+       * random heights avoid equally distant discs */
+      const size_t numPoints = 200000;
+      std::vector<Vec4f> points(numPoints);
+      for (size_t i=0; i<numPoints; i++) {
+        const float x = RandomSampler_get1D(sampler);
+        const float y = 0.1f*RandomSampler_get1D(sampler);
+        const float z = RandomSampler_get1D(sampler);
+        points[i] = Vec4f(x,y,z,0.0002f*float(1+(i%4)));
+      }
+
+      RTCSceneRef scene = rtcNewScene(device);
+      RTCSceneRef sceneCompressed = rtcNewScene(deviceCompressed);
+      const ssize_t bytes = build(device,scene,points);
+      const ssize_t bytesCompressed = build(deviceCompressed,sceneCompressed,points);
+      AssertNoError(device);
+      AssertNoError(deviceCompressed);
+
+      /* compressed leaves have to be smaller than the regular BVH and
+       * the vertex data the regular leaves read during traversal */
+      const ssize_t bytesVertices = numPoints*sizeof(Vec4f);
+      if (bytesCompressed >= bytes) return VerifyApplication::FAILED;
+      if (2*bytesCompressed >= bytes+bytesVertices) return VerifyApplication::FAILED;
+
+      /* rays towards the point centers hit the same points with dequantized positions */
+      RTCIntersectContext context;
+      rtcInitIntersectContext(&context);
+      size_t numHits = 0;
+      for (size_t i=0; i<1000; i+=4)
+      {
+        RTCRayHit ray[4];
+        RTCRayHit4 ray4;
+        for (size_t j=0; j<4; j++)
+        {
+          const Vec4f& p = points[(i+j)*(numPoints/1000)];
+          const Vec3fa org(p.x,1.0f,p.z);
+          RTCRayHit ray0 = makeRay(org,Vec3fa(0,-1,0));
+          ray[j] = makeRay(org,Vec3fa(0,-1,0));
+          setRay(ray4,j,ray[j]);
+          rtcIntersect1(scene,&context,&ray0);
+          rtcIntersect1(sceneCompressed,&context,&ray[j]);
+          if (ray0.hit.geomID != ray[j].hit.geomID) return VerifyApplication::FAILED;
+          if (ray0.hit.primID != ray[j].hit.primID) return VerifyApplication::FAILED;
+          if (abs(ray0.ray.tfar-ray[j].ray.tfar) > 1E-4f) return VerifyApplication::FAILED;
+          numHits += ray0.hit.geomID != RTC_INVALID_GEOMETRY_ID;
+        }
+        __aligned(16) int valid4[4] = { -1,-1,-1,-1 };
+        rtcIntersect4(valid4,sceneCompressed,&context,&ray4);
+        for (size_t j=0; j<4; j++) {
+          if (ray4.hit.primID[j] != ray[j].hit.primID) return VerifyApplication::FAILED;
+          if (ray4.ray.tfar[j] != ray[j].ray.tfar) return VerifyApplication::FAILED;
+        }
+      }
+      if (numHits != 1000) return VerifyApplication::FAILED;
+      AssertNoError(deviceCompressed);
+
+      return VerifyApplication::PASSED;
+    }
+  };
+
+  std::atomic<ssize_t> PointCompressionTest::bytes_used(0);
+
+  struct OverlappingGeometryTest : public VerifyApplication::Test
+  {
+    SceneFlags sflags;
+    RTCBuildQuality quality; 
+    size_t N;
+    
+    OverlappingGeometryTest (std::string name, int isa, SceneFlags sflags, RTCBuildQuality quality, size_t N)
+      : VerifyApplication::Test(name,isa,VerifyApplication::TEST_SHOULD_PASS), sflags(sflags), quality(quality), N(N) {}
+    
+    VerifyApplication::TestReturnValue run(VerifyApplication* state, bool silent)
+    {
+      std::string cfg = state->rtcore + ",isa="+stringOfISA(isa);
+      RTCDeviceRef device = rtcNewDevice(cfg.c_str());
+      errorHandler(nullptr,rtcGetDeviceError(device));
+      VerifyScene scene(device,sflags);
+      AssertNoError(device);
+
+      const Vec3fa p (0,0,0);
+      const Vec3fa dx(1,0,0);
+      const Vec3fa dy(0,1,0);
+      
+      Ref<SceneGraph::TriangleMeshNode> trimesh = SceneGraph::createTrianglePlane(p,dx,dy,1,1).dynamicCast<SceneGraph::TriangleMeshNode>();
+      for (size_t i=0; i<N; i++) trimesh->triangles.push_back(trimesh->triangles.back());
+      scene.addGeometry(quality,trimesh.dynamicCast<SceneGraph::Node>());
+
+      Ref<SceneGraph::TriangleMeshNode> trimesh2 = SceneGraph::createTrianglePlane(p,dx,dy,1,1)->set_motion_vector(random_motion_vector(1.0f)).dynamicCast<SceneGraph::TriangleMeshNode>();
+      for (size_t i=0; i<N; i++) trimesh2->triangles.push_back(trimesh2->triangles.back());
+      scene.addGeometry(quality,trimesh2.dynamicCast<SceneGraph::Node>());
+
+      Ref<SceneGraph::QuadMeshNode> quadmesh = SceneGraph::createQuadPlane(p,dx,dy,1,1).dynamicCast<SceneGraph::QuadMeshNode>();
+      for (size_t i=0; i<N; i++) quadmesh->quads.push_back(quadmesh->quads.back());
+      scene.addGeometry(quality,quadmesh.dynamicCast<SceneGraph::Node>());
+
+      Ref<SceneGraph::QuadMeshNode> quadmesh2 = SceneGraph::createQuadPlane(p,dx,dy,1,1)->set_motion_vector(random_motion_vector(1.0f)).dynamicCast<SceneGraph::QuadMeshNode>();
+      for (size_t i=0; i<N; i++) quadmesh2->quads.push_back(quadmesh2->quads.back());
+      scene.addGeometry(quality,quadmesh2.dynamicCast<SceneGraph::Node>());
+
+      Ref<SceneGraph::GridMeshNode> gridmesh = SceneGraph::createGridPlane(p,dx,dy,1,1).dynamicCast<SceneGraph::GridMeshNode>();
+      for (size_t i=0; i<N; i++) gridmesh->grids.push_back(gridmesh->grids.back());
+      scene.addGeometry(quality,gridmesh.dynamicCast<SceneGraph::Node>());
+
+      Ref<SceneGraph::GridMeshNode> gridmesh2 = SceneGraph::createGridPlane(p,dx,dy,1,1)->set_motion_vector(random_motion_vector(1.0f)).dynamicCast<SceneGraph::GridMeshNode>();
+      for (size_t i=0; i<N; i++) gridmesh2->grids.push_back(gridmesh2->grids.back());
+      scene.addGeometry(quality,gridmesh2.dynamicCast<SceneGraph::Node>());
+      
+      Ref<SceneGraph::SubdivMeshNode> subdivmesh = new SceneGraph::SubdivMeshNode(nullptr,BBox1f(0,1),1);
+      for (unsigned i=0; i<unsigned(N); i++) {
+        subdivmesh->verticesPerFace.push_back(4);
+        subdivmesh->position_indices.push_back(4*i+0);
+        subdivmesh->position_indices.push_back(4*i+1);
+        subdivmesh->position_indices.push_back(4*i+2);
+        subdivmesh->position_indices.push_back(4*i+3);
+        subdivmesh->positions[0].push_back(Vec3fa(0,0,0));
+        subdivmesh->positions[0].push_back(Vec3fa(0,1,0));
+        subdivmesh->positions[0].push_back(Vec3fa(1,1,0));
+        subdivmesh->positions[0].push_back(Vec3fa(1,0,0));
+      }
+      scene.addGeometry(quality,subdivmesh.dynamicCast<SceneGraph::Node>());
+
+      Ref<SceneGraph::SubdivMeshNode> subdivmesh2 = new SceneGraph::SubdivMeshNode(nullptr,BBox1f(0,1),1);
+      for (unsigned i=0; i<unsigned(N); i++) {
+        subdivmesh2->verticesPerFace.push_back(4);
+        subdivmesh2->position_indices.push_back(4*i+0);
+        subdivmesh2->position_indices.push_back(4*i+1);
+        subdivmesh2->position_indices.push_back(4*i+2);
+        subdivmesh2->position_indices.push_back(4*i+3);
+        subdivmesh2->positions[0].push_back(Vec3fa(0,0,0));
+        subdivmesh2->positions[0].push_back(Vec3fa(0,1,0));
+        subdivmesh2->positions[0].push_back(Vec3fa(1,1,0));
+        subdivmesh2->positions[0].push_back(Vec3fa(1,0,0));
+      }
+      subdivmesh2->set_motion_vector(random_motion_vector(1.0f));
+      scene.addGeometry(quality,subdivmesh2.dynamicCast<SceneGraph::Node>());
+      
+      Ref<SceneGraph::HairSetNode> hairgeom = SceneGraph::createHairyPlane(RandomSampler_getInt(sampler),p,dx,dy,0.2f,0.01f,1,SceneGraph::FLAT_CURVE).dynamicCast<SceneGraph::HairSetNode>();
+      for (size_t i=0; i<N; i++) hairgeom->hairs.push_back(hairgeom->hairs.back());
+      scene.addGeometry(quality,hairgeom.dynamicCast<SceneGraph::Node>());
+
+      Ref<SceneGraph::HairSetNode> hairgeom2 = SceneGraph::createHairyPlane(RandomSampler_getInt(sampler),p,dx,dy,0.2f,0.01f,1,SceneGraph::FLAT_CURVE)->set_motion_vector(random_motion_vector(1.0f)).dynamicCast<SceneGraph::HairSetNode>();
+      for (size_t i=0; i<N; i++) hairgeom2->hairs.push_back(hairgeom2->hairs.back());
+      scene.addGeometry(quality,hairgeom2.dynamicCast<SceneGraph::Node>());
+
+      Ref<SceneGraph::Node> curvegeom = SceneGraph::convert_flat_to_round_curves(hairgeom.dynamicCast<SceneGraph::Node>());
+      scene.addGeometry(quality,curvegeom);
+
+      Ref<SceneGraph::Node> curvegeom2 = SceneGraph::convert_flat_to_round_curves(hairgeom2.dynamicCast<SceneGraph::Node>());
+      scene.addGeometry(quality,curvegeom2);
+
+      Ref<SceneGraph::Node> linegeom = SceneGraph::convert_bezier_to_lines(hairgeom.dynamicCast<SceneGraph::Node>());
+      scene.addGeometry(quality,linegeom);
+
+      Ref<SceneGraph::Node> linegeom2 = SceneGraph::convert_bezier_to_lines(hairgeom2.dynamicCast<SceneGraph::Node>());
+      scene.addGeometry(quality,linegeom2);
+      
+      rtcCommitScene (scene);
+      AssertNoError(device);
+      return VerifyApplication::PASSED;
+    }
+  };
+
+  static std::atomic<ssize_t> memory_consumption_bytes_used(0);
+
+  struct MemoryConsumptionTest : public VerifyApplication::Test
+  {
+    GeometryType gtype;
+    SceneFlags sflags;
+    RTCBuildQuality quality;
+    
+    MemoryConsumptionTest (std::string name, int isa, GeometryType gtype, SceneFlags sflags, RTCBuildQuality quality)
+      : VerifyApplication::Test(name,isa,VerifyApplication::TEST_SHOULD_PASS), gtype(gtype), sflags(sflags), quality(quality) {}
+
+    static bool memoryMonitor(void* userPtr, const ssize_t bytes, const bool /*post*/)
+    {
+      memory_consumption_bytes_used += bytes;
+      return true;
+    }
+
+    double expected_size_helper(VerifyApplication* state, size_t NN)
+    {
+      bool has_avx = (isa & AVX) == AVX;
+      bool has_avx2 = (isa & AVX2) == AVX2;
+      
+      if (sflags.qflags == RTC_BUILD_QUALITY_LOW)
+      {
+        switch (gtype) {
+        case TRIANGLE_MESH: return has_avx ? 131.0f*NN : 117.0f*NN; // triangle4
+        default: return inf;
+        }
+      }
+      else
+      {
+        switch (gtype)
+        {
+        case TRIANGLE_MESH: switch (sflags.sflags) {
+          case RTC_SCENE_FLAG_NONE: return has_avx ?  70.0f*NN :  63.0f*NN; // triangle4
+          case RTC_SCENE_FLAG_ROBUST : return has_avx ?  70.0f*NN :  63.0f*NN; // triangle4v
+          case RTC_SCENE_FLAG_COMPACT: return has_avx ?  35.0f*NN :  35.0f*NN; // triangle4i
+          default: return inf;
+          }
+          
+          
+        case TRIANGLE_MESH_MB: switch (sflags.sflags) {
+          case RTC_SCENE_FLAG_NONE: return has_avx2 ? 55.0f*NN : 45.0f*NN; // triangle4imb
+          case RTC_SCENE_FLAG_ROBUST : return has_avx2 ? 55.0f*NN : 45.0f*NN; // triangle4imb
+          case RTC_SCENE_FLAG_COMPACT: return has_avx2 ? 45.0f*NN : 45.0f*NN; // triangle4imb
+          default: return inf;
+          }
+          
+        case QUAD_MESH: switch (sflags.sflags) {
+          case RTC_SCENE_FLAG_NONE: return has_avx ? 85.0f*NN : 79.0f*NN; // quad4v
+          case RTC_SCENE_FLAG_ROBUST : return has_avx ? 85.0f*NN : 79.0f*NN; // quad4v
+          case RTC_SCENE_FLAG_COMPACT: return has_avx ? 41.0f*NN : 41.0f*NN; // quad4i
+          default: return inf;
+          }
+        case QUAD_MESH_MB: switch (sflags.sflags) {
+          case RTC_SCENE_FLAG_NONE: return has_avx ? 68.0f*NN : 53.0f*NN; // quad4imb
+          case RTC_SCENE_FLAG_ROBUST : return has_avx ? 68.0f*NN : 53.0f*NN; // quad4imb
+          case RTC_SCENE_FLAG_COMPACT: return has_avx ? 53.0f*NN : 53.0f*NN; // quad4imb
+          default: return inf;
+          }
           
         case BEZIER_GEOMETRY: switch (sflags.sflags) {
           case RTC_SCENE_FLAG_NONE: return has_avx2 ?  222.0f*NN : 165.0f*NN; // bezier1v
@@ -1524,120 +2810,658 @@ namespace embree
   {
     SceneFlags sflags;
 
-    NewDeleteGeometryTest (std::string name, int isa, SceneFlags sflags)
-      : VerifyApplication::Test(name,isa,VerifyApplication::TEST_SHOULD_PASS), sflags(sflags) {}
-    
+    NewDeleteGeometryTest (std::string name, int isa, SceneFlags sflags)
+      : VerifyApplication::Test(name,isa,VerifyApplication::TEST_SHOULD_PASS), sflags(sflags) {}
+    
+    VerifyApplication::TestReturnValue run(VerifyApplication* state, bool silent)
+    {
+      std::string cfg = state->rtcore + ",isa="+stringOfISA(isa);
+      RTCDeviceRef device = rtcNewDevice(cfg.c_str());
+      errorHandler(nullptr,rtcGetDeviceError(device));
+      VerifyScene scene(device,sflags);
+      AssertNoError(device);
+      unsigned int geom[128];
+      for (size_t i=0; i<128; i++) geom[i] = -1;
+      Sphere spheres[128];
+      memset(spheres,0,sizeof(spheres));
+      
+      for (size_t i=0; i<size_t(50*state->intensity); i++) 
+      {
+        for (size_t j=0; j<10; j++) {
+          int index = random_int()%128;
+          Vec3fa pos = 100.0f*random_Vec3fa();
+          if (geom[index] == -1) {
+            switch (random_int()%11) {
+            case 0: geom[index] = scene.addSphere(sampler,RTC_BUILD_QUALITY_MEDIUM,pos,2.0f,10).first; break;
+            case 1: geom[index] = scene.addSphere(sampler,RTC_BUILD_QUALITY_MEDIUM,pos,2.0f,10,-1,random_motion_vector(1.0f)).first; break;
+            case 2: geom[index] = scene.addQuadSphere(sampler,RTC_BUILD_QUALITY_MEDIUM,pos,2.0f,10).first; break;
+            case 3: geom[index] = scene.addQuadSphere(sampler,RTC_BUILD_QUALITY_MEDIUM,pos,2.0f,10,-1,random_motion_vector(1.0f)).first; break;
+            case 4: geom[index] = scene.addGridSphere(sampler,RTC_BUILD_QUALITY_MEDIUM,pos,2.0f,10).first; break;
+            case 5: geom[index] = scene.addGridSphere(sampler,RTC_BUILD_QUALITY_MEDIUM,pos,2.0f,10,-1,random_motion_vector(1.0f)).first; break;
+            case 6: geom[index] = scene.addHair(sampler,RTC_BUILD_QUALITY_MEDIUM,pos,1.0f,2.0f,10).first; break;
+            case 7: geom[index] = scene.addHair(sampler,RTC_BUILD_QUALITY_MEDIUM,pos,1.0f,2.0f,10,random_motion_vector(1.0f)).first; break;
+            case 8: geom[index] = scene.addSubdivSphere(sampler,RTC_BUILD_QUALITY_MEDIUM,pos,2.0f,4,4).first; break;
+            case 9: geom[index] = scene.addSubdivSphere(sampler,RTC_BUILD_QUALITY_MEDIUM,pos,2.0f,4,4,-1,random_motion_vector(1.0f)).first; break;
+            case 10: 
+              spheres[index] = Sphere(pos,2.0f);
+              geom[index] = scene.addUserGeometryEmpty(sampler,RTC_BUILD_QUALITY_MEDIUM,&spheres[index]).first; break;
+            }
+            AssertNoError(device);
+          }
+          else { 
+            rtcDetachGeometry(scene,geom[index]);     
+            AssertNoError(device);
+            geom[index] = -1; 
+          }
+        }
+        rtcCommitScene(scene);
+        AssertNoError(device);
+        rtcCommitScene(scene);
+        AssertNoError(device);
+        if (i%2 == 0) std::cout << "." << std::flush;
+      }
+      
+      /* now delete all geometries */
+      for (size_t i=0; i<128; i++) 
+        if (geom[i] != -1) rtcDetachGeometry(scene,geom[i]);
+      rtcCommitScene(scene);
+      AssertNoError(device);
+
+      rtcCommitScene (scene);
+      AssertNoError(device);
+
+      return VerifyApplication::PASSED;
+    }
+  };
+
+  struct UserGeometryIDTest : public VerifyApplication::Test
+  {
+    SceneFlags sflags;
+
+    UserGeometryIDTest (std::string name, int isa, SceneFlags sflags)
+      : VerifyApplication::Test(name,isa,VerifyApplication::TEST_SHOULD_PASS), sflags(sflags) {}
+    
+    VerifyApplication::TestReturnValue run(VerifyApplication* state, bool silent)
+    {
+      std::string cfg = state->rtcore + ",isa="+stringOfISA(isa);
+      RTCDeviceRef device = rtcNewDevice(cfg.c_str());
+      errorHandler(nullptr,rtcGetDeviceError(device));
+      VerifyScene scene(device,sflags);
+      AssertNoError(device);
+
+      int geom[128];
+      for (size_t i=0; i<128; i++) geom[i] = -1;
+      
+      for (size_t i=0; i<size_t(50*state->intensity); i++) 
+      {
+        for (size_t j=0; j<10; j++) 
+        {
+          int index = random_int()%128;
+          if (geom[index] == -1) {
+            if (random_bool()) {
+              RTCGeometry hgeom = rtcNewGeometry(device, RTC_GEOMETRY_TYPE_TRIANGLE);
+              rtcCommitGeometry(hgeom);
+              unsigned int geomID = rtcAttachGeometry(scene,hgeom);
+              rtcReleaseGeometry(hgeom);
+              geom[geomID] = geomID;
+              AssertNoError(device);
+            } else {
+              RTCGeometry hgeom = rtcNewGeometry(device, RTC_GEOMETRY_TYPE_TRIANGLE);
+              rtcCommitGeometry(hgeom);
+              unsigned int geomID = rtcAttachGeometry(scene,hgeom);
+              rtcReleaseGeometry(hgeom);
+              geom[geomID] = geomID;
+              AssertNoError(device);
+            }
+          } else {
+             if (random_bool()) {
+               rtcDetachGeometry(scene,geom[index]);     
+               AssertNoError(device);
+               geom[index] = -1; 
+             }
+          }
+        }
+        rtcCommitScene(scene);
+        AssertNoError(device);
+      }
+      return VerifyApplication::PASSED;
+    }
+  };
+
+  struct DeferredSpheres
+  {
+    DeferredSpheres ()
+      : invocations(0), numRays(0), maxRays(0) {}
+
+    /* counts a callback invocation and the number of valid rays passed to it */
+    void countBatch(const int* valid, unsigned int N)
+    {
+      size_t num = 0;
+      for (unsigned int i=0; i<N; i++)
+        num += valid[i] ? 1 : 0;
+      invocations++;
+      numRays += num;
+      size_t prev = maxRays;
+      while (num > prev && !maxRays.compare_exchange_weak(prev,num));
+    }
+
+    void resetCounters() {
+      invocations = 0; numRays = 0; maxRays = 0;
+    }
+
+    Sphere spheres[64];
+    std::atomic<size_t> invocations; //!< number of callback invocations
+    std::atomic<size_t> numRays;     //!< number of valid rays passed to the callbacks
+    std::atomic<size_t> maxRays;     //!< largest number of valid rays passed to a single invocation
+  };
+
+  void DeferredSpheresBoundsFunc(const struct RTCBoundsFunctionArguments* const args)
+  {
+    const DeferredSpheres* data = (const DeferredSpheres*) args->geometryUserPtr;
+    *(BBox3fa*)args->bounds_o = data->spheres[args->primID].bounds();
+  }
+
+  bool DeferredSpheresIntersect(const Sphere& sphere, RTCRayN* ray, unsigned int N, unsigned int i, float& t)
+  {
+    const Vec3fa org(RTCRayN_org_x(ray,N,i),RTCRayN_org_y(ray,N,i),RTCRayN_org_z(ray,N,i));
+    const Vec3fa dir(RTCRayN_dir_x(ray,N,i),RTCRayN_dir_y(ray,N,i),RTCRayN_dir_z(ray,N,i));
+    const Vec3fa v = org-sphere.pos;
+    const float A = dot(dir,dir);
+    const float B = 2.0f*dot(v,dir);
+    const float C = dot(v,v) - sqr(sphere.r);
+    const float D = B*B - 4.0f*A*C;
+    if (D < 0.0f) return false;
+    t = (-B-sqrt(D))/(2.0f*A);
+    return RTCRayN_tnear(ray,N,i) < t && t < RTCRayN_tfar(ray,N,i);
+  }
+
+  void DeferredSpheresIntersectFuncN(const struct RTCIntersectFunctionNArguments* const args)
+  {
+    DeferredSpheres* data = (DeferredSpheres*) args->geometryUserPtr;
+    data->countBatch(args->valid,args->N);
+    RTCRayN* ray = RTCRayHitN_RayN(args->rayhit,args->N);
+    RTCHitN* hit = RTCRayHitN_HitN(args->rayhit,args->N);
+    for (unsigned int i=0; i<args->N; i++)
+    {
+      float t;
+      if (!args->valid[i] || !DeferredSpheresIntersect(data->spheres[args->primID],ray,args->N,i,t)) continue;
+      RTCRayN_tfar(ray,args->N,i) = t;
+      RTCHitN_geomID(hit,args->N,i) = args->geomID;
+      RTCHitN_primID(hit,args->N,i) = args->primID;
+    }
+  }
+
+  void DeferredSpheresOccludedFuncN(const struct RTCOccludedFunctionNArguments* const args)
+  {
+    DeferredSpheres* data = (DeferredSpheres*) args->geometryUserPtr;
+    data->countBatch(args->valid,args->N);
+    for (unsigned int i=0; i<args->N; i++)
+    {
+      float t;
+      if (!args->valid[i] || !DeferredSpheresIntersect(data->spheres[args->primID],args->ray,args->N,i,t)) continue;
+      RTCRayN_tfar(args->ray,args->N,i) = neg_inf;
+    }
+  }
+
+  void DeferredSpheresSplitFunc(const struct RTCSplitFunctionArguments* const args)
+  {
+    const DeferredSpheres* data = (const DeferredSpheres*) args->geometryUserPtr;
+    const Sphere& sphere = data->spheres[args->primID];
+    const unsigned int dim = args->dimension;
+    const float d = args->position-sphere.pos[dim];
+
+    /* the cap of the sphere on the far side of the split plane from the center is bounded by the disc in the plane */
+    BBox3fa left = sphere.bounds(), right = sphere.bounds();
+    left.upper[dim] = args->position;
+    right.lower[dim] = args->position;
+    BBox3fa& cap = d < 0.0f ? left : right;
+    const float r = sqrt(max(0.0f,sqr(sphere.r)-sqr(d)));
+    for (unsigned int i=0; i<3; i++)
+    {
+      if (i == dim) continue;
+      cap.lower[i] = sphere.pos[i]-r;
+      cap.upper[i] = sphere.pos[i]+r;
+    }
+    const BBox3fa bounds = *(const BBox3fa*)args->bounds;
+    *(BBox3fa*)args->leftBounds_o  = intersect(left,bounds);
+    *(BBox3fa*)args->rightBounds_o = intersect(right,bounds);
+  }
+
+  struct UserGeometrySplitTest : public VerifyApplication::Test
+  {
+    SceneFlags sflags;
+
+    UserGeometrySplitTest (std::string name, int isa, SceneFlags sflags)
+      : VerifyApplication::Test(name,isa,VerifyApplication::TEST_SHOULD_PASS), sflags(sflags) {}
+
+    /* adds user geometries with and without split function, a grid sphere and rotated instances of a triangle sphere */
+    void addGeometries(RTCDevice device, VerifyScene& scene, DeferredSpheres* data, RTCScene child)
+    {
+      for (size_t i=0; i<2; i++)
+      {
+        RTCGeometry geom = rtcNewGeometry (device, RTC_GEOMETRY_TYPE_USER);
+        rtcSetGeometryUserPrimitiveCount(geom,64);
+        rtcSetGeometryUserData(geom,&data[i]);
+        rtcSetGeometryBoundsFunction(geom,DeferredSpheresBoundsFunc,nullptr);
+        if (i == 1) rtcSetGeometrySplitFunction(geom,DeferredSpheresSplitFunc);
+        rtcSetGeometryIntersectFunction(geom,DeferredSpheresIntersectFuncN);
+        rtcSetGeometryOccludedFunction(geom,DeferredSpheresOccludedFuncN);
+        rtcCommitGeometry(geom);
+        rtcAttachGeometry(scene,geom);
+        rtcReleaseGeometry(geom);
+      }
+
+      scene.addGridSphere(sampler,RTC_BUILD_QUALITY_MEDIUM,Vec3fa(4.0f,4.0f,4.0f),3.0f,16);
+
+      for (size_t i=0; i<4; i++)
+      {
+        const AffineSpace3fa xfm = AffineSpace3fa::translate(Vec3fa(2.0f+4.0f*float(i%2),1.0f+2.0f*float(i),2.0f+4.0f*float(i/2)))
+          * AffineSpace3fa::rotate(normalize(Vec3fa(1.0f,float(i),2.0f)),0.7f*float(i+1)) * AffineSpace3fa::scale(Vec3fa(2.0f,0.5f,1.0f));
+        RTCGeometry inst = rtcNewGeometry(device,RTC_GEOMETRY_TYPE_INSTANCE);
+        rtcSetGeometryInstancedScene(inst,child);
+        rtcSetGeometryTransform(inst,0,RTC_FORMAT_FLOAT4X4_COLUMN_MAJOR,(float*)&xfm);
+        rtcCommitGeometry(inst);
+        rtcAttachGeometry(scene,inst);
+        rtcReleaseGeometry(inst);
+      }
+    }
+
+    VerifyApplication::TestReturnValue run(VerifyApplication* state, bool silent)
+    {
+      std::string cfg = state->rtcore + ",isa="+stringOfISA(isa);
+      RTCDeviceRef device = rtcNewDevice(cfg.c_str());
+      errorHandler(nullptr,rtcGetDeviceError(device));
+      AssertNoError(device);
+
+      /* overlapping spheres of different sizes, such that splits cut through many of them */
+      std::unique_ptr<DeferredSpheres[]> data(new DeferredSpheres[2]);
+      for (size_t j=0; j<2; j++)
+        for (size_t i=0; i<64; i++)
+          data[j].spheres[i] = Sphere(Vec3fa(8.0f*random_float(),8.0f*random_float(),8.0f*random_float()),0.2f+0.8f*random_float());
+
+      VerifyScene child(device,SceneFlags(RTC_SCENE_FLAG_NONE,RTC_BUILD_QUALITY_MEDIUM));
+      child.addSphere(sampler,RTC_BUILD_QUALITY_MEDIUM,Vec3fa(0.0f),1.0f,20);
+      rtcCommitScene(child);
+
+      /* the tested scene and an unsplit reference scene hold the same geometries */
+      VerifyScene scene(device,sflags);
+      VerifyScene reference(device,SceneFlags(RTC_SCENE_FLAG_NONE,RTC_BUILD_QUALITY_MEDIUM));
+      addGeometries(device,scene,data.get(),child);
+      addGeometries(device,reference,data.get(),child);
+      rtcCommitScene(scene);
+      rtcCommitScene(reference);
+      AssertNoError(device);
+
+      RTCIntersectContext context;
+      rtcInitIntersectContext(&context);
+      for (size_t i=0; i<1000; i++)
+      {
+        const Vec3fa org(-2.0f+12.0f*random_float(),-2.0f+12.0f*random_float(),-10.0f);
+        const Vec3fa dir(random_float()-0.5f,random_float()-0.5f,1.0f);
+        RTCRayHit ray0 = makeRay(org,dir);
+        RTCRayHit ray1 = makeRay(org,dir);
+        rtcIntersect1(scene,&context,&ray0);
+        rtcIntersect1(reference,&context,&ray1);
+        if (ray0.hit.geomID != ray1.hit.geomID) return VerifyApplication::FAILED;
+        if (ray0.hit.primID != ray1.hit.primID) return VerifyApplication::FAILED;
+        if (ray0.hit.instID[0] != ray1.hit.instID[0]) return VerifyApplication::FAILED;
+        if (std::abs(ray0.ray.tfar-ray1.ray.tfar) > 1E-4f*ray1.ray.tfar) return VerifyApplication::FAILED;
+
+        RTCRayHit shadow0 = makeRay(org,dir); rtcOccluded1(scene,&context,&shadow0.ray);
+        RTCRayHit shadow1 = makeRay(org,dir); rtcOccluded1(reference,&context,&shadow1.ray);
+        if (shadow0.ray.tfar != shadow1.ray.tfar) return VerifyApplication::FAILED;
+      }
+      AssertNoError(device);
+
+      return VerifyApplication::PASSED;
+    }
+  };
+
+  struct DeferredUserGeometryTest : public VerifyApplication::Test
+  {
+    SceneFlags sflags;
+    RTCIntersectContextFlags iflags;
+
+    DeferredUserGeometryTest (std::string name, int isa, SceneFlags sflags, RTCIntersectContextFlags iflags)
+      : VerifyApplication::Test(name,isa,VerifyApplication::TEST_SHOULD_PASS), sflags(sflags), iflags(iflags) {}
+
+    VerifyApplication::TestReturnValue run(VerifyApplication* state, bool silent)
+    {
+      std::string cfg = state->rtcore + ",isa="+stringOfISA(isa);
+      RTCDeviceRef device = rtcNewDevice(cfg.c_str());
+      errorHandler(nullptr,rtcGetDeviceError(device));
+      VerifyScene scene(device,sflags);
+      AssertNoError(device);
+
+      /* two layers of overlapping spheres */
+      std::unique_ptr<DeferredSpheres> data(new DeferredSpheres);
+      for (size_t i=0; i<64; i++)
+        data->spheres[i] = Sphere(Vec3fa(float(i%8),float(i/32),float((i/8)%4)),0.7f);
+
+      RTCGeometry geom = rtcNewGeometry (device, RTC_GEOMETRY_TYPE_USER);
+      rtcSetGeometryUserPrimitiveCount(geom,64);
+      rtcSetGeometryUserData(geom,data.get());
+      rtcSetGeometryBoundsFunction(geom,DeferredSpheresBoundsFunc,nullptr);
+      rtcSetGeometryIntersectFunction(geom,DeferredSpheresIntersectFuncN);
+      rtcSetGeometryOccludedFunction(geom,DeferredSpheresOccludedFuncN);
+      rtcCommitGeometry(geom);
+      rtcAttachGeometry(scene,geom);
+      rtcReleaseGeometry(geom);
+      rtcCommitScene(scene);
+      AssertNoError(device);
+
+      RTCIntersectContext context;
+      rtcInitIntersectContext(&context);
+      context.flags = (RTCIntersectContextFlags) (iflags | RTC_INTERSECT_CONTEXT_FLAG_DEFER_USER_GEOMETRY);
+
+      RTCIntersectContext refcontext;
+      rtcInitIntersectContext(&refcontext);
+
+      /* compare streams with deferred callbacks against single rays */
+      const size_t numRays = 1000;
+      std::vector<RTCRayHit> rays(numRays), refRays(numRays);
+      std::vector<RTCRay> shadows(numRays), refShadows(numRays);
+      for (size_t i=0; i<numRays; i++)
+      {
+        const Vec3fa org(-1.0f+9.0f*RandomSampler_getFloat(sampler),10.0f,-1.0f+5.0f*RandomSampler_getFloat(sampler));
+        const Vec3fa dir(0.1f*RandomSampler_getFloat(sampler)-0.05f,-1.0f,0.1f*RandomSampler_getFloat(sampler)-0.05f);
+        rays[i] = refRays[i] = makeRay(org,dir);
+        shadows[i] = refShadows[i] = makeRay(org,dir).ray;
+      }
+
+      /* coherent streams have to pass the rays that reached the same sphere to the callbacks in batches */
+      bool passed = true;
+      data->resetCounters();
+      rtcIntersect1M(scene,&context,rays.data(),numRays,sizeof(RTCRayHit));
+      passed &= data->invocations > 0;
+      if (iflags == RTC_INTERSECT_CONTEXT_FLAG_COHERENT)
+        passed &= data->maxRays > 1 && data->invocations < data->numRays;
+
+      data->resetCounters();
+      rtcOccluded1M(scene,&context,shadows.data(),numRays,sizeof(RTCRay));
+      passed &= data->invocations > 0;
+      if (iflags == RTC_INTERSECT_CONTEXT_FLAG_COHERENT)
+        passed &= data->maxRays > 1 && data->invocations < data->numRays;
+      AssertNoError(device);
+
+      for (size_t i=0; i<numRays; i++)
+      {
+        rtcIntersect1(scene,&refcontext,&refRays[i]);
+        rtcOccluded1(scene,&refcontext,&refShadows[i]);
+        passed &= rays[i].hit.geomID == refRays[i].hit.geomID;
+        passed &= rays[i].hit.primID == refRays[i].hit.primID;
+        passed &= rays[i].ray.tfar == refRays[i].ray.tfar;
+        passed &= (shadows[i].tfar < 0.0f) == (refShadows[i].tfar < 0.0f);
+      }
+      AssertNoError(device);
+
+      return passed ? VerifyApplication::PASSED : VerifyApplication::FAILED;
+    }
+  };
+
+  struct AdaptiveCoherenceTest : public VerifyApplication::Test
+  {
+    SceneFlags sflags;
+
+    AdaptiveCoherenceTest (std::string name, int isa, SceneFlags sflags)
+      : VerifyApplication::Test(name,isa,VerifyApplication::TEST_SHOULD_PASS), sflags(sflags) {}
+
+    enum StreamType { CAMERA, CONE, RANDOM };
+
+    /* traces a stream of camera rays, a regular grid of rays in a wide cone, or rays with random origins and directions and compares it against single rays */
+    static bool traceStream(RTCScene scene, RandomSampler& sampler, StreamType type, bool occluded)
+    {
+      RTCIntersectContext context;
+      rtcInitIntersectContext(&context);
+      context.flags = RTC_INTERSECT_CONTEXT_FLAG_ADAPTIVE_COHERENCE;
+
+      RTCIntersectContext refcontext;
+      rtcInitIntersectContext(&refcontext);
+
+      const size_t numRays = 256;
+      std::vector<RTCRayHit> rays(numRays), refRays(numRays);
+      for (size_t i=0; i<numRays; i++)
+      {
+        Vec3fa org, dir;
+        if (type == CAMERA) {
+          org = Vec3fa(1.5f,0.0f,-10.0f);
+          dir = Vec3fa(0.4f*RandomSampler_getFloat(sampler)-0.2f,0.4f*RandomSampler_getFloat(sampler)-0.2f,1.0f);
+        } else if (type == CONE) {
+          org = Vec3fa(1.5f,0.0f,-10.0f);
+          dir = Vec3fa(float(i%16)/15.0f*5.0f-2.5f,float(i/16)/15.0f*5.0f-2.5f,1.0f);
+        } else {
+          org = 10.0f*RandomSampler_get3D(sampler) - Vec3fa(5.0f);
+          dir = 2.0f*RandomSampler_get3D(sampler) - Vec3fa(1.0f);
+        }
+        rays[i] = refRays[i] = makeRay(org,dir);
+      }
+
+      if (occluded) rtcOccluded1M(scene,&context,(RTCRay*)rays.data(),numRays,sizeof(RTCRayHit));
+      else          rtcIntersect1M(scene,&context,rays.data(),numRays,sizeof(RTCRayHit));
+
+      bool passed = true;
+      for (size_t i=0; i<numRays; i++)
+      {
+        if (occluded) {
+          rtcOccluded1(scene,&refcontext,&refRays[i].ray);
+          passed &= (rays[i].ray.tfar < 0.0f) == (refRays[i].ray.tfar < 0.0f);
+        } else {
+          rtcIntersect1(scene,&refcontext,&refRays[i]);
+          passed &= rays[i].hit.geomID == refRays[i].hit.geomID;
+          passed &= rays[i].hit.primID == refRays[i].hit.primID;
+        }
+      }
+      return passed;
+    }
+
     VerifyApplication::TestReturnValue run(VerifyApplication* state, bool silent)
     {
       std::string cfg = state->rtcore + ",isa="+stringOfISA(isa);
       RTCDeviceRef device = rtcNewDevice(cfg.c_str());
       errorHandler(nullptr,rtcGetDeviceError(device));
       VerifyScene scene(device,sflags);
+      scene.addSphere(sampler,RTC_BUILD_QUALITY_MEDIUM,Vec3fa(0,0,0),1.0f,50);
+      scene.addSphere(sampler,RTC_BUILD_QUALITY_MEDIUM,Vec3fa(3,0,0),1.0f,50);
+      rtcCommitScene(scene);
       AssertNoError(device);
-      unsigned int geom[128];
-      for (size_t i=0; i<128; i++) geom[i] = -1;
-      Sphere spheres[128];
-      memset(spheres,0,sizeof(spheres));
-      
-      for (size_t i=0; i<size_t(50*state->intensity); i++) 
+
+      /* each stream of an interleaved sequence selects the traversal mode of its own coherence */
+      bool passed = true;
+      const StreamType types[8] = { CAMERA, RANDOM, CONE, CAMERA, CONE, RANDOM, RANDOM, CAMERA };
+      for (size_t s=0; s<8; s++)
+        passed &= traceStream(scene,sampler,types[s],s%2);
+      AssertNoError(device);
+
+      RTCSceneTraversalStatistics stats;
+      rtcGetSceneTraversalStatistics(scene,&stats);
+      AssertNoError(device);
+      passed &= stats.coherentStreamCount == 3;
+      passed &= stats.packetStreamCount == 2;
+      passed &= stats.singleRayStreamCount == 3;
+
+      /* threads tracing different workloads concurrently do not influence each other */
+      const size_t numThreads = 4;
+      const size_t numStreams = 8;
+      std::atomic<bool> threadsPassed(true);
+      std::vector<std::thread> threads;
+      for (size_t t=0; t<numThreads; t++)
       {
-        for (size_t j=0; j<10; j++) {
-          int index = random_int()%128;
-          Vec3fa pos = 100.0f*random_Vec3fa();
-          if (geom[index] == -1) {
-            switch (random_int()%11) {
-            case 0: geom[index] = scene.addSphere(sampler,RTC_BUILD_QUALITY_MEDIUM,pos,2.0f,10).first; break;
-            case 1: geom[index] = scene.addSphere(sampler,RTC_BUILD_QUALITY_MEDIUM,pos,2.0f,10,-1,random_motion_vector(1.0f)).first; break;
-            case 2: geom[index] = scene.addQuadSphere(sampler,RTC_BUILD_QUALITY_MEDIUM,pos,2.0f,10).first; break;
-            case 3: geom[index] = scene.addQuadSphere(sampler,RTC_BUILD_QUALITY_MEDIUM,pos,2.0f,10,-1,random_motion_vector(1.0f)).first; break;
-            case 4: geom[index] = scene.addGridSphere(sampler,RTC_BUILD_QUALITY_MEDIUM,pos,2.0f,10).first; break;
-            case 5: geom[index] = scene.addGridSphere(sampler,RTC_BUILD_QUALITY_MEDIUM,pos,2.0f,10,-1,random_motion_vector(1.0f)).first; break;
-            case 6: geom[index] = scene.addHair(sampler,RTC_BUILD_QUALITY_MEDIUM,pos,1.0f,2.0f,10).first; break;
-            case 7: geom[index] = scene.addHair(sampler,RTC_BUILD_QUALITY_MEDIUM,pos,1.0f,2.0f,10,random_motion_vector(1.0f)).first; break;
-            case 8: geom[index] = scene.addSubdivSphere(sampler,RTC_BUILD_QUALITY_MEDIUM,pos,2.0f,4,4).first; break;
-            case 9: geom[index] = scene.addSubdivSphere(sampler,RTC_BUILD_QUALITY_MEDIUM,pos,2.0f,4,4,-1,random_motion_vector(1.0f)).first; break;
-            case 10: 
-              spheres[index] = Sphere(pos,2.0f);
-              geom[index] = scene.addUserGeometryEmpty(sampler,RTC_BUILD_QUALITY_MEDIUM,&spheres[index]).first; break;
-            }
-            AssertNoError(device);
-          }
-          else { 
-            rtcDetachGeometry(scene,geom[index]);     
-            AssertNoError(device);
-            geom[index] = -1; 
-          }
-        }
-        rtcCommitScene(scene);
-        AssertNoError(device);
-        rtcCommitScene(scene);
-        AssertNoError(device);
-        if (i%2 == 0) std::cout << "." << std::flush;
-      }
-      
-      /* now delete all geometries */
-      for (size_t i=0; i<128; i++) 
-        if (geom[i] != -1) rtcDetachGeometry(scene,geom[i]);
-      rtcCommitScene(scene);
+        threads.push_back(std::thread([&,t] () {
+              RandomSampler sampler;
+              RandomSampler_init(sampler,int(t));
+              for (size_t s=0; s<numStreams; s++)
+                if (!traceStream(scene,sampler,t%2 ? RANDOM : CAMERA,s%2)) threadsPassed = false;
+            }));
+      }
+      for (auto& thread : threads) thread.join();
       AssertNoError(device);
+      passed &= threadsPassed;
 
-      rtcCommitScene (scene);
+      rtcGetSceneTraversalStatistics(scene,&stats);
       AssertNoError(device);
+      passed &= stats.coherentStreamCount == 3+numThreads/2*numStreams;
+      passed &= stats.packetStreamCount == 2;
+      passed &= stats.singleRayStreamCount == 3+numThreads/2*numStreams;
 
-      return VerifyApplication::PASSED;
+      return passed ? VerifyApplication::PASSED : VerifyApplication::FAILED;
     }
   };
 
-  struct UserGeometryIDTest : public VerifyApplication::Test
+  struct ShadowRayStreamTest : public VerifyApplication::Test
   {
     SceneFlags sflags;
+    bool curves;
+
+    ShadowRayStreamTest (std::string name, int isa, SceneFlags sflags, bool curves)
+      : VerifyApplication::Test(name,isa,VerifyApplication::TEST_SHOULD_PASS), sflags(sflags), curves(curves) {}
 
-    UserGeometryIDTest (std::string name, int isa, SceneFlags sflags)
-      : VerifyApplication::Test(name,isa,VerifyApplication::TEST_SHOULD_PASS), sflags(sflags) {}
-    
     VerifyApplication::TestReturnValue run(VerifyApplication* state, bool silent)
     {
       std::string cfg = state->rtcore + ",isa="+stringOfISA(isa);
       RTCDeviceRef device = rtcNewDevice(cfg.c_str());
       errorHandler(nullptr,rtcGetDeviceError(device));
       VerifyScene scene(device,sflags);
+      scene.addSphere(sampler,RTC_BUILD_QUALITY_MEDIUM,Vec3fa(-1,0,0),0.8f,50);
+      scene.addQuadSphere(sampler,RTC_BUILD_QUALITY_MEDIUM,Vec3fa(+1,0,0),0.8f,50);
+      if (curves) scene.addHair(sampler,RTC_BUILD_QUALITY_MEDIUM,Vec3fa(0,0,1),1.0f,1.0f,100);
+      rtcCommitScene(scene);
       AssertNoError(device);
 
-      int geom[128];
-      for (size_t i=0; i<128; i++) geom[i] = -1;
-      
-      for (size_t i=0; i<size_t(50*state->intensity); i++) 
+      RTCIntersectContext context;
+      rtcInitIntersectContext(&context);
+
+      /* rays from random shading points towards a few light samples, and from some shading points towards random points */
+      const Vec3fa lights[4] = { Vec3fa(0,5,0), Vec3fa(3,3,3), Vec3fa(-4,1,-2), Vec3fa(0,-5,1) };
+      const size_t numRays = 3000;
+      std::vector<RTCRay> rays(numRays), refRays(numRays);
+      for (size_t i=0; i<numRays; i++)
       {
-        for (size_t j=0; j<10; j++) 
-        {
-          int index = random_int()%128;
-          if (geom[index] == -1) {
-            if (random_bool()) {
-              RTCGeometry hgeom = rtcNewGeometry(device, RTC_GEOMETRY_TYPE_TRIANGLE);
-              rtcCommitGeometry(hgeom);
-              unsigned int geomID = rtcAttachGeometry(scene,hgeom);
-              rtcReleaseGeometry(hgeom);
-              geom[geomID] = geomID;
-              AssertNoError(device);
-            } else {
-              RTCGeometry hgeom = rtcNewGeometry(device, RTC_GEOMETRY_TYPE_TRIANGLE);
-              rtcCommitGeometry(hgeom);
-              unsigned int geomID = rtcAttachGeometry(scene,hgeom);
-              rtcReleaseGeometry(hgeom);
-              geom[geomID] = geomID;
-              AssertNoError(device);
-            }
-          } else {
-             if (random_bool()) {
-               rtcDetachGeometry(scene,geom[index]);     
-               AssertNoError(device);
-               geom[index] = -1; 
-             }
-          }
-        }
-        rtcCommitScene(scene);
-        AssertNoError(device);
+        const Vec3fa org = (i % 3 == 2) ? Vec3fa(0.0f,0.0f,-3.0f+0.01f*float(i%5)) : 6.0f*RandomSampler_get3D(sampler) - Vec3fa(3.0f);
+        const Vec3fa target = (i % 3 == 2) ? 6.0f*RandomSampler_get3D(sampler) - Vec3fa(3.0f) : lights[i%4];
+        rays[i] = makeRay(org,target-org,0.001f,0.999f).ray;
+        if (i % 97 == 0) rays[i].tnear = 2.0f; // inactive ray
+        refRays[i] = rays[i];
+      }
+
+      rtcOccludedShadow1M(scene,&context,rays.data(),numRays,sizeof(RTCRay));
+      AssertNoError(device);
+
+      size_t numErrors = 0, numOccluded = 0;
+      for (size_t i=0; i<numRays; i++)
+      {
+        if (refRays[i].tnear <= refRays[i].tfar)
+          rtcOccluded1(scene,&context,&refRays[i]);
+        numErrors += (rays[i].tfar < 0.0f) != (refRays[i].tfar < 0.0f);
+        numOccluded += refRays[i].tfar < 0.0f;
+      }
+      AssertNoError(device);
+
+      /* reversed rays may differ for hits exactly at primitive edges */
+      return numErrors <= numRays/1000 && numOccluded > 0 ? VerifyApplication::PASSED : VerifyApplication::FAILED;
+    }
+  };
+
+  struct ExpensiveInstanceTest : public VerifyApplication::Test
+  {
+    RTCBuildQuality quality;
+
+    ExpensiveInstanceTest (std::string name, int isa, RTCBuildQuality quality)
+      : VerifyApplication::Test(name,isa,VerifyApplication::TEST_SHOULD_PASS), quality(quality) {}
+
+    static void addInstance(RTCDevice device, RTCScene scene, RTCScene child, const AffineSpace3fa& xfm)
+    {
+      RTCGeometry inst = rtcNewGeometry(device,RTC_GEOMETRY_TYPE_INSTANCE);
+      rtcSetGeometryInstancedScene(inst,child);
+      rtcSetGeometryTransform(inst,0,RTC_FORMAT_FLOAT4X4_COLUMN_MAJOR,(float*)&xfm);
+      rtcCommitGeometry(inst);
+      rtcAttachGeometry(scene,inst);
+      rtcReleaseGeometry(inst);
+    }
+
+    /* traces random rays and checks that both scenes report the same hits */
+    bool compare(RTCScene scene0, RTCScene scene1)
+    {
+      RTCIntersectContext context;
+      rtcInitIntersectContext(&context);
+      for (size_t i=0; i<1000; i++)
+      {
+        const Vec3fa org(-1.0f+12.0f*RandomSampler_get1D(sampler),10.0f,-1.0f+12.0f*RandomSampler_get1D(sampler));
+        const Vec3fa dir(RandomSampler_get1D(sampler)-0.5f,-10.0f,RandomSampler_get1D(sampler)-0.5f);
+        RTCRayHit ray0 = makeRay(org,dir);
+        RTCRayHit ray1 = makeRay(org,dir);
+        rtcIntersect1(scene0,&context,&ray0);
+        rtcIntersect1(scene1,&context,&ray1);
+        if (ray0.hit.instID[0] != ray1.hit.instID[0]) return false;
+        if (ray0.hit.geomID != ray1.hit.geomID) return false;
+        if (ray0.hit.primID != ray1.hit.primID) return false;
+        if (ray0.ray.tfar != ray1.ray.tfar) return false;
+
+        RTCRay shadow0 = makeRay(org,dir).ray;
+        RTCRay shadow1 = makeRay(org,dir).ray;
+        rtcOccluded1(scene0,&context,&shadow0);
+        rtcOccluded1(scene1,&context,&shadow1);
+        if (shadow0.tfar != shadow1.tfar) return false;
+      }
+      return true;
+    }
+
+    static AffineSpace3fa xfmExpensive(unsigned int i) {
+      return AffineSpace3fa::translate(Vec3fa(3.0f*float(i),-0.2f,3.0f*float(i)));
+    }
+
+    /* grid of cheap spheres overlapped by a few hairy planes */
+    void createScene(RTCDevice device, VerifyScene& scene, VerifyScene& cheap, VerifyScene& expensive)
+    {
+      cheap.addGeometry(quality,SceneGraph::createTriangleSphere(zero,0.6f,4));
+      expensive.addGeometry(quality,SceneGraph::createHairyPlane(17,Vec3fa(0,0,0),Vec3fa(4,0,0),Vec3fa(0,0,4),0.5f,0.02f,2000,SceneGraph::FLAT_CURVE));
+      expensive.addGeometry(quality,SceneGraph::createTriangleSphere(Vec3fa(2,0,2),1.0f,20));
+      rtcCommitScene(cheap);
+      rtcCommitScene(expensive);
+
+      for (size_t y=0; y<10; y++)
+        for (size_t x=0; x<10; x++)
+          addInstance(device,scene,cheap,AffineSpace3fa::translate(Vec3fa(float(x),0.0f,float(y))));
+      for (unsigned int i=0; i<3; i++)
+        addInstance(device,scene,expensive,xfmExpensive(i));
+      rtcCommitScene(scene);
+    }
+
+    VerifyApplication::TestReturnValue run (VerifyApplication* state, bool silent)
+    {
+      std::string cfg = state->rtcore + ",isa="+stringOfISA(isa);
+      RTCDeviceRef device0 = rtcNewDevice((cfg+",instancing_expensive_factor=0").c_str());
+      errorHandler(nullptr,rtcGetDeviceError(device0));
+      RTCDeviceRef device1 = rtcNewDevice(cfg.c_str());
+      errorHandler(nullptr,rtcGetDeviceError(device1));
+
+      VerifyScene cheap0(device0,SceneFlags(RTC_SCENE_FLAG_NONE,quality)), expensive0(device0,SceneFlags(RTC_SCENE_FLAG_NONE,quality));
+      VerifyScene cheap1(device1,SceneFlags(RTC_SCENE_FLAG_NONE,quality)), expensive1(device1,SceneFlags(RTC_SCENE_FLAG_NONE,quality));
+      VerifyScene scene0(device0,SceneFlags(RTC_SCENE_FLAG_NONE,quality));
+      VerifyScene scene1(device1,SceneFlags(RTC_SCENE_FLAG_NONE,quality));
+      createScene(device0,scene0,cheap0,expensive0);
+      createScene(device1,scene1,cheap1,expensive1);
+      AssertNoError(device0);
+      AssertNoError(device1);
+
+      /* splitting the instances into two hierarchies must not change any hit */
+      if (!compare(scene0,scene1)) return VerifyApplication::FAILED;
+
+      /* the expensive instances are shared with a scene in which they are not classified as expensive */
+      VerifyScene shared0(device0,SceneFlags(RTC_SCENE_FLAG_NONE,quality));
+      VerifyScene shared1(device1,SceneFlags(RTC_SCENE_FLAG_NONE,quality));
+      for (unsigned int i=0; i<3; i++) {
+        addInstance(device0,shared0,expensive0,xfmExpensive(i));
+        rtcAttachGeometry(shared1,rtcGetGeometry(scene1,100+i));
       }
+      rtcCommitScene(shared0);
+      rtcCommitScene(shared1);
+      AssertNoError(device0);
+      AssertNoError(device1);
+      if (!compare(shared0,shared1)) return VerifyApplication::FAILED;
+      if (!compare(scene0,scene1)) return VerifyApplication::FAILED;
+      AssertNoError(device0);
+      AssertNoError(device1);
+
       return VerifyApplication::PASSED;
     }
   };
@@ -2406,6 +4230,156 @@ namespace embree
     }
   };
 
+  __aligned(16) int interpolation_curve_indices[5] = {
+    0, 3, 6, 9, 12
+  };
+
+  __aligned(16) int interpolation_segment_indices[15] = {
+    0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14
+  };
+
+  struct InterpolateNTest : public VerifyApplication::Test
+  {
+    RTCGeometryType gtype;
+    size_t N;
+    
+    InterpolateNTest (std::string name, int isa, RTCGeometryType gtype, size_t N)
+      : VerifyApplication::Test(name,isa,VerifyApplication::TEST_SHOULD_PASS), gtype(gtype), N(N) {}
+
+    bool isCurve() const {
+      return gtype != RTC_GEOMETRY_TYPE_TRIANGLE && gtype != RTC_GEOMETRY_TYPE_QUAD && gtype != RTC_GEOMETRY_TYPE_GRID;
+    }
+
+    /* compares rtcInterpolateN against rtcInterpolate1 for a batch of random locations */
+    bool checkInterpolateN(RTCGeometry geom, unsigned int numPrims, RTCBufferType bufferType, unsigned int bufferSlot, size_t valueCount)
+    {
+      const size_t M = 13; // not a multiple of the SIMD width
+      const float sentinel = -12345.0f;
+      std::vector<int> valid(M);
+      std::vector<unsigned int> primIDs(M);
+      std::vector<float> u(M), v(M);
+      for (size_t i=0; i<M; i++) {
+        valid[i] = (i%5 == 3) ? 0 : -1;
+        primIDs[i] = (unsigned int)(random_int()%numPrims);
+        u[i] = 0.999f*random_float();
+        v[i] = 0.999f*random_float();
+        if (gtype == RTC_GEOMETRY_TYPE_TRIANGLE && u[i]+v[i] > 1.0f) { u[i] = 1.0f-u[i]; v[i] = 1.0f-v[i]; }
+      }
+      
+      std::vector<float> P(M*valueCount,sentinel), dPdu(M*valueCount,sentinel), dPdv(M*valueCount,sentinel);
+      RTCInterpolateNArguments args;
+      args.geometry = geom;
+      args.valid = valid.data();
+      args.primIDs = primIDs.data();
+      args.u = u.data();
+      args.v = v.data();
+      args.N = (unsigned int)M;
+      args.bufferType = bufferType;
+      args.bufferSlot = bufferSlot;
+      args.P = P.data();
+      args.dPdu = dPdu.data();
+      args.dPdv = dPdv.data();
+      args.ddPdudu = nullptr;
+      args.ddPdvdv = nullptr;
+      args.ddPdudv = nullptr;
+      args.valueCount = (unsigned int)valueCount;
+      rtcInterpolateN(&args);
+
+      bool passed = true;
+      for (size_t i=0; i<M; i++)
+      {
+        float P1[256], dPdu1[256], dPdv1[256];
+        rtcInterpolate1(geom,primIDs[i],u[i],v[i],bufferType,bufferSlot,P1,dPdu1,dPdv1,(unsigned int)valueCount);
+        
+        for (size_t j=0; j<valueCount; j++)
+        {
+          if (!valid[i]) {
+            passed &= P[j*M+i] == sentinel && dPdu[j*M+i] == sentinel;
+            continue;
+          }
+          passed &= fabs(P1[j]-P[j*M+i]) < 1E-4f;
+          passed &= fabs(dPdu1[j]-dPdu[j*M+i]) < 1E-3f;
+          if (!isCurve()) passed &= fabs(dPdv1[j]-dPdv[j*M+i]) < 1E-3f;
+        }
+      }
+      return passed;
+    }
+    
+    VerifyApplication::TestReturnValue run(VerifyApplication* state, bool silent)
+    {
+      std::string cfg = state->rtcore + ",isa="+stringOfISA(isa);
+      RTCDeviceRef device = rtcNewDevice(cfg.c_str());
+      errorHandler(nullptr,rtcGetDeviceError(device));
+
+      const size_t M = num_interpolation_vertices*N+16; // pads the arrays with some valid data
+      
+      RTCGeometry geom = rtcNewGeometry(device, gtype);
+      AssertNoError(device);
+      rtcSetGeometryVertexAttributeCount(geom,1);
+
+      unsigned int numPrims = 0;
+      switch (gtype) {
+      case RTC_GEOMETRY_TYPE_TRIANGLE:
+        numPrims = num_interpolation_triangle_faces;
+        rtcSetSharedGeometryBuffer(geom, RTC_BUFFER_TYPE_INDEX, 0, RTC_FORMAT_UINT3, interpolation_triangle_indices, 0, 3*sizeof(unsigned int), numPrims);
+        break;
+      case RTC_GEOMETRY_TYPE_QUAD:
+        numPrims = num_interpolation_quad_faces;
+        rtcSetSharedGeometryBuffer(geom, RTC_BUFFER_TYPE_INDEX, 0, RTC_FORMAT_UINT4, interpolation_quad_indices, 0, 4*sizeof(unsigned int), numPrims);
+        break;
+      case RTC_GEOMETRY_TYPE_GRID:
+        numPrims = 1;
+        interpolation_grids[0].startVertexID = 0;
+        interpolation_grids[0].stride = 4;
+        interpolation_grids[0].width = 4;
+        interpolation_grids[0].height = 4;
+        rtcSetSharedGeometryBuffer(geom, RTC_BUFFER_TYPE_GRID, 0, RTC_FORMAT_GRID, interpolation_grids, 0, sizeof(RTCGrid), numPrims);
+        break;
+      case RTC_GEOMETRY_TYPE_FLAT_LINEAR_CURVE:
+      case RTC_GEOMETRY_TYPE_ROUND_HERMITE_CURVE:
+        numPrims = 15;
+        rtcSetSharedGeometryBuffer(geom, RTC_BUFFER_TYPE_INDEX, 0, RTC_FORMAT_UINT, interpolation_segment_indices, 0, sizeof(unsigned int), numPrims);
+        break;
+      default:
+        numPrims = 5;
+        rtcSetSharedGeometryBuffer(geom, RTC_BUFFER_TYPE_INDEX, 0, RTC_FORMAT_UINT, interpolation_curve_indices, 0, sizeof(unsigned int), numPrims);
+        break;
+      }
+      AssertNoError(device);
+
+      const RTCFormat vformat = isCurve() ? RTC_FORMAT_FLOAT4 : RTC_FORMAT_FLOAT3;
+      std::vector<float> vertices0(M);
+      for (size_t i=0; i<M; i++) vertices0[i] = random_float();
+      rtcSetSharedGeometryBuffer(geom, RTC_BUFFER_TYPE_VERTEX, 0, vformat, vertices0.data(), 0, N*sizeof(float), num_interpolation_vertices);
+      AssertNoError(device);
+
+      std::vector<float> tangents0(M);
+      for (size_t i=0; i<M; i++) tangents0[i] = random_float();
+      if (gtype == RTC_GEOMETRY_TYPE_ROUND_HERMITE_CURVE) {
+        rtcSetSharedGeometryBuffer(geom, RTC_BUFFER_TYPE_TANGENT, 0, RTC_FORMAT_FLOAT4, tangents0.data(), 0, N*sizeof(float), num_interpolation_vertices);
+        AssertNoError(device);
+      }
+      
+      std::vector<float> user_vertices0(M);
+      for (size_t i=0; i<M; i++) user_vertices0[i] = random_float();
+      rtcSetSharedGeometryBuffer(geom, RTC_BUFFER_TYPE_VERTEX_ATTRIBUTE, 0, RTCFormat(RTC_FORMAT_FLOAT+N), user_vertices0.data(), 0, N*sizeof(float), num_interpolation_vertices);
+      AssertNoError(device);
+      
+      rtcCommitGeometry(geom);
+      AssertNoError(device);
+      
+      bool passed = true;
+      passed &= checkInterpolateN(geom,numPrims,RTC_BUFFER_TYPE_VERTEX,0,isCurve() ? 4 : 3);
+      passed &= checkInterpolateN(geom,numPrims,RTC_BUFFER_TYPE_VERTEX_ATTRIBUTE,0,N);
+      passed &= checkInterpolateN(geom,numPrims,RTC_BUFFER_TYPE_VERTEX_ATTRIBUTE,0,1);
+
+      rtcReleaseGeometry(geom);
+      AssertNoError(device);
+
+      return (VerifyApplication::TestReturnValue) passed;
+    }
+  };
+
   /////////////////////////////////////////////////////////////////////////////////
   /////////////////////////////////////////////////////////////////////////////////
   /////////////////////////////////////////////////////////////////////////////////
@@ -5311,6 +7285,7 @@ namespace embree
       groups.top()->add(new EmbreeInternalTest(testName,i-2000000));
     }
     groups.top()->add(new os_shrink_test());
+    groups.top()->add(new BinarySceneCacheTest("binary_scene_cache"));
 
     for (auto isa : isas)
     {
@@ -5335,6 +7310,20 @@ namespace embree
       for (auto gtype : gtypes)
         groups.top()->add(new BufferStrideTest(to_string(gtype),isa,gtype));
       groups.pop();
+
+      push(new TestGroup("compact_formats",true,true));
+      for (auto gtype : { RTC_GEOMETRY_TYPE_TRIANGLE, RTC_GEOMETRY_TYPE_QUAD })
+      {
+        for (auto vformat : { RTC_FORMAT_HALF3, RTC_FORMAT_SHORT3 })
+        {
+          std::string name = std::string(gtype == RTC_GEOMETRY_TYPE_QUAD ? "quads" : "triangles") + (vformat == RTC_FORMAT_HALF3 ? "_half" : "_snorm16");
+          push(new TestGroup(name,true,true));
+          for (auto sflags : sceneFlags)
+            groups.top()->add(new CompactFormatsTest(to_string(sflags),isa,sflags,gtype,vformat));
+          groups.pop();
+        }
+      }
+      groups.pop();
       
       /**************************************************************************/
       /*                        Builder Tests                                   */
@@ -5359,6 +7348,74 @@ namespace embree
       for (auto sflags : sceneFlags) 
         groups.top()->add(new BuildTest(to_string(sflags),isa,sflags,RTC_BUILD_QUALITY_MEDIUM));
       groups.pop();
+
+      push(new TestGroup("memory_budget",true,true));
+      for (auto sflags : sceneFlags) {
+        groups.top()->add(new MemoryBudgetTest(to_string(sflags),isa,sflags));
+      }
+      groups.pop();
+
+      push(new TestGroup("streaming_build",true,true));
+      groups.top()->add(new StreamingBuildTest("triangle4",isa,"tri_accel=bvh4.triangle4,tri_builder=sah_streaming,build_memory_budget=0.5"));
+      groups.top()->add(new StreamingBuildTest("triangle4i",isa,"tri_accel=bvh4.triangle4i,tri_builder=sah_streaming,build_memory_budget=0.5"));
+      groups.top()->add(new StreamingBuildTest("triangle4v",isa,"tri_accel=bvh4.triangle4v,tri_builder=sah_streaming,build_memory_budget=0.5"));
+      groups.top()->add(new StreamingBuildTest("unbounded",isa,"tri_builder=sah_streaming"));
+      groups.pop();
+
+      push(new TestGroup("time_split",true,true));
+      groups.top()->add(new TimeSplitTest("fixed",isa,0.0f));
+      groups.top()->add(new TimeSplitTest("adaptive",isa,1.5f));
+      groups.top()->add(new TimeSplitTest("always",isa,1.0f));
+      groups.pop();
+
+      push(new TestGroup("no_filter_context",true,true));
+      groups.top()->add(new NoFilterContextTest("triangles",isa,false));
+      groups.top()->add(new NoFilterContextTest("quads",isa,true));
+      groups.pop();
+
+      push(new TestGroup("async_commit",true,true));
+      groups.top()->add(new AsyncCommitTest("spheres",isa));
+      groups.pop();
+
+      push(new TestGroup("displaced_grid",true,true));
+      groups.top()->add(new DisplacedGridTest("rate1",isa,1));
+      groups.top()->add(new DisplacedGridTest("rate3",isa,3));
+      groups.top()->add(new DisplacedGridTest("rate8",isa,8));
+      groups.top()->add(new DisplacedGridTest("rate16",isa,16));
+      groups.pop();
+
+      push(new TestGroup("progressive_commit",true,true));
+      groups.top()->add(new ProgressiveCommitTest("triangles",isa,false));
+      groups.top()->add(new ProgressiveCommitTest("quads",isa,true));
+      groups.pop();
+
+      push(new TestGroup("fused_binning",true,true));
+      groups.top()->add(new FusedBinningTest("triangles",isa,false));
+      groups.top()->add(new FusedBinningTest("quads",isa,true));
+      groups.pop();
+
+      push(new TestGroup("treelet_layout",true,true));
+      groups.top()->add(new TreeletLayoutTest("medium",isa,RTC_BUILD_QUALITY_MEDIUM,false));
+      groups.top()->add(new TreeletLayoutTest("high",isa,RTC_BUILD_QUALITY_HIGH,false));
+      groups.top()->add(new TreeletLayoutTest("motion_blur",isa,RTC_BUILD_QUALITY_MEDIUM,true));
+      groups.pop();
+
+      push(new TestGroup("scene_origin",true,true));
+      groups.top()->add(new SceneOriginTest("static",isa,1));
+      groups.top()->add(new SceneOriginTest("motion_blur",isa,2));
+      groups.pop();
+
+#if RTC_MIN_WIDTH
+      push(new TestGroup("curve_lod",true,true));
+      groups.top()->add(new CurveLODTest("hair",isa));
+      groups.top()->add(new PointLODTest("points",isa));
+      groups.pop();
+#endif
+
+      push(new TestGroup("point_compression",true,true));
+      groups.top()->add(new PointCompressionTest("spheres",isa,RTC_GEOMETRY_TYPE_SPHERE_POINT));
+      groups.top()->add(new PointCompressionTest("discs",isa,RTC_GEOMETRY_TYPE_DISC_POINT));
+      groups.pop();
       
       push(new TestGroup("overlapping_primitives",true,false));
       for (auto sflags : sceneFlags)
@@ -5374,6 +7431,35 @@ namespace embree
       for (auto sflags : sceneFlagsDynamic) 
         groups.top()->add(new UserGeometryIDTest(to_string(sflags),isa,sflags));
       groups.pop();
+
+      push(new TestGroup("user_geometry_split",true,true));
+      for (auto sflags : sceneFlags)
+        groups.top()->add(new UserGeometrySplitTest(to_string(sflags),isa,sflags));
+      groups.pop();
+
+      push(new TestGroup("adaptive_coherence",true,true));
+      for (auto sflags : sceneFlags)
+        groups.top()->add(new AdaptiveCoherenceTest(to_string(sflags),isa,sflags));
+      groups.pop();
+
+      push(new TestGroup("expensive_instances",true,true));
+      groups.top()->add(new ExpensiveInstanceTest("static",isa,RTC_BUILD_QUALITY_MEDIUM));
+      groups.top()->add(new ExpensiveInstanceTest("dynamic",isa,RTC_BUILD_QUALITY_LOW));
+      groups.pop();
+
+      push(new TestGroup("shadow_ray_stream",true,true));
+      for (auto sflags : sceneFlags) {
+        groups.top()->add(new ShadowRayStreamTest("meshes."+to_string(sflags),isa,sflags,false));
+        groups.top()->add(new ShadowRayStreamTest("curves."+to_string(sflags),isa,sflags,true));
+      }
+      groups.pop();
+
+      push(new TestGroup("deferred_user_geometry",true,true));
+      for (auto sflags : sceneFlags) {
+        groups.top()->add(new DeferredUserGeometryTest("coherent."+to_string(sflags),isa,sflags,RTC_INTERSECT_CONTEXT_FLAG_COHERENT));
+        groups.top()->add(new DeferredUserGeometryTest("incoherent."+to_string(sflags),isa,sflags,RTC_INTERSECT_CONTEXT_FLAG_INCOHERENT));
+      }
+      groups.pop();
       
       push(new TestGroup("enable_disable_geometry",true,true));
       for (auto sflags : sceneFlagsDynamic) 
@@ -5447,6 +7533,18 @@ namespace embree
         groups.top()->add(new InterpolateHairTest(std::to_string((long long)(s)),isa,s));
       groups.pop();
 
+      push(new TestGroup("N",true,true));
+      RTCGeometryType interpolateNTypes[] = {
+        RTC_GEOMETRY_TYPE_TRIANGLE, RTC_GEOMETRY_TYPE_QUAD, RTC_GEOMETRY_TYPE_GRID, RTC_GEOMETRY_TYPE_FLAT_LINEAR_CURVE,
+        RTC_GEOMETRY_TYPE_ROUND_BEZIER_CURVE, RTC_GEOMETRY_TYPE_ROUND_BSPLINE_CURVE, RTC_GEOMETRY_TYPE_ROUND_CATMULL_ROM_CURVE,
+        RTC_GEOMETRY_TYPE_ROUND_HERMITE_CURVE
+      };
+      const char* interpolateNNames[] = { "triangles", "quads", "grid", "lines", "bezier", "bspline", "catmull_rom", "hermite" };
+      for (size_t t=0; t<sizeof(interpolateNTypes)/sizeof(RTCGeometryType); t++)
+        for (auto s : interpolateTests) 
+          groups.top()->add(new InterpolateNTest(std::string(interpolateNNames[t])+"_"+std::to_string((long long)(s)),isa,interpolateNTypes[t],s));
+      groups.pop();
+
       groups.pop();
       
       /**************************************************************************/